@@ -61,6 +61,8 @@ void pipeline_stage_1(chanend_t c_frame_in, chanend_t c_frame_out) {
     // Disable ADEC's automatic mode. We only want to estimate and correct for the delay at startup
     adec_config_t adec_conf;
     adec_conf.bypass = 1; // Bypass automatic DE correction
+    adec_conf.use_refined_delay = 0; // Correct delay to whole AEC filter phases
+    adec_conf.use_gcc_phat = STAGE_1_GCC_PHAT; // Correct delay changes from the GCC-PHAT estimate when stage 1 runs it
 #if DISABLE_INITIAL_DELAY_EST
     adec_conf.force_de_cycle_trigger = 0; // Do not force a DE correction cycle ob startup
 #else
@@ -80,11 +82,12 @@ void pipeline_stage_1(chanend_t c_frame_in, chanend_t c_frame_out) {
 #endif
         
         // AEC, DE ADEC
-        stage_1_process_frame(&stage_1_state, &stage_1_out[0], &md.max_ref_energy, &md.aec_corr_factor[0], &md.ref_active_flag, &frame[0], &frame[AP_MAX_Y_CHANNELS]);
-        // If AEC has processed fewer y channels than downstream stages (in DE mode for example), then copy aec_corr_factor[0] to other channels
+        stage_1_process_frame(&stage_1_state, &stage_1_out[0], &md.max_ref_energy, &md.aec_corr_factor[0], &md.aec_double_talk_state[0], &md.ref_active_flag, &frame[0], &frame[AP_MAX_Y_CHANNELS]);
+        // If AEC has processed fewer y channels than downstream stages (in DE mode for example), then copy aec_corr_factor[0] and aec_double_talk_state[0] to other channels
         if(stage_1_state.aec_main_state.shared_state->num_y_channels < AP_MAX_Y_CHANNELS) {
             for(int ch=stage_1_state.aec_main_state.shared_state->num_y_channels; ch<AP_MAX_Y_CHANNELS; ch++) {
                 md.aec_corr_factor[ch] = md.aec_corr_factor[0];
+                md.aec_double_talk_state[ch] = md.aec_double_talk_state[0];
             }
         }
         
@@ -223,6 +226,7 @@ void pipeline_stage_4(chanend_t c_frame_in, chanend_t c_frame_out) {
         /** AGC*/
         for(int ch=0; ch<AP_MAX_Y_CHANNELS; ch++) {
             agc_md.aec_corr_factor = md.aec_corr_factor[ch];
+            agc_md.aec_double_talk_flag = (md.aec_double_talk_state[ch] == AEC_DT_DOUBLE_TALK);
             // Memory optimisation: Reuse input memory for AGC output
             agc_process_frame(&agc_state[ch], frame[ch], frame[ch], &agc_md);
         }
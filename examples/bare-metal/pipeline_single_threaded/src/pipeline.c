@@ -46,6 +46,8 @@ void pipeline_tile0_init(pipeline_state_tile0_t *state) {
     // Disable ADEC's automatic mode. We only want to estimate and correct for the delay at startup
     adec_config_t adec_conf;
     adec_conf.bypass = 1; // Bypass automatic DE correction
+    adec_conf.use_refined_delay = 0; // Correct delay to whole AEC filter phases
+    adec_conf.use_gcc_phat = STAGE_1_GCC_PHAT; // Correct delay changes from the GCC-PHAT estimate when stage 1 runs it
 #if DISABLE_INITIAL_DELAY_EST
     adec_conf.force_de_cycle_trigger = 0; // Do not force a DE correction cycle ob startup
 #else
@@ -91,11 +93,12 @@ void pipeline_process_frame_tile0(pipeline_state_tile0_t *state,
 #if DISABLE_STAGE_1
     memcpy(&stage_1_out[0][0], &input_y_data[0][0], AEC_MAX_Y_CHANNELS*AP_FRAME_ADVANCE*sizeof(int32_t));
 #else
-    stage_1_process_frame(&state->stage_1_state, &stage_1_out[0], &md.max_ref_energy, &md.aec_corr_factor[0], &md.ref_active_flag, input_y_data, input_x_data);
+    stage_1_process_frame(&state->stage_1_state, &stage_1_out[0], &md.max_ref_energy, &md.aec_corr_factor[0], &md.aec_double_talk_state[0], &md.ref_active_flag, input_y_data, input_x_data);
     
     if(state->stage_1_state.aec_main_state.shared_state->num_y_channels < AP_MAX_Y_CHANNELS) {
         for(int ch=state->stage_1_state.aec_main_state.shared_state->num_y_channels; ch<AP_MAX_Y_CHANNELS; ch++) {
             md.aec_corr_factor[ch] = md.aec_corr_factor[0];
+            md.aec_double_talk_state[ch] = md.aec_double_talk_state[0];
         }
     }
 #endif
@@ -164,6 +167,7 @@ void pipeline_process_frame_tile1(pipeline_state_tile1_t *state, pipeline_metada
 
     for(int ch=0; ch<AP_MAX_Y_CHANNELS; ch++) {
         agc_md.aec_corr_factor = md.aec_corr_factor[ch];
+        agc_md.aec_double_talk_flag = (md.aec_double_talk_state[ch] == AEC_DT_DOUBLE_TALK);
         agc_process_frame(&state->agc_state[ch], output_data[ch], ns_output[ch], &agc_md);
     }
 #endif
@@ -0,0 +1,48 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <string.h>
+#include "aec_engine.h"
+#include "aec_process_frame_1thread.h"
+
+void aec_engine_init(
+        aec_engine_t *engine,
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_shadow_filter_phases)
+{
+    aec_init(&engine->main_state, &engine->shadow_state, &engine->shared_state,
+            (uint8_t*)&engine->main_memory_pool, (uint8_t*)&engine->shadow_memory_pool,
+            num_y_channels, num_x_channels, num_main_filter_phases, num_shadow_filter_phases);
+    engine->X_energy_recalc_bin = 0;
+    engine->frame_count = 0;
+}
+
+void aec_engine_process_frame(
+        aec_engine_t *engine,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE])
+{
+    aec_process_frame_1thread_r(&engine->main_state, &engine->shadow_state, &engine->X_energy_recalc_bin,
+            output_main, output_shadow, y_data, x_data);
+    engine->frame_count++;
+}
+
+void aec_engine_process_frame_batch(
+        aec_engine_t *engines,
+        unsigned num_engines,
+        int32_t (*output_main)[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_MAX_X_CHANNELS][AEC_FRAME_ADVANCE])
+{
+    for(unsigned i=0; i<num_engines; i++) {
+        aec_engine_process_frame(&engines[i],
+                output_main[i],
+                (output_shadow != NULL) ? output_shadow[i] : NULL,
+                y_data[i],
+                x_data[i]);
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef AEC_ENGINE_H
+#define AEC_ENGINE_H
+
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_config.h"
+#include "aec_memory_pool.h"
+
+/* A self contained AEC instance. It owns the main and shadow filter state, their memory pools and the per-instance
+ * scheduling state that aec_process_frame_1thread() keeps in file statics, so that any number of independent echo
+ * cancellers can be run from the same process.
+ */
+typedef struct {
+    aec_state_t main_state;
+    aec_state_t shadow_state;
+    aec_shared_state_t shared_state;
+    aec_memory_pool_t main_memory_pool;
+    aec_shadow_filt_memory_pool_t shadow_memory_pool;
+    /** Bin whose X energy is recalculated from scratch in the next frame*/
+    unsigned X_energy_recalc_bin;
+    /** Number of frames processed since aec_engine_init()*/
+    unsigned frame_count;
+}aec_engine_t;
+
+/* Initialise an AEC instance. Arguments are as for aec_init(). */
+void aec_engine_init(
+        aec_engine_t *engine,
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_shadow_filter_phases);
+
+/* Process one frame through an AEC instance. Arguments are as for aec_process_frame_1thread(). */
+void aec_engine_process_frame(
+        aec_engine_t *engine,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
+
+/* Process one frame through each of num_engines AEC instances.
+ *
+ * The ith instance reads y_data[i] and x_data[i] and writes output_main[i] and output_shadow[i]. output_shadow can be
+ * NULL if the shadow filter output is not needed. Instances are processed one after another, so each instance's
+ * state is only brought into cache once per frame instead of once per processing stage.
+ */
+void aec_engine_process_frame_batch(
+        aec_engine_t *engines,
+        unsigned num_engines,
+        int32_t (*output_main)[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_MAX_X_CHANNELS][AEC_FRAME_ADVANCE]);
+
+#endif
@@ -4,15 +4,19 @@
 #include <string.h>
 #include "aec_defines.h"
 #include "aec_api.h"
+#include "aec_process_frame_1thread.h"
 
 /* This is an example of processing one frame of data through the AEC pipeline stage. The example runs on 1 thread and
  * can be compiled for both bare metal and x86.
  */
-static unsigned X_energy_recalc_bin = 0;
-static int framenum = 0;
-void aec_process_frame_1thread(
+
+/* Process a frame with an optional residual echo suppressor. res_state is NULL when there isn't one.
+ */
+static void process_frame_1thread(
         aec_state_t *main_state,
         aec_state_t *shadow_state,
+        aec_res_state_t *res_state,
+        unsigned *X_energy_recalc_bin,
         int32_t (*output_main)[AEC_FRAME_ADVANCE],
         int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
         const int32_t (*y_data)[AEC_FRAME_ADVANCE],
@@ -66,22 +70,22 @@ void aec_process_frame_1thread(
         /* BFP struct main_state->X_energy[ch] points to AEC_PROC_FRAME_LENGTH/2 + 1 real 32bit values where value at index n is
          * the nth X sample's energy summed over main_state->num_phases number of frames in the X FIFO.
          */
-        aec_calc_X_fifo_energy(main_state, ch, X_energy_recalc_bin);
+        aec_calc_X_fifo_energy(main_state, ch, *X_energy_recalc_bin);
         
         // Calculate sum of X energy for shadow filter
         /* BFP struct shadow_state->X_energy[ch] points to AEC_PROC_FRAME_LENGTH/2 + 1 real 32bit values where value at index n is
          * the nth X sample's energy summed over shadow_state->num_phases number of frames in the X FIFO.
          */
-        aec_calc_X_fifo_energy(shadow_state, ch, X_energy_recalc_bin);
+        aec_calc_X_fifo_energy(shadow_state, ch, *X_energy_recalc_bin);
     }
 
     // Increment X_energy_recalc_bin to the next sample index.
     /* Passing X_energy_recalc_bin to aec_calc_X_fifo_energy() ensures that energy of sample at index X_energy_recalc_bin
      * is recalculated without the speed optimisations so that quantisation error can be kept in check
      */
-    X_energy_recalc_bin += 1;
-    if(X_energy_recalc_bin == (AEC_PROC_FRAME_LENGTH/2) + 1) { // Wrap around to 0 on completing one (AEC_PROC_FRAME_LENGTH/2) + 1 samples pass.
-        X_energy_recalc_bin = 0;
+    *X_energy_recalc_bin += 1;
+    if(*X_energy_recalc_bin == (AEC_PROC_FRAME_LENGTH/2) + 1) { // Wrap around to 0 on completing one (AEC_PROC_FRAME_LENGTH/2) + 1 samples pass.
+        *X_energy_recalc_bin = 0;
     }
 
     // Update X-FIFO and calculate sigma_XX.
@@ -93,19 +97,17 @@ void aec_process_frame_1thread(
         aec_update_X_fifo_and_calc_sigmaXX(main_state, ch);
     }
 
-    // Copy state->shared_state->X_fifo BFP struct to main_state->X_fifo_1d and shadow_state->X_fifo_1d BFP structs
-    /* The updated state->shared_state->X_FIFO BFP structures are copied to an alternate set of BFP structs present in the 
-     * main and shadow filter state structure, that are used to efficiently access the X FIFO in the Error computation and filter
-     * update steps.
-     */
-    aec_update_X_fifo_1d(main_state);
-    aec_update_X_fifo_1d(shadow_state);
-
     // Calculate error spectrum and estimated mic spectrum for main and shadow adaptive filters
     for(int ch=0; ch<num_y_channels; ch++) {
         // main_state->Error[ch] and main_state->Y_hat[ch] are updated
         aec_calc_Error_and_Y_hat(main_state, ch);
 
+        // The residual echo suppression gain is calculated from the main filter Error and Y_hat spectra, before they
+        // are converted to the time domain
+        if(res_state != NULL) {
+            aec_res_calc_gain(res_state, main_state, ch);
+        }
+
         // shadow_state->Error[ch] and shadow_state->Y_hat[ch] are updated
         aec_calc_Error_and_Y_hat(shadow_state, ch);
     }
@@ -164,6 +166,14 @@ void aec_process_frame_1thread(
                );
     }
 
+    // Replace the main filter output with the residual echo suppressed output. This is calculated from the windowed
+    // error spectrum, so comes after the forward FFT, and after the error EMA energy so that the ERLE is of the filter.
+    if(res_state != NULL) {
+        for(int ch=0; ch<num_y_channels; ch++) {
+            aec_res_calc_output(res_state, main_state, &output_main[ch], ch);
+        }
+    }
+
     // Calculate energies of mic input and error spectrum of main and shadow filters.
     // These energy values are later used in aec_compare_filters_and_calc_mu() to estimate how well the filters are performing.
     for(int ch=0; ch<num_y_channels; ch++) {
@@ -218,5 +228,76 @@ void aec_process_frame_1thread(
         // Update shadow_state->H_hat
         aec_filter_adapt(shadow_state, ych);
     }
-    framenum++; 
+}
+
+/* Reentrant version of aec_process_frame_1thread(). Per-instance scheduling state that would otherwise be a file static, the
+ * X energy recalculation bin, is passed in by the caller so that any number of independent AEC instances can be run
+ * from the same process. It should be set to 0 along with aec_init() and is updated every frame.
+ */
+void aec_process_frame_1thread_r(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE])
+{
+    process_frame_1thread(main_state, shadow_state, NULL, X_energy_recalc_bin, output_main, output_shadow, y_data, x_data);
+}
+
+/* Version of aec_process_frame_1thread_r() with a residual echo suppressor after the main filter. output_main is the
+ * residual echo suppressed output. res_state is initialised with aec_res_init().
+ */
+void aec_process_frame_1thread_res(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        aec_res_state_t *res_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE])
+{
+    process_frame_1thread(main_state, shadow_state, res_state, X_energy_recalc_bin, output_main, output_shadow, y_data, x_data);
+}
+
+/* Version of aec_process_frame_1thread_r() with a tail filter extending the main filter to long echo tails. The tail
+ * filter echo estimate is removed from the mic input before the main and shadow filters see it, and the tail filter is
+ * updated with the main filter output at the end of the frame. tail_state is initialised with aec_tail_init() after
+ * aec_init().
+ */
+void aec_process_frame_1thread_tail(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        aec_tail_state_t *tail_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE])
+{
+    int32_t DWORD_ALIGNED y_cancelled[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+    memcpy(y_cancelled, y_data, main_state->shared_state->num_y_channels*AEC_FRAME_ADVANCE*sizeof(int32_t));
+
+    // Remove the tail filter echo estimate for this frame from the mic input
+    aec_tail_remove_echo(tail_state, y_cancelled);
+
+    aec_process_frame_1thread_r(main_state, shadow_state, X_energy_recalc_bin, output_main, output_shadow,
+            (const int32_t (*)[AEC_FRAME_ADVANCE])y_cancelled, x_data);
+
+    // Adapt the tail filter on the main filter output and work towards the next block's echo estimate
+    aec_tail_update(tail_state, main_state, x_data, (const int32_t (*)[AEC_FRAME_ADVANCE])output_main);
+}
+
+static unsigned X_energy_recalc_bin = 0;
+void aec_process_frame_1thread(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE])
+{
+    aec_process_frame_1thread_r(main_state, shadow_state, &X_energy_recalc_bin, output_main, output_shadow, y_data, x_data);
 }
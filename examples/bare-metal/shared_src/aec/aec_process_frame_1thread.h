@@ -0,0 +1,59 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef AEC_PROCESS_FRAME_1THREAD_H
+#define AEC_PROCESS_FRAME_1THREAD_H
+
+#include <stdint.h>
+#include "aec_defines.h"
+#include "aec_state.h"
+
+/* Process one frame through the AEC on the calling thread. The X energy recalculation bin is kept in a file static, so
+ * only one AEC instance can be processed with this function.
+ */
+void aec_process_frame_1thread(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
+
+/* Reentrant version of aec_process_frame_1thread(). X_energy_recalc_bin is per instance state, set to 0 along with
+ * aec_init() and updated every frame.
+ */
+void aec_process_frame_1thread_r(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
+
+/* Version of aec_process_frame_1thread_r() with a residual echo suppressor after the main filter. output_main is the
+ * residual echo suppressed output. res_state is initialised with aec_res_init().
+ */
+void aec_process_frame_1thread_res(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        aec_res_state_t *res_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
+
+/* Version of aec_process_frame_1thread_r() with a tail filter extending the main filter to long echo tails. tail_state
+ * is initialised with aec_tail_init() after aec_init().
+ */
+void aec_process_frame_1thread_tail(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        aec_tail_state_t *tail_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
+
+#endif
@@ -29,12 +29,16 @@ DECLARE_JOB(calc_normalisation_spectrum_task, (par_tasks_and_channels_t*, aec_st
 DECLARE_JOB(calc_T_task, (par_tasks_and_channels_t*, aec_state_t*, aec_state_t*, int, int, int));
 DECLARE_JOB(filter_adapt_task, (par_tasks_t*, aec_state_t*, aec_state_t*, int, int));
 
-extern task_distribution_t tdist;
-static unsigned X_energy_recalc_bin = 0;
-static int framenum = 0;
-void aec_process_frame_2threads(
+/* Reentrant version of aec_process_frame_2threads(). Per-instance scheduling state that would otherwise be a file static, the
+ * task distribution and the X energy recalculation bin, is passed in by the caller so that any number of independent
+ * AEC instances can be run from the same process. tdist is a task distribution scheme as generated in
+ * aec_task_distribution.c. X_energy_recalc_bin should be set to 0 along with aec_init() and is updated every frame.
+ */
+void aec_process_frame_2threads_r(
+        task_distribution_t *tdist,
         aec_state_t *main_state,
         aec_state_t *shadow_state,
+        unsigned *X_energy_recalc_bin,
         int32_t (*output_main)[AEC_FRAME_ADVANCE],
         int32_t (*output_shadow)[AEC_FRAME_ADVANCE],    
         const int32_t (*y_data)[AEC_FRAME_ADVANCE],
@@ -50,13 +54,13 @@ void aec_process_frame_2threads(
 
     // Calculate Exponential moving average (EMA) energy of the mic and reference input.
     PAR_JOBS(
-        PJOB(calc_time_domain_ema_energy_task, (tdist.par_1_tasks_and_channels[0], main_state, NULL, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, Y_EMA)),
-        PJOB(calc_time_domain_ema_energy_task, (tdist.par_1_tasks_and_channels[1], main_state, NULL, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, Y_EMA))
+        PJOB(calc_time_domain_ema_energy_task, (tdist->par_1_tasks_and_channels[0], main_state, NULL, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, Y_EMA)),
+        PJOB(calc_time_domain_ema_energy_task, (tdist->par_1_tasks_and_channels[1], main_state, NULL, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, Y_EMA))
         );
 
     PAR_JOBS(
-        PJOB(calc_time_domain_ema_energy_task, (tdist.par_1_tasks_and_channels[0], main_state, NULL, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_EMA)),
-        PJOB(calc_time_domain_ema_energy_task, (tdist.par_1_tasks_and_channels[1], main_state, NULL, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_EMA))
+        PJOB(calc_time_domain_ema_energy_task, (tdist->par_1_tasks_and_channels[0], main_state, NULL, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_EMA)),
+        PJOB(calc_time_domain_ema_energy_task, (tdist->par_1_tasks_and_channels[1], main_state, NULL, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_EMA))
         );
 
     // Calculate mic input spectrum for all num_y_channels of mic input
@@ -70,14 +74,14 @@ void aec_process_frame_2threads(
      * as well.
      */
     PAR_JOBS(
-        PJOB(fft_task, (tdist.par_1_tasks_and_channels[0], main_state, shadow_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, Y_FFT)),
-        PJOB(fft_task, (tdist.par_1_tasks_and_channels[1], main_state, shadow_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, Y_FFT))
+        PJOB(fft_task, (tdist->par_1_tasks_and_channels[0], main_state, shadow_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, Y_FFT)),
+        PJOB(fft_task, (tdist->par_1_tasks_and_channels[1], main_state, shadow_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, Y_FFT))
         );
 
     // Calculate reference input spectrum for all num_x_channels of reference input
     PAR_JOBS(
-        PJOB(fft_task, (tdist.par_1_tasks_and_channels[0], main_state, shadow_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_FFT)),
-        PJOB(fft_task, (tdist.par_1_tasks_and_channels[1], main_state, shadow_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_FFT))
+        PJOB(fft_task, (tdist->par_1_tasks_and_channels[0], main_state, shadow_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_FFT)),
+        PJOB(fft_task, (tdist->par_1_tasks_and_channels[1], main_state, shadow_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_FFT))
         );
 
     // Calculate sum of X energy over X FIFO phases for all num_x_channels reference channels for main and shadow filter.   
@@ -93,17 +97,17 @@ void aec_process_frame_2threads(
      * of frames in the X FIFO.
      */
     PAR_JOBS(
-        PJOB(update_X_energy_task, (tdist.par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_energy_recalc_bin)),
-        PJOB(update_X_energy_task, (tdist.par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels, X_energy_recalc_bin))
+        PJOB(update_X_energy_task, (tdist->par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels, *X_energy_recalc_bin)),
+        PJOB(update_X_energy_task, (tdist->par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels, *X_energy_recalc_bin))
         );
 
     // Increment X_energy_recalc_bin to the next sample index.
     /* Passing X_energy_recalc_bin to aec_calc_X_fifo_energy() ensures that energy of sample at index X_energy_recalc_bin
      * is recalculated without the speed optimisations so that quantisation error can be kept in check
      */
-    X_energy_recalc_bin += 1;
-    if(X_energy_recalc_bin == (AEC_PROC_FRAME_LENGTH/2) + 1) {
-        X_energy_recalc_bin = 0;
+    *X_energy_recalc_bin += 1;
+    if(*X_energy_recalc_bin == (AEC_PROC_FRAME_LENGTH/2) + 1) {
+        *X_energy_recalc_bin = 0;
     }
 
     // Update X-FIFO and calculate sigma_XX.
@@ -112,25 +116,17 @@ void aec_process_frame_2threads(
      * It is later used to time smooth the X_energy while calculating the normalisation spectrum
      */
     PAR_JOBS(
-        PJOB(update_X_fifo_task, (tdist.par_1_tasks_and_channels[0], main_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels)),
-        PJOB(update_X_fifo_task, (tdist.par_1_tasks_and_channels[1], main_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels))
+        PJOB(update_X_fifo_task, (tdist->par_1_tasks_and_channels[0], main_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels)),
+        PJOB(update_X_fifo_task, (tdist->par_1_tasks_and_channels[1], main_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_x_channels))
         );
 
-    // Copy state->shared_state->X_fifo BFP struct to main_state->X_fifo_1d and shadow_state->X_fifo_1d BFP structs
-    /* The updated state->shared_state->X_FIFO BFP structures are copied to an alternate set of BFP structs present in the 
-     * main and shadow filter state structure, that are used to efficiently access the X FIFO in the Error computation and filter
-     * update steps.
-     */
-    aec_update_X_fifo_1d(main_state);
-    aec_update_X_fifo_1d(shadow_state);
-
     // Calculate error spectrum and estimated mic spectrum for main and shadow adaptive filters
     /* For main filter, main_state->Error[ch] and main_state->Y_hat[ch] are updated.
      * For shadow filter, shadow_state->Error[ch] and shadow_state->Y_hat[ch] are updated. 
      */
     PAR_JOBS(
-        PJOB(calc_Error_task, (tdist.par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
-        PJOB(calc_Error_task, (tdist.par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels))
+        PJOB(calc_Error_task, (tdist->par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
+        PJOB(calc_Error_task, (tdist->par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels))
         );
     
     // Calculate time domain error and time domain estimated mic input from their spectrums calculated in the previous step.
@@ -139,15 +135,15 @@ void aec_process_frame_2threads(
      * done only for main filter.
      */
     PAR_JOBS(
-        PJOB(ifft_task, (tdist.par_3_tasks_and_channels[0], main_state, shadow_state, AEC_3_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
-        PJOB(ifft_task, (tdist.par_3_tasks_and_channels[1], main_state, shadow_state, AEC_3_TASKS_AND_CHANNELS_PASSES, num_y_channels))
+        PJOB(ifft_task, (tdist->par_3_tasks_and_channels[0], main_state, shadow_state, AEC_3_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
+        PJOB(ifft_task, (tdist->par_3_tasks_and_channels[1], main_state, shadow_state, AEC_3_TASKS_AND_CHANNELS_PASSES, num_y_channels))
         );
 
     // Calculate average coherence and average slow moving coherence between mic and estimated mic time domain signals
     // main_state->shared_state->coh_mu_state[ch].coh and main_state->shared_state->coh_mu_state[ch].coh_slow are updated
     PAR_JOBS(
-        PJOB(calc_coh_task, (tdist.par_1_tasks_and_channels[0], main_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
-        PJOB(calc_coh_task, (tdist.par_1_tasks_and_channels[1], main_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels))
+        PJOB(calc_coh_task, (tdist->par_1_tasks_and_channels[0], main_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
+        PJOB(calc_coh_task, (tdist->par_1_tasks_and_channels[1], main_state, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels))
         );
 
     // Calculate AEC filter time domain output. This is the output sent to downstream pipeline stages
@@ -156,8 +152,8 @@ void aec_process_frame_2threads(
      * which is needed for subsequent processing of the shadow filter even when output is not generated.
      */
     PAR_JOBS(
-        PJOB(calc_output_task, (tdist.par_2_tasks_and_channels[0], main_state, shadow_state, (int32_t*)output_main, (int32_t*)output_shadow, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
-        PJOB(calc_output_task, (tdist.par_2_tasks_and_channels[1], main_state, shadow_state, (int32_t*)output_main, (int32_t*)output_shadow, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels))
+        PJOB(calc_output_task, (tdist->par_2_tasks_and_channels[0], main_state, shadow_state, (int32_t*)output_main, (int32_t*)output_shadow, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
+        PJOB(calc_output_task, (tdist->par_2_tasks_and_channels[1], main_state, shadow_state, (int32_t*)output_main, (int32_t*)output_shadow, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels))
         );
 
     // Calculate exponential moving average of main_filter time domain error.
@@ -165,8 +161,8 @@ void aec_process_frame_2threads(
      * so not calling this function to calculate shadow filter error EMA energy.
      */
     PAR_JOBS(
-        PJOB(calc_time_domain_ema_energy_task, (tdist.par_1_tasks_and_channels[0], main_state, (int32_t*)output_main, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, ERROR_EMA)),
-        PJOB(calc_time_domain_ema_energy_task, (tdist.par_1_tasks_and_channels[1], main_state, (int32_t*)output_main, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, ERROR_EMA))
+        PJOB(calc_time_domain_ema_energy_task, (tdist->par_1_tasks_and_channels[0], main_state, (int32_t*)output_main, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, ERROR_EMA)),
+        PJOB(calc_time_domain_ema_energy_task, (tdist->par_1_tasks_and_channels[1], main_state, (int32_t*)output_main, AEC_1_TASKS_AND_CHANNELS_PASSES, num_y_channels, ERROR_EMA))
         );
 
     // Convert shadow and main filters error back to frequency domain since subsequent AEC functions will use the error spectrum.
@@ -174,8 +170,8 @@ void aec_process_frame_2threads(
      * main_state->Error[ch] and shadow_state->Error[ch] are updated.
      */
     PAR_JOBS(
-        PJOB(fft_task, (tdist.par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels, ERROR_FFT)),
-        PJOB(fft_task, (tdist.par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels, ERROR_FFT))
+        PJOB(fft_task, (tdist->par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels, ERROR_FFT)),
+        PJOB(fft_task, (tdist->par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_y_channels, ERROR_FFT))
             );
 
     // Calculate energies of mic input and error spectrum of main and shadow filters.
@@ -184,8 +180,8 @@ void aec_process_frame_2threads(
      * updated.
      */
     PAR_JOBS(
-        PJOB(calc_freq_domain_energy_task, (tdist.par_3_tasks_and_channels[0], main_state, shadow_state, AEC_3_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
-        PJOB(calc_freq_domain_energy_task, (tdist.par_3_tasks_and_channels[1], main_state, shadow_state, AEC_3_TASKS_AND_CHANNELS_PASSES, num_y_channels))
+        PJOB(calc_freq_domain_energy_task, (tdist->par_3_tasks_and_channels[0], main_state, shadow_state, AEC_3_TASKS_AND_CHANNELS_PASSES, num_y_channels)),
+        PJOB(calc_freq_domain_energy_task, (tdist->par_3_tasks_and_channels[1], main_state, shadow_state, AEC_3_TASKS_AND_CHANNELS_PASSES, num_y_channels))
         );
 
     // Compare and update filters. Calculate adaption step_size mu
@@ -207,8 +203,8 @@ void aec_process_frame_2threads(
      * main_state->inv_X_energy[ch] and shadow_state->inv_X_energy[ch] is updated.
      */
     PAR_JOBS(
-        PJOB(calc_normalisation_spectrum_task, (tdist.par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels)),
-        PJOB(calc_normalisation_spectrum_task, (tdist.par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels))
+        PJOB(calc_normalisation_spectrum_task, (tdist->par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels)),
+        PJOB(calc_normalisation_spectrum_task, (tdist->par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels))
         );
 
     //Adapt H_hat
@@ -217,18 +213,30 @@ void aec_process_frame_2threads(
         // T is a function of state->mu, state->Error and state->inv_X_energy.
         // main_state->T[ch] and shadow_state->T[ch] are updated.
         PAR_JOBS(
-            PJOB(calc_T_task, (tdist.par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels, ych)),
-            PJOB(calc_T_task, (tdist.par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels, ych))
+            PJOB(calc_T_task, (tdist->par_2_tasks_and_channels[0], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels, ych)),
+            PJOB(calc_T_task, (tdist->par_2_tasks_and_channels[1], main_state, shadow_state, AEC_2_TASKS_AND_CHANNELS_PASSES, num_x_channels, ych))
             );
 
         // Update filters
         // main_state->H_hat and shadow_state->H_hat are updated.
         PAR_JOBS(
-            PJOB(filter_adapt_task, (tdist.par_2_tasks[0], main_state, shadow_state, AEC_2_TASKS_PASSES, ych)),
-            PJOB(filter_adapt_task, (tdist.par_2_tasks[1], main_state, shadow_state, AEC_2_TASKS_PASSES, ych))
+            PJOB(filter_adapt_task, (tdist->par_2_tasks[0], main_state, shadow_state, AEC_2_TASKS_PASSES, ych)),
+            PJOB(filter_adapt_task, (tdist->par_2_tasks[1], main_state, shadow_state, AEC_2_TASKS_PASSES, ych))
             );
     }
-    framenum++; 
+}
+
+extern task_distribution_t tdist;
+static unsigned X_energy_recalc_bin = 0;
+void aec_process_frame_2threads(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE])
+{
+    aec_process_frame_2threads_r(&tdist, main_state, shadow_state, &X_energy_recalc_bin, output_main, output_shadow, y_data, x_data);
 }
 
 void calc_time_domain_ema_energy_task(par_tasks_and_channels_t* s, aec_state_t *state, int32_t *output, int passes, int channels, enum e_td_ema type) {
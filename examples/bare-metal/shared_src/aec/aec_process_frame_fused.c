@@ -0,0 +1,217 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "aec_process_frame_fused.h"
+
+#include "aec_defines.h"
+#include "aec_api.h"
+
+#ifdef __xcore__
+#include <xcore/hwtimer.h>
+#define FUSED_TIME() ((uint32_t)get_reference_time())
+#else
+#define FUSED_TIME() ((uint32_t)0)
+#endif
+
+/* This is a bare-metal example of processing one frame of data through the AEC pipeline stage on 2 threads, with as
+ * few PAR_JOBS fork/join barriers as the data dependencies allow.
+ *
+ * aec_process_frame_2threads() runs every AEC function in its own PAR_JOBS, which is 15 or more barriers a frame.
+ * Most of those functions only depend on earlier functions for the same channel and filter, so here every thread runs
+ * the whole sequence of functions for the channels and filters it owns and only synchronises where a function needs
+ * the output of another channel or filter:
+ *
+ * - AEC_FUSED_PAR_INPUT: one job per y channel (EMA energy, FFT) and one per x channel (EMA energy, FFT, main and
+ *   shadow X energy, X FIFO update). aec_calc_Error_and_Y_hat() needs the X FIFO of every x channel.
+ * - AEC_FUSED_PAR_ERROR: one job per y channel and filter, from the Error calculation to the error spectrum energy.
+ *   aec_compare_filters_and_calc_mu() needs both filters of every y channel.
+ * - AEC_FUSED_PAR_ADAPT: one job per x channel and filter, running the normalisation spectrum and then T and the
+ *   filter update of that x channel's phases with aec_filter_adapt_channel() for every y channel in turn. The update of
+ *   an x channel's phases only needs T for that x channel, so T being overwritten by the next y channel is never seen
+ *   by another thread.
+ *
+ * That is 3 barriers a frame for any number of channels. With an even number of x channels both threads get the same
+ * number of filter phases to update. With an odd number, one thread updates one more main filter x channel and the
+ * other one more shadow filter x channel. The AEC functions called, and the order they are called in for any
+ * one channel and filter, are the same as in aec_process_frame_2threads() so the output is identical. See there for a
+ * description of each step.
+ */
+
+/* Jobs are given to threads so that with an even number of channels every thread gets the same number of main and
+ * shadow filter jobs.
+ */
+#define OWNS_JOB(thread, ch, task) ((((ch) + (task)) % AEC_FUSED_THREADS) == (thread))
+
+#if X86_BUILD
+// There is no lib_xcore on x86 builds, so the jobs of a parallel region are run one after the other
+#define DECLARE_JOB(name, args)
+#define PJOB(func, args) func args
+#define PAR_JOBS(...) do { __VA_ARGS__; } while(0)
+#else
+#include <xcore/parallel.h>
+#endif
+DECLARE_JOB(fused_input_task, (aec_state_t*, aec_state_t*, unsigned, unsigned, uint32_t*));
+DECLARE_JOB(fused_error_task, (aec_state_t*, aec_state_t*, int32_t*, int32_t*, unsigned, uint32_t*));
+DECLARE_JOB(fused_adapt_task, (aec_state_t*, aec_state_t*, unsigned, uint32_t*));
+
+void fused_input_task(aec_state_t *main_state, aec_state_t *shadow_state, unsigned thread, unsigned recalc_bin, uint32_t *ticks)
+{
+    uint32_t start = FUSED_TIME();
+    aec_shared_state_t *shared_state = main_state->shared_state;
+    // y channel jobs are offset by one thread from x channel jobs, so that the cheaper y jobs fill in around the x jobs
+    for(int ch=0; ch<shared_state->num_x_channels; ch++) {
+        if(!OWNS_JOB(thread, ch, 0)) continue;
+        aec_calc_time_domain_ema_energy(&shared_state->x_ema_energy[ch], &shared_state->x[ch], AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE, AEC_FRAME_ADVANCE, &shared_state->config_params);
+        aec_forward_fft(&shared_state->X[ch], &shared_state->x[ch]);
+        aec_calc_X_fifo_energy(main_state, ch, recalc_bin);
+        if(shadow_state != NULL) {
+            aec_calc_X_fifo_energy(shadow_state, ch, recalc_bin);
+        }
+        aec_update_X_fifo_and_calc_sigmaXX(main_state, ch);
+    }
+    for(int ch=0; ch<shared_state->num_y_channels; ch++) {
+        if(!OWNS_JOB(thread, ch, 1)) continue;
+        aec_calc_time_domain_ema_energy(&shared_state->y_ema_energy[ch], &shared_state->y[ch], AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE, AEC_FRAME_ADVANCE, &shared_state->config_params);
+        aec_forward_fft(&shared_state->Y[ch], &shared_state->y[ch]);
+    }
+    *ticks += FUSED_TIME() - start;
+}
+
+void fused_error_task(aec_state_t *main_state, aec_state_t *shadow_state, int32_t *output_main, int32_t *output_shadow, unsigned thread, uint32_t *ticks)
+{
+    uint32_t start = FUSED_TIME();
+    int32_t (*out_main)[AEC_FRAME_ADVANCE] = (int32_t(*)[AEC_FRAME_ADVANCE])output_main;
+    int32_t (*out_shadow)[AEC_FRAME_ADVANCE] = (int32_t(*)[AEC_FRAME_ADVANCE])output_shadow;
+    for(int ch=0; ch<main_state->shared_state->num_y_channels; ch++) {
+        if(OWNS_JOB(thread, ch, 0)) {
+            aec_calc_Error_and_Y_hat(main_state, ch);
+            aec_inverse_fft(&main_state->error[ch], &main_state->Error[ch]);
+            aec_inverse_fft(&main_state->y_hat[ch], &main_state->Y_hat[ch]);
+            aec_calc_coherence(main_state, ch);
+            aec_calc_output(main_state, &out_main[ch], ch);
+
+            bfp_s32_t temp;
+            bfp_s32_init(&temp, &out_main[ch][0], -31, AEC_FRAME_ADVANCE, 1);
+            aec_calc_time_domain_ema_energy(&main_state->error_ema_energy[ch], &temp, 0, AEC_FRAME_ADVANCE, &main_state->shared_state->config_params);
+
+            aec_forward_fft(&main_state->Error[ch], &main_state->error[ch]);
+            aec_calc_freq_domain_energy(&main_state->overall_Error[ch], &main_state->Error[ch]);
+            aec_calc_freq_domain_energy(&main_state->shared_state->overall_Y[ch], &main_state->shared_state->Y[ch]);
+        }
+        if((shadow_state != NULL) && OWNS_JOB(thread, ch, 1)) {
+            aec_calc_Error_and_Y_hat(shadow_state, ch);
+            aec_inverse_fft(&shadow_state->error[ch], &shadow_state->Error[ch]);
+            aec_calc_output(shadow_state, (out_shadow != NULL) ? &out_shadow[ch] : NULL, ch);
+            aec_forward_fft(&shadow_state->Error[ch], &shadow_state->error[ch]);
+            aec_calc_freq_domain_energy(&shadow_state->overall_Error[ch], &shadow_state->Error[ch]);
+        }
+    }
+    *ticks += FUSED_TIME() - start;
+}
+
+void fused_adapt_task(aec_state_t *main_state, aec_state_t *shadow_state, unsigned thread, uint32_t *ticks)
+{
+    uint32_t start = FUSED_TIME();
+    aec_shared_state_t *shared_state = main_state->shared_state;
+    for(int xch=0; xch<shared_state->num_x_channels; xch++) {
+        if(OWNS_JOB(thread, xch, 0)) {
+            aec_calc_normalisation_spectrum(main_state, xch, 0);
+            for(int ych=0; ych<shared_state->num_y_channels; ych++) {
+                aec_calc_T(main_state, ych, xch);
+                aec_filter_adapt_channel(main_state, ych, xch);
+            }
+        }
+        if((shadow_state != NULL) && OWNS_JOB(thread, xch, 1)) {
+            aec_calc_normalisation_spectrum(shadow_state, xch, 1);
+            for(int ych=0; ych<shared_state->num_y_channels; ych++) {
+                aec_calc_T(shadow_state, ych, xch);
+                aec_filter_adapt_channel(shadow_state, ych, xch);
+            }
+        }
+    }
+    *ticks += FUSED_TIME() - start;
+}
+
+void aec_process_frame_fused_r(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE],
+        aec_fused_timing_t *timing)
+{
+    aec_fused_timing_t local_timing;
+    if(timing == NULL) {
+        timing = &local_timing;
+    }
+    memset(timing, 0, sizeof(aec_fused_timing_t));
+    uint32_t (*thread_ticks)[AEC_FUSED_THREADS] = timing->thread_ticks;
+
+    uint32_t t0 = FUSED_TIME();
+    aec_frame_init(main_state, shadow_state, y_data, x_data);
+    uint32_t t1 = FUSED_TIME();
+    timing->serial_ticks = t1 - t0;
+
+    PAR_JOBS(
+        PJOB(fused_input_task, (main_state, shadow_state, 0, *X_energy_recalc_bin, &thread_ticks[AEC_FUSED_PAR_INPUT][0])),
+        PJOB(fused_input_task, (main_state, shadow_state, 1, *X_energy_recalc_bin, &thread_ticks[AEC_FUSED_PAR_INPUT][1]))
+        );
+    t0 = FUSED_TIME();
+    timing->par_ticks[AEC_FUSED_PAR_INPUT] = t0 - t1;
+    timing->num_par++;
+
+    *X_energy_recalc_bin += 1;
+    if(*X_energy_recalc_bin == (AEC_PROC_FRAME_LENGTH/2) + 1) {
+        *X_energy_recalc_bin = 0;
+    }
+
+    t1 = FUSED_TIME();
+    PAR_JOBS(
+        PJOB(fused_error_task, (main_state, shadow_state, (int32_t*)output_main, (int32_t*)output_shadow, 0, &thread_ticks[AEC_FUSED_PAR_ERROR][0])),
+        PJOB(fused_error_task, (main_state, shadow_state, (int32_t*)output_main, (int32_t*)output_shadow, 1, &thread_ticks[AEC_FUSED_PAR_ERROR][1]))
+        );
+    t0 = FUSED_TIME();
+    timing->par_ticks[AEC_FUSED_PAR_ERROR] = t0 - t1;
+    timing->num_par++;
+
+    aec_compare_filters_and_calc_mu(
+            main_state,
+            shadow_state);
+    t1 = FUSED_TIME();
+    timing->serial_ticks += t1 - t0;
+
+    PAR_JOBS(
+        PJOB(fused_adapt_task, (main_state, shadow_state, 0, &thread_ticks[AEC_FUSED_PAR_ADAPT][0])),
+        PJOB(fused_adapt_task, (main_state, shadow_state, 1, &thread_ticks[AEC_FUSED_PAR_ADAPT][1]))
+        );
+    t0 = FUSED_TIME();
+    timing->par_ticks[AEC_FUSED_PAR_ADAPT] = t0 - t1;
+    timing->num_par++;
+}
+
+uint32_t aec_fused_sync_ticks(const aec_fused_timing_t *timing, aec_fused_par_e par)
+{
+    uint32_t busy = 0;
+    for(int t=0; t<AEC_FUSED_THREADS; t++) {
+        if(timing->thread_ticks[par][t] > busy) {
+            busy = timing->thread_ticks[par][t];
+        }
+    }
+    return timing->par_ticks[par] - busy;
+}
+
+static unsigned X_energy_recalc_bin = 0;
+void aec_process_frame_fused(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE])
+{
+    aec_process_frame_fused_r(main_state, shadow_state, &X_energy_recalc_bin, output_main, output_shadow, y_data, x_data, NULL);
+}
@@ -0,0 +1,61 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef AEC_PROCESS_FRAME_FUSED_H
+#define AEC_PROCESS_FRAME_FUSED_H
+
+#include <stdint.h>
+#include "aec_defines.h"
+#include "aec_state.h"
+
+/** Number of threads aec_process_frame_fused_r() runs on*/
+#define AEC_FUSED_THREADS (2)
+
+/** The parallel regions of aec_process_frame_fused_r(), in the order they are run*/
+typedef enum {
+    AEC_FUSED_PAR_INPUT,    ///< Input EMA, input FFTs, X energy and X FIFO update
+    AEC_FUSED_PAR_ERROR,    ///< Error, output and error spectrum energy calculation
+    AEC_FUSED_PAR_ADAPT,    ///< Normalisation spectrum, T and filter adaption for all y channels
+    AEC_FUSED_NUM_PAR,
+}aec_fused_par_e;
+
+/** Per frame timing breakdown of aec_process_frame_fused_r(), in reference clock ticks.
+ * The synchronisation overhead of a parallel region is par_ticks minus the largest of its thread_ticks, and is
+ * returned by aec_fused_sync_ticks(). Ticks are always 0 on non xcore builds.
+ */
+typedef struct {
+    /** Time from starting the jobs of each parallel region until all of them have joined*/
+    uint32_t par_ticks[AEC_FUSED_NUM_PAR];
+    /** Time each thread spends running its jobs in each parallel region*/
+    uint32_t thread_ticks[AEC_FUSED_NUM_PAR][AEC_FUSED_THREADS];
+    /** Time spent in aec_frame_init() and aec_compare_filters_and_calc_mu(), which are run on the calling thread*/
+    uint32_t serial_ticks;
+    /** Number of parallel regions run in the frame, which is AEC_FUSED_NUM_PAR for any number of channels*/
+    unsigned num_par;
+}aec_fused_timing_t;
+
+/* Process one frame through the AEC with the same output as aec_process_frame_2threads_r(), using
+ * AEC_FUSED_NUM_PAR parallel regions instead of one per AEC function. timing can be NULL if the timing breakdown is not needed.
+ */
+void aec_process_frame_fused_r(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE],
+        aec_fused_timing_t *timing);
+
+/* Non reentrant version of aec_process_frame_fused_r(), without the timing breakdown. */
+void aec_process_frame_fused(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
+
+/* Synchronisation overhead of a parallel region in the last frame timed, in reference clock ticks. */
+uint32_t aec_fused_sync_ticks(const aec_fused_timing_t *timing, aec_fused_par_e par);
+
+#endif
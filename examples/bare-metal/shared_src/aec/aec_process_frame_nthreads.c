@@ -0,0 +1,220 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "aec_scheduler.h"
+
+#include "aec_defines.h"
+#include "aec_api.h"
+
+/* This is a bare-metal example of processing one frame of data through the AEC pipeline stage, with the AEC functions
+ * distributed across any number of threads at runtime by the work stealing scheduler in aec_scheduler.h.
+ * The processing steps are the same as in aec_process_frame_2threads(), see there for a description of each step.
+ * Every step is a stage made up of (task, channel) jobs. Jobs are only queued for the channels the AEC is configured
+ * for and, when there is no shadow filter, only for the main filter, so the work is balanced across threads for any
+ * thread count and channel count.
+ */
+enum e_stage {
+    STAGE_TD_INPUT_EMA,   // task 0: y, task 1: x
+    STAGE_INPUT_FFT,      // task 0: y, task 1: x
+    STAGE_X_ENERGY,       // task 0: main, task 1: shadow
+    STAGE_X_FIFO,
+    STAGE_ERROR,          // task 0: main, task 1: shadow
+    STAGE_IFFT,           // task 0: main error, task 1: main y_hat, task 2: shadow error
+    STAGE_COHERENCE,
+    STAGE_OUTPUT,         // task 0: main, task 1: shadow
+    STAGE_TD_ERROR_EMA,
+    STAGE_ERROR_FFT,      // task 0: main, task 1: shadow
+    STAGE_FD_ENERGY,      // task 0: main error, task 1: y, task 2: shadow error
+    STAGE_NORM_SPECTRUM,  // task 0: main, task 1: shadow
+    STAGE_CALC_T,         // task 0: main, task 1: shadow
+    STAGE_FILTER_ADAPT,   // task 0: main, task 1: shadow, channel: y channel
+};
+
+typedef struct {
+    aec_state_t *main_state;
+    aec_state_t *shadow_state;
+    int32_t (*output_main)[AEC_FRAME_ADVANCE];
+    int32_t (*output_shadow)[AEC_FRAME_ADVANCE];
+    unsigned X_energy_recalc_bin;
+    unsigned ych;
+}nthreads_ctx_t;
+
+void aec_sched_run_job(void *ctx, const aec_job_t *job)
+{
+    nthreads_ctx_t *c = (nthreads_ctx_t*)ctx;
+    aec_state_t *main_state = c->main_state;
+    aec_state_t *shadow_state = c->shadow_state;
+    aec_state_t *state = (job->task == 0) ? main_state : shadow_state;
+    aec_shared_state_t *shared_state = main_state->shared_state;
+    unsigned ch = job->channel;
+    switch(job->stage) {
+        case STAGE_TD_INPUT_EMA:
+            if(job->task == 0) {
+                aec_calc_time_domain_ema_energy(&shared_state->y_ema_energy[ch], &shared_state->y[ch], AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE, AEC_FRAME_ADVANCE, &shared_state->config_params);
+            }
+            else {
+                aec_calc_time_domain_ema_energy(&shared_state->x_ema_energy[ch], &shared_state->x[ch], AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE, AEC_FRAME_ADVANCE, &shared_state->config_params);
+            }
+            break;
+        case STAGE_INPUT_FFT:
+            if(job->task == 0) {
+                aec_forward_fft(&shared_state->Y[ch], &shared_state->y[ch]);
+            }
+            else {
+                aec_forward_fft(&shared_state->X[ch], &shared_state->x[ch]);
+            }
+            break;
+        case STAGE_X_ENERGY:
+            aec_calc_X_fifo_energy(state, ch, c->X_energy_recalc_bin);
+            break;
+        case STAGE_X_FIFO:
+            aec_update_X_fifo_and_calc_sigmaXX(main_state, ch);
+            break;
+        case STAGE_ERROR:
+            aec_calc_Error_and_Y_hat(state, ch);
+            break;
+        case STAGE_IFFT:
+            if(job->task == 0) {
+                aec_inverse_fft(&main_state->error[ch], &main_state->Error[ch]);
+            }
+            else if(job->task == 1) {
+                aec_inverse_fft(&main_state->y_hat[ch], &main_state->Y_hat[ch]);
+            }
+            else {
+                aec_inverse_fft(&shadow_state->error[ch], &shadow_state->Error[ch]);
+            }
+            break;
+        case STAGE_COHERENCE:
+            aec_calc_coherence(main_state, ch);
+            break;
+        case STAGE_OUTPUT:
+            if(job->task == 0) {
+                aec_calc_output(main_state, &c->output_main[ch], ch);
+            }
+            else {
+                aec_calc_output(shadow_state, (c->output_shadow != NULL) ? &c->output_shadow[ch] : NULL, ch);
+            }
+            break;
+        case STAGE_TD_ERROR_EMA:
+            {
+                bfp_s32_t temp;
+                bfp_s32_init(&temp, &c->output_main[ch][0], -31, AEC_FRAME_ADVANCE, 1);
+                aec_calc_time_domain_ema_energy(&main_state->error_ema_energy[ch], &temp, 0, AEC_FRAME_ADVANCE, &shared_state->config_params);
+            }
+            break;
+        case STAGE_ERROR_FFT:
+            aec_forward_fft(&state->Error[ch], &state->error[ch]);
+            break;
+        case STAGE_FD_ENERGY:
+            if(job->task == 0) {
+                aec_calc_freq_domain_energy(&main_state->overall_Error[ch], &main_state->Error[ch]);
+            }
+            else if(job->task == 1) {
+                aec_calc_freq_domain_energy(&shared_state->overall_Y[ch], &shared_state->Y[ch]);
+            }
+            else {
+                aec_calc_freq_domain_energy(&shadow_state->overall_Error[ch], &shadow_state->Error[ch]);
+            }
+            break;
+        case STAGE_NORM_SPECTRUM:
+            aec_calc_normalisation_spectrum(state, ch, (job->task == 1));
+            break;
+        case STAGE_CALC_T:
+            aec_calc_T(state, c->ych, ch);
+            break;
+        case STAGE_FILTER_ADAPT:
+            aec_filter_adapt(state, ch);
+            break;
+        default:
+            assert(0);
+            break;
+    }
+}
+
+/* Queue a job for every channel and task of a stage and run them. Tasks from num_main_tasks onwards are for the shadow
+ * filter and are left out when there isn't one.
+ */
+static void run_stage(aec_sched_t *sched, nthreads_ctx_t *ctx, enum e_stage stage, unsigned num_tasks, unsigned num_main_tasks, unsigned num_channels)
+{
+    if(ctx->shadow_state == NULL) {
+        num_tasks = num_main_tasks;
+    }
+    for(unsigned ch=0; ch<num_channels; ch++) {
+        for(unsigned task=0; task<num_tasks; task++) {
+            aec_sched_push(sched, stage, task, ch);
+        }
+    }
+    aec_sched_run(sched, ctx);
+}
+
+/* Process one frame with the AEC functions spread across the threads of sched, which is set up with aec_sched_init().
+ * Otherwise the same as aec_process_frame_2threads_r(). Output is bit identical to aec_process_frame_1thread_r() for
+ * any thread count.
+ */
+void aec_process_frame_nthreads_r(
+        aec_sched_t *sched,
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE])
+{
+    unsigned num_y_channels = main_state->shared_state->num_y_channels;
+    unsigned num_x_channels = main_state->shared_state->num_x_channels;
+    unsigned num_channels = (num_y_channels > num_x_channels) ? num_y_channels : num_x_channels;
+
+    nthreads_ctx_t ctx;
+    ctx.main_state = main_state;
+    ctx.shadow_state = shadow_state;
+    ctx.output_main = output_main;
+    ctx.output_shadow = output_shadow;
+    ctx.X_energy_recalc_bin = *X_energy_recalc_bin;
+    ctx.ych = 0;
+
+    aec_frame_init(main_state, shadow_state, y_data, x_data);
+
+    //y and x input stages have jobs for both, so queue them by hand for when there are more of one than the other
+    for(unsigned ch=0; ch<num_channels; ch++) {
+        if(ch < num_y_channels) aec_sched_push(sched, STAGE_TD_INPUT_EMA, 0, ch);
+        if(ch < num_x_channels) aec_sched_push(sched, STAGE_TD_INPUT_EMA, 1, ch);
+    }
+    aec_sched_run(sched, &ctx);
+    for(unsigned ch=0; ch<num_channels; ch++) {
+        if(ch < num_y_channels) aec_sched_push(sched, STAGE_INPUT_FFT, 0, ch);
+        if(ch < num_x_channels) aec_sched_push(sched, STAGE_INPUT_FFT, 1, ch);
+    }
+    aec_sched_run(sched, &ctx);
+
+    run_stage(sched, &ctx, STAGE_X_ENERGY, 2, 1, num_x_channels);
+    *X_energy_recalc_bin += 1;
+    if(*X_energy_recalc_bin == (AEC_PROC_FRAME_LENGTH/2) + 1) {
+        *X_energy_recalc_bin = 0;
+    }
+
+    run_stage(sched, &ctx, STAGE_X_FIFO, 1, 1, num_x_channels);
+    run_stage(sched, &ctx, STAGE_ERROR, 2, 1, num_y_channels);
+    run_stage(sched, &ctx, STAGE_IFFT, 3, 2, num_y_channels);
+    run_stage(sched, &ctx, STAGE_COHERENCE, 1, 1, num_y_channels);
+    run_stage(sched, &ctx, STAGE_OUTPUT, 2, 1, num_y_channels);
+    run_stage(sched, &ctx, STAGE_TD_ERROR_EMA, 1, 1, num_y_channels);
+    run_stage(sched, &ctx, STAGE_ERROR_FFT, 2, 1, num_y_channels);
+    run_stage(sched, &ctx, STAGE_FD_ENERGY, 3, 2, num_y_channels);
+
+    aec_compare_filters_and_calc_mu(main_state, shadow_state);
+
+    run_stage(sched, &ctx, STAGE_NORM_SPECTRUM, 2, 1, num_x_channels);
+    for(unsigned ych=0; ych<num_y_channels; ych++) {
+        ctx.ych = ych;
+        run_stage(sched, &ctx, STAGE_CALC_T, 2, 1, num_x_channels);
+        //aec_filter_adapt() adapts the filter for a y channel across all x channels, so there is one job per filter
+        aec_sched_push(sched, STAGE_FILTER_ADAPT, 0, ych);
+        if(shadow_state != NULL) {
+            aec_sched_push(sched, STAGE_FILTER_ADAPT, 1, ych);
+        }
+        aec_sched_run(sched, &ctx);
+    }
+}
@@ -0,0 +1,199 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "aec_scheduler.h"
+
+#if X86_BUILD
+#define SCHED_LOCK(s) pthread_mutex_lock(&(s)->lock)
+#define SCHED_UNLOCK(s) pthread_mutex_unlock(&(s)->lock)
+#else
+#include <xcore/parallel.h>
+#define SCHED_LOCK(s) lock_acquire((s)->lock)
+#define SCHED_UNLOCK(s) lock_release((s)->lock)
+#endif
+
+/* Take the next job for thread id, from the back of its own deque or else the front of another thread's deque.
+ * Returns 0 once all deques are empty. No jobs are pushed while a stage runs, so that means the stage is done as far
+ * as this thread is concerned.
+ */
+static int get_job(aec_sched_t *sched, unsigned id, aec_job_t *job)
+{
+    //Jobs take tens of microseconds so a single lock for all deques is not a bottleneck, and it means only one
+    //hardware lock is used on xcore
+    SCHED_LOCK(sched);
+    aec_job_deque_t *own = &sched->deque[id];
+    if(own->back > own->front) {
+        own->back--;
+        *job = own->jobs[own->back];
+        SCHED_UNLOCK(sched);
+        return 1;
+    }
+    //Steal from the next thread along first, so that idle threads spread out over the busy ones
+    for(unsigned i=1; i<sched->num_threads; i++) {
+        aec_job_deque_t *victim = &sched->deque[(id + i) % sched->num_threads];
+        if(victim->back > victim->front) {
+            *job = victim->jobs[victim->front];
+            victim->front++;
+            sched->jobs_stolen[id]++;
+            SCHED_UNLOCK(sched);
+            return 1;
+        }
+    }
+    SCHED_UNLOCK(sched);
+    return 0;
+}
+
+static void sched_worker(aec_sched_t *sched, unsigned id)
+{
+    aec_job_t job;
+    while(get_job(sched, id, &job)) {
+        aec_sched_run_job(sched->ctx, &job);
+        sched->jobs_run[id]++;
+    }
+}
+
+#if X86_BUILD
+static void *pool_worker(void *arg)
+{
+    aec_sched_t *sched = ((aec_sched_worker_args_t*)arg)->sched;
+    unsigned id = ((aec_sched_worker_args_t*)arg)->id;
+    unsigned stages_done = 0;
+    pthread_mutex_lock(&sched->lock);
+    while(1) {
+        while((sched->stage_count == stages_done) && !sched->shutdown) {
+            pthread_cond_wait(&sched->start_cond, &sched->lock);
+        }
+        if(sched->shutdown) {
+            break;
+        }
+        stages_done = sched->stage_count;
+        pthread_mutex_unlock(&sched->lock);
+
+        sched_worker(sched, id);
+
+        pthread_mutex_lock(&sched->lock);
+        sched->workers_busy--;
+        if(sched->workers_busy == 0) {
+            pthread_cond_signal(&sched->done_cond);
+        }
+    }
+    pthread_mutex_unlock(&sched->lock);
+    return NULL;
+}
+#else
+DECLARE_JOB(sched_worker, (aec_sched_t*, unsigned));
+#endif
+
+int aec_sched_init(aec_sched_t *sched, unsigned num_threads)
+{
+    if((num_threads == 0) || (num_threads > AEC_SCHED_MAX_THREADS)) {
+        return -1;
+    }
+    memset(sched, 0, sizeof(aec_sched_t));
+    sched->num_threads = num_threads;
+#if X86_BUILD
+    pthread_mutex_init(&sched->lock, NULL);
+    pthread_cond_init(&sched->start_cond, NULL);
+    pthread_cond_init(&sched->done_cond, NULL);
+    //Thread 0 is the thread calling aec_sched_run()
+    for(unsigned id=1; id<num_threads; id++) {
+        sched->worker_args[id].sched = sched;
+        sched->worker_args[id].id = id;
+        if(pthread_create(&sched->workers[id], NULL, pool_worker, &sched->worker_args[id]) != 0) {
+            sched->num_threads = id;
+            aec_sched_deinit(sched);
+            return -1;
+        }
+    }
+#else
+    sched->lock = lock_alloc();
+    if(sched->lock == 0) {
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+void aec_sched_deinit(aec_sched_t *sched)
+{
+#if X86_BUILD
+    pthread_mutex_lock(&sched->lock);
+    sched->shutdown = 1;
+    pthread_cond_broadcast(&sched->start_cond);
+    pthread_mutex_unlock(&sched->lock);
+    for(unsigned id=1; id<sched->num_threads; id++) {
+        pthread_join(sched->workers[id], NULL);
+    }
+    pthread_cond_destroy(&sched->done_cond);
+    pthread_cond_destroy(&sched->start_cond);
+    pthread_mutex_destroy(&sched->lock);
+#else
+    lock_free(sched->lock);
+#endif
+}
+
+void aec_sched_push(aec_sched_t *sched, unsigned stage, unsigned task, unsigned channel)
+{
+    aec_job_deque_t *deque = &sched->deque[sched->next_thread];
+    assert(deque->back < AEC_SCHED_MAX_JOBS);
+    deque->jobs[deque->back].stage = stage;
+    deque->jobs[deque->back].task = task;
+    deque->jobs[deque->back].channel = channel;
+    deque->back++;
+    sched->next_thread = (sched->next_thread + 1) % sched->num_threads;
+}
+
+void aec_sched_run(aec_sched_t *sched, void *ctx)
+{
+    sched->ctx = ctx;
+#if X86_BUILD
+    pthread_mutex_lock(&sched->lock);
+    sched->workers_busy = sched->num_threads - 1;
+    sched->stage_count++;
+    pthread_cond_broadcast(&sched->start_cond);
+    pthread_mutex_unlock(&sched->lock);
+
+    sched_worker(sched, 0);
+
+    pthread_mutex_lock(&sched->lock);
+    while(sched->workers_busy != 0) {
+        pthread_cond_wait(&sched->done_cond, &sched->lock);
+    }
+    pthread_mutex_unlock(&sched->lock);
+#else
+    switch(sched->num_threads) {
+        case 1:
+            sched_worker(sched, 0);
+            break;
+        case 2:
+            PAR_JOBS(
+                PJOB(sched_worker, (sched, 0)),
+                PJOB(sched_worker, (sched, 1))
+                );
+            break;
+        case 3:
+            PAR_JOBS(
+                PJOB(sched_worker, (sched, 0)),
+                PJOB(sched_worker, (sched, 1)),
+                PJOB(sched_worker, (sched, 2))
+                );
+            break;
+        default:
+            PAR_JOBS(
+                PJOB(sched_worker, (sched, 0)),
+                PJOB(sched_worker, (sched, 1)),
+                PJOB(sched_worker, (sched, 2)),
+                PJOB(sched_worker, (sched, 3))
+                );
+            break;
+    }
+#endif
+    //All deques are empty now, start the next stage's jobs from thread 0 again
+    for(unsigned id=0; id<sched->num_threads; id++) {
+        sched->deque[id].front = 0;
+        sched->deque[id].back = 0;
+    }
+    sched->next_thread = 0;
+}
@@ -0,0 +1,103 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef AEC_SCHEDULER_H
+#define AEC_SCHEDULER_H
+
+#include <stdint.h>
+#include "aec_defines.h"
+
+#if X86_BUILD
+#include <pthread.h>
+#else
+#include <xcore/lock.h>
+#endif
+
+/* Runtime scheduler for running the AEC (task, channel) jobs of a processing stage across a number of threads.
+ *
+ * This replaces the offline generated task distribution tables in aec_task_distribution.c, which are fixed to the
+ * thread count and channel count they were generated for. Jobs for a stage are pushed to per-thread deques round
+ * robin, only for the (task, channel) pairs that actually need running. Every thread then runs the jobs from the back
+ * of its own deque and, once that is empty, steals jobs from the front of the other threads' deques. So threads that
+ * are given cheaper jobs, or fewer of them because a channel or the shadow filter is not in use, pick up work from
+ * the others instead of idling until the end of the stage.
+ *
+ * On x86 builds the worker threads are a pthread pool created in aec_sched_init(). On xcore, the workers are run
+ * with PAR_JOBS for every stage, like in aec_process_frame_2threads().
+ */
+
+/** Maximum number of threads a scheduler can run jobs on*/
+#define AEC_SCHED_MAX_THREADS (4)
+
+/** Maximum number of jobs in a stage. The widest stages have 3 tasks for each channel*/
+#define AEC_SCHED_MAX_JOBS (3 * ((AEC_LIB_MAX_Y_CHANNELS > AEC_LIB_MAX_X_CHANNELS) ? AEC_LIB_MAX_Y_CHANNELS : AEC_LIB_MAX_X_CHANNELS))
+
+/** One (task, channel) job of a processing stage*/
+typedef struct {
+    uint8_t stage;
+    uint8_t task;
+    uint8_t channel;
+}aec_job_t;
+
+/** Jobs queued for one thread. The owner takes jobs from the back, other threads steal from the front*/
+typedef struct {
+    aec_job_t jobs[AEC_SCHED_MAX_JOBS];
+    int front;
+    int back;
+}aec_job_deque_t;
+
+#if X86_BUILD
+typedef struct {
+    void *sched;
+    unsigned id;
+}aec_sched_worker_args_t;
+#endif
+
+typedef struct {
+    unsigned num_threads;
+    aec_job_deque_t deque[AEC_SCHED_MAX_THREADS];
+    /** Thread that the next pushed job is queued for*/
+    unsigned next_thread;
+    /** Passed to aec_sched_run_job() with every job*/
+    void *ctx;
+    /** Number of jobs each thread has run and how many of those it stole, since aec_sched_init()*/
+    unsigned jobs_run[AEC_SCHED_MAX_THREADS];
+    unsigned jobs_stolen[AEC_SCHED_MAX_THREADS];
+#if X86_BUILD
+    /** Arguments passed to the pool worker threads*/
+    aec_sched_worker_args_t worker_args[AEC_SCHED_MAX_THREADS];
+    pthread_mutex_t lock;
+    pthread_cond_t start_cond;
+    pthread_cond_t done_cond;
+    pthread_t workers[AEC_SCHED_MAX_THREADS];
+    /** Incremented for every stage run, so that the pool workers know there is a new stage to work on*/
+    unsigned stage_count;
+    /** Number of pool workers still running jobs of the current stage*/
+    unsigned workers_busy;
+    int shutdown;
+#else
+    lock_t lock;
+#endif
+}aec_sched_t;
+
+/* Initialise a scheduler for num_threads threads, 1 to AEC_SCHED_MAX_THREADS. Returns 0 on success and -1 if
+ * num_threads is not supported or the threads or lock could not be allocated.
+ */
+int aec_sched_init(aec_sched_t *sched, unsigned num_threads);
+
+/* Stop the worker threads and free the lock. */
+void aec_sched_deinit(aec_sched_t *sched);
+
+/* Queue a job for the next aec_sched_run() call. */
+void aec_sched_push(aec_sched_t *sched, unsigned stage, unsigned task, unsigned channel);
+
+/* Run all queued jobs across the scheduler's threads by calling aec_sched_run_job() for each of them, returning once
+ * they have all completed. The calling thread works on the jobs too.
+ */
+void aec_sched_run(aec_sched_t *sched, void *ctx);
+
+/* Implemented by the user of the scheduler. Called from the worker threads to run one job. A direct call is used
+ * instead of a function pointer so that the stack size of the xcore workers can be worked out at build time.
+ */
+void aec_sched_run_job(void *ctx, const aec_job_t *job);
+
+#endif
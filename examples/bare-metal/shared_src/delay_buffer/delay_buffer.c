@@ -2,30 +2,101 @@
 #include <string.h>
 #include "delay_buffer.h"
 
-void delay_buffer_init(delay_buf_state_t *state, int default_delay_samples) {
-    memset(state->delay_buffer, 0, sizeof(state->delay_buffer));
-    memset(&state->curr_idx[0], 0, sizeof(state->curr_idx));
-    state->delay_samples = default_delay_samples;
+int delay_buffer_init(delay_buf_state_t *state, int32_t *memory, int32_t num_channels, int32_t buffer_length,
+        int32_t frame_length, int32_t default_delay_samples) {
+    if((num_channels <= 0) || (num_channels > MAX_DELAY_BUF_CHANNELS) || (frame_length <= 0) ||
+            (buffer_length < (2 * frame_length)) || ((buffer_length % frame_length) != 0)) {
+        return -1;
+    }
+    memset(state, 0, sizeof(delay_buf_state_t));
+    memset(memory, 0, num_channels * buffer_length * sizeof(int32_t));
+    for(int ch=0; ch<num_channels; ch++) {
+        state->delay_buffer[ch] = &memory[ch * buffer_length];
+    }
+    state->buffer_length = buffer_length;
+    state->frame_length = frame_length;
+    update_delay_samples(state, default_delay_samples);
+    state->prev_delay_samples = state->delay_samples;
+    return 0;
+}
 
+int32_t delay_buffer_max_delay_samples(const delay_buf_state_t *delay_state) {
+    return delay_state->buffer_length - delay_state->frame_length;
 }
 
-void get_delayed_sample(delay_buf_state_t *delay_state, int32_t *sample, int32_t ch) {
-    delay_state->delay_buffer[ch][delay_state->curr_idx[ch]] = *sample;
+void get_delayed_block(delay_buf_state_t *delay_state, int32_t *frame, int32_t ch) {
+    int32_t *buffer = delay_state->delay_buffer[ch];
+    int32_t length = delay_state->buffer_length;
+    int32_t frame_length = delay_state->frame_length;
+    int32_t curr_idx = delay_state->curr_idx[ch];
+
+    // curr_idx is always at a frame boundary, so the new frame never wraps around the end of the buffer
+    memcpy(&buffer[curr_idx], frame, frame_length * sizeof(int32_t));
+
+    // Send back the samples with the correct delay. These may include some of the frame just stored
     int32_t abs_delay_samples = (delay_state->delay_samples < 0) ? -delay_state->delay_samples : delay_state->delay_samples;
-    // Send back the samples with the correct delay
-    uint32_t delay_idx = (
-            (DELAY_BUF_MAX_DELAY_SAMPLES + delay_state->curr_idx[ch] - abs_delay_samples)
-            % DELAY_BUF_MAX_DELAY_SAMPLES
-            );
-    *sample = delay_state->delay_buffer[ch][delay_idx];
-    delay_state->curr_idx[ch] = (delay_state->curr_idx[ch] + 1) % DELAY_BUF_MAX_DELAY_SAMPLES;
+    int32_t delay_idx = curr_idx - abs_delay_samples;
+    if(delay_idx < 0) {
+        delay_idx += length;
+    }
+    int32_t first = length - delay_idx;
+    if(first >= frame_length) {
+        memcpy(frame, &buffer[delay_idx], frame_length * sizeof(int32_t));
+    }
+    else {
+        memcpy(frame, &buffer[delay_idx], first * sizeof(int32_t));
+        memcpy(&frame[first], &buffer[0], (frame_length - first) * sizeof(int32_t));
+    }
+
+    // Linear crossfade from the samples at the previous delay
+    int32_t pos = delay_state->crossfade_pos[ch];
+    if(pos < delay_state->crossfade_length) {
+        int32_t abs_prev_delay = (delay_state->prev_delay_samples < 0) ? -delay_state->prev_delay_samples : delay_state->prev_delay_samples;
+        int32_t prev_idx = curr_idx - abs_prev_delay;
+        if(prev_idx < 0) {
+            prev_idx += length;
+        }
+        for(int i=0; (i<frame_length) && (pos<delay_state->crossfade_length); i++, pos++) {
+            int64_t prev = buffer[prev_idx];
+            frame[i] = (int32_t)(prev + ((((int64_t)frame[i] - prev) * pos) / delay_state->crossfade_length));
+            prev_idx = (prev_idx + 1 == length) ? 0 : prev_idx + 1;
+        }
+        delay_state->crossfade_pos[ch] = pos;
+    }
+
+    curr_idx += frame_length;
+    delay_state->curr_idx[ch] = (curr_idx == length) ? 0 : curr_idx;
+}
+
+void delay_buffer_set_crossfade(delay_buf_state_t *delay_state, int32_t crossfade_frames) {
+    delay_state->crossfade_length = crossfade_frames * delay_state->frame_length;
+    for(int ch=0; ch<MAX_DELAY_BUF_CHANNELS; ch++) {
+        delay_state->crossfade_pos[ch] = delay_state->crossfade_length;
+    }
 }
 
-void update_delay_samples(delay_buf_state_t *delay_state, int32_t num_samples) {
+int32_t update_delay_samples(delay_buf_state_t *delay_state, int32_t num_samples) {
+    int32_t max_delay = delay_buffer_max_delay_samples(delay_state);
+    if(num_samples > max_delay) {
+        num_samples = max_delay;
+    }
+    else if(num_samples < -max_delay) {
+        num_samples = -max_delay;
+    }
+    int32_t crossfade = (delay_state->crossfade_length > 0) && (num_samples != delay_state->delay_samples) &&
+        ((num_samples < 0) == (delay_state->delay_samples < 0));
+    delay_state->prev_delay_samples = delay_state->delay_samples;
     delay_state->delay_samples = num_samples;
+    for(int ch=0; ch<MAX_DELAY_BUF_CHANNELS; ch++) {
+        delay_state->crossfade_pos[ch] = crossfade ? 0 : delay_state->crossfade_length;
+    }
+    return crossfade;
 }
 
 void reset_partial_delay_buffer(delay_buf_state_t *delay_state, int32_t ch) {
+    if(delay_state->crossfade_pos[ch] < delay_state->crossfade_length) {
+        return;
+    }
     int32_t num_samples = delay_state->delay_samples;
     if(!num_samples) {
         return;
@@ -33,19 +104,15 @@ void reset_partial_delay_buffer(delay_buf_state_t *delay_state, int32_t ch) {
     // Reset delay_state->delay_samples before the current index
 
     num_samples = (num_samples < 0) ? -num_samples : num_samples;
-    // Reset num_samples samples before curr_idx
-    int32_t reset_start = (
-            (DELAY_BUF_MAX_DELAY_SAMPLES + delay_state->curr_idx[ch] - num_samples)
-            % DELAY_BUF_MAX_DELAY_SAMPLES
-            );
-    if(reset_start < delay_state->curr_idx[ch]) {
+    int32_t curr_idx = delay_state->curr_idx[ch];
+    if(num_samples <= curr_idx) {
         //reset_start hasn't wrapped around
-        memset(&delay_state->delay_buffer[ch][reset_start], 0, num_samples*sizeof(int32_t));
+        memset(&delay_state->delay_buffer[ch][curr_idx - num_samples], 0, num_samples*sizeof(int32_t));
     }
     else {
         //reset_start has wrapped around
-        memset(&delay_state->delay_buffer[ch][0], 0, delay_state->curr_idx[ch]*sizeof(int32_t));
-        int remaining = num_samples - delay_state->curr_idx[ch];
-        memset(&delay_state->delay_buffer[ch][DELAY_BUF_MAX_DELAY_SAMPLES - remaining], 0, remaining*sizeof(int32_t));
+        memset(&delay_state->delay_buffer[ch][0], 0, curr_idx*sizeof(int32_t));
+        int remaining = num_samples - curr_idx;
+        memset(&delay_state->delay_buffer[ch][delay_state->buffer_length - remaining], 0, remaining*sizeof(int32_t));
     }
 }
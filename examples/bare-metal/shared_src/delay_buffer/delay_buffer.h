@@ -1,20 +1,48 @@
 #ifndef DELAY_BUFFER_H
 #define DELAY_BUFFER_H
 
+#include <stdint.h>
+
 #define MAX_DELAY_BUF_CHANNELS (2)
-#define DELAY_BUF_MAX_DELAY_MS                ( 150 )
-#define DELAY_BUF_MAX_DELAY_SAMPLES           ( 16000*DELAY_BUF_MAX_DELAY_MS/1000 )
+
+// Length of each channel's circular buffer, in samples, for delays of up to max_delay_samples with frames of
+// frame_length samples. A whole number of frames, so that every frame is written to the buffer in one piece
+#define DELAY_BUF_LENGTH(max_delay_samples, frame_length) \
+    ((((max_delay_samples) + (2 * (frame_length)) - 1) / (frame_length)) * (frame_length))
 
 typedef struct {
-    // Circular buffer to store the samples
-    int32_t delay_buffer[MAX_DELAY_BUF_CHANNELS][DELAY_BUF_MAX_DELAY_SAMPLES];
+    // Circular buffers to store the samples, buffer_length samples per channel. Memory is provided by the application
+    int32_t *delay_buffer[MAX_DELAY_BUF_CHANNELS];
+    int32_t buffer_length;
+    int32_t frame_length;
     // index of the value for the samples to be stored in the buffer
     int32_t curr_idx[MAX_DELAY_BUF_CHANNELS];
     int32_t delay_samples;
+    // Number of samples delay changes are crossfaded over. 0 switches to the new delay straight away
+    int32_t crossfade_length;
+    // Delay being crossfaded from, and how far through the crossfade each channel is
+    int32_t prev_delay_samples;
+    int32_t crossfade_pos[MAX_DELAY_BUF_CHANNELS];
 } delay_buf_state_t;
 
-void delay_buffer_init(delay_buf_state_t *state, int default_delay_samples);
-void get_delayed_sample(delay_buf_state_t *delay_state, int32_t *sample, int32_t ch);
-void update_delay_samples(delay_buf_state_t *delay_state, int32_t num_samples);
+/* Initialise the delay buffer with num_channels * buffer_length samples of memory. buffer_length must be a whole number
+ * of frame_length sample frames, see DELAY_BUF_LENGTH(). Returns 0 on success, -1 if the sizes are not supported.
+ */
+int delay_buffer_init(delay_buf_state_t *state, int32_t *memory, int32_t num_channels, int32_t buffer_length,
+        int32_t frame_length, int32_t default_delay_samples);
+/* Largest delay, in samples, that the buffer supports. */
+int32_t delay_buffer_max_delay_samples(const delay_buf_state_t *delay_state);
+/* Store a block of frame_length samples of a channel and replace it with the block delayed by the absolute value of
+ * delay_samples. */
+void get_delayed_block(delay_buf_state_t *delay_state, int32_t *frame, int32_t ch);
+/* Crossfade from the old delay to the new one over crossfade_frames frames after a delay change, instead of switching
+ * straight away. 0 disables crossfading. */
+void delay_buffer_set_crossfade(delay_buf_state_t *delay_state, int32_t crossfade_frames);
+/* Set the delay applied from the next frame. Delays longer than delay_buffer_max_delay_samples() are limited to it.
+ * Returns 1 if the change is crossfaded. It isn't when crossfading is disabled or when the delay moves between the mic
+ * and the reference, since the buffer only holds the history of the one being delayed. */
+int32_t update_delay_samples(delay_buf_state_t *delay_state, int32_t num_samples);
+/* Clear the samples of a channel that the new delay brings back into use after a delay change. Does nothing while a
+ * delay change is being crossfaded, since both delays read valid history. */
 void reset_partial_delay_buffer(delay_buf_state_t *delay_state, int32_t ch);
 #endif
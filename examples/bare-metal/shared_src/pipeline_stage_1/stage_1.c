@@ -1,6 +1,8 @@
+#include <assert.h>
 #include "pipeline_config.h"
 #include "pipeline_state.h"
 #include "stage_1.h"
+#include "aec_process_frame_1thread.h"
 
 extern void aec_process_frame_2threads(
         aec_state_t *main_state,
@@ -10,13 +12,9 @@ extern void aec_process_frame_2threads(
         const int32_t (*y_data)[AEC_FRAME_ADVANCE],
         const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
 
-extern void aec_process_frame_1thread(
-        aec_state_t *main_state,
-        aec_state_t *shadow_state,
-        int32_t (*output_main)[AEC_FRAME_ADVANCE],
-        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
-        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
-        const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
+#if STAGE_1_RESIDUAL_ECHO_SUPPRESSION && (NUM_AEC_THREADS > 1)
+#error "STAGE_1_RESIDUAL_ECHO_SUPPRESSION is only supported with NUM_AEC_THREADS 1"
+#endif
 
 static void aec_switch_configuration(stage_1_state_t *state, aec_conf_t *conf)
 {
@@ -24,6 +22,24 @@ static void aec_switch_configuration(stage_1_state_t *state, aec_conf_t *conf)
             &state->aec_main_memory_pool[0], &state->aec_shadow_memory_pool[0],
             conf->num_y_channels, conf->num_x_channels,
             conf->num_main_filt_phases, conf->num_shadow_filt_phases);
+    // Phase energies held by the delay estimator are for the old filter
+    adec_de_init(&state->de_state, DE_PHASES_PER_FRAME);
+#if STAGE_1_RESIDUAL_ECHO_SUPPRESSION
+    // So is the echo leakage estimate
+    aec_res_init(&state->aec_res_state);
+    state->aec_X_energy_recalc_bin = 0;
+#endif
+}
+
+static void reset_residual_echo_suppression(stage_1_state_t *state) {
+#if STAGE_1_RESIDUAL_ECHO_SUPPRESSION
+    // The echo leakage estimate is for the filters before they were reset, shifted or restored. Keep the configuration
+    aec_res_config_t res_config = state->aec_res_state.config;
+    aec_res_init(&state->aec_res_state);
+    state->aec_res_state.config = res_config;
+#else
+    (void)state;
+#endif
 }
 
 static inline void get_delayed_frame(
@@ -34,16 +50,12 @@ static inline void get_delayed_frame(
     int num_channels = (delay_state->delay_samples) > 0 ? AP_MAX_Y_CHANNELS : AP_MAX_X_CHANNELS;
     if (delay_state->delay_samples >= 0) {/** Requested Mic delay +ve => delay mic*/
         for(int ch=0; ch<num_channels; ch++) {
-            for(int i=0; i<AP_FRAME_ADVANCE; i++) {
-                get_delayed_sample(delay_state, &input_y_data[ch][i], ch);
-            }
+            get_delayed_block(delay_state, &input_y_data[ch][0], ch);
         }
     }
     else if (delay_state->delay_samples < 0) {/* Requested Mic delay negative => advance mic which can't be done, so delay reference*/
         for(int ch=0; ch<num_channels; ch++) {
-            for(int i=0; i<AP_FRAME_ADVANCE; i++) {
-                get_delayed_sample(delay_state, &input_x_data[ch][i], ch);
-            }
+            get_delayed_block(delay_state, &input_x_data[ch][0], ch);
         }
     }
     return;
@@ -55,14 +67,73 @@ void stage_1_init(stage_1_state_t *state, aec_conf_t *de_conf, aec_conf_t *non_d
     state->hold_aec_count = 0; //No. of consecutive frames reference has been absent for
     state->hold_aec_limit = (16000*HOLD_AEC_LIMIT_SECONDS)/AP_FRAME_ADVANCE; //bypass AEC only when reference has been absent for atleast 3 seconds (200 frames)
 
-    delay_buffer_init(&state->delay_state, 0/*Initialise with 0 delay_samples*/);
+    int32_t ret = delay_buffer_init(&state->delay_state, state->delay_buffer_memory, MAX_DELAY_BUF_CHANNELS, STAGE_1_DELAY_BUF_LENGTH, AP_FRAME_ADVANCE, 0/*Initialise with 0 delay_samples*/);
+    assert((ret == 0) && "STAGE_1_DELAY_BUF_LENGTH not supported for AP_FRAME_ADVANCE");
+    (void)ret;
+    delay_buffer_set_crossfade(&state->delay_state, STAGE_1_DELAY_CROSSFADE_FRAMES);
     memcpy(&state->aec_de_mode_conf, de_conf, sizeof(aec_conf_t));
     memcpy(&state->aec_non_de_mode_conf, non_de_conf, sizeof(aec_conf_t));
 
     adec_init(&state->adec_state, adec_config);
+#if STAGE_1_GCC_PHAT
+    adec_gcc_phat_init(&state->gcc_phat_state);
+    state->gcc_phat_output.valid = 0;
+#endif
     aec_switch_configuration(state, &state->aec_non_de_mode_conf);
 }
 
+// Snapshot of the stage is the delay buffer delay and the ADEC state, followed by the AEC snapshot. The ADEC state is
+// plain data so it is stored as it is, which ties the snapshot to the build it was saved with.
+#define STAGE_1_SNAPSHOT_HEADER_SIZE (sizeof(int32_t) + sizeof(adec_state_t))
+
+uint32_t stage_1_get_snapshot_size(const stage_1_state_t *state) {
+    const aec_conf_t *conf = &state->aec_non_de_mode_conf;
+    return STAGE_1_SNAPSHOT_HEADER_SIZE + aec_get_snapshot_size(conf->num_y_channels, conf->num_x_channels,
+            conf->num_main_filt_phases, conf->num_shadow_filt_phases);
+}
+
+uint32_t stage_1_save_snapshot(const stage_1_state_t *state, uint8_t *snapshot, uint32_t snapshot_size) {
+    // The AEC is only worth saving once it is back in normal mode with the delay corrected
+    if(state->delay_estimator_enabled || (snapshot_size < STAGE_1_SNAPSHOT_HEADER_SIZE)) {
+        return 0;
+    }
+    uint32_t aec_size = aec_save_snapshot(&snapshot[STAGE_1_SNAPSHOT_HEADER_SIZE], snapshot_size - STAGE_1_SNAPSHOT_HEADER_SIZE,
+            &state->aec_main_state, &state->aec_shadow_state);
+    if(!aec_size) {
+        return 0;
+    }
+    memcpy(snapshot, &state->delay_state.delay_samples, sizeof(int32_t));
+    memcpy(&snapshot[sizeof(int32_t)], &state->adec_state, sizeof(adec_state_t));
+    return STAGE_1_SNAPSHOT_HEADER_SIZE + aec_size;
+}
+
+int32_t stage_1_restore_snapshot(stage_1_state_t *state, const uint8_t *snapshot, uint32_t snapshot_size) {
+    if(state->delay_estimator_enabled || (snapshot_size < STAGE_1_SNAPSHOT_HEADER_SIZE)) {
+        return -1;
+    }
+    if(aec_restore_snapshot(&state->aec_main_state, &state->aec_shadow_state,
+            &snapshot[STAGE_1_SNAPSHOT_HEADER_SIZE], snapshot_size - STAGE_1_SNAPSHOT_HEADER_SIZE) != 0) {
+        return -1;
+    }
+    int32_t delay_samples;
+    memcpy(&delay_samples, snapshot, sizeof(int32_t));
+    // Start the buffer at the saved delay rather than changing to it, since there is no history to crossfade from
+    if(delay_buffer_init(&state->delay_state, state->delay_buffer_memory, MAX_DELAY_BUF_CHANNELS, STAGE_1_DELAY_BUF_LENGTH, AP_FRAME_ADVANCE, delay_samples) != 0) {
+        return -1;
+    }
+    delay_buffer_set_crossfade(&state->delay_state, STAGE_1_DELAY_CROSSFADE_FRAMES);
+
+    // Keep the configuration the application initialised ADEC with, except that the delay is already known so there is
+    // no need for a startup delay estimation cycle
+    adec_config_t adec_config = state->adec_state.adec_config;
+    memcpy(&state->adec_state, &snapshot[sizeof(int32_t)], sizeof(adec_state_t));
+    state->adec_state.adec_config = adec_config;
+    state->adec_state.adec_config.force_de_cycle_trigger = 0;
+    adec_de_init(&state->de_state, DE_PHASES_PER_FRAME);
+    reset_residual_echo_suppression(state);
+    return 0;
+}
+
 #if ALT_ARCH_MODE
 // Based of activity on the reference channels, this function controls enabling and disabling of AEC and IC stages.
 static void alt_arch_controller(stage_1_state_t *state, int32_t *ref_active_flag) {
@@ -119,7 +190,7 @@ static void alt_arch_rewrite_output(int32_t (*output)[AP_FRAME_ADVANCE], const i
 /** Process a frame of data through AEC and ADEC*/
 static int framenum = 0;
 void stage_1_process_frame(stage_1_state_t *state, int32_t (*output_frame)[AP_FRAME_ADVANCE],
-    float_s32_t *max_ref_energy, float_s32_t *aec_corr_factor, int32_t *ref_active_flag,
+    float_s32_t *max_ref_energy, float_s32_t *aec_corr_factor, int32_t *aec_double_talk_state, int32_t *ref_active_flag,
     int32_t (*input_y)[AP_FRAME_ADVANCE], int32_t (*input_x)[AP_FRAME_ADVANCE])
 {
     //printf("frame %d\n",framenum);
@@ -143,6 +214,9 @@ void stage_1_process_frame(stage_1_state_t *state, int32_t (*output_frame)[AP_FR
     /** AEC*/
 #if (NUM_AEC_THREADS > 1)
     aec_process_frame_2threads(&state->aec_main_state, &state->aec_shadow_state, output_frame, NULL, input_y, input_x);
+#elif STAGE_1_RESIDUAL_ECHO_SUPPRESSION
+    aec_process_frame_1thread_res(&state->aec_main_state, &state->aec_shadow_state, &state->aec_res_state,
+            &state->aec_X_energy_recalc_bin, output_frame, NULL, input_y, input_x);
 #else
     aec_process_frame_1thread(&state->aec_main_state, &state->aec_shadow_state, output_frame, NULL, input_y, input_x);
 #endif
@@ -151,15 +225,23 @@ void stage_1_process_frame(stage_1_state_t *state, int32_t (*output_frame)[AP_FR
     *max_ref_energy = aec_calc_max_input_energy(input_x, state->aec_main_state.shared_state->num_x_channels);
     for(int ch=0; ch<state->aec_main_state.shared_state->num_y_channels; ch++) {
         aec_corr_factor[ch] = aec_calc_corr_factor(&state->aec_main_state, ch);
+        aec_double_talk_state[ch] = aec_get_double_talk_state(&state->aec_main_state, ch);
     }
 
     /** Delay Estimation*/
     adec_input_t adec_in;
-    adec_estimate_delay(
+    adec_estimate_delay_multi(
+            &state->de_state,
             &adec_in.from_de,
-            state->aec_main_state.H_hat[0],
+            (const bfp_complex_s32_t (*)[AEC_LIB_MAX_PHASES])state->aec_main_state.H_hat,
+            state->aec_main_state.shared_state->num_y_channels,
+            state->aec_main_state.shared_state->num_x_channels,
             state->aec_main_state.num_phases
             );
+#if STAGE_1_GCC_PHAT
+    adec_gcc_phat_process_frame(&state->gcc_phat_state, &state->gcc_phat_output, input_y[0], input_x[0], *ref_active_flag);
+    adec_in.from_gcc_phat = state->gcc_phat_output;
+#endif
 
 
     /** ADEC*/
@@ -177,19 +259,46 @@ void stage_1_process_frame(stage_1_state_t *state, int32_t (*output_frame)[AP_FR
             &adec_in
             );
 
-    //** Reset AEC state if needed*/
-    if(adec_output.reset_aec_flag) {
-        aec_reset_state(&state->aec_main_state, &state->aec_shadow_state);
-    }
-
     /** Update delay buffer if there's a delay change requested by ADEC*/
+    int32_t prev_delay_samples = state->delay_state.delay_samples;
+    int32_t delay_change = 0;
+    int32_t keep_aec_filters = 0;
     if(adec_output.delay_change_request_flag == 1){
         //printf("Frame %d: Set delay to %ld\n", framenum, adec_output.requested_mic_delay_samples);
         // Update delay_buffer delay_samples with mic delay requested by adec
-        update_delay_samples(&state->delay_state, adec_output.requested_mic_delay_samples);
-        for(int ch=0; ch<AP_MAX_Y_CHANNELS; ch++) {
-            reset_partial_delay_buffer(&state->delay_state, ch);
+        int32_t delay_crossfaded = update_delay_samples(&state->delay_state, adec_output.requested_mic_delay_samples);
+        delay_change = state->delay_state.delay_samples - prev_delay_samples;
+        // The delay buffer holds the history of the input it delays, so if that is still the same input, the delayed
+        // input carries on from valid samples and the AEC filters can follow the change
+        int32_t same_input = ((prev_delay_samples < 0) == (state->delay_state.delay_samples < 0));
+        keep_aec_filters = delay_crossfaded ||
+            (STAGE_1_SHIFT_AEC_PHASES && same_input && ((delay_change % AP_FRAME_ADVANCE) == 0));
+        if(!keep_aec_filters) {
+            for(int ch=0; ch<AP_MAX_Y_CHANNELS; ch++) {
+                reset_partial_delay_buffer(&state->delay_state, ch);
+            }
+        }
+#if STAGE_1_GCC_PHAT
+        // Input history held by GCC-PHAT is for the old delay
+        adec_gcc_phat_init(&state->gcc_phat_state);
+        state->gcc_phat_output.valid = 0;
+#endif
+    }
+
+    //** Reset AEC state if needed*/
+    if(adec_output.reset_aec_flag) {
+        if(keep_aec_filters && ((delay_change % AP_FRAME_ADVANCE) == 0)) {
+            // The echo path has just moved by the delay change. Keep the converged filters, reordering their phases
+            aec_shift_filter_phases(&state->aec_main_state, &state->aec_shadow_state, delay_change / AP_FRAME_ADVANCE, (state->delay_state.delay_samples < 0));
+        }
+        else if(keep_aec_filters) {
+            aec_shift_filter_samples(&state->aec_main_state, &state->aec_shadow_state, delay_change);
+        }
+        else {
+            aec_reset_state(&state->aec_main_state, &state->aec_shadow_state);
         }
+        adec_de_init(&state->de_state, DE_PHASES_PER_FRAME);
+        reset_residual_echo_suppression(state);
     }
     
 #if ALT_ARCH_MODE
@@ -8,6 +8,23 @@
 
 #define REF_ACTIVE_THRESHOLD_dB (-60) // Reference input level above which it is considered active
 #define HOLD_AEC_LIMIT_SECONDS (3) // Keep AEC enabled for atleast 3seconds after detecting reference as inactive. Used only in alt arch configuration
+#define DE_PHASES_PER_FRAME (15) // AEC filter phase energies recalculated by the delay estimator every frame. Shared by all the x-y channel pairs, so covers every pair's filter every 3 frames in the 2x2 channel normal AEC mode and every 2 frames in the 30 phase delay estimation mode
+#ifndef STAGE_1_MAX_DELAY_MS
+#define STAGE_1_MAX_DELAY_MS (150) // Longest mic or reference delay the delay buffer is sized for
+#endif
+#define STAGE_1_DELAY_BUF_LENGTH DELAY_BUF_LENGTH(16000*STAGE_1_MAX_DELAY_MS/1000, AP_FRAME_ADVANCE)
+#ifndef STAGE_1_DELAY_CROSSFADE_FRAMES
+#define STAGE_1_DELAY_CROSSFADE_FRAMES (0) // Frames to crossfade ADEC delay changes over, shifting the AEC filters instead of resetting them. 0 switches delay straight away and resets the AEC
+#endif
+#ifndef STAGE_1_SHIFT_AEC_PHASES
+#define STAGE_1_SHIFT_AEC_PHASES (0) // Shift the AEC filter phases on whole frame ADEC delay changes instead of resetting the AEC. 0 resets the AEC
+#endif
+#ifndef STAGE_1_RESIDUAL_ECHO_SUPPRESSION
+#define STAGE_1_RESIDUAL_ECHO_SUPPRESSION (0) // Suppress the echo left in the AEC output before passing it on. Needs NUM_AEC_THREADS 1
+#endif
+#ifndef STAGE_1_GCC_PHAT
+#define STAGE_1_GCC_PHAT (0) // Run the GCC-PHAT delay estimator beside the AEC so ADEC can correct delay changes without a delay estimation mode cycle
+#endif
 
 typedef struct {
     uint8_t num_x_channels;
@@ -23,12 +40,22 @@ typedef struct {
     aec_shared_state_t DWORD_ALIGNED aec_shared_state;
     uint8_t DWORD_ALIGNED aec_main_memory_pool[sizeof(aec_memory_pool_t)];
     uint8_t DWORD_ALIGNED aec_shadow_memory_pool[sizeof(aec_shadow_filt_memory_pool_t)];
+#if STAGE_1_RESIDUAL_ECHO_SUPPRESSION
+    aec_res_state_t DWORD_ALIGNED aec_res_state;
+    unsigned aec_X_energy_recalc_bin;
+#endif
     
     // ADEC
     adec_state_t DWORD_ALIGNED adec_state;
+    de_state_t DWORD_ALIGNED de_state;
+#if STAGE_1_GCC_PHAT
+    gcc_phat_state_t DWORD_ALIGNED gcc_phat_state;
+    gcc_phat_output_t gcc_phat_output;
+#endif
  
     // Delay Buffer
     delay_buf_state_t DWORD_ALIGNED delay_state;
+    int32_t DWORD_ALIGNED delay_buffer_memory[MAX_DELAY_BUF_CHANNELS * STAGE_1_DELAY_BUF_LENGTH];
 
     //Top level
     aec_conf_t aec_de_mode_conf;
@@ -42,7 +69,17 @@ typedef struct {
 
 void stage_1_init(stage_1_state_t *state, aec_conf_t *de_conf, aec_conf_t *non_de_conf, adec_config_t *adec_config);
 
+/* Size in bytes of the snapshot saved by stage_1_save_snapshot(). */
+uint32_t stage_1_get_snapshot_size(const stage_1_state_t *state);
+/* Save the AEC filters, the delay and the ADEC state, so that a later session can restore them and start with a
+ * converged canceller. Returns the number of bytes written, or 0 if the buffer is too small or the stage is in delay
+ * estimation mode. */
+uint32_t stage_1_save_snapshot(const stage_1_state_t *state, uint8_t *snapshot, uint32_t snapshot_size);
+/* Restore a snapshot saved by stage_1_save_snapshot(). Called after stage_1_init(), it skips the startup delay
+ * estimation cycle. Returns 0 on success, -1 if the snapshot doesn't match the stage's configuration. */
+int32_t stage_1_restore_snapshot(stage_1_state_t *state, const uint8_t *snapshot, uint32_t snapshot_size);
+
 void stage_1_process_frame(stage_1_state_t *state, int32_t (*output_frame)[AP_FRAME_ADVANCE],
-    float_s32_t *max_ref_energy, float_s32_t *aec_corr_factor, int32_t *ref_active_flag,
+    float_s32_t *max_ref_energy, float_s32_t *aec_corr_factor, int32_t *aec_double_talk_state, int32_t *ref_active_flag,
     int32_t (*input_y)[AP_FRAME_ADVANCE], int32_t (*input_x)[AP_FRAME_ADVANCE]);
 #endif
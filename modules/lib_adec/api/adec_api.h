@@ -29,6 +29,8 @@
         adec_config_t adec_conf;
         adec_conf.bypass = 1; // Bypass automatic DE correction
         adec_conf.force_de_cycle_trigger = 1; // Force a delay correction cycle, so that delay correction happens once after initialisation
+        adec_conf.use_refined_delay = 0; // Correct delay to whole AEC filter phases
+        adec_conf.use_gcc_phat = 0; // Estimate delay from the AEC filter only
         adec_init(&adec_state, &adec_conf);
         // Application needs to ensure that adec_state->adec_config.force_de_cycle_trigger is set to 0 after ADEC has requested a transition to delay estimation mode once in order to ensure that delay is corrected only at startup.  
  * @endcode
@@ -38,6 +40,8 @@
  *      adec_state_t adec_state;
         adec_conf.bypass = 0;
         adec_conf.force_de_cycle_trigger = 0;
+        adec_conf.use_refined_delay = 0;
+        adec_conf.use_gcc_phat = 0;
         adec_init(&adec_state, &adec_conf);
  * @endcode
  *
@@ -66,7 +70,9 @@ void adec_process_frame(
  * 
  * This function measures the microphone signal delay wrt the reference signal. It does so by
  * looking for the phase with the peak energy among all AEC filter phases and uses the peak energy phase index
- * as the estimate of the microphone delay. Along with the measured delay, it also outputs information
+ * as the estimate of the microphone delay. It also refines the estimate to single sample resolution from the per bin
+ * phase slope of the peak energy phase, which is output as de_output->refined_delay_samples.
+ * Along with the measured delay, it also outputs information
  * about the peak phase energy that can then be used to gauge the AEC filter convergence and the reliability of the
  * measured delay.
  *
@@ -80,3 +86,123 @@ void adec_estimate_delay (
         de_output_t *de_output,
         const bfp_complex_s32_t* H_hat, 
         unsigned num_phases);
+
+/** @brief Initialise the incremental delay estimator
+ *
+ * This function initialises the state used by adec_estimate_delay_incremental(). It must be called at startup before
+ * estimating any delays and again whenever the AEC filter is reset, so that phase energies held from before the reset
+ * are not used.
+ *
+ * @param[out] de_state Incremental delay estimator state structure
+ * @param[in] phases_per_frame Number of filter phase energies to recalculate every frame. 0 recalculates all of them
+ * every frame.
+ *
+ * @ingroup adec_func
+ */
+void adec_de_init(de_state_t *de_state, unsigned phases_per_frame);
+
+/** @brief Estimate microphone delay, recalculating only some of the filter phase energies every frame
+ *
+ * This function gives the same outputs as adec_estimate_delay() but, instead of recalculating the energy of every AEC
+ * filter phase every frame, it recalculates de_state->phases_per_frame of them in round robin order and holds the last
+ * calculated energy for the others. The filter energy of every phase is refreshed once every
+ * ceil(num_phases / phases_per_frame) frames, which bounds how out of date the estimate can get, while the cost per
+ * frame is bounded to phases_per_frame phase energy calculations whatever the number of phases.
+ *
+ * All phase energies are recalculated on the first call after adec_de_init() and whenever num_phases changes, for
+ * example when the AEC is reconfigured for delay estimation. With de_state->phases_per_frame set to 0 or to at least
+ * num_phases, the outputs are bit exact with adec_estimate_delay().
+ *
+ * @param[inout] de_state Incremental delay estimator state structure
+ * @param[out] de_output Delay estimator output structure
+ * @param[in] H_hat bfp_complex_s32_t array storing the AEC filter spectrum
+ * @param[in] num_phases Number of phases in the AEC filter
+ *
+ * @ingroup adec_func
+ */
+void adec_estimate_delay_incremental(
+        de_state_t *de_state,
+        de_output_t *de_output,
+        const bfp_complex_s32_t* H_hat,
+        unsigned num_phases);
+
+/** @brief Estimate microphone delay from the AEC filters of every microphone and reference channel pair
+ *
+ * This function extends adec_estimate_delay_incremental() to AEC instances with more than one microphone or reference
+ * channel. The phase energies of all the x-y channel pairs are recalculated in a single round robin, so
+ * de_state->phases_per_frame bounds the cost per frame whatever the number of channel pairs, and every phase energy is
+ * refreshed once every ceil(num_y_channels * num_x_channels * num_phases / phases_per_frame) frames.
+ *
+ * The echo path profile of each reference channel is the sum of its phase energies over all the microphone channels,
+ * and gives that reference's delay in de_output->x_measured_delay_samples. The sum of the profiles of all the references
+ * gives the other outputs, in the same way as adec_estimate_delay() does for a single channel pair, so a channel with
+ * little echo on it doesn't hide the peak of the others.
+ *
+ * When the filters of two or more references have a clear peak, with a peak to average ratio of at least
+ * ADEC_MULTI_REF_GOOD_PEAK_TO_AVERAGE, and the peaks are ADEC_MULTI_REF_MISMATCH_PHASES or more phases apart,
+ * de_output->reference_delay_mismatch_flag is set. This happens when the references are played out through different
+ * paths, for example a soundbar and a TV speaker. No single delay aligns all of them, so de_output->measured_delay_samples
+ * is then the delay of the earliest echo, which keeps all of them within the filter, and de_output->peak_power_phase_index
+ * and de_output->peak_phase_power are the peak of that reference's profile. de_output->refined_delay_samples is
+ * refined from the channel pair with the most energy in the phase of de_output->measured_delay_samples.
+ *
+ * With a single microphone and reference channel the outputs are the same as adec_estimate_delay_incremental().
+ *
+ * @param[inout] de_state Incremental delay estimator state structure
+ * @param[out] de_output Delay estimator output structure
+ * @param[in] H_hat AEC filter spectrum of every microphone channel, as in aec_state_t::H_hat
+ * @param[in] num_y_channels Number of microphone channels
+ * @param[in] num_x_channels Number of reference channels
+ * @param[in] num_phases Number of phases in the AEC filter of each channel pair
+ *
+ * @ingroup adec_func
+ */
+void adec_estimate_delay_multi(
+        de_state_t *de_state,
+        de_output_t *de_output,
+        const bfp_complex_s32_t (*H_hat)[AEC_LIB_MAX_PHASES],
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_phases);
+
+/** @brief Initialise the GCC-PHAT delay estimator
+ *
+ * This function initialises the state used by adec_gcc_phat_process_frame(). It must be called at startup before
+ * processing any frames and again whenever the delay between the microphone and reference inputs to the estimator
+ * is changed, so that input history from before the change is not used.
+ *
+ * @param[out] state GCC-PHAT delay estimator state structure
+ *
+ * @ingroup adec_func
+ */
+void adec_gcc_phat_init(gcc_phat_state_t *state);
+
+/** @brief Estimate microphone delay from the cross correlation of the microphone and reference inputs
+ *
+ * This function estimates the microphone delay wrt the reference with the generalised cross correlation with phase
+ * transform (GCC-PHAT) method, directly from the input signals and independently of the AEC filter, so it can run
+ * beside the AEC in its normal configuration.
+ *
+ * Both inputs are decimated by ADEC_GCC_PHAT_DECIMATION_FACTOR and the last ADEC_GCC_PHAT_FFT_LENGTH decimated
+ * samples of each are kept. Every ADEC_GCC_PHAT_HOP_FRAMES frames, and only if far_end_active is set, the PHAT
+ * weighted cross spectrum of the two is calculated and added to a running average. Its inverse FFT is searched for the
+ * cross correlation peak within +/- ADEC_GCC_PHAT_MAX_DELAY_SAMPLES, which is interpolated to better than the
+ * decimated sample resolution.
+ *
+ * output is only updated when a new estimate is calculated, so the last estimate is held in between. output->valid is
+ * 0 until ADEC_GCC_PHAT_MIN_BLOCKS cross spectra have been averaged over a full window of input.
+ *
+ * @param[inout] state GCC-PHAT delay estimator state structure
+ * @param[inout] output GCC-PHAT delay estimator output structure
+ * @param[in] y_frame AEC_FRAME_ADVANCE samples of microphone input
+ * @param[in] x_frame AEC_FRAME_ADVANCE samples of reference input
+ * @param[in] far_end_active Flag indicating if there is activity on the reference input
+ *
+ * @ingroup adec_func
+ */
+void adec_gcc_phat_process_frame(
+        gcc_phat_state_t *state,
+        gcc_phat_output_t *output,
+        const int32_t *y_frame,
+        const int32_t *x_frame,
+        int32_t far_end_active);
@@ -26,4 +26,62 @@
  */
 #define ADEC_PEAK_LINREG_HISTORY_SIZE           66
 
+/**
+ * @brief Number of samples ahead of the echo path peak that the delay is set to when adec_config_t::use_refined_delay is
+ * enabled. Allows for refined delay estimation error and for echo path energy ahead of the peak.
+ * @ingroup adec_defines
+ */
+#define ADEC_REFINED_DELAY_HEADROOM_SAMPS       32
+
+/**
+ * @brief Factor the GCC-PHAT delay estimator decimates its input by
+ * @ingroup adec_defines
+ */
+#define ADEC_GCC_PHAT_DECIMATION_FACTOR         8
+
+/**
+ * @brief Length of the GCC-PHAT delay estimator analysis window and FFT, in decimated samples. NOT USER MODIFIABLE
+ * @ingroup adec_defines
+ */
+#define ADEC_GCC_PHAT_FFT_LENGTH                1024
+
+/**
+ * @brief Number of frames between GCC-PHAT delay estimates
+ * @ingroup adec_defines
+ */
+#define ADEC_GCC_PHAT_HOP_FRAMES                4
+
+/**
+ * @brief Largest mic or reference delay, in samples, that the GCC-PHAT delay estimator looks for
+ * @ingroup adec_defines
+ */
+#define ADEC_GCC_PHAT_MAX_DELAY_SAMPLES         2400
+
+/**
+ * @brief Number of GCC-PHAT estimates averaged before its output is marked valid
+ * @ingroup adec_defines
+ */
+#define ADEC_GCC_PHAT_MIN_BLOCKS                8
+
+/**
+ * @brief GCC-PHAT peak to average ratio above which its delay estimate is considered reliable
+ * @ingroup adec_defines
+ */
+#define ADEC_GCC_PHAT_GOOD_PEAK_TO_AVERAGE      (10.0f)
+
+/**
+ * @brief Peak to average ratio of a reference's filter phase energies above which adec_estimate_delay_multi() treats
+ * that reference's echo path peak as reliable when comparing the delays of the references
+ * @ingroup adec_defines
+ */
+#define ADEC_MULTI_REF_GOOD_PEAK_TO_AVERAGE     (4.0f)
+
+/**
+ * @brief Number of filter phases apart that the echo path peaks of two references must be for
+ * adec_estimate_delay_multi() to flag them as having different delays. Peaks in neighbouring phases can be the same
+ * delay straddling a phase boundary.
+ * @ingroup adec_defines
+ */
+#define ADEC_MULTI_REF_MISMATCH_PHASES          2
+
 #endif
@@ -42,6 +42,15 @@ typedef struct {
      * estimation mode for measuring delay offset.
     */
     int32_t force_de_cycle_trigger; 
+    /** Use de_output_t::refined_delay_samples instead of de_output_t::measured_delay_samples for delay corrections.
+     * When set to 1, the delay is set so that the echo path peak lands ADEC_REFINED_DELAY_HEADROOM_SAMPS samples into
+     * the AEC filter instead of at the start of its second phase, which leaves more of the filter for the echo tail.*/
+    int32_t use_refined_delay;
+    /** Use the GCC-PHAT delay estimator output, adec_input_t::from_gcc_phat, to correct bulk delay changes while
+     * in normal AEC mode. When set to 1, a confident GCC-PHAT estimate that is more than ADEC_AEC_ESTIMATE_MIN_MS
+     * away from the current alignment is corrected straight away, and a delay estimation mode cycle is only
+     * started when GCC-PHAT has no confident estimate.*/
+    int32_t use_gcc_phat;
 }adec_config_t;
 
 /**
@@ -51,13 +60,85 @@ typedef struct {
  */
 typedef struct {
     int32_t measured_delay_samples; ///< Estimated microphone delay in time domain samples
+    int32_t refined_delay_samples; ///< Estimated microphone delay at single sample resolution. measured_delay_samples plus the offset of the echo path peak into the peak energy phase, from the per bin phase slope of that phase.
     int32_t peak_power_phase_index; ///< Phase index of peak energy AEC filter phase
     float_s32_t peak_phase_power; ///< Maximum per phase energy across all AEC filter phases
     float_s32_t sum_phase_powers; ///< Sum of filter energy across all filter phases.
     float_s32_t peak_to_average_ratio; ///< Ratio of peak filter phase energy to average filter phase energy. Used to evaluate how well the filter has converged.
-    float_s32_t phase_power[AEC_LIB_MAX_PHASES]; ///< Phase energy of all AEC filter phases
+    float_s32_t phase_power[AEC_LIB_MAX_PHASES]; ///< Phase energy of all AEC filter phases. Summed over all the x-y channel pairs by adec_estimate_delay_multi().
+    int32_t x_measured_delay_samples[AEC_LIB_MAX_X_CHANNELS]; ///< Estimated microphone delay wrt each reference channel, from that reference's filter phases summed over all microphone channels. Only channel 0 is set by the single channel pair estimators.
+    float_s32_t x_peak_to_average_ratio[AEC_LIB_MAX_X_CHANNELS]; ///< Peak to average ratio of each reference channel's filter phase energies.
+    int32_t reference_delay_mismatch_flag; ///< Flag indicating that the echoes of different reference channels are at different delays, so no single delay aligns all of them. measured_delay_samples, peak_power_phase_index and peak_phase_power are then those of the reference with the earliest echo.
 }de_output_t;
 
+/**
+ * @brief Incremental delay estimator state structure
+ *
+ * Holds the per phase energies of the AEC filter between calls to adec_estimate_delay_incremental() or
+ * adec_estimate_delay_multi(), so that only some of the phases need recalculating every frame. It is initialised with
+ * adec_de_init().
+ *
+ * @ingroup adec_types
+ */
+typedef struct {
+    /** Number of phase energies recalculated every frame. 0 recalculates all of them, which is the same as calling
+     * adec_estimate_delay().*/
+    int32_t phases_per_frame;
+    /** Index of the first phase to recalculate in the next frame, counting the phases of every microphone channel in
+     * turn*/
+    int32_t next_phase;
+    /** Number of filter phases per microphone channel, over all reference channels, that the held phase energies are
+     * for. 0 when there aren't any held phase energies yet.*/
+    int32_t num_phases;
+    /** Number of microphone channels the held phase energies are for*/
+    int32_t num_y_channels;
+    /** Phase energy of all AEC filter phases, from when each phase was last recalculated. Microphone channel y's
+     * phases start at y * AEC_LIB_MAX_PHASES, in the same order as aec_state_t::H_hat[y]*/
+    float_s32_t phase_power[AEC_LIB_MAX_Y_CHANNELS * AEC_LIB_MAX_PHASES];
+}de_state_t;
+
+/**
+ * @brief GCC-PHAT delay estimator state structure
+ *
+ * Holds the decimated input history and the smoothed cross spectrum of the GCC-PHAT delay estimator. It is
+ * initialised with adec_gcc_phat_init().
+ *
+ * @ingroup adec_types
+ */
+typedef struct {
+    /** Circular buffers of the last ADEC_GCC_PHAT_FFT_LENGTH decimated mic and reference samples*/
+    int32_t y_history[ADEC_GCC_PHAT_FFT_LENGTH];
+    int32_t x_history[ADEC_GCC_PHAT_FFT_LENGTH];
+    /** FFT buffers. 2 extra values for the Nyquist bin*/
+    int32_t y_work[ADEC_GCC_PHAT_FFT_LENGTH + 2];
+    int32_t x_work[ADEC_GCC_PHAT_FFT_LENGTH + 2];
+    /** Time smoothed PHAT weighted cross spectrum of mic and reference*/
+    complex_s32_t cross_spectrum_data[ADEC_GCC_PHAT_FFT_LENGTH/2 + 1];
+    bfp_complex_s32_t cross_spectrum;
+    /** Index in the history buffers of the oldest sample*/
+    int32_t history_head;
+    /** Frames processed since initialisation*/
+    int32_t frame_count;
+    /** Cross spectra averaged since initialisation*/
+    int32_t num_blocks;
+}gcc_phat_state_t;
+
+/**
+ * @brief GCC-PHAT delay estimator output structure
+ *
+ * @ingroup adec_types
+ */
+typedef struct {
+    /** Flag indicating there is an estimate, once ADEC_GCC_PHAT_MIN_BLOCKS cross spectra have been averaged over a full
+     * analysis window of input*/
+    int32_t valid;
+    /** Estimated microphone delay in time domain samples, relative to the reference as they are input to the estimator*/
+    int32_t delay_samples;
+    /** Ratio of the cross correlation peak to its average magnitude over all the delays searched. Used to evaluate how
+     * reliable delay_samples is.*/
+    float_s32_t peak_to_average_ratio;
+}gcc_phat_output_t;
+
 /**
  * @brief ADEC output structure
  * 
@@ -81,6 +162,10 @@ typedef struct {
     int32_t delay_estimator_enabled_flag;
     /** Requested delay samples without clamping to +- MAX_DELAY_SAMPLES. Used only for debugging.*/
     int32_t requested_delay_samples_debug;
+    /** Flag indicating that the echoes of different reference channels are at different delays, passed on from
+     * de_output_t::reference_delay_mismatch_flag. Delay corrections then align the earliest echo, so the others need
+     * enough AEC filter phases after it to be cancelled.*/
+    int32_t reference_delay_mismatch_flag;
 } adec_output_t;
 
 /**
@@ -109,6 +194,8 @@ typedef struct {
     aec_to_adec_t from_aec;
     /** Flag indicating if there is activity on reference input channels.*/
     int32_t far_end_active_flag;
+    /** ADEC input from the GCC-PHAT delay estimator. Only used when adec_config_t::use_gcc_phat is set*/
+    gcc_phat_output_t from_gcc_phat;
 }adec_input_t;
 
 /**
@@ -136,6 +223,7 @@ typedef struct {
     int32_t peak_to_average_ratio_valid_flag;
     int32_t gated_milliseconds_since_mode_change; ///< milliseconds elapsed since a delay change was last requested. Used to ensure that delay corrections are not requested too early without allowing enough time for aec filter to converge.
     int32_t last_measured_delay; ///< Last measured delay 
+    int32_t requested_mic_delay; ///< Mic delay most recently requested by ADEC. 0 until ADEC has requested a delay change.
     int32_t peak_power_history_idx; ///< index storing the head of the peak_power_history circular buffer
     int32_t peak_power_history_valid; ///< Flag indicating whether the peak_power_history buffer has been filled at least once.
     int32_t sf_copy_flag; ///< Flag indicating if shadow to main filter copy has happened at least once in the AEC
@@ -1,4 +1,5 @@
 #include <string.h>
+#include <stdlib.h>
 #include <math.h>
 #include <limits.h>
 #include "adec_api.h"
@@ -9,6 +10,8 @@
 void adec_init(adec_state_t *adec_state, adec_config_t *config){
   adec_state->adec_config.bypass = config->bypass;
   adec_state->adec_config.force_de_cycle_trigger = config->force_de_cycle_trigger;
+  adec_state->adec_config.use_refined_delay = config->use_refined_delay;
+  adec_state->adec_config.use_gcc_phat = config->use_gcc_phat;
   adec_state->agm_q24 = ADEC_AGM_HALF;
 
   //Using bits log2(erle) with q7_28 gives us up to 10log(2^127) = 382dB ERLE measurement range.. 
@@ -26,6 +29,7 @@ void adec_init(adec_state_t *adec_state, adec_config_t *config){
   adec_state->mode = ADEC_NORMAL_AEC_MODE;
   adec_state->gated_milliseconds_since_mode_change = 0;
   adec_state->last_measured_delay = 0;
+  adec_state->requested_mic_delay = 0;
 
   for (int i = 0; i < ADEC_PEAK_LINREG_HISTORY_SIZE; i++){
     adec_state->peak_power_history[i] = f64_to_float_s32(0.0);
@@ -59,11 +63,23 @@ void adec_process_frame(
   adec_output->reset_aec_flag = 0;
   adec_output->delay_change_request_flag = 0;
   adec_output->delay_estimator_enabled_flag = (state->mode == ADEC_NORMAL_AEC_MODE) ? 0 : 1;
+  adec_output->reference_delay_mismatch_flag = adec_in->from_de.reference_delay_mismatch_flag;
 
   uint32_t elapsed_milliseconds = 15; //Each frame is 15ms and assuming adec process frame is called every frame since that's the only mode supported
 
   const float_s32_t aec_peak_to_average_good_de_threshold       = ADEC_PEAK_TO_AVERAGE_GOOD_DE;
   const float_s32_t aec_peak_to_average_ruined_aec_threshold    = ADEC_PEAK_TO_AVERAGE_RUINED_AEC;
+
+  //With refined delay, the echo path peak is placed just inside the first filter phase instead of a phase into the filter
+  const int32_t measured_delay = state->adec_config.use_refined_delay ?
+      adec_in->from_de.refined_delay_samples : adec_in->from_de.measured_delay_samples;
+  const int32_t delay_headroom = state->adec_config.use_refined_delay ?
+      ADEC_REFINED_DELAY_HEADROOM_SAMPS : ADEC_DE_DELAY_HEADROOM_SAMPS;
+
+  //from_gcc_phat is only looked at if the application has enabled GCC-PHAT
+  const float_s32_t gcc_phat_good_threshold = f32_to_float_s32(ADEC_GCC_PHAT_GOOD_PEAK_TO_AVERAGE);
+  const unsigned gcc_phat_confident = state->adec_config.use_gcc_phat && adec_in->from_gcc_phat.valid &&
+      float_s32_gte(adec_in->from_gcc_phat.peak_to_average_ratio, gcc_phat_good_threshold);
  
   //The XC AEC, despite being reset, sometimes starts up with some odd phase energies which make it
   //appear there is a strong pk:ave before it converges. These erode as it converges and a genuine peak
@@ -148,20 +164,40 @@ void adec_process_frame(
           state->sf_copy_flag = 1;
         }
         
+        //GCC-PHAT measures the delay from the inputs, so a confident estimate can be acted on straight away without
+        //waiting for the AEC to converge. It is relative to the current mic delay, so the new delay is only requested
+        //if it is far enough from the current one to be worth an AEC reset.
+        if (gcc_phat_confident && adec_in->far_end_active_flag && !state->adec_config.bypass) {
+          int32_t gcc_phat_delay = adec_in->from_gcc_phat.delay_samples - state->requested_mic_delay;
+          int32_t new_mic_delay, new_delay_debug;
+          set_delay_params_from_signed_delay(gcc_phat_delay, delay_headroom, &new_mic_delay, &new_delay_debug);
+          if (abs(new_mic_delay - state->requested_mic_delay) > MILLISECONDS_TO_SAMPLES(ADEC_AEC_ESTIMATE_MIN_MS)) {
+            state->last_measured_delay = gcc_phat_delay;
+#ifdef ENABLE_ADEC_DEBUG_PRINTS
+            printf("GCC-PHAT - Measured delay estimate: %ld (raw %ld)\n", state->last_measured_delay, adec_in->from_gcc_phat.delay_samples); //+ve means MIC delay
+#endif
+            adec_output->requested_mic_delay_samples = new_mic_delay;
+            adec_output->requested_delay_samples_debug = new_delay_debug;
+            adec_output->reset_aec_flag = 1;
+            adec_output->delay_change_request_flag = 1;
+            break;
+          }
+        }
+
         //In normal AEC mode, check to see if we have converged but have left significant tail on the table
         //But only change mode if the delay change is big enough - else reset of AEC not worth it
         if ((state->gated_milliseconds_since_mode_change > ADEC_AEC_DELAY_EST_TIME_MS) &&
           (float_s32_gte(adec_in->from_de.peak_to_average_ratio, state->aec_peak_to_average_good_aec_threshold)) &&
           (state->peak_to_average_ratio_valid_flag == 1) &&
-          (adec_in->from_de.measured_delay_samples > MILLISECONDS_TO_SAMPLES(ADEC_AEC_ESTIMATE_MIN_MS)) &&
+          (measured_delay > MILLISECONDS_TO_SAMPLES(ADEC_AEC_ESTIMATE_MIN_MS)) &&
           (!state->adec_config.bypass)){
 
           //We have a new estimate RELATIVE to current delay settings
-          state->last_measured_delay += adec_in->from_de.measured_delay_samples;
+          state->last_measured_delay += measured_delay;
 #ifdef ENABLE_ADEC_DEBUG_PRINTS
           printf("AEC MODE - Measured delay estimate: %ld (raw %ld)\n", state->last_measured_delay, adec_in->from_de.delay_estimate); //+ve means MIC delay
 #endif
-          set_delay_params_from_signed_delay(state->last_measured_delay, &adec_output->requested_mic_delay_samples, &adec_output->requested_delay_samples_debug);
+          set_delay_params_from_signed_delay(state->last_measured_delay, delay_headroom, &adec_output->requested_mic_delay_samples, &adec_output->requested_delay_samples_debug);
           adec_output->reset_aec_flag = 1;
           state->mode = state->mode; //Same mode (no change)
 
@@ -201,7 +237,8 @@ void adec_process_frame(
                          )
                                         );
 
-          if ((state->agm_q24 < 0 || watchdog_triggered) &&
+          //A confident GCC-PHAT estimate means the delay is already right, so a delay estimation cycle won't help
+          if ((state->agm_q24 < 0 || watchdog_triggered) && !gcc_phat_confident &&
                (state->shadow_flag_counter >= ADEC_SHADOW_FLAG_COUNTER_LIMIT ||
                 state->convergence_counter >= ADEC_CONVERGENCE_COUNTER_LIMIT)) {
 		  
@@ -221,11 +258,11 @@ void adec_process_frame(
 
           //We have come from DE mode with a new estimate and need to reset AEC + adjust delay
           //so switch back to AEC normal mode + set delay from fresh
-          state->last_measured_delay = adec_in->from_de.measured_delay_samples - MAX_DELAY_SAMPLES;
+          state->last_measured_delay = measured_delay - MAX_DELAY_SAMPLES;
 #ifdef ENABLE_ADEC_DEBUG_PRINTS
           printf("DE MODE - Measured delay estimate: %ld (raw %ld)\n", state->last_measured_delay, adec_in->from_de.delay_estimate); //+ve means MIC delay
 #endif
-          set_delay_params_from_signed_delay(state->last_measured_delay, &adec_output->requested_mic_delay_samples, &adec_output->requested_delay_samples_debug);
+          set_delay_params_from_signed_delay(state->last_measured_delay, delay_headroom, &adec_output->requested_mic_delay_samples, &adec_output->requested_delay_samples_debug);
           state->mode = ADEC_NORMAL_AEC_MODE;
           adec_output->delay_estimator_enabled_flag = 0;
            
@@ -243,6 +280,7 @@ void adec_process_frame(
     }
 
   if (adec_output->delay_change_request_flag == 1){
+      state->requested_mic_delay = adec_output->requested_mic_delay_samples;
       reset_stuff_on_AEC_mode_start(state, 1);
   }
 }
@@ -51,10 +51,10 @@ void reset_stuff_on_AEC_mode_start(adec_state_t *adec_state, unsigned set_toggle
   }
 }
 
-void set_delay_params_from_signed_delay(int32_t measured_delay, int32_t *mic_delay_samples, int32_t *requested_delay_debug){
+void set_delay_params_from_signed_delay(int32_t measured_delay, int32_t headroom, int32_t *mic_delay_samples, int32_t *requested_delay_debug){
     //If we see a MIC delay (+ve measured delay), we want to delay Reference by LESS than this to leave some headroom
     //If we see a REF delay (-ve measured delay), we want to delay MIC by MORE than this to leave some headroom
-    int32_t measured_delay_compensated = measured_delay - ADEC_DE_DELAY_HEADROOM_SAMPS;
+    int32_t measured_delay_compensated = measured_delay - headroom;
 
     //Set the requested mic delay to -ve of the measured delay in order to compensate the effect of delay measured in the system
     *mic_delay_samples = -(measured_delay_compensated);
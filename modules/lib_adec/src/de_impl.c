@@ -1,12 +1,36 @@
 // Copyright 2022 XMOS LIMITED.
 // This Software is subject to the terms of the XMOS Public Licence: Version 1.
 
+#include <string.h>
+#include <math.h>
 #include "aec_api.h"
 #include "adec_api.h"
 
-void adec_estimate_delay (
+// Right shift applied to every product when correlating neighbouring bins, so that the sum of AEC_FD_FRAME_LENGTH of
+// them can't overflow
+#define SUB_PHASE_PRODUCT_SHR (10)
+
+/* Offset in samples of the echo path peak from the start of a filter phase.
+ * For an echo path peak d samples into the phase, H[k] is close to exp(-j*2*pi*k*d/AEC_PROC_FRAME_LENGTH) times a
+ * real gain, so the angle of the sum of H[k]*conj(H[k-1]) over all bins is -2*pi*d/AEC_PROC_FRAME_LENGTH.
+ * The exponent of H is common to all the products, so it doesn't affect the angle and is ignored.
+ */
+static int32_t calc_sub_phase_delay(const bfp_complex_s32_t *H)
+{
+    int64_t re = 0, im = 0;
+    for(int k=1; k<H->length; k++) {
+        int64_t a_re = H->data[k].re, a_im = H->data[k].im;
+        int64_t b_re = H->data[k-1].re, b_im = H->data[k-1].im;
+        re += ((a_re * b_re) >> SUB_PHASE_PRODUCT_SHR) + ((a_im * b_im) >> SUB_PHASE_PRODUCT_SHR);
+        im += ((a_im * b_re) >> SUB_PHASE_PRODUCT_SHR) - ((a_re * b_im) >> SUB_PHASE_PRODUCT_SHR);
+    }
+    float angle = atan2f((float)im, (float)re);
+    return (int32_t)lroundf(-angle * (AEC_PROC_FRAME_LENGTH / (2.0f * (float)M_PI)));
+}
+
+// Calculate the delay estimate outputs from the phase energies in de_output->phase_power
+static void summarise_phase_powers(
         de_output_t *de_output,
-        const bfp_complex_s32_t* H_hat, 
         unsigned num_phases)
 {
     //Direct manipulation of mant/exp because f64_to_float_s32(0.0) takes hundreds of cycles
@@ -16,11 +40,9 @@ void adec_estimate_delay (
     float_s32_t peak_fd_power = zero;
     int32_t peak_power_phase_index = 0;
     de_output->sum_phase_powers = zero;
-    
-    for(int ph=0; ph<num_phases; ph++) { //compute delay over 1 x-y pair phases
-        float_s32_t phase_power;
-        aec_calc_freq_domain_energy(&phase_power, &H_hat[ph]);
-        de_output->phase_power[ph] = phase_power;
+
+    for(int ph=0; ph<num_phases; ph++) {
+        float_s32_t phase_power = de_output->phase_power[ph];
         de_output->sum_phase_powers = float_s32_add(de_output->sum_phase_powers, phase_power);
         if(float_s32_gt(phase_power, peak_fd_power)) {
             peak_fd_power = phase_power;
@@ -32,10 +54,161 @@ void adec_estimate_delay (
 
     if(float_s32_gt(de_output->sum_phase_powers, zero)){
         float_s32_t num_phases_s32 = {num_phases, 0};
-        de_output->peak_to_average_ratio = 
+        de_output->peak_to_average_ratio =
                 float_s32_div(float_s32_mul(peak_fd_power, num_phases_s32), de_output->sum_phase_powers);
     }else{
         de_output->peak_to_average_ratio = one;
     }
     de_output->measured_delay_samples = AEC_FRAME_ADVANCE * peak_power_phase_index;
 }
+
+// Per reference outputs when there is only one reference
+static void set_single_reference_outputs(de_output_t *de_output)
+{
+    de_output->x_measured_delay_samples[0] = de_output->measured_delay_samples;
+    de_output->x_peak_to_average_ratio[0] = de_output->peak_to_average_ratio;
+    de_output->reference_delay_mismatch_flag = 0;
+}
+
+void adec_estimate_delay (
+        de_output_t *de_output,
+        const bfp_complex_s32_t* H_hat,
+        unsigned num_phases)
+{
+    for(int ph=0; ph<num_phases; ph++) { //compute delay over 1 x-y pair phases
+        aec_calc_freq_domain_energy(&de_output->phase_power[ph], &H_hat[ph]);
+    }
+    summarise_phase_powers(de_output, num_phases);
+    set_single_reference_outputs(de_output);
+    de_output->refined_delay_samples = de_output->measured_delay_samples +
+        calc_sub_phase_delay(&H_hat[de_output->peak_power_phase_index]);
+}
+
+void adec_de_init(de_state_t *de_state, unsigned phases_per_frame)
+{
+    memset(de_state, 0, sizeof(de_state_t));
+    de_state->phases_per_frame = phases_per_frame;
+}
+
+void adec_estimate_delay_incremental(
+        de_state_t *de_state,
+        de_output_t *de_output,
+        const bfp_complex_s32_t* H_hat,
+        unsigned num_phases)
+{
+    unsigned phases_to_calc = de_state->phases_per_frame;
+    if((phases_to_calc == 0) || (phases_to_calc > num_phases) || (de_state->num_phases != num_phases) ||
+            (de_state->num_y_channels != 1)) {
+        //Held phase energies are for a different filter or there aren't any yet, so start from a full recalculation
+        phases_to_calc = num_phases;
+        de_state->next_phase = 0;
+        de_state->num_phases = num_phases;
+        de_state->num_y_channels = 1;
+    }
+
+    unsigned ph = de_state->next_phase;
+    for(int i=0; i<phases_to_calc; i++) {
+        aec_calc_freq_domain_energy(&de_state->phase_power[ph], &H_hat[ph]);
+        ph = (ph + 1 == num_phases) ? 0 : ph + 1;
+    }
+    de_state->next_phase = ph;
+
+    memcpy(de_output->phase_power, de_state->phase_power, num_phases * sizeof(float_s32_t));
+    summarise_phase_powers(de_output, num_phases);
+    set_single_reference_outputs(de_output);
+    de_output->refined_delay_samples = de_output->measured_delay_samples +
+        calc_sub_phase_delay(&H_hat[de_output->peak_power_phase_index]);
+}
+
+void adec_estimate_delay_multi(
+        de_state_t *de_state,
+        de_output_t *de_output,
+        const bfp_complex_s32_t (*H_hat)[AEC_LIB_MAX_PHASES],
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_phases)
+{
+    const unsigned row_phases = num_x_channels * num_phases;
+    const unsigned total_phases = num_y_channels * row_phases;
+    unsigned phases_to_calc = de_state->phases_per_frame;
+    if((phases_to_calc == 0) || (phases_to_calc > total_phases) || (de_state->num_phases != row_phases) ||
+            (de_state->num_y_channels != num_y_channels)) {
+        //Held phase energies are for a different filter or there aren't any yet, so start from a full recalculation
+        phases_to_calc = total_phases;
+        de_state->next_phase = 0;
+        de_state->num_phases = row_phases;
+        de_state->num_y_channels = num_y_channels;
+    }
+
+    //The phases of every x-y pair share one round robin, so the cost per frame doesn't grow with the number of pairs
+    unsigned ych = de_state->next_phase / row_phases;
+    unsigned ph = de_state->next_phase - (ych * row_phases);
+    for(int i=0; i<phases_to_calc; i++) {
+        aec_calc_freq_domain_energy(&de_state->phase_power[ych*AEC_LIB_MAX_PHASES + ph], &H_hat[ych][ph]);
+        if(++ph == row_phases) {
+            ph = 0;
+            ych = (ych + 1 == num_y_channels) ? 0 : ych + 1;
+        }
+    }
+    de_state->next_phase = (ych * row_phases) + ph;
+
+    //Echo path profile of each reference, summed over the mics, and of all of them together
+    const float_s32_t zero = {0, 0};
+    float_s32_t combined_power[AEC_LIB_MAX_PHASES];
+    float_s32_t x_peak_phase_power[AEC_LIB_MAX_X_CHANNELS];
+    for(int xch=0; xch<num_x_channels; xch++) {
+        for(int p=0; p<num_phases; p++) {
+            //Sums start from the first term, not zero, so that a single x-y pair is bit exact with the other estimators
+            float_s32_t power = de_state->phase_power[xch*num_phases + p];
+            for(int y=1; y<num_y_channels; y++) {
+                power = float_s32_add(power, de_state->phase_power[y*AEC_LIB_MAX_PHASES + xch*num_phases + p]);
+            }
+            de_output->phase_power[p] = power;
+            combined_power[p] = (xch == 0) ? power : float_s32_add(combined_power[p], power);
+        }
+        summarise_phase_powers(de_output, num_phases);
+        de_output->x_measured_delay_samples[xch] = de_output->measured_delay_samples;
+        de_output->x_peak_to_average_ratio[xch] = de_output->peak_to_average_ratio;
+        x_peak_phase_power[xch] = de_output->peak_phase_power;
+    }
+    memcpy(de_output->phase_power, combined_power, num_phases * sizeof(float_s32_t));
+    summarise_phase_powers(de_output, num_phases);
+
+    //Compare the delays of the references whose filters have a clear peak. When they differ, no single delay aligns all
+    //of them, so align to the earliest echo. The later ones then land further into the filter instead of before its start
+    const float_s32_t good_ratio = f32_to_float_s32(ADEC_MULTI_REF_GOOD_PEAK_TO_AVERAGE);
+    int32_t earliest = -1, latest = -1, earliest_xch = 0;
+    for(int xch=0; xch<num_x_channels; xch++) {
+        if(float_s32_gte(de_output->x_peak_to_average_ratio[xch], good_ratio)) {
+            int32_t delay = de_output->x_measured_delay_samples[xch];
+            if((earliest < 0) || (delay < earliest)) {
+                earliest = delay;
+                earliest_xch = xch;
+            }
+            latest = (delay > latest) ? delay : latest;
+        }
+    }
+    de_output->reference_delay_mismatch_flag =
+        (earliest >= 0) && ((latest - earliest) >= (ADEC_MULTI_REF_MISMATCH_PHASES * AEC_FRAME_ADVANCE));
+    if(de_output->reference_delay_mismatch_flag) {
+        //The peak then describes the earliest reference's profile rather than the combined one
+        de_output->measured_delay_samples = earliest;
+        de_output->peak_power_phase_index = earliest / AEC_FRAME_ADVANCE;
+        de_output->peak_phase_power = x_peak_phase_power[earliest_xch];
+    }
+
+    //Refine from the x-y pair with the most energy in the phase the delay is measured to
+    const unsigned delay_phase = de_output->measured_delay_samples / AEC_FRAME_ADVANCE;
+    float_s32_t best_power = zero;
+    const bfp_complex_s32_t *H_peak = &H_hat[0][delay_phase];
+    for(int y=0; y<num_y_channels; y++) {
+        for(int xch=0; xch<num_x_channels; xch++) {
+            unsigned index = xch*num_phases + delay_phase;
+            if(float_s32_gt(de_state->phase_power[y*AEC_LIB_MAX_PHASES + index], best_power)) {
+                best_power = de_state->phase_power[y*AEC_LIB_MAX_PHASES + index];
+                H_peak = &H_hat[y][index];
+            }
+        }
+    }
+    de_output->refined_delay_samples = de_output->measured_delay_samples + calc_sub_phase_delay(H_peak);
+}
@@ -0,0 +1,137 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <math.h>
+#include <stdlib.h>
+#include "aec_api.h"
+#include "adec_api.h"
+
+#define GCC_PHAT_DEC_PER_FRAME (AEC_FRAME_ADVANCE / ADEC_GCC_PHAT_DECIMATION_FACTOR)
+#define GCC_PHAT_NUM_BINS ((ADEC_GCC_PHAT_FFT_LENGTH / 2) + 1)
+#define GCC_PHAT_MAX_LAG (ADEC_GCC_PHAT_MAX_DELAY_SAMPLES / ADEC_GCC_PHAT_DECIMATION_FACTOR)
+// Frames of input needed to fill the analysis window
+#define GCC_PHAT_WINDOW_FRAMES ((ADEC_GCC_PHAT_FFT_LENGTH + GCC_PHAT_DEC_PER_FRAME - 1) / GCC_PHAT_DEC_PER_FRAME)
+// log2 of the ratio of the largest cross spectrum magnitude to the regularisation added to every magnitude before
+// PHAT weighting. Keeps bins with no energy from being weighted up to unit magnitude noise.
+#define GCC_PHAT_REGULARISATION_SHR (20)
+
+#if (AEC_FRAME_ADVANCE % ADEC_GCC_PHAT_DECIMATION_FACTOR) != 0
+#error AEC_FRAME_ADVANCE must be a multiple of ADEC_GCC_PHAT_DECIMATION_FACTOR
+#endif
+#if GCC_PHAT_MAX_LAG >= (ADEC_GCC_PHAT_FFT_LENGTH / 2)
+#error ADEC_GCC_PHAT_MAX_DELAY_SAMPLES does not fit in the GCC-PHAT analysis window
+#endif
+
+// Decimate a frame into the history buffer starting at head. The average of ADEC_GCC_PHAT_DECIMATION_FACTOR samples is used
+// as the anti aliasing filter. It is cheap and, since PHAT weights every bin equally, its passband droop doesn't matter.
+static void decimate_frame(int32_t *history, int32_t head, const int32_t *frame)
+{
+    for(int i=0; i<GCC_PHAT_DEC_PER_FRAME; i++) {
+        int64_t sum = 0;
+        for(int j=0; j<ADEC_GCC_PHAT_DECIMATION_FACTOR; j++) {
+            sum += frame[i*ADEC_GCC_PHAT_DECIMATION_FACTOR + j];
+        }
+        history[(head + i) % ADEC_GCC_PHAT_FFT_LENGTH] = (int32_t)(sum / ADEC_GCC_PHAT_DECIMATION_FACTOR);
+    }
+}
+
+// Copy the history buffer to work oldest sample first and FFT it in place
+static bfp_complex_s32_t* history_fft(bfp_s32_t *temp, int32_t *work, const int32_t *history, int32_t head)
+{
+    memcpy(work, &history[head], (ADEC_GCC_PHAT_FFT_LENGTH - head) * sizeof(int32_t));
+    memcpy(&work[ADEC_GCC_PHAT_FFT_LENGTH - head], history, head * sizeof(int32_t));
+    bfp_s32_init(temp, work, -31, ADEC_GCC_PHAT_FFT_LENGTH, 1);
+    bfp_complex_s32_t *spectrum = bfp_fft_forward_mono(temp);
+    bfp_fft_unpack_mono(spectrum);
+    return spectrum;
+}
+
+static inline int32_t abs_at_lag(const int32_t *r, int32_t lag)
+{
+    int32_t v = r[(lag < 0) ? (ADEC_GCC_PHAT_FFT_LENGTH + lag) : lag];
+    return (v < 0) ? -v : v;
+}
+
+void adec_gcc_phat_init(gcc_phat_state_t *state)
+{
+    memset(state, 0, sizeof(gcc_phat_state_t));
+    bfp_complex_s32_init(&state->cross_spectrum, state->cross_spectrum_data, -31, GCC_PHAT_NUM_BINS, 0);
+    state->cross_spectrum.hr = 31;
+}
+
+void adec_gcc_phat_process_frame(
+        gcc_phat_state_t *state,
+        gcc_phat_output_t *output,
+        const int32_t *y_frame,
+        const int32_t *x_frame,
+        int32_t far_end_active)
+{
+    decimate_frame(state->y_history, state->history_head, y_frame);
+    decimate_frame(state->x_history, state->history_head, x_frame);
+    state->history_head = (state->history_head + GCC_PHAT_DEC_PER_FRAME) % ADEC_GCC_PHAT_FFT_LENGTH;
+    state->frame_count++;
+
+    if(!far_end_active || (state->frame_count % ADEC_GCC_PHAT_HOP_FRAMES) != 0) {
+        return;
+    }
+
+    bfp_s32_t y, x;
+    bfp_complex_s32_t *Y = history_fft(&y, state->y_work, state->y_history, state->history_head);
+    bfp_complex_s32_t *X = history_fft(&x, state->x_work, state->x_history, state->history_head);
+
+    // PHAT weighted cross spectrum, Y.conj(X)/|Y.conj(X)|. X is no longer needed so its memory holds the magnitudes
+    bfp_complex_s32_conj_mul(Y, Y, X);
+    bfp_s32_t mag;
+    bfp_s32_init(&mag, state->x_work, 0, GCC_PHAT_NUM_BINS, 0);
+    bfp_complex_s32_mag(&mag, Y);
+    float_s32_t max_mag = bfp_s32_max(&mag);
+    if(max_mag.mant == 0) {
+        return;
+    }
+    max_mag.exp -= GCC_PHAT_REGULARISATION_SHR;
+    bfp_s32_add_scalar(&mag, &mag, max_mag);
+    bfp_s32_inverse(&mag, &mag);
+    bfp_complex_s32_real_mul(Y, Y, &mag);
+
+    // Average over time to reject uncorrelated near end signals
+    const float_s32_t one_minus_alpha = {Q30(0.875), -30};
+    const float_s32_t alpha = {Q30(0.125), -30};
+    bfp_complex_s32_real_scale(&state->cross_spectrum, &state->cross_spectrum, one_minus_alpha);
+    bfp_complex_s32_real_scale(Y, Y, alpha);
+    bfp_complex_s32_add(&state->cross_spectrum, &state->cross_spectrum, Y);
+    state->num_blocks++;
+
+    // Cross correlation, in the x memory since the averaged cross spectrum needs to be kept
+    bfp_complex_s32_t C;
+    memcpy(state->x_work, state->cross_spectrum.data, GCC_PHAT_NUM_BINS * sizeof(complex_s32_t));
+    bfp_complex_s32_init(&C, (complex_s32_t*)state->x_work, state->cross_spectrum.exp, GCC_PHAT_NUM_BINS, 0);
+    C.hr = state->cross_spectrum.hr;
+    bfp_fft_pack_mono(&C);
+    bfp_s32_t *r = bfp_fft_inverse_mono(&C);
+
+    // The peak may be negative if the echo path inverts the signal, so search the magnitude
+    int32_t peak = 0, peak_lag = 0;
+    int64_t sum = 0;
+    for(int32_t lag=-GCC_PHAT_MAX_LAG; lag<=GCC_PHAT_MAX_LAG; lag++) {
+        int32_t v = abs_at_lag(r->data, lag);
+        sum += v;
+        if(v > peak) {
+            peak = v;
+            peak_lag = lag;
+        }
+    }
+    if(sum == 0) {
+        return;
+    }
+
+    // Parabolic interpolation of the peak position
+    float a = (float)abs_at_lag(r->data, peak_lag - 1);
+    float b = (float)peak;
+    float c = (float)abs_at_lag(r->data, peak_lag + 1);
+    float denom = a - 2.0f*b + c;
+    float offset = (denom != 0.0f) ? (0.5f * (a - c) / denom) : 0.0f;
+
+    output->delay_samples = (int32_t)lroundf(((float)peak_lag + offset) * ADEC_GCC_PHAT_DECIMATION_FACTOR);
+    output->peak_to_average_ratio = f32_to_float_s32((float)peak * (2*GCC_PHAT_MAX_LAG + 1) / (float)sum);
+    output->valid = (state->num_blocks >= ADEC_GCC_PHAT_MIN_BLOCKS) && (state->frame_count >= GCC_PHAT_WINDOW_FRAMES);
+}
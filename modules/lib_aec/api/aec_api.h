@@ -78,6 +78,81 @@ void aec_init(
         unsigned num_main_filter_phases,
         unsigned num_shadow_filter_phases);
 
+/**
+ * @brief Get the memory needed by the AEC for a given configuration
+ *
+ * This function returns the number of bytes of memory pool that aec_init_from_arena() needs for the configuration
+ * passed in. Unlike aec_memory_pool_t and aec_shadow_filt_memory_pool_t which are sized for the compile time maximum
+ * channels and phases, this is the exact footprint of the runtime configuration, so several differently configured AEC
+ * instances can be packed into one memory region.
+ *
+ * The size always includes the shadow filter's per channel buffers, which aec_init_from_arena() sets up whenever it is
+ * given a shadow_state, even one with 0 shadow filter phases. With a NULL shadow_state only the main filter pool at the
+ * start of the arena is used.
+ *
+ * @param[in] num_y_channels              Number of mic input channels
+ * @param[in] num_x_channels              Number of reference input channels
+ * @param[in] num_main_filter_phases      Number of phases in the main filter
+ * @param[in] num_shadow_filter_phases    Number of phases in the shadow filter
+ *
+ * @returns Number of bytes needed for the main and shadow filter memory pools together
+ *
+ * @ingroup aec_func
+ */
+uint32_t aec_get_required_memory(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_shadow_filter_phases);
+
+/**
+ * @brief Initialise AEC data structures using memory from a caller provided arena
+ *
+ * This function does the same initialisation as aec_init(), but the main and shadow filter memory pools are carved
+ * out of a single arena of arena_size bytes. The arena needs to be at least aec_get_required_memory() bytes for this
+ * configuration and start at a double word aligned address.
+ *
+ * shadow_state can be NULL, in which case num_shadow_filter_phases must be 0 and no shadow filter memory is used. A
+ * shadow_state with 0 shadow filter phases still needs the shadow filter's per channel buffers, as counted by
+ * aec_get_required_memory().
+ *
+ * @param[inout] main_state               AEC state structure for holding main filter specific state
+ * @param[inout] shadow_state             AEC state structure for holding shadow filter specific state
+ * @param[inout] shared_state             Shared state structure for holding state that is common to main and shadow filter
+ * @param[inout] arena                    Memory from which the main and shadow filter memory pools are allocated
+ * @param[in] arena_size                  Size of arena in bytes
+ * @param[in] num_y_channels              Number of mic input channels
+ * @param[in] num_x_channels              Number of reference input channels
+ * @param[in] num_main_filter_phases      Number of phases in the main filter
+ * @param[in] num_shadow_filter_phases    Number of phases in the shadow filter
+ *
+ * @returns 0 on success, -1 if the arena is too small or not double word aligned
+ *
+ * @par Example
+ * @code{.c}
+        // A 1x1 instance and a 2x2 instance sharing one arena
+        uint64_t arena[N];
+        uint8_t *mem = (uint8_t*)arena;
+        uint32_t size_1x1 = aec_get_required_memory(1, 1, 10, 0);
+        aec_init_from_arena(&de_main_state, NULL, &de_shared_state, mem, size_1x1, 1, 1, 10, 0);
+        mem += size_1x1;
+        uint32_t size_2x2 = aec_get_required_memory(2, 2, 10, 5);
+        aec_init_from_arena(&main_state, &shadow_state, &shared_state, mem, size_2x2, 2, 2, 10, 5);
+ * @endcode
+ *
+ * @ingroup aec_func
+ */
+int32_t aec_init_from_arena(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        aec_shared_state_t *shared_state,
+        uint8_t *arena,
+        uint32_t arena_size,
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_shadow_filter_phases);
+
 
 /**
  * @brief Initialise AEC data structures for processing a new frame
@@ -213,9 +288,11 @@ void aec_calc_X_fifo_energy(
  * @brief Update X FIFO with the current X frame
  *
  * This function updates the X FIFO by removing the oldest X frame from it and adding the current X frame to it. 
+ * The X FIFO is a circular buffer, so this is done by moving `state->shared_state->X_fifo_head[ch]` back by one phase
+ * and overwriting the oldest frame's data in place.
  * This function also calculates sigmaXX which is the exponential moving average of the current X frame energy
  *
- * @param[inout] state AEC state structure. state->shared_state->X_fifo[ch] and state->shared_state->sigma_XX[ch] are updated.
+ * @param[inout] state AEC state structure. state->shared_state->X_fifo[ch], state->shared_state->X_fifo_head[ch] and state->shared_state->sigma_XX[ch] are updated.
  * @param[in] ch X channel index for which to update X FIFO
  *
  * @ingroup aec_func
@@ -331,6 +408,9 @@ void aec_calc_T(
  * This function updates the adaptive filter spectrum (`H_hat'). It calculates the delta update that is applied to the filter by scaling the X FIFO with the T values computed in `aec_compute_T()` and applies the delta update to `H_hat`.
  * A gradient constraint FFT is then applied to constrain the length of each phase of the filter to avoid wrapping when calculating `y_hat`
  *
+ * When `aec_core_config_params_t::partial_update_phases` is set, only that many phases per x channel are updated,
+ * picked as set by `aec_core_config_params_t::partial_update_mode`.
+ *
  * @param[inout] state AEC state structure. `state->H_hat[y_ch]` is updated
  * @param[in] y_ch mic channel index
  *
@@ -341,19 +421,23 @@ void aec_filter_adapt(
         aec_state_t *state,
         unsigned y_ch);
 
-/** @brief Update the X FIFO alternate BFP structure
+/** @brief Update the filter for one x channel
  *
- * The X FIFO BFP structure is maintained in 2 forms - as a 2 dimensional [x_channels][num_phases] and as a [x_channels * num_phases] 1 dimensional array.
- * This is done in order to optimally access the X FIFO as needed in different functions.
- * After the X FIFO is updated with the current X frame, this function is called in order to copy the 2 dimensional BFP structure into it's 1 dimensional counterpart.
+ * This function does the part of the filter update done by aec_filter_adapt() that uses reference channel x_ch, so
+ * that the update can be split across threads by x channel. It only reads `state->T[x_ch]`, so a thread can calculate
+ * T for an x channel with aec_calc_T() and update that x channel's filter phases without waiting for the other x
+ * channels. Calling this function for every x channel gives the same `H_hat` as one aec_filter_adapt() call.
  *
- * @param[inout] state AEC state structure. `state->X_fifo_1d` is updated
+ * @param[inout] state AEC state structure. The x_ch phases of `state->H_hat[y_ch]` are updated
+ * @param[in] y_ch mic channel index
+ * @param[in] x_ch reference channel index
  *
  * @ingroup aec_func
- *
  */
-void aec_update_X_fifo_1d(
-        aec_state_t *state);
+void aec_filter_adapt_channel(
+        aec_state_t *state,
+        unsigned y_ch,
+        unsigned x_ch);
 
 /** @brief Calculate a correlation metric between the microphone input and estimated microphone signal
  *
@@ -388,6 +472,35 @@ float_s32_t aec_calc_max_input_energy(
         const int32_t (*input_data)[AEC_FRAME_ADVANCE],
         int num_channels);
 
+/** @brief Get the double talk state of a mic channel
+ *
+ * This function classifies the frame that has just been processed from the state that the AEC has already computed,
+ * so it is only a few scalar comparisons and can be passed downstream in place of stages recomputing near and far
+ * end energies.
+ *
+ * The far end is active when the energy of any reference channel is above
+ * `coherence_mu_config_params_t::x_energy_thresh`, below which the filters don't adapt. While the far end is active,
+ * the near end is detected the same way as the adaption freeze in aec_compare_filters_and_calc_mu(): from the
+ * coherence between the mic input and the estimated mic signal dropping, either below
+ * `coherence_mu_config_params_t::coh_thresh_abs` within the last `coherence_mu_config_params_t::mu_coh_time` frames
+ * or below `coherence_mu_config_params_t::coh_thresh_slow` times the lowest slow moving average coherence of all the
+ * mic channels. A coherence drop while the
+ * shadow filter has recently been copied to the main filter is put down to an echo path change instead.
+ *
+ * Until the main filter has converged the coherence is low, so AEC_DT_DOUBLE_TALK can be reported while only the far
+ * end is active.
+ *
+ * @param[in] main_state AEC state structure for the main filter, after aec_compare_filters_and_calc_mu() has been
+ * called for the frame
+ * @param[in] ch mic channel index
+ * @returns aec_double_talk_state_e value for the channel
+ *
+ * @ingroup aec_func
+ */
+aec_double_talk_state_e aec_get_double_talk_state(
+        const aec_state_t *main_state,
+        unsigned ch);
+
 /** @brief Reset parts of aec state structure.
  *
  * This function resets parts of AEC state so that the echo canceller starts adapting from a zero filter.
@@ -399,6 +512,114 @@ float_s32_t aec_calc_max_input_energy(
  */
 void aec_reset_state(aec_state_t *main_state, aec_state_t *shadow_state);
 
+/** @brief Shift the AEC filters in time to follow a change in the delay between the mic and reference inputs.
+ *
+ * This function can be called instead of aec_reset_state() when the application changes the delay applied to the
+ * AEC inputs, so that the AEC keeps its converged filters instead of adapting from zero. Every main and shadow filter
+ * is moved later by delta_samples, or earlier if delta_samples is negative, where delta_samples is the increase in
+ * the mic delay relative to the reference. Filter taps moved past either end of a filter are lost.
+ *
+ * Each filter phase is converted to the time domain and back, so this costs 2 FFTs per phase. The X FIFO is not
+ * changed, so if the delay is changed on the reference input rather than the mic input, the filters are not fully
+ * aligned with it until it has been refilled, num_phases frames later. Delay changes of a whole number of frames are
+ * better followed with aec_shift_filter_phases(), which has neither of these costs.
+ *
+ * @param[inout] main_state pointer to AEC main filter state structure
+ * @param[inout] shadow_state pointer to AEC shadow filter state structure. NULL if there is no shadow filter
+ * @param[in] delta_samples change in the mic delay, in samples
+ *
+ * @ingroup aec_func
+ */
+void aec_shift_filter_samples(aec_state_t *main_state, aec_state_t *shadow_state, int32_t delta_samples);
+
+/** @brief Shift the AEC filters by whole phases to follow a change in the delay between the mic and reference inputs.
+ *
+ * This is the whole frame counterpart of aec_shift_filter_samples(). Since a change of a whole number of frames just
+ * moves the echo path by that many filter phases, the phases are reordered in place, with no FFTs and no data copied.
+ * Phases moved past either end of a filter are reset.
+ *
+ * If the delay change was made on the reference input, the reference history held in the X FIFO has moved too, so
+ * the X FIFO is shifted along with the filters and the X energy recalculated. Each filter phase then stays paired with
+ * the frame of reference it was converged on and the echo estimate carries on unchanged. The X FIFO entries with no
+ * history to take, which are the newest ones when the reference delay is reduced, are cleared.
+ *
+ * @param[inout] main_state pointer to AEC main filter state structure
+ * @param[inout] shadow_state pointer to AEC shadow filter state structure. NULL if there is no shadow filter
+ * @param[in] delta_phases change in the mic delay relative to the reference, in frames
+ * @param[in] reference_delayed 1 if the delay change was made on the reference input, 0 if it was made on the mic
+ * input
+ *
+ * @ingroup aec_func
+ */
+void aec_shift_filter_phases(aec_state_t *main_state, aec_state_t *shadow_state, int32_t delta_phases, int32_t reference_delayed);
+
+/**
+ * @brief Get the size of an AEC snapshot for a given configuration
+ *
+ * @param[in] num_y_channels              Number of mic input channels
+ * @param[in] num_x_channels              Number of reference input channels
+ * @param[in] num_main_filter_phases      Number of phases in the main filter
+ * @param[in] num_shadow_filter_phases    Number of phases in the shadow filter. 0 if there is no shadow filter.
+ *
+ * @returns Number of bytes written by aec_save_snapshot() for this configuration
+ *
+ * @ingroup aec_func
+ */
+uint32_t aec_get_snapshot_size(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_shadow_filter_phases);
+
+/**
+ * @brief Save the converged state of the AEC
+ *
+ * This function writes the main and shadow filters, the sigma_XX spectra and the coherence mu state to snapshot, so
+ * that a later session can start from them with aec_restore_snapshot() instead of from zero filters. Devices that stay
+ * in the same room can then cancel echo straight away after a restart.
+ *
+ * The filters are stored as their time domain taps, which makes a snapshot about half the size of the spectra they are
+ * held as, at the cost of an inverse FFT per filter phase. The reference and mic history and the statistics derived
+ * from it are not saved, since they belong to the session they were captured in. The snapshot is in the byte order of
+ * the device and is only meant to be restored on devices of the same type.
+ *
+ * @param[out] snapshot                   Memory to write the snapshot to
+ * @param[in] snapshot_size               Size of snapshot in bytes
+ * @param[in] main_state                  AEC main filter state structure
+ * @param[in] shadow_state                AEC shadow filter state structure. NULL if there is no shadow filter
+ *
+ * @returns Number of bytes written, which is aec_get_snapshot_size() for the AEC configuration. 0 if snapshot_size is
+ * too small, in which case nothing is written.
+ *
+ * @ingroup aec_func
+ */
+uint32_t aec_save_snapshot(
+        uint8_t *snapshot,
+        uint32_t snapshot_size,
+        const aec_state_t *main_state,
+        const aec_state_t *shadow_state);
+
+/**
+ * @brief Restore the AEC state saved by aec_save_snapshot()
+ *
+ * This function is called after aec_init(), with the AEC initialised in the same configuration the snapshot was saved
+ * in. The snapshot is checked against that configuration before any state is changed.
+ *
+ * @param[inout] main_state               AEC main filter state structure
+ * @param[inout] shadow_state             AEC shadow filter state structure. NULL if there is no shadow filter
+ * @param[in] snapshot                    Snapshot written by aec_save_snapshot()
+ * @param[in] snapshot_size               Size of snapshot in bytes
+ *
+ * @returns 0 on success, -1 if the snapshot is too short, not an AEC snapshot or saved in a different configuration
+ *
+ * @ingroup aec_func
+ */
+int32_t aec_restore_snapshot(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        const uint8_t *snapshot,
+        uint32_t snapshot_size);
+
 /** @brief Detect activity on input channels.
  * 
  * This function implements a quick check for detecting activity on the input channels. It detects signal presence by checking
@@ -413,17 +634,208 @@ void aec_reset_state(aec_state_t *main_state, aec_state_t *shadow_state);
  */
 uint32_t aec_detect_input_activity(const int32_t (*input_data)[AEC_FRAME_ADVANCE], float_s32_t active_threshold, int32_t num_channels);
 
+/**
+ * @brief Get the memory needed by the AEC tail filter for a given configuration
+ *
+ * @param[in] num_y_channels              Number of mic input channels
+ * @param[in] num_x_channels              Number of reference input channels
+ * @param[in] num_main_filter_phases      Number of phases in the main filter
+ * @param[in] num_tail_partitions         Number of tail filter partitions per x-y pair
+ *
+ * @returns Number of bytes of memory pool needed by aec_tail_init()
+ *
+ * @ingroup aec_func
+ */
+uint32_t aec_tail_get_required_memory(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_tail_partitions);
+
+/**
+ * @brief Initialise the AEC tail filter
+ *
+ * The tail filter is an optional non-uniformly partitioned extension of the main filter for rooms with long echo tails.
+ * The main filter models the start of the echo path with short AEC_FRAME_ADVANCE tap phases for low latency, and the
+ * tail filter models the next num_tail_partitions * AEC_TAIL_BLOCK_LENGTH taps with AEC_TAIL_BLOCK_FRAMES times longer
+ * partitions, which are adapted and applied once every AEC_TAIL_BLOCK_FRAMES frames.
+ *
+ * With AEC_TAIL_BLOCK_FRAMES of 2 and 1024 point FFTs, the tail filter does about half the complex multiply accumulates
+ * and FFT work per modelled tap of extending the main filter by the same number of taps. Longer partitions would save
+ * more but need FFTs longer than lib_xcore_math supports by default. test_tail_cost in the AEC unit tests measures the
+ * saving.
+ *
+ * The tail filter starts at the main filter length rounded down to a whole number of blocks, so the main filter needs
+ * at least 2 * AEC_TAIL_BLOCK_FRAMES phases. Choosing a multiple of AEC_TAIL_BLOCK_FRAMES avoids overlap between the
+ * two filters.
+ *
+ * This function needs to be called after aec_init() and whenever the AEC configuration changes.
+ *
+ * @param[inout] tail_state               AEC tail filter state structure
+ * @param[in] main_state                  Initialised AEC main filter state structure
+ * @param[inout] mem_pool                 Memory pool for the tail filter buffers
+ * @param[in] mem_pool_size               Size of mem_pool in bytes
+ * @param[in] num_tail_partitions         Number of tail filter partitions per x-y pair
+ *
+ * @returns 0 on success, -1 if the memory pool is too small or not double word aligned, or the configuration is not
+ * supported
+ *
+ * @par Example
+ * @code{.c}
+        // 8 main filter phases (120ms) followed by 8 tail partitions (240ms)
+        aec_init(&main_state, &shadow_state, &shared_state, aec_mem, aec_shadow_mem, 1, 1, 8, 5);
+        uint32_t tail_size = aec_tail_get_required_memory(1, 1, 8, 8);
+        aec_tail_init(&tail_state, &main_state, tail_mem, tail_size, 8);
+        // every frame
+        aec_tail_remove_echo(&tail_state, y_data);
+        // ... process the frame through the main and shadow filters ...
+        aec_tail_update(&tail_state, &main_state, x_data, output_main);
+ * @endcode
+ *
+ * @ingroup aec_func
+ */
+int32_t aec_tail_init(
+        aec_tail_state_t *tail_state,
+        const aec_state_t *main_state,
+        uint8_t *mem_pool,
+        uint32_t mem_pool_size,
+        unsigned num_tail_partitions);
+
+/**
+ * @brief Remove the tail filter echo estimate from the mic input
+ *
+ * This function needs to be called every frame on the mic input before it is passed to aec_frame_init().
+ *
+ * @param[in] tail_state                  AEC tail filter state structure
+ * @param[inout] y_data                   Mic input frame, updated in place
+ *
+ * @ingroup aec_func
+ */
+void aec_tail_remove_echo(
+        const aec_tail_state_t *tail_state,
+        int32_t (*y_data)[AEC_FRAME_ADVANCE]);
+
+/**
+ * @brief Update the tail filter with the current frame
+ *
+ * This function needs to be called every frame after the main filter has been adapted and the AEC output has been
+ * calculated. It adapts the tail filter on the previous block of AEC output and accumulates the echo estimate for the
+ * next block, processing num_tail_partitions / AEC_TAIL_BLOCK_FRAMES partitions per frame. The tail filter step size
+ * follows the main filter's coherence mu, so it freezes on near end speech along with the main filter. It is reset when
+ * the main filter is replaced by the shadow filter.
+ *
+ * @param[inout] tail_state               AEC tail filter state structure
+ * @param[in] main_state                  AEC main filter state structure
+ * @param[in] x_data                      Reference input frame
+ * @param[in] output_main                 AEC main filter output frame
+ *
+ * @ingroup aec_func
+ */
+void aec_tail_update(
+        aec_tail_state_t *tail_state,
+        const aec_state_t *main_state,
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*output_main)[AEC_FRAME_ADVANCE]);
+
+/** @brief Reset the tail filter
+ *
+ * This function resets the tail filter so that it starts adapting from a zero filter. It should be called along with
+ * aec_reset_state().
+ *
+ * @param[inout] tail_state               AEC tail filter state structure
+ *
+ * @ingroup aec_func
+ */
+void aec_tail_reset(aec_tail_state_t *tail_state);
+
+/**
+ * @brief Initialise the AEC residual echo suppressor
+ *
+ * The residual echo suppressor is an optional extra stage of the main filter output. It suppresses the echo the main
+ * filter leaves behind, for example when the echo path is longer than the filter or has just changed, so that fewer
+ * filter phases give the same perceived echo. It works on the error and echo estimate spectra the AEC calculates
+ * anyway, so it needs one inverse FFT per mic channel instead of the FFT and inverse FFT of a separate stage.
+ *
+ * This function sets res_state->config to its defaults and can be called at any time to reset the suppressor.
+ *
+ * @param[out] res_state                  AEC residual echo suppressor state structure
+ *
+ * @par Example
+ * @code{.c}
+        aec_res_init(&res_state);
+        // every frame, for every mic channel
+        aec_calc_Error_and_Y_hat(&main_state, ch);
+        aec_res_calc_gain(&res_state, &main_state, ch);
+        // ... inverse FFT, coherence, output and forward FFT of the error as usual ...
+        aec_res_calc_output(&res_state, &main_state, &output_main[ch], ch);
+ * @endcode
+ *
+ * @ingroup aec_func
+ */
+void aec_res_init(aec_res_state_t *res_state);
+
+/**
+ * @brief Calculate the residual echo suppression gain for a mic channel
+ *
+ * This function updates the smoothed power spectra of the main filter error and echo estimate and calculates the gain
+ * applied by aec_res_calc_output(). The residual echo power is estimated as the echo estimate power times the leakage,
+ * which is tracked from the correlation of the two power spectra. The leakage is only updated while the coherence
+ * between the mic input and the echo estimate is not below coh_thresh_slow times its slow moving average, since near
+ * end speech would otherwise look like echo leaking through the filter, and a smaller overestimation factor is used
+ * while it is. The coherence is from the previous frame, since the coherence of the current frame is calculated from
+ * the time domain signals.
+ *
+ * This function needs to be called after aec_calc_Error_and_Y_hat() for the main filter and before the inverse FFT of
+ * its Error and Y_hat.
+ *
+ * @param[inout] res_state                AEC residual echo suppressor state structure
+ * @param[in] main_state                  AEC main filter state structure
+ * @param[in] ch                          mic channel index
+ *
+ * @ingroup aec_func
+ */
+void aec_res_calc_gain(
+        aec_res_state_t *res_state,
+        const aec_state_t *main_state,
+        unsigned ch);
+
+/**
+ * @brief Calculate the residual echo suppressed output for a mic channel
+ *
+ * This function applies the gain from aec_res_calc_gain() to the windowed main filter error spectrum and overlap adds
+ * its inverse FFT into output, in the same way that aec_calc_output() does for the unsuppressed error. The main filter
+ * state is not changed, so the filters still adapt on the unsuppressed error.
+ *
+ * This function needs to be called after the main filter error has been transformed back to the frequency domain with
+ * aec_forward_fft() and before aec_compare_filters_and_calc_mu().
+ *
+ * @param[inout] res_state                AEC residual echo suppressor state structure
+ * @param[in] main_state                  AEC main filter state structure
+ * @param[out] output                     Residual echo suppressed output frame
+ * @param[in] ch                          mic channel index
+ *
+ * @ingroup aec_func
+ */
+void aec_res_calc_output(
+        aec_res_state_t *res_state,
+        const aec_state_t *main_state,
+        int32_t (*output)[AEC_FRAME_ADVANCE],
+        unsigned ch);
+
 //TODO pending documentation and examples for L2 APIs
 /**
  * @brief Calculate Error and Y_hat for a channel over a range of bins.
  *
+ * `X_fifo[ch]` points to the `num_phases` X FIFO phases of x channel `ch`, ordered from most recent to least recent,
+ * i.e. `&shared_state->X_fifo[ch][shared_state->X_fifo_head[ch]]`.
+ *
  * @ingroup aec_low_level_func
  */
 void aec_l2_calc_Error_and_Y_hat(
         bfp_complex_s32_t *Error,
         bfp_complex_s32_t *Y_hat,
         const bfp_complex_s32_t *Y,
-        const bfp_complex_s32_t *X_fifo,
+        const bfp_complex_s32_t * const *X_fifo,
         const bfp_complex_s32_t *H_hat,
         unsigned num_x_channels,
         unsigned num_phases,
@@ -83,6 +83,50 @@
  */
 #define AEC_LIB_MAX_PHASES (AEC_LIB_MAX_Y_CHANNELS * AEC_LIB_MAX_X_CHANNELS * 10)
 
+/** @brief Number of AEC frames in one tail filter block
+ * The tail filter extends the main filter to long echo tails using partitions that are AEC_TAIL_BLOCK_FRAMES times
+ * longer than a main filter phase. Its echo estimate and adaption are updated once every AEC_TAIL_BLOCK_FRAMES frames,
+ * with the partition work spread over the frames of a block. See aec_tail_init().
+ *
+ * @ingroup aec_defines
+ */
+#define AEC_TAIL_BLOCK_FRAMES (2)
+
+/** Number of samples in a tail filter block. This is also the number of filter taps modelled by one tail filter
+ * partition.
+ *
+ * @ingroup aec_defines
+ */
+#define AEC_TAIL_BLOCK_LENGTH (AEC_TAIL_BLOCK_FRAMES * AEC_FRAME_ADVANCE)
+
+/** Time domain block length used by the tail filter's block LMS algorithm. Needs to be a power of 2 that is at least
+ * 2 * AEC_TAIL_BLOCK_LENGTH and no longer than the 1024 point FFTs lib_xcore_math supports by default.
+ *
+ * @ingroup aec_defines
+ */
+#define AEC_TAIL_PROC_FRAME_LENGTH (1024)
+
+/** Number of bins of spectrum data computed when doing a DFT of a AEC_TAIL_PROC_FRAME_LENGTH length time domain vector.
+ *
+ * @ingroup aec_defines
+ */
+#define AEC_TAIL_FD_FRAME_LENGTH ((AEC_TAIL_PROC_FRAME_LENGTH / 2) + 1)
+
+/** @brief Maximum total number of tail filter partitions supported in the AEC library
+ * Like AEC_LIB_MAX_PHASES, this is summed across the tail filters for all x-y pairs.
+ *
+ * @ingroup aec_defines
+ */
+#define AEC_TAIL_MAX_PARTITIONS (AEC_LIB_MAX_Y_CHANNELS * AEC_LIB_MAX_X_CHANNELS * 8)
+
+/** Maximum number of reference block spectra held per x channel by the tail filter. The tail filter only keeps the
+ * blocks covering its own partitions, plus the 2 blocks before them and one for the block being adapted on. The blocks
+ * covering the main filter length are kept as time domain samples.
+ *
+ * @ingroup aec_defines
+ */
+#define AEC_TAIL_MAX_FIFO_LENGTH (AEC_TAIL_MAX_PARTITIONS + 3)
+
 /** Overlap data length
  *
  * @ingroup aec_defines
@@ -30,6 +30,14 @@ typedef enum {
     AEC_ADAPTION_FORCE_OFF, ///< Filter adaption always OFF
 } aec_adaption_e;
 
+/**
+ * @ingroup aec_types
+ */
+typedef enum {
+    AEC_PARTIAL_UPDATE_ROUND_ROBIN, ///< Adapt the filter phases in turn
+    AEC_PARTIAL_UPDATE_MAX_ENERGY, ///< Adapt the filter phases whose X FIFO entries have the most energy
+} aec_partial_update_e;
+
 /**
  * @ingroup aec_types
  */
@@ -43,6 +51,15 @@ typedef enum {
     COPY = 2,        ///< shadow filter much better, copy to main
 }shadow_state_e;
 
+/**
+ * @ingroup aec_types
+ */
+typedef enum {
+    AEC_DT_FAR_END_INACTIVE = 0, ///< Too little reference energy to tell near end activity from echo
+    AEC_DT_FAR_END_ONLY = 1,     ///< Far end active and the mic input is explained by the echo estimate
+    AEC_DT_DOUBLE_TALK = 2,      ///< Far end active and the coherence has dropped, so the near end is active too
+}aec_double_talk_state_e;
+
 /**
  * @ingroup aec_types
  */
@@ -117,6 +134,22 @@ typedef struct {
     uint32_t coeff_index;
     /** alpha used while calculating y_ema_energy, x_ema_energy and error_ema_energy.*/
     uq2_30 ema_alpha_q30;
+    /** First bin of the active band. Filtering, adaption and the X energy and normalisation spectrum calculations are
+     * only done for the bins in the active band. Outside it, the mic spectrum is passed to the output unchanged.*/
+    uint32_t active_band_start;
+    /** Number of bins in the active band. The default of AEC_FD_FRAME_LENGTH bins starting at bin 0 processes the
+     * whole spectrum. For example, with a reference band limited to 4kHz, bins 129 to 256 carry no reference energy
+     * and an active band of 129 bins starting at bin 0 halves the per bin work. active_band_start + active_band_length
+     * must not be more than AEC_FD_FRAME_LENGTH. The band should be set before the first frame is processed, since
+     * the X energy of bins outside the band is not tracked.*/
+    uint32_t active_band_length;
+    /** Number of filter phases per x-y pair that are adapted every frame. 0, the default, adapts all of them. Adapting
+     * fewer phases than the filter has saves the per phase update and gradient constraint FFT cycles of the skipped
+     * phases, at the cost of slower convergence. Applies to both main and shadow filter, capped at their number of
+     * phases.*/
+    uint32_t partial_update_phases;
+    /** How the phases adapted every frame are picked when partial_update_phases is not 0.*/
+    aec_partial_update_e partial_update_mode;
 }aec_core_config_params_t;
 
 /**
@@ -173,11 +206,17 @@ typedef struct {
      * Each phase spectrum, pointed to by X_fifo[i][j]->data is stored as a length AEC_FD_FRAME_LENGTH, complex 32bit
      * array.
      *
-     * The phases are ordered from most recent to least recent in the X_fifo. For example, for an AEC configuration of 2
-     * x-channels and 10 phases per x channel, 10 frames of X data spectrum is stored in the X_fifo. For a given x
-     * channel, say x channel 0, X_fifo[0][0] points to the most recent frame's X spectrum and X_fifo[0][9] points to
-     * the last phase, i.e the least recent frame's X spectrum.*/
-    bfp_complex_s32_t X_fifo[AEC_LIB_MAX_X_CHANNELS][AEC_LIB_MAX_PHASES];
+     * The X_fifo is a circular buffer of num_phases entries per x channel, where num_phases is the main filter phase
+     * count. Every frame, X_fifo_head[ch] is moved back by one entry and the newest X spectrum is written there, so no
+     * BFP structures are shuffled around. Entries num_phases to 2*num_phases-1 mirror entries 0 to num_phases-1, so
+     * that &X_fifo[ch][X_fifo_head[ch]] always points to num_phases contiguous entries ordered from most recent to
+     * least recent. For example, for a configuration of 10 phases per x channel, X_fifo[0][X_fifo_head[0]] is the
+     * most recent frame's X spectrum for x channel 0 and X_fifo[0][X_fifo_head[0] + 9] is the least recent frame's X
+     * spectrum.*/
+    bfp_complex_s32_t X_fifo[AEC_LIB_MAX_X_CHANNELS][2*AEC_LIB_MAX_PHASES];
+
+    /** Index of the most recent phase in X_fifo, per x channel.*/
+    unsigned X_fifo_head[AEC_LIB_MAX_X_CHANNELS];
 
     /** BFP array pointing to reference input signal spectrum. The X data values are stored as a length
      * AEC_FD_FRAME_LENGTH complex 32bit array per x channel.*/
@@ -197,13 +236,18 @@ typedef struct {
 
     /** BFP array pointing to time domain mic input values from the previous frame. These are put together with the new
      * samples received in the current frame to make a AEC_PROC_FRAME_LENGTH processing block. The prev_y data values
-     * are stored as length (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE), 32bit integer array per y channel.*/
+     * are stored as length (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE), 32bit integer ring buffer per y channel, with
+     * the oldest sample at index prev_frame_head.*/
     bfp_s32_t prev_y[AEC_LIB_MAX_Y_CHANNELS];
 
     /** BFP array pointing to time domain reference input values from the previous frame. These are put together with
      * the new samples received in the current frame to make a AEC_PROC_FRAME_LENGTH processing block. The prev_x data
-     * values are stored as length (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE), 32bit integer array per x channel.*/
+     * values are stored as length (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE), 32bit integer ring buffer per x channel,
+     * with the oldest sample at index prev_frame_head.*/
     bfp_s32_t prev_x[AEC_LIB_MAX_X_CHANNELS];
+
+    /** Index of the oldest sample in the prev_y and prev_x ring buffers.*/
+    unsigned prev_frame_head;
     
     /** BFP array pointing to sigma_XX values which are the weighted average of the X_energy signal. The sigma_XX data
      * is stored as 32bit integer array of length AEC_FD_FRAME_LENGTH*/
@@ -226,6 +270,10 @@ typedef struct {
     /** Sum of the X_energy across all bins for a given x channel. Stored in a x channels array with every value stored
      * as a 32bit integer mantissa and exponent.*/ 
     float_s32_t sum_X_energy[AEC_LIB_MAX_X_CHANNELS]; 
+
+    /** sum_X_energy of the frame in each X_fifo entry, mirrored and indexed the same way as X_fifo. Used for picking
+     * the phases to adapt in AEC_PARTIAL_UPDATE_MAX_ENERGY mode.*/
+    float_s32_t X_fifo_energy[AEC_LIB_MAX_X_CHANNELS][2*AEC_LIB_MAX_PHASES];
     
     /** Structure containing coherence mu calculation related parameters.*/
     coherence_mu_params_t coh_mu_state[AEC_LIB_MAX_Y_CHANNELS];
@@ -281,15 +329,6 @@ typedef struct {
      * array.*/
     bfp_complex_s32_t H_hat[AEC_LIB_MAX_Y_CHANNELS][AEC_LIB_MAX_PHASES];
 
-    /** BFP array pointing to all phases of reference input spectrum across all x channels. Here, the reference input
-     * spectrum is saved in a 1 dimensional array of phases, with x channel 0 phases followed by x channel 1 phases and
-     * so on.  For example, for a 2 x-channels, 10 phases per x channel configuration, X_fifo_1d[0] to X_fifo_1d[9]
-     * points to the 10 phases for channel 0 and X_fifo[10] to X_fifo[19] points to the 10 phases for channel 1.
-     *
-     * Each X data spectrum phase pointed to by X_fifo_1d[i][j].data is stored as length AEC_FD_FRAME_LENGTH complex
-     * 32bit array.*/
-    bfp_complex_s32_t X_fifo_1d[AEC_LIB_MAX_PHASES];
-
     /** BFP array pointing to T values which are stored as a length AEC_FD_FRAME_LENGTH, complex array per x channel.*/ 
     bfp_complex_s32_t T[AEC_LIB_MAX_X_CHANNELS]; 
 
@@ -341,7 +380,176 @@ typedef struct {
      * num_main_filter_phases or num_shadow_filter_phases, depending on which filter the aec_state_t is instantiated
      * for, passed in aec_init() call.*/
     unsigned num_phases; 
+
+    /** First phase adapted in the current frame when aec_core_config_params_t::partial_update_phases is set and the
+     * phases are adapted round robin. Moved on by partial_update_phases every frame in aec_frame_init().*/
+    unsigned partial_update_offset;
 }aec_state_t;
 //! [aec_state_t]
 
+/**
+ * @brief AEC tail filter state structure.
+ *
+ * Data structures holding the persistent state of the tail filter, which models the part of the echo path beyond the
+ * main filter. The main filter is a uniform partition of AEC_FRAME_ADVANCE tap phases. The tail filter uses partitions
+ * of AEC_TAIL_BLOCK_LENGTH taps, adapted and applied once every AEC_TAIL_BLOCK_FRAMES frames, so a long echo tail costs
+ * a fraction of the MACs and FFTs it would cost as extra main filter phases.
+ *
+ * The tail filter removes its echo estimate from the mic input before it reaches the main filter, and adapts on the AEC
+ * output, so both filters minimise the same error. Its step size is the lowest main filter coherence mu over the block
+ * it adapts on, it doesn't adapt in frames where the main filter adaption is frozen, and it is reset whenever the shadow
+ * filter is copied to the main filter.
+ *
+ * @ingroup aec_types
+ */
+//! [aec_tail_state_t]
+typedef struct {
+    /** BFP array pointing to the tail filter spectrum, stored as a num_y_channels x
+     * (num_x_channels * num_partitions) array in the same order as aec_state_t::H_hat. Partition p of a filter models
+     * taps (start_block + p) * AEC_TAIL_BLOCK_LENGTH to (start_block + p + 1) * AEC_TAIL_BLOCK_LENGTH - 1 of the echo
+     * path. Each partition is stored as a length AEC_TAIL_FD_FRAME_LENGTH complex 32bit array.*/
+    bfp_complex_s32_t H_hat[AEC_LIB_MAX_Y_CHANNELS][AEC_TAIL_MAX_PARTITIONS];
+
+    /** BFP array pointing to the reference block spectra. Every AEC_TAIL_BLOCK_FRAMES frames, the spectrum of the oldest
+     * 2 blocks in x_block is added to the FIFO. This is a circular buffer of fifo_length entries
+     * per x channel, mirrored like aec_shared_state_t::X_fifo so that &X_fifo[ch][X_fifo_head[ch]] always points to
+     * fifo_length contiguous entries ordered from most recent to least recent. Each entry is stored as a length
+     * AEC_TAIL_FD_FRAME_LENGTH complex 32bit array.*/
+    bfp_complex_s32_t X_fifo[AEC_LIB_MAX_X_CHANNELS][2*AEC_TAIL_MAX_FIFO_LENGTH];
+
+    /** Index of the most recent block in X_fifo, per x channel.*/
+    unsigned X_fifo_head[AEC_LIB_MAX_X_CHANNELS];
+
+    /** BFP array pointing to the energy per bin of the reference blocks spanning the echo path covered by the main and
+     * tail filters together. The part covered by the main filter is taken from aec_state_t::X_energy. Stored as a
+     * length AEC_TAIL_FD_FRAME_LENGTH, 32bit integer array per x channel.*/
+    bfp_s32_t X_energy[AEC_LIB_MAX_X_CHANNELS];
+
+    /** BFP array pointing to the tail filter normalisation spectrum. Stored as a length AEC_TAIL_FD_FRAME_LENGTH, 32bit
+     * integer array per x channel.*/
+    bfp_s32_t inv_X_energy[AEC_LIB_MAX_X_CHANNELS];
+
+    /** BFP array pointing to the estimated echo spectrum for the next block, accumulated one partition at a time over
+     * the frames of the current block. Stored as a length AEC_TAIL_FD_FRAME_LENGTH complex 32bit array per y channel.*/
+    bfp_complex_s32_t Y_hat[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** BFP array pointing to the spectrum of the previous block of AEC output, which the tail filter adapts on during
+     * the current block. Stored as a length AEC_TAIL_FD_FRAME_LENGTH complex 32bit array per y channel.*/
+    bfp_complex_s32_t Error[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** BFP array pointing to scratch memory used for T while adapting a partition. Stored as a length
+     * AEC_TAIL_FD_FRAME_LENGTH complex 32bit array.*/
+    bfp_complex_s32_t T;
+
+    /** BFP array pointing to the time domain reference samples of the last start_block blocks, which span the main
+     * filter. Stored as a length start_block * AEC_TAIL_BLOCK_LENGTH, 32bit integer circular buffer per x channel, with
+     * the current block at offset x_block_index * AEC_TAIL_BLOCK_LENGTH.*/
+    bfp_s32_t x_block[AEC_LIB_MAX_X_CHANNELS];
+
+    /** BFP array pointing to the time domain AEC output samples of the current block. Stored as a length
+     * AEC_TAIL_BLOCK_LENGTH, 32bit integer array per y channel.*/
+    bfp_s32_t error_block[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** BFP array pointing to the time domain tail echo estimate for the current block, which is removed from the mic
+     * input. Stored as a length AEC_TAIL_BLOCK_LENGTH, 32bit integer array per y channel.*/
+    bfp_s32_t y_hat_block[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** mu values used for adapting the tail filter in the current block, for every x-y pair. Set to a quarter of
+     * block_mu at the start of every block.*/
+    float_s32_t mu[AEC_LIB_MAX_Y_CHANNELS][AEC_LIB_MAX_X_CHANNELS];
+
+    /** Lowest main filter mu so far in the current block, for every x-y pair.*/
+    float_s32_t block_mu[AEC_LIB_MAX_Y_CHANNELS][AEC_LIB_MAX_X_CHANNELS];
+
+    /** delta parameter used in the tail filter normalisation spectrum calculation.*/
+    float_s32_t delta;
+
+    /** pointer to the state data shared between main and shadow filter.*/
+    aec_shared_state_t *shared_state;
+
+    /** Number of tail filter partitions per x-y pair.*/
+    unsigned num_partitions;
+
+    /** Offset of the tail filter into the echo path, in blocks. This is the main filter length rounded down to a whole
+     * number of blocks.*/
+    unsigned start_block;
+
+    /** Number of X_fifo entries per x channel. This is num_partitions + 3.*/
+    unsigned fifo_length;
+
+    /** Index of the current frame within the current block.*/
+    unsigned frame_index;
+
+    /** Block of x_block that holds the current block's reference samples.*/
+    unsigned x_block_index;
+}aec_tail_state_t;
+//! [aec_tail_state_t]
+
+/**
+ * @brief AEC residual echo suppressor configuration structure.
+ *
+ * Set to defaults by aec_res_init() and available to be modified by the application for run time control.
+ *
+ * @ingroup aec_types
+ */
+typedef struct {
+    /** The error and echo estimate power spectra are smoothed with a coefficient of 1 - pow(2, -psd_smoothing_shr)
+     * per frame.*/
+    uint32_t psd_smoothing_shr;
+    /** The echo leakage estimate is updated with a coefficient of pow(2, -leak_update_shr) per frame.*/
+    uint32_t leak_update_shr;
+    /** Largest fraction of the echo estimate power that is expected to be left in the AEC error.*/
+    float_s32_t max_leak;
+    /** Factor the residual echo estimate is overestimated by when there is no double talk.*/
+    float_s32_t overdrive;
+    /** Factor the residual echo estimate is overestimated by during double talk, so that less of the near end is
+     * suppressed.*/
+    float_s32_t double_talk_overdrive;
+    /** Lowest gain applied to any bin.*/
+    float_s32_t min_gain;
+}aec_res_config_t;
+
+/**
+ * @brief AEC residual echo suppressor state structure.
+ *
+ * The residual echo suppressor removes the echo left in the main filter output by echo path changes, a filter
+ * shorter than the echo path and the non linearities the filter can't model. It estimates the residual echo power
+ * per bin as a fraction, the leakage, of the main filter echo estimate power and applies a Wiener like gain to the
+ * error spectrum. The AEC has the error and echo estimate spectra anyway, so this costs an inverse FFT per mic channel
+ * and a few vector operations, rather than a separate frequency domain stage after the AEC.
+ *
+ * @ingroup aec_types
+ */
+//! [aec_res_state_t]
+typedef struct {
+    /** BFP array pointing to the smoothed power spectrum of the main filter error. Stored as a length
+     * AEC_FD_FRAME_LENGTH, 32bit integer array per y channel.*/
+    bfp_s32_t Error_psd[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** BFP array pointing to the smoothed power spectrum of the main filter echo estimate. Stored as a length
+     * AEC_FD_FRAME_LENGTH, 32bit integer array per y channel.*/
+    bfp_s32_t Y_hat_psd[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** BFP array pointing to the gain applied to the error spectrum in the current frame. Stored as a length
+     * AEC_FD_FRAME_LENGTH, 32bit integer array per y channel.*/
+    bfp_s32_t gain[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** BFP array pointing to the last AEC_UNUSED_TAPS_PER_PHASE*2 samples of the previous frame's suppressed output,
+     * which overlap with the current frame's. Stored as a 32bit integer array per y channel.*/
+    bfp_s32_t overlap[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** Estimated fraction of the echo estimate power left in the main filter error, per y channel.*/
+    float_s32_t leak[AEC_LIB_MAX_Y_CHANNELS];
+
+    /** Residual echo suppressor configuration.*/
+    aec_res_config_t config;
+
+    /** Memory for the BFP arrays above.*/
+    int32_t Error_psd_data[AEC_LIB_MAX_Y_CHANNELS][AEC_FD_FRAME_LENGTH];
+    int32_t Y_hat_psd_data[AEC_LIB_MAX_Y_CHANNELS][AEC_FD_FRAME_LENGTH];
+    int32_t gain_data[AEC_LIB_MAX_Y_CHANNELS][AEC_FD_FRAME_LENGTH];
+    int32_t overlap_data[AEC_LIB_MAX_Y_CHANNELS][AEC_UNUSED_TAPS_PER_PHASE*2];
+}aec_res_state_t;
+//! [aec_res_state_t]
+
 #endif
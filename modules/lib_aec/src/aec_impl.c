@@ -22,6 +22,50 @@ void aec_init(
     aec_priv_shadow_init(shadow_state, shared_state, shadow_mem_pool, num_shadow_filter_phases);
 }
 
+uint32_t aec_get_required_memory(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_shadow_filter_phases)
+{
+    uint32_t main_size = aec_priv_main_memory_required(num_y_channels, num_x_channels, num_main_filter_phases);
+    //aec_priv_shadow_init() sets up the shadow filter's Error, Y_hat, T, energy and overlap buffers for any shadow state,
+    //even one with 0 phases, so they are always counted
+    uint32_t shadow_size = aec_priv_shadow_memory_required(num_y_channels, num_x_channels, num_shadow_filter_phases);
+    return AEC_MEM_ALIGN(main_size) + shadow_size;
+}
+
+int32_t aec_init_from_arena(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        aec_shared_state_t *shared_state,
+        uint8_t *arena,
+        uint32_t arena_size,
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_shadow_filter_phases)
+{
+    if(((uintptr_t)arena & 0x7) != 0) {
+        return -1;
+    }
+    if((shadow_state == NULL) && (num_shadow_filter_phases != 0)) {
+        return -1;
+    }
+    //Shadow filter pool follows the main filter pool, starting on a double word boundary. Without a shadow state only the
+    //main filter pool is used
+    uint32_t main_size = AEC_MEM_ALIGN(aec_priv_main_memory_required(num_y_channels, num_x_channels, num_main_filter_phases));
+    uint32_t required = (shadow_state == NULL) ? main_size :
+        aec_get_required_memory(num_y_channels, num_x_channels, num_main_filter_phases, num_shadow_filter_phases);
+    if(arena_size < required) {
+        return -1;
+    }
+    uint8_t *shadow_mem_pool = arena + main_size;
+    aec_init(main_state, shadow_state, shared_state, arena, shadow_mem_pool,
+            num_y_channels, num_x_channels, num_main_filter_phases, num_shadow_filter_phases);
+    return 0;
+}
+
 void aec_frame_init(
         aec_state_t *main_state,
         aec_state_t *shadow_state,
@@ -31,49 +75,30 @@ void aec_frame_init(
     unsigned num_y_channels = main_state->shared_state->num_y_channels;
     unsigned num_x_channels = main_state->shared_state->num_x_channels;
 
+    /* prev_y and prev_x are ring buffers of the last (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE) input samples, with the
+     * oldest sample at prev_frame_head. The processing block is assembled straight from the ring and the new samples
+     * then overwrite the oldest ones, so the history is never shifted.
+     */
+    unsigned head = main_state->shared_state->prev_frame_head;
     // y frame 
     for(unsigned ch=0; ch<num_y_channels; ch++) {
-        /* Create 512 samples frame */
-        // Copy previous y samples
-        memcpy(main_state->shared_state->y[ch].data, main_state->shared_state->prev_y[ch].data, (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE)*sizeof(int32_t));
-        // Copy current y samples
-        memcpy(&main_state->shared_state->y[ch].data[AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE], &y_data[ch][0], (AEC_FRAME_ADVANCE)*sizeof(int32_t));
-        // Update exp just in case
-        main_state->shared_state->y[ch].exp = AEC_INPUT_EXP;
-        // Update headroom
-        bfp_s32_headroom(&main_state->shared_state->y[ch]);
-
-        /* Update previous samples */
-        // Copy the last 32 samples to the beginning
-        memcpy(main_state->shared_state->prev_y[ch].data, &main_state->shared_state->prev_y[ch].data[AEC_FRAME_ADVANCE], (AEC_PROC_FRAME_LENGTH - (2*AEC_FRAME_ADVANCE))*sizeof(int32_t));
-        // Copy current frame to previous
-        memcpy(&main_state->shared_state->prev_y[ch].data[(AEC_PROC_FRAME_LENGTH - (2*AEC_FRAME_ADVANCE))], &y_data[ch][0], AEC_FRAME_ADVANCE*sizeof(int32_t));
-        // Update headroom
-        bfp_s32_headroom(&main_state->shared_state->prev_y[ch]);
-        // Update exp just in case
-        main_state->shared_state->prev_y[ch].exp = AEC_INPUT_EXP;
+        aec_priv_frame_init_channel(&main_state->shared_state->y[ch], main_state->shared_state->prev_y[ch].data, head, &y_data[ch][0]);
     }
     // x frame 
     for(unsigned ch=0; ch<num_x_channels; ch++) {
-        /* Create 512 samples frame */
-        // Copy previous x samples
-        memcpy(main_state->shared_state->x[ch].data, main_state->shared_state->prev_x[ch].data, (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE)*sizeof(int32_t));
-        // Copy current x samples
-        memcpy(&main_state->shared_state->x[ch].data[AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE], &x_data[ch][0], (AEC_FRAME_ADVANCE)*sizeof(int32_t));
-        // Update exp just in case
-        main_state->shared_state->x[ch].exp = AEC_INPUT_EXP;
-        // Update headroom
-        bfp_s32_headroom(&main_state->shared_state->x[ch]);
-
-        /* Update previous samples */
-        // Copy the last 32 samples to the beginning
-        memcpy(main_state->shared_state->prev_x[ch].data, &main_state->shared_state->prev_x[ch].data[AEC_FRAME_ADVANCE], (AEC_PROC_FRAME_LENGTH - (2*AEC_FRAME_ADVANCE))*sizeof(int32_t));
-        // Copy current frame to previous
-        memcpy(&main_state->shared_state->prev_x[ch].data[(AEC_PROC_FRAME_LENGTH - (2*AEC_FRAME_ADVANCE))], &x_data[ch][0], AEC_FRAME_ADVANCE*sizeof(int32_t));
-        // Update exp just in case
-        main_state->shared_state->prev_x[ch].exp = AEC_INPUT_EXP;
-        // Update headroom
-        bfp_s32_headroom(&main_state->shared_state->prev_x[ch]);
+        aec_priv_frame_init_channel(&main_state->shared_state->x[ch], main_state->shared_state->prev_x[ch].data, head, &x_data[ch][0]);
+    }
+    head += AEC_FRAME_ADVANCE;
+    if(head >= (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE)) {
+        head -= (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE);
+    }
+    main_state->shared_state->prev_frame_head = head;
+
+    //Move the round robin partial update schedule on to the next set of phases
+    unsigned num_adapt = main_state->shared_state->config_params.aec_core_conf.partial_update_phases;
+    main_state->partial_update_offset = (main_state->partial_update_offset + num_adapt) % main_state->num_phases;
+    if((shadow_state != NULL) && (shadow_state->num_phases != 0)) {
+        shadow_state->partial_update_offset = (shadow_state->partial_update_offset + num_adapt) % shadow_state->num_phases;
     }
 
     //Initialise T
@@ -129,6 +154,43 @@ float_s32_t aec_calc_max_input_energy(const int32_t (*input_data)[AEC_FRAME_ADVA
     return max;
 }
 
+aec_double_talk_state_e aec_get_double_talk_state(
+        const aec_state_t *main_state,
+        unsigned ch)
+{
+    const aec_shared_state_t *shared_state = main_state->shared_state;
+    const coherence_mu_config_params_t *coh_conf = &shared_state->config_params.coh_mu_conf;
+    const coherence_mu_params_t *coh_mu_state = &shared_state->coh_mu_state[ch];
+    if(shared_state->config_params.aec_core_conf.bypass) {
+        return AEC_DT_FAR_END_INACTIVE;
+    }
+    unsigned far_end_active = 0;
+    for(unsigned x_ch=0; x_ch<shared_state->num_x_channels; x_ch++) {
+        if(float_s32_gt(shared_state->sum_X_energy[x_ch], coh_conf->x_energy_thresh)) {
+            far_end_active = 1;
+        }
+    }
+    if(!far_end_active) {
+        return AEC_DT_FAR_END_INACTIVE;
+    }
+    if(coh_mu_state->mu_shad_count > 0) {
+        //Shadow filter copied recently, so the echo path has changed and the main filter is catching up
+        return AEC_DT_FAR_END_ONLY;
+    }
+    //Same threshold as the adaption freeze, which is relative to the lowest slow moving coherence of all mic channels
+    float_s32_t min_coh_slow = shared_state->coh_mu_state[0].coh_slow;
+    for(unsigned y_ch=1; y_ch<shared_state->num_y_channels; y_ch++) {
+        if(float_s32_gt(min_coh_slow, shared_state->coh_mu_state[y_ch].coh_slow)) {
+            min_coh_slow = shared_state->coh_mu_state[y_ch].coh_slow;
+        }
+    }
+    float_s32_t coh_thresh = float_s32_mul(min_coh_slow, coh_conf->coh_thresh_slow);
+    if((coh_mu_state->mu_coh_count > 0) || float_s32_gt(coh_thresh, coh_mu_state->coh)) {
+        return AEC_DT_DOUBLE_TALK;
+    }
+    return AEC_DT_FAR_END_ONLY;
+}
+
 void aec_forward_fft(
         bfp_complex_s32_t *output,
         bfp_s32_t *input)
@@ -144,6 +206,51 @@ void aec_forward_fft(
     input->length = len;
 }
 
+//Newest to oldest phase window into the circular X FIFO of each x channel
+static void get_X_fifo_windows(
+        const bfp_complex_s32_t **X_fifo,
+        aec_shared_state_t *shared_state)
+{
+    for(unsigned ch=0; ch<shared_state->num_x_channels; ch++) {
+        X_fifo[ch] = &shared_state->X_fifo[ch][shared_state->X_fifo_head[ch]];
+    }
+}
+
+//Bins [start, start + length) that are processed. Returns 0 if that is the whole spectrum
+static unsigned get_active_band(
+        const aec_shared_state_t *shared_state,
+        unsigned *start,
+        unsigned *length)
+{
+    const aec_core_config_params_t *core_conf = &shared_state->config_params.aec_core_conf;
+    *start = core_conf->active_band_start;
+    *length = core_conf->active_band_length;
+    assert((*length > 0) && ((*start + *length) <= AEC_FD_FRAME_LENGTH));
+    return !((*start == 0) && (*length == AEC_FD_FRAME_LENGTH));
+}
+
+//BFP structures pointing to the active band of a full spectrum. Headroom is not recalculated, same as in
+//aec_l2_calc_Error_and_Y_hat(), so the results are the same whichever way the spectrum is split up
+static void complex_band(
+        bfp_complex_s32_t *band,
+        const bfp_complex_s32_t *full,
+        unsigned start,
+        unsigned length)
+{
+    bfp_complex_s32_init(band, &full->data[start], full->exp, length, 0);
+    band->hr = full->hr;
+}
+
+static void real_band(
+        bfp_s32_t *band,
+        const bfp_s32_t *full,
+        unsigned start,
+        unsigned length)
+{
+    bfp_s32_init(band, &full->data[start], full->exp, length, 0);
+    band->hr = full->hr;
+}
+
 //per x-channel
 //API: calculate X-energy (per x-channel)
 void aec_calc_X_fifo_energy(
@@ -158,7 +265,24 @@ void aec_calc_X_fifo_energy(
     bfp_s32_t *X_energy_ptr = &state->X_energy[ch];
     bfp_complex_s32_t *X_ptr = &state->shared_state->X[ch];
     float_s32_t *max_X_energy_ptr = &state->max_X_energy[ch];
-    aec_priv_update_total_X_energy(X_energy_ptr, max_X_energy_ptr, &state->shared_state->X_fifo[ch][0], X_ptr, state->num_phases, recalc_bin);
+    const bfp_complex_s32_t *X_fifo_ptr = &state->shared_state->X_fifo[ch][state->shared_state->X_fifo_head[ch]];
+    unsigned start, length;
+    if(!get_active_band(state->shared_state, &start, &length)) {
+        aec_priv_update_total_X_energy(X_energy_ptr, max_X_energy_ptr, X_fifo_ptr, X_ptr, state->num_phases, recalc_bin);
+        return;
+    }
+    //X_energy is only tracked in the active band, so bins outside of it are left as they are
+    bfp_s32_t X_energy_band;
+    bfp_complex_s32_t X_band, X_fifo_band[AEC_LIB_MAX_PHASES];
+    real_band(&X_energy_band, X_energy_ptr, start, length);
+    complex_band(&X_band, X_ptr, start, length);
+    for(unsigned ph=0; ph<state->num_phases; ph++) {
+        complex_band(&X_fifo_band[ph], &X_fifo_ptr[ph], start, length);
+    }
+    //recalc_bin goes over the whole spectrum, so fold it into the band
+    aec_priv_update_total_X_energy(&X_energy_band, max_X_energy_ptr, X_fifo_band, &X_band, state->num_phases, recalc_bin % length);
+    X_energy_ptr->exp = X_energy_band.exp;
+    X_energy_ptr->hr = X_energy_band.hr;
 }
 //per x-channel
 void aec_update_X_fifo_and_calc_sigmaXX(
@@ -169,7 +293,24 @@ void aec_update_X_fifo_and_calc_sigmaXX(
     bfp_complex_s32_t *X_ptr = &state->shared_state->X[ch];
     uint32_t sigma_xx_shift = state->shared_state->config_params.aec_core_conf.sigma_xx_shift;
     float_s32_t *sum_X_energy_ptr = &state->shared_state->sum_X_energy[ch]; //This needs to be done only for main filter, so doing it here instead of in aec_calc_X_fifo_energy
-    aec_priv_update_X_fifo_and_calc_sigmaXX(&state->shared_state->X_fifo[ch][0], sigma_XX_ptr, sum_X_energy_ptr, X_ptr, state->num_phases, sigma_xx_shift);
+    unsigned start, length;
+    if(!get_active_band(state->shared_state, &start, &length)) {
+        aec_priv_update_X_fifo_and_calc_sigmaXX(&state->shared_state->X_fifo[ch][0], &state->shared_state->X_fifo_head[ch], sigma_XX_ptr, sum_X_energy_ptr, X_ptr, state->num_phases, sigma_xx_shift);
+    }
+    else {
+        aec_priv_update_X_fifo(&state->shared_state->X_fifo[ch][0], &state->shared_state->X_fifo_head[ch], X_ptr, state->num_phases);
+        bfp_s32_t sigma_XX_band;
+        bfp_complex_s32_t X_band;
+        real_band(&sigma_XX_band, sigma_XX_ptr, start, length);
+        complex_band(&X_band, X_ptr, start, length);
+        aec_priv_calc_sigma_XX(&sigma_XX_band, sum_X_energy_ptr, &X_band, sigma_xx_shift);
+        sigma_XX_ptr->exp = sigma_XX_band.exp;
+        sigma_XX_ptr->hr = sigma_XX_band.hr;
+    }
+    //Keep the energy of every X_fifo entry for picking the phases to adapt in partial update mode
+    unsigned head = state->shared_state->X_fifo_head[ch];
+    state->shared_state->X_fifo_energy[ch][head] = *sum_X_energy_ptr;
+    state->shared_state->X_fifo_energy[ch][head + state->num_phases] = *sum_X_energy_ptr;
 }
 
 //per y-channel
@@ -184,7 +325,27 @@ void aec_calc_Error_and_Y_hat(
     bfp_complex_s32_t *Y_hat_ptr = &state->Y_hat[ch];
     bfp_complex_s32_t *Error_ptr = &state->Error[ch];
     int32_t bypass_enabled = state->shared_state->config_params.aec_core_conf.bypass;
-    aec_priv_calc_Error_and_Y_hat(Error_ptr, Y_hat_ptr, Y_ptr, state->X_fifo_1d, state->H_hat[ch], state->shared_state->num_x_channels, state->num_phases, bypass_enabled);
+    const bfp_complex_s32_t *X_fifo[AEC_LIB_MAX_X_CHANNELS];
+    get_X_fifo_windows(X_fifo, state->shared_state);
+    unsigned start, length;
+    if(!get_active_band(state->shared_state, &start, &length)) {
+        aec_priv_calc_Error_and_Y_hat(Error_ptr, Y_hat_ptr, Y_ptr, X_fifo, state->H_hat[ch], state->shared_state->num_x_channels, state->num_phases, bypass_enabled);
+        return;
+    }
+    //Y_hat is zeroed in aec_frame_init() so outside the active band it stays 0, and Error is Y there
+    bfp_complex_s32_t Error_band, Y_hat_band;
+    complex_band(&Y_hat_band, Y_hat_ptr, start, length);
+    complex_band(&Error_band, Error_ptr, start, length);
+    aec_l2_calc_Error_and_Y_hat(&Error_band, &Y_hat_band, Y_ptr, X_fifo, state->H_hat[ch], state->shared_state->num_x_channels, state->num_phases, start, length, bypass_enabled);
+    Y_hat_ptr->exp = Y_hat_band.exp;
+    Y_hat_ptr->hr = Y_hat_band.hr;
+
+    unsigned end = start + length;
+    memcpy(Error_ptr->data, Y_ptr->data, start*sizeof(complex_s32_t));
+    memcpy(&Error_ptr->data[end], &Y_ptr->data[end], (AEC_FD_FRAME_LENGTH - end)*sizeof(complex_s32_t));
+    Error_ptr->exp = Y_ptr->exp;
+    Error_ptr->hr = Y_ptr->hr;
+    aec_priv_bfp_complex_s32_merge_band(Error_ptr, &Error_band, start);
 }
 
 void aec_inverse_fft(
@@ -207,9 +368,10 @@ float_s32_t aec_calc_corr_factor(
     // We need yhat[240:480-32] and y[240:480-32]
     int frame_window = 32;
 
-    // y[240:480] is prev_y[0:240].
+    // y[240:480] is the oldest AEC_FRAME_ADVANCE samples in the prev_y ring buffer.
+    int32_t DWORD_ALIGNED y_scratch[AEC_FRAME_ADVANCE];
     bfp_s32_t y_subset;
-    bfp_s32_init(&y_subset, state->shared_state->prev_y[ch].data, state->shared_state->prev_y[ch].exp, AEC_FRAME_ADVANCE-frame_window, 1);
+    aec_priv_get_oldest_prev_samples(&y_subset, y_scratch, &state->shared_state->prev_y[ch], state->shared_state->prev_frame_head, AEC_FRAME_ADVANCE-frame_window);
 
     bfp_s32_t yhat_subset;
     bfp_s32_init(&yhat_subset, &state->y_hat[ch].data[AEC_FRAME_ADVANCE], state->y_hat[ch].exp, AEC_FRAME_ADVANCE-frame_window, 1);
@@ -230,9 +392,10 @@ void aec_calc_coherence(
     bfp_s32_t y_hat_subset;
     bfp_s32_init(&y_hat_subset, &state->y_hat[ch].data[AEC_FRAME_ADVANCE], state->y_hat[ch].exp, AEC_FRAME_ADVANCE, 1);
 
-    //y[240:480] is prev_y[0:240]. Create a temporary bfp_s32_t to point to prev_y[0:240]
+    //y[240:480] is the oldest AEC_FRAME_ADVANCE samples in the prev_y ring buffer
+    int32_t DWORD_ALIGNED y_scratch[AEC_FRAME_ADVANCE];
     bfp_s32_t temp;
-    bfp_s32_init(&temp, state->shared_state->prev_y[ch].data, state->shared_state->prev_y[ch].exp, AEC_FRAME_ADVANCE, 1);
+    aec_priv_get_oldest_prev_samples(&temp, y_scratch, &state->shared_state->prev_y[ch], state->shared_state->prev_frame_head, AEC_FRAME_ADVANCE);
 
     aec_priv_calc_coherence(coh_mu_state_ptr, &temp, &y_hat_subset, &state->shared_state->config_params);
 }
@@ -286,12 +449,27 @@ void aec_calc_normalisation_spectrum(
     bfp_s32_t *sigma_XX_ptr = &state->shared_state->sigma_XX[ch];
     bfp_s32_t *X_energy_ptr = &state->X_energy[ch];
     unsigned normdenom_apply_factor_of_2 = 0;
-    aec_priv_calc_inv_X_energy(&state->inv_X_energy[ch], X_energy_ptr, sigma_XX_ptr, &state->shared_state->config_params, state->delta, is_shadow, normdenom_apply_factor_of_2);
+    unsigned start, length;
+    if(!get_active_band(state->shared_state, &start, &length)) {
+        aec_priv_calc_inv_X_energy(&state->inv_X_energy[ch], X_energy_ptr, sigma_XX_ptr, &state->shared_state->config_params, state->delta, is_shadow, normdenom_apply_factor_of_2);
+        return;
+    }
+    //inv_X_energy is only used in the active band
+    bfp_s32_t inv_X_energy_band, X_energy_band, sigma_XX_band;
+    real_band(&inv_X_energy_band, &state->inv_X_energy[ch], start, length);
+    real_band(&X_energy_band, X_energy_ptr, start, length);
+    real_band(&sigma_XX_band, sigma_XX_ptr, start, length);
+    aec_priv_calc_inv_X_energy(&inv_X_energy_band, &X_energy_band, &sigma_XX_band, &state->shared_state->config_params, state->delta, is_shadow, normdenom_apply_factor_of_2);
+    state->inv_X_energy[ch].exp = inv_X_energy_band.exp;
+    state->inv_X_energy[ch].hr = inv_X_energy_band.hr;
 }
 
-void aec_filter_adapt(
+//Adapt the filter of y channel y_ch for x channels x_start to x_start + num_x_channels - 1
+static void filter_adapt_x_channels(
         aec_state_t *state,
-        unsigned y_ch)
+        unsigned y_ch,
+        unsigned x_start,
+        unsigned num_x_channels)
 {
     if(state == NULL) {
         return;
@@ -299,9 +477,48 @@ void aec_filter_adapt(
     if(state->shared_state->config_params.aec_core_conf.bypass) {
         return;
     }
-    bfp_complex_s32_t *T_ptr = &state->T[0];
+    bfp_complex_s32_t *T_ptr = &state->T[x_start];
+    bfp_complex_s32_t *H_hat_ptr = &state->H_hat[y_ch][x_start * state->num_phases];
+
+    const bfp_complex_s32_t *X_fifo[AEC_LIB_MAX_X_CHANNELS];
+    get_X_fifo_windows(X_fifo, state->shared_state);
+    unsigned start, length;
+    unsigned band_limited = get_active_band(state->shared_state, &start, &length);
+    const aec_core_config_params_t *core_conf = &state->shared_state->config_params.aec_core_conf;
+    unsigned num_adapt = core_conf->partial_update_phases;
+    if((num_adapt != 0) && (num_adapt < state->num_phases)) {
+        unsigned phases[AEC_LIB_MAX_X_CHANNELS][AEC_LIB_MAX_PHASES];
+        for(unsigned ch=0; ch<num_x_channels; ch++) {
+            const float_s32_t *X_fifo_energy = &state->shared_state->X_fifo_energy[x_start + ch][state->shared_state->X_fifo_head[x_start + ch]];
+            aec_priv_select_adapt_phases(phases[ch], X_fifo_energy, state->num_phases, num_adapt, state->partial_update_offset, core_conf->partial_update_mode);
+        }
+        aec_priv_filter_adapt_phases(H_hat_ptr, &X_fifo[x_start], T_ptr, num_x_channels, state->num_phases,
+                (const unsigned (*)[AEC_LIB_MAX_PHASES])phases, num_adapt, start, length);
+        return;
+    }
+    if(!band_limited) {
+        aec_priv_filter_adapt(H_hat_ptr, &X_fifo[x_start], T_ptr, num_x_channels, state->num_phases);
+        return;
+    }
+    aec_priv_filter_adapt_band(H_hat_ptr, &X_fifo[x_start], T_ptr, num_x_channels, state->num_phases, start, length);
+}
 
-    aec_priv_filter_adapt(state->H_hat[y_ch], state->X_fifo_1d, T_ptr, state->shared_state->num_x_channels, state->num_phases);
+void aec_filter_adapt(
+        aec_state_t *state,
+        unsigned y_ch)
+{
+    if(state == NULL) {
+        return;
+    }
+    filter_adapt_x_channels(state, y_ch, 0, state->shared_state->num_x_channels);
+}
+
+void aec_filter_adapt_channel(
+        aec_state_t *state,
+        unsigned y_ch,
+        unsigned x_ch)
+{
+    filter_adapt_x_channels(state, y_ch, x_ch, 1);
 }
 
 void aec_calc_T(
@@ -316,7 +533,20 @@ void aec_calc_T(
     bfp_complex_s32_t *Error_ptr = &state->Error[y_ch];
     bfp_s32_t *inv_X_energy_ptr = &state->inv_X_energy[x_ch];
     float_s32_t mu = state->mu[y_ch][x_ch];
-    aec_priv_compute_T(T_ptr, Error_ptr, inv_X_energy_ptr, mu);
+    unsigned start, length;
+    if(!get_active_band(state->shared_state, &start, &length)) {
+        aec_priv_compute_T(T_ptr, Error_ptr, inv_X_energy_ptr, mu);
+        return;
+    }
+    //T is only used in the active band
+    bfp_complex_s32_t T_band, Error_band;
+    bfp_s32_t inv_X_energy_band;
+    complex_band(&T_band, T_ptr, start, length);
+    complex_band(&Error_band, Error_ptr, start, length);
+    real_band(&inv_X_energy_band, inv_X_energy_ptr, start, length);
+    aec_priv_compute_T(&T_band, &Error_band, &inv_X_energy_band, mu);
+    T_ptr->exp = T_band.exp;
+    T_ptr->hr = T_band.hr;
 }
 
 void aec_compare_filters_and_calc_mu(
@@ -353,21 +583,6 @@ void aec_compare_filters_and_calc_mu(
     }
 }
 
-void aec_update_X_fifo_1d(
-        aec_state_t *state)
-{
-    if(state == NULL) {
-        return;
-    }
-    unsigned count = 0;
-    for(unsigned ch=0; ch<state->shared_state->num_x_channels; ch++) {
-        for(unsigned ph=0; ph<state->num_phases; ph++) {
-            state->X_fifo_1d[count] = state->shared_state->X_fifo[ch][ph];
-            count += 1;
-        }
-    }
-}
-
 void aec_reset_state(aec_state_t *main_state, aec_state_t *shadow_state){
     aec_shared_state_t *shared_state = main_state->shared_state; 
     uint32_t y_channels = shared_state->num_y_channels;
@@ -388,9 +603,9 @@ void aec_reset_state(aec_state_t *main_state, aec_state_t *shadow_state){
             shadow_state->H_hat[ch][ph].hr = AEC_ZEROVAL_HR;
         }
     }
-    //X_fifo
+    //X_fifo, including the mirrored entries
     for(int ch=0; ch<x_channels; ch++) {
-        for(int ph=0; ph<main_phases; ph++) {
+        for(int ph=0; ph<2*main_phases; ph++) {
             shared_state->X_fifo[ch][ph].exp = AEC_ZEROVAL_EXP;
             shared_state->X_fifo[ch][ph].hr = AEC_ZEROVAL_HR;
         }
@@ -406,6 +621,56 @@ void aec_reset_state(aec_state_t *main_state, aec_state_t *shadow_state){
     }
 }
 
+void aec_shift_filter_samples(aec_state_t *main_state, aec_state_t *shadow_state, int32_t delta_samples){
+    aec_state_t *states[2] = {main_state, shadow_state};
+    for(int s=0; s<2; s++) {
+        aec_state_t *state = states[s];
+        if(state == NULL) {
+            continue;
+        }
+        for(int ych=0; ych<state->shared_state->num_y_channels; ych++) {
+            for(int xch=0; xch<state->shared_state->num_x_channels; xch++) {
+                aec_priv_shift_filter(&state->H_hat[ych][xch*state->num_phases], state->num_phases, delta_samples);
+            }
+        }
+    }
+}
+
+void aec_shift_filter_phases(aec_state_t *main_state, aec_state_t *shadow_state, int32_t delta_phases, int32_t reference_delayed){
+    aec_shared_state_t *shared_state = main_state->shared_state;
+    aec_state_t *states[2] = {main_state, shadow_state};
+    for(int s=0; s<2; s++) {
+        aec_state_t *state = states[s];
+        if(state == NULL) {
+            continue;
+        }
+        for(int ych=0; ych<shared_state->num_y_channels; ych++) {
+            for(int xch=0; xch<shared_state->num_x_channels; xch++) {
+                aec_priv_shift_phases(&state->H_hat[ych][xch*state->num_phases], state->num_phases, delta_phases);
+            }
+        }
+    }
+    if(!reference_delayed) {
+        return;
+    }
+    //The reference history has moved too, so the X FIFO is shifted to keep every phase paired with the same frame of
+    //reference it was paired with before, and X_energy, which is kept up to date incrementally, is recalculated
+    for(int xch=0; xch<shared_state->num_x_channels; xch++) {
+        if((delta_phases < 0) && (-delta_phases <= (int32_t)main_state->num_phases)) {
+            //The reference samples that now come before the next frame were in the processing block -delta_phases - 1
+            //frames ago, so the next block is assembled from them rather than from the samples before the change
+            const bfp_complex_s32_t *X_fifo = &shared_state->X_fifo[xch][shared_state->X_fifo_head[xch]];
+            aec_priv_prev_samples_from_spectrum(shared_state->prev_x[xch].data, shared_state->prev_frame_head, &X_fifo[-delta_phases - 1]);
+        }
+        aec_priv_shift_X_fifo(shared_state->X_fifo[xch], shared_state->X_fifo_energy[xch], &shared_state->X_fifo_head[xch], main_state->num_phases, delta_phases);
+        for(int s=0; s<2; s++) {
+            if((states[s] != NULL) && states[s]->num_phases) {
+                aec_priv_calc_total_X_energy(&states[s]->X_energy[xch], &states[s]->max_X_energy[xch], shared_state->X_fifo[xch], states[s]->num_phases);
+            }
+        }
+    }
+}
+
 uint32_t aec_detect_input_activity(const int32_t (*input_data)[AEC_FRAME_ADVANCE], float_s32_t active_threshold, int32_t num_channels) {
     /*abs_max_ref = abs(np.max(new_frame))
     return abs_max_ref > threshold*/
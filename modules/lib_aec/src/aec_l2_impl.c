@@ -5,13 +5,14 @@
 #include <limits.h>
 #include "aec_defines.h"
 #include "aec_api.h"
+#include "aec_priv.h"
 
 //AEC level 2
 void aec_l2_calc_Error_and_Y_hat(
         bfp_complex_s32_t *Error,
         bfp_complex_s32_t *Y_hat,
         const bfp_complex_s32_t *Y,
-        const bfp_complex_s32_t *X_fifo,
+        const bfp_complex_s32_t * const *X_fifo,
         const bfp_complex_s32_t *H_hat,
         unsigned num_x_channels,
         unsigned num_phases,
@@ -33,15 +34,23 @@ void aec_l2_calc_Error_and_Y_hat(
         Y_hat->hr = AEC_ZEROVAL_HR;
     }
     else {
-        uint32_t phases = num_x_channels * num_phases;
-        for(unsigned ph=0; ph<phases; ph++) {
-            //create input chunks
-            bfp_complex_s32_t X_chunk, H_hat_chunk;
-            bfp_complex_s32_init(&X_chunk, &X_fifo[ph].data[start_offset], X_fifo[ph].exp, length, 0); //Not recalculating headroom here to make sure outputs are bitexact irrespective of the length this function is called for.
-            X_chunk.hr = X_fifo[ph].hr;
-            bfp_complex_s32_init(&H_hat_chunk, &H_hat[ph].data[start_offset], H_hat[ph].exp, length, 0);
-            H_hat_chunk.hr = H_hat[ph].hr;
-            bfp_complex_s32_macc(Y_hat, &X_chunk, &H_hat_chunk);
+        for(unsigned ch=0; ch<num_x_channels; ch++) {
+            //X_fifo[ch] is the newest to oldest window into the circular X FIFO of this channel
+            const bfp_complex_s32_t *X_fifo_ch = X_fifo[ch];
+            const bfp_complex_s32_t *H_hat_ch = &H_hat[ch*num_phases];
+#if AEC_VECT_BACKEND
+            aec_vect_complex_s32_macc(Y_hat, X_fifo_ch, H_hat_ch, num_phases, start_offset, 0);
+#else
+            for(unsigned ph=0; ph<num_phases; ph++) {
+                //create input chunks
+                bfp_complex_s32_t X_chunk, H_hat_chunk;
+                bfp_complex_s32_init(&X_chunk, &X_fifo_ch[ph].data[start_offset], X_fifo_ch[ph].exp, length, 0); //Not recalculating headroom here to make sure outputs are bitexact irrespective of the length this function is called for.
+                X_chunk.hr = X_fifo_ch[ph].hr;
+                bfp_complex_s32_init(&H_hat_chunk, &H_hat_ch[ph].data[start_offset], H_hat_ch[ph].exp, length, 0);
+                H_hat_chunk.hr = H_hat_ch[ph].hr;
+                bfp_complex_s32_macc(Y_hat, &X_chunk, &H_hat_chunk);
+            }
+#endif
         }
 
         bfp_complex_s32_t Y_chunk;
@@ -57,7 +66,11 @@ void aec_l2_adapt_plus_fft_gc(
         const bfp_complex_s32_t *T_ph
         )
 {
+#if AEC_VECT_BACKEND
+    aec_vect_complex_s32_macc(H_hat_ph, T_ph, X_fifo_ph, 1, 0, 1);
+#else
     bfp_complex_s32_conj_macc(H_hat_ph, T_ph, X_fifo_ph);
+#endif
     bfp_fft_pack_mono(H_hat_ph);
     bfp_complex_s32_gradient_constraint_mono(H_hat_ph, 240);
     bfp_fft_unpack_mono(H_hat_ph);
@@ -12,6 +12,30 @@
 #define AEC_INPUT_EXP (-31) /// Exponent of AEC input and output
 #define AEC_WINDOW_EXP (-31) /// Hanning window coefficients exponent
 
+/// Select the fused 64-bit accumulator kernels in aec_vect_impl.c instead of the lib_xcore_math BFP calls for the
+/// Y_hat macc, the filter adaption conj macc and the X energy update. Host only, set through the AEC_VECT_BACKEND
+/// CMake option. Leave disabled for output that is bit-exact with the xcore build.
+#ifndef AEC_VECT_BACKEND
+#define AEC_VECT_BACKEND (0)
+#endif
+/// Max error in LSBs of an AEC_VECT_BACKEND kernel output relative to the exact result
+#define AEC_VECT_LSB_TOLERANCE (1)
+
+/// Round a memory pool size up to a whole number of double words
+#define AEC_MEM_ALIGN(size) (((size) + 7) & ~7)
+
+/// Number of bytes of memory pool used by aec_priv_main_init() for a given configuration
+uint32_t aec_priv_main_memory_required(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_phases);
+
+/// Number of bytes of memory pool used by aec_priv_shadow_init() for a given configuration
+uint32_t aec_priv_shadow_memory_required(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_phases);
+
 void aec_priv_main_init(
         aec_state_t *state,
         aec_shared_state_t *shared_state,
@@ -25,6 +49,23 @@ void aec_priv_shadow_init(
         aec_shared_state_t *shared_state,
         uint8_t *mem_pool,
         unsigned num_phases);
+/// Assemble a AEC_PROC_FRAME_LENGTH processing block from the prev_samples ring buffer starting at head and the
+/// AEC_FRAME_ADVANCE new samples, then overwrite the oldest samples in the ring with the new samples
+void aec_priv_frame_init_channel(
+        bfp_s32_t *frame,
+        int32_t *prev_samples,
+        unsigned head,
+        const int32_t *new_samples);
+
+/// Point output at the oldest length samples of the prev_samples ring buffer starting at head, in order. They're copied
+/// to scratch if they wrap around the end of the ring.
+void aec_priv_get_oldest_prev_samples(
+        bfp_s32_t *output,
+        int32_t *scratch,
+        const bfp_s32_t *prev_samples,
+        unsigned head,
+        unsigned length);
+
 void aec_priv_reset_filter(
         bfp_complex_s32_t *H_hat,
         unsigned num_x_channels,
@@ -37,6 +78,46 @@ void aec_priv_copy_filter(
         unsigned num_dst_phases,
         unsigned num_src_phases);
 
+/// Shift the filter modelled by the num_phases phases of H_hat later in time by delta_samples, or earlier if
+/// delta_samples is negative. Taps shifted past either end of the filter are lost and the taps shifted in are 0.
+void aec_priv_shift_filter(
+        bfp_complex_s32_t *H_hat,
+        unsigned num_phases,
+        int32_t delta_samples);
+
+/// Shift the filter modelled by the num_phases phases of H_hat later in time by delta_phases whole phases, or earlier if
+/// delta_phases is negative, by reordering the phases. Phases shifted past either end of the filter are reset and reused
+/// for the phases shifted in.
+void aec_priv_shift_phases(
+        bfp_complex_s32_t *H_hat,
+        unsigned num_phases,
+        int32_t delta_phases);
+
+/// Reorder the num_phases entries of the X FIFO window starting at *X_fifo_head, and the X_fifo_energy of each, so that
+/// entry ph of the window holds what entry ph - delta_phases held. Entries with nothing to take are cleared. The window
+/// is moved to start at entry 0.
+void aec_priv_shift_X_fifo(
+        bfp_complex_s32_t *X_fifo,
+        float_s32_t *X_fifo_energy,
+        unsigned *X_fifo_head,
+        unsigned num_phases,
+        int32_t delta_phases);
+
+/// Overwrite the prev_samples ring buffer, which has its oldest sample at head, with the first
+/// AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE samples of the processing block that X is the spectrum of.
+void aec_priv_prev_samples_from_spectrum(
+        int32_t *prev_samples,
+        unsigned head,
+        const bfp_complex_s32_t *X);
+
+/// Calculate X_energy from scratch as the energy per bin summed over the first num_phases entries of the X FIFO window
+/// X_fifo, and max_X_energy as its maximum.
+void aec_priv_calc_total_X_energy(
+        bfp_s32_t *X_energy,
+        float_s32_t *max_X_energy,
+        const bfp_complex_s32_t *X_fifo,
+        unsigned num_phases);
+
 void aec_priv_bfp_complex_s32_copy(
         bfp_complex_s32_t *dst,
         const bfp_complex_s32_t *src);
@@ -65,8 +146,24 @@ void aec_priv_update_total_X_energy(
         unsigned num_phases,
         unsigned recalc_bin);
 
+/// Add X to the circular X FIFO of a channel. X_fifo points to the channel's 2*num_phases mirrored entries.
+void aec_priv_update_X_fifo(
+        bfp_complex_s32_t *X_fifo,
+        unsigned *X_fifo_head,
+        const bfp_complex_s32_t *X_data,
+        unsigned num_phases);
+
+/// Update the EMA of the X energy per bin and calculate the total X energy of the frame
+void aec_priv_calc_sigma_XX(
+        bfp_s32_t *sigma_XX,
+        float_s32_t *sum_X_energy,
+        const bfp_complex_s32_t *X_data,
+        uint32_t sigma_xx_shift);
+
+/// aec_priv_update_X_fifo() followed by aec_priv_calc_sigma_XX()
 void aec_priv_update_X_fifo_and_calc_sigmaXX(
         bfp_complex_s32_t *X_fifo,
+        unsigned *X_fifo_head,
         bfp_s32_t *sigma_XX,
         float_s32_t *sum_X_energy,
         const bfp_complex_s32_t *X_data,
@@ -77,7 +174,7 @@ void aec_priv_calc_Error_and_Y_hat(
         bfp_complex_s32_t *Error,
         bfp_complex_s32_t *Y_hat,
         const bfp_complex_s32_t *Y,
-        const bfp_complex_s32_t *X_fifo,
+        const bfp_complex_s32_t * const *X_fifo,
         const bfp_complex_s32_t *H_hat,
         unsigned num_x_channels,
         unsigned num_phases,
@@ -94,6 +191,12 @@ void aec_priv_create_output(
         bfp_s32_t *overlap,
         bfp_s32_t *error);
 
+/// Overlap add an already windowed error block into output and keep the end of it in overlap for the next frame
+void aec_priv_overlap_add_output(
+        bfp_s32_t *output,
+        bfp_s32_t *overlap,
+        const bfp_s32_t *error);
+
 /// Calculate inverse X energy for a channel over a range of bins
 void aec_priv_calc_inverse(
         bfp_s32_t *input);
@@ -119,11 +222,49 @@ void aec_priv_calc_inv_X_energy(
 
 void aec_priv_filter_adapt(
         bfp_complex_s32_t *H_hat,
-        const bfp_complex_s32_t *X_fifo,
+        const bfp_complex_s32_t * const *X_fifo,
         const bfp_complex_s32_t *T,
         unsigned num_x_channels,
         unsigned num_phases);
 
+/// Adapt the filter on the bins [start_offset, start_offset + length) only. T only needs to be valid in that range
+void aec_priv_filter_adapt_band(
+        bfp_complex_s32_t *H_hat,
+        const bfp_complex_s32_t * const *X_fifo,
+        const bfp_complex_s32_t *T,
+        unsigned num_x_channels,
+        unsigned num_phases,
+        unsigned start_offset,
+        unsigned length);
+
+/// Pick num_adapt of the num_phases phases to adapt this frame. In round robin mode these are the phases from offset
+/// onwards, otherwise the phases with the most energy in X_fifo_energy, which is ordered the same as the X FIFO window
+void aec_priv_select_adapt_phases(
+        unsigned *phases,
+        const float_s32_t *X_fifo_energy,
+        unsigned num_phases,
+        unsigned num_adapt,
+        unsigned offset,
+        aec_partial_update_e mode);
+
+/// Adapt the num_adapt phases listed in phases[ch] for every x channel ch, on the bins [start_offset, start_offset + length)
+void aec_priv_filter_adapt_phases(
+        bfp_complex_s32_t *H_hat,
+        const bfp_complex_s32_t * const *X_fifo,
+        const bfp_complex_s32_t *T,
+        unsigned num_x_channels,
+        unsigned num_phases,
+        const unsigned (*phases)[AEC_LIB_MAX_PHASES],
+        unsigned num_adapt,
+        unsigned start_offset,
+        unsigned length);
+
+/// Give full a single exponent after the bins of band, which starts at full->data[start_offset], have been updated
+void aec_priv_bfp_complex_s32_merge_band(
+        bfp_complex_s32_t *full,
+        bfp_complex_s32_t *band,
+        unsigned start_offset);
+
 void aec_priv_compute_T(
         bfp_complex_s32_t *T,
         const bfp_complex_s32_t *Error,
@@ -144,4 +285,20 @@ float_s32_t aec_priv_calc_corr_factor(
         bfp_s32_t *y,
         bfp_s32_t *yhat);
 
+/// acc += sum over count of b[i][offset:] * c[i][offset:] (or * conj(c[i]) when conj_c is set), using a 64-bit
+/// accumulator and a single normalisation. acc->length bins are processed.
+void aec_vect_complex_s32_macc(
+        bfp_complex_s32_t *acc,
+        const bfp_complex_s32_t *b,
+        const bfp_complex_s32_t *c,
+        unsigned count,
+        unsigned offset,
+        unsigned conj_c);
+
+/// energy = energy - |X_sub|^2 + |X_add|^2, using a 64-bit accumulator and a single normalisation
+void aec_vect_energy_update(
+        bfp_s32_t *energy,
+        const bfp_complex_s32_t *X_sub,
+        const bfp_complex_s32_t *X_add);
+
 #endif
@@ -8,6 +8,47 @@
 #include "aec_priv.h"
 #include "xmath/xmath.h"
 
+// The sizes here need to match the order in which aec_priv_main_init() and aec_priv_shadow_init() carve up the pool.
+uint32_t aec_priv_main_memory_required(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_phases)
+{
+    uint32_t size = 0;
+    //y, x
+    size += (num_y_channels + num_x_channels) * (AEC_PROC_FRAME_LENGTH + AEC_FFT_PADDING) * sizeof(int32_t);
+    //prev_y, prev_x
+    size += (num_y_channels + num_x_channels) * (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE) * sizeof(int32_t);
+    //H_hat, X_fifo
+    size += ((num_y_channels * num_x_channels * num_phases) + (num_x_channels * num_phases)) * AEC_FD_FRAME_LENGTH * sizeof(complex_s32_t);
+    //Error, Y_hat
+    size += 2 * num_y_channels * AEC_FD_FRAME_LENGTH * sizeof(complex_s32_t);
+    //X_energy, sigma_XX, inv_X_energy
+    size += 3 * num_x_channels * AEC_FD_FRAME_LENGTH * sizeof(int32_t);
+    //overlap
+    size += num_y_channels * AEC_UNUSED_TAPS_PER_PHASE * 2 * sizeof(int32_t);
+    return size;
+}
+
+uint32_t aec_priv_shadow_memory_required(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_phases)
+{
+    uint32_t size = 0;
+    //H_hat
+    size += num_y_channels * num_x_channels * num_phases * AEC_FD_FRAME_LENGTH * sizeof(complex_s32_t);
+    //Error, Y_hat
+    size += 2 * num_y_channels * AEC_FD_FRAME_LENGTH * sizeof(complex_s32_t);
+    //T
+    size += num_x_channels * AEC_FD_FRAME_LENGTH * sizeof(complex_s32_t);
+    //X_energy, inv_X_energy
+    size += 2 * num_x_channels * AEC_FD_FRAME_LENGTH * sizeof(int32_t);
+    //overlap
+    size += num_y_channels * AEC_UNUSED_TAPS_PER_PHASE * 2 * sizeof(int32_t);
+    return size;
+}
+
 void aec_priv_main_init(
         aec_state_t *state,
         aec_shared_state_t *shared_state,
@@ -61,8 +102,11 @@ void aec_priv_main_init(
     for(unsigned ch=0; ch<num_x_channels; ch++) {
         for(unsigned ph=0; ph<num_phases; ph++) {
             bfp_complex_s32_init(&state->shared_state->X_fifo[ch][ph], (complex_s32_t*)available_mem_start, AEC_ZEROVAL_EXP, AEC_FD_FRAME_LENGTH, 0);
+            //mirror entry so that num_phases entries from any head index are contiguous
+            state->shared_state->X_fifo[ch][ph + num_phases] = state->shared_state->X_fifo[ch][ph];
             available_mem_start += (AEC_FD_FRAME_LENGTH*sizeof(complex_s32_t)); 
         }
+        state->shared_state->X_fifo_head[ch] = 0;
     }
     //initialise Error
     for(unsigned ch=0; ch<num_y_channels; ch++) {
@@ -225,6 +269,48 @@ void aec_priv_bfp_complex_s32_reset(bfp_complex_s32_t *a)
     a->hr = AEC_ZEROVAL_HR;
 }
 
+void aec_priv_frame_init_channel(
+        bfp_s32_t *frame,
+        int32_t *prev_samples,
+        unsigned head,
+        const int32_t *new_samples)
+{
+    const unsigned prev_len = AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE;
+    // Copy previous samples, oldest first
+    memcpy(frame->data, &prev_samples[head], (prev_len - head)*sizeof(int32_t));
+    memcpy(&frame->data[prev_len - head], prev_samples, head*sizeof(int32_t));
+    // Copy current samples
+    memcpy(&frame->data[prev_len], new_samples, AEC_FRAME_ADVANCE*sizeof(int32_t));
+    // Update exp just in case
+    frame->exp = AEC_INPUT_EXP;
+    // Update headroom
+    bfp_s32_headroom(frame);
+
+    // Overwrite the oldest previous samples with the current samples
+    unsigned first = ((prev_len - head) < AEC_FRAME_ADVANCE) ? (prev_len - head) : AEC_FRAME_ADVANCE;
+    memcpy(&prev_samples[head], new_samples, first*sizeof(int32_t));
+    memcpy(prev_samples, &new_samples[first], (AEC_FRAME_ADVANCE - first)*sizeof(int32_t));
+}
+
+void aec_priv_get_oldest_prev_samples(
+        bfp_s32_t *output,
+        int32_t *scratch,
+        const bfp_s32_t *prev_samples,
+        unsigned head,
+        unsigned length)
+{
+    const unsigned prev_len = AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE;
+    int32_t *data = &prev_samples->data[head];
+    if((head + length) > prev_len) {
+        // Wraps around the end of the ring
+        unsigned first = prev_len - head;
+        memcpy(scratch, data, first*sizeof(int32_t));
+        memcpy(&scratch[first], prev_samples->data, (length - first)*sizeof(int32_t));
+        data = scratch;
+    }
+    bfp_s32_init(output, data, prev_samples->exp, length, 1);
+}
+
 void aec_priv_reset_filter(
         bfp_complex_s32_t *H_hat,
         unsigned num_x_channels,
@@ -263,6 +349,177 @@ void aec_priv_copy_filter(
     }
 }
 
+// Copy count time domain taps from phase src_ph starting at tap start, or zeros if src_ph is outside the filter
+static void move_taps(int32_t *dst, bfp_s32_t **h, unsigned num_phases, int32_t src_ph, int32_t start, int32_t count)
+{
+    if((src_ph >= 0) && (src_ph < (int32_t)num_phases)) {
+        memmove(dst, &h[src_ph]->data[start], count*sizeof(int32_t));
+    }
+    else {
+        memset(dst, 0, count*sizeof(int32_t));
+    }
+}
+
+void aec_priv_shift_filter(
+        bfp_complex_s32_t *H_hat,
+        unsigned num_phases,
+        int32_t delta_samples)
+{
+    //After the gradient constraint, phase ph holds the AEC_FRAME_ADVANCE time domain taps starting at tap
+    //ph*AEC_FRAME_ADVANCE of the filter, followed by zeros
+    const int32_t taps = AEC_FRAME_ADVANCE;
+    bfp_s32_t *h[AEC_LIB_MAX_PHASES];
+    exponent_t exp = AEC_ZEROVAL_EXP;
+    for(unsigned ph=0; ph<num_phases; ph++) {
+        if(H_hat[ph].exp == AEC_ZEROVAL_EXP) {
+            //Data isn't cleared when a filter is reset
+            memset(H_hat[ph].data, 0, H_hat[ph].length*sizeof(complex_s32_t));
+        }
+        bfp_fft_pack_mono(&H_hat[ph]);
+        h[ph] = bfp_fft_inverse_mono(&H_hat[ph]);
+        if((h[ph]->hr < 31) && ((int32_t)(h[ph]->exp - h[ph]->hr) > exp)) {
+            exp = h[ph]->exp - h[ph]->hr;
+        }
+    }
+    //Put every phase in the same exponent so taps can be moved between phases as they are
+    for(unsigned ph=0; ph<num_phases; ph++) {
+        if(h[ph]->hr >= 31) {
+            memset(h[ph]->data, 0, h[ph]->length*sizeof(int32_t));
+            h[ph]->exp = exp;
+        }
+        else {
+            bfp_s32_use_exponent(h[ph], exp);
+        }
+    }
+
+    //Rewrite the phases in the order that leaves every source phase unchanged until it has been read
+    int32_t ph = (delta_samples >= 0) ? (int32_t)num_phases - 1 : 0;
+    int32_t step = (delta_samples >= 0) ? -1 : 1;
+    for(unsigned i=0; i<num_phases; i++, ph+=step) {
+        int32_t src_start = (ph * taps) - delta_samples;
+        int32_t src_ph = (src_start >= 0) ? (src_start / taps) : -((taps - 1 - src_start) / taps);
+        int32_t offset = src_start - (src_ph * taps);
+        int32_t *dst = h[ph]->data;
+        //Taps [0, taps - offset) come from the end of src_ph and taps [taps - offset, taps) from the start of src_ph + 1.
+        //Whichever of them is phase ph itself has to be read first
+        if(src_ph + 1 == ph) {
+            move_taps(&dst[taps - offset], h, num_phases, src_ph + 1, 0, offset);
+            move_taps(dst, h, num_phases, src_ph, offset, taps - offset);
+        }
+        else {
+            move_taps(dst, h, num_phases, src_ph, offset, taps - offset);
+            move_taps(&dst[taps - offset], h, num_phases, src_ph + 1, 0, offset);
+        }
+        memset(&dst[taps], 0, (h[ph]->length - taps)*sizeof(int32_t));
+    }
+
+    for(unsigned ph=0; ph<num_phases; ph++) {
+        bfp_s32_headroom(h[ph]);
+        bfp_complex_s32_t *H = bfp_fft_forward_mono(h[ph]);
+        bfp_fft_unpack_mono(H);
+    }
+}
+
+void aec_priv_shift_phases(
+        bfp_complex_s32_t *H_hat,
+        unsigned num_phases,
+        int32_t delta_phases)
+{
+    //Phase ph takes the BFP structure of phase ph - delta_phases, so no data is moved. The rotation hands the phases
+    //shifted past one end to the phases shifted in at the other, which are reset
+    bfp_complex_s32_t shifted[AEC_LIB_MAX_PHASES];
+    for(unsigned ph=0; ph<num_phases; ph++) {
+        int32_t src_ph = (int32_t)ph - delta_phases;
+        shifted[ph] = H_hat[((src_ph % (int32_t)num_phases) + num_phases) % num_phases];
+        if((src_ph < 0) || (src_ph >= (int32_t)num_phases)) {
+            shifted[ph].exp = AEC_ZEROVAL_EXP;
+            shifted[ph].hr = AEC_ZEROVAL_HR;
+        }
+    }
+    memcpy(H_hat, shifted, num_phases*sizeof(bfp_complex_s32_t));
+}
+
+void aec_priv_shift_X_fifo(
+        bfp_complex_s32_t *X_fifo,
+        float_s32_t *X_fifo_energy,
+        unsigned *X_fifo_head,
+        unsigned num_phases,
+        int32_t delta_phases)
+{
+    //Same rotation as aec_priv_shift_phases() on the window starting at the head, which is then moved to entry 0
+    const float_s32_t zero_energy = {0, AEC_ZEROVAL_EXP};
+    bfp_complex_s32_t shifted[AEC_LIB_MAX_PHASES];
+    float_s32_t shifted_energy[AEC_LIB_MAX_PHASES];
+    unsigned head = *X_fifo_head;
+    for(unsigned ph=0; ph<num_phases; ph++) {
+        int32_t src_ph = (int32_t)ph - delta_phases;
+        unsigned src = head + (((src_ph % (int32_t)num_phases) + num_phases) % num_phases);
+        shifted[ph] = X_fifo[src];
+        shifted_energy[ph] = X_fifo_energy[src];
+        if((src_ph < 0) || (src_ph >= (int32_t)num_phases)) {
+            //X FIFO data is used without checking for AEC_ZEROVAL_EXP, so clear it
+            memset(shifted[ph].data, 0, shifted[ph].length*sizeof(complex_s32_t));
+            shifted[ph].exp = AEC_ZEROVAL_EXP;
+            shifted[ph].hr = AEC_ZEROVAL_HR;
+            shifted_energy[ph] = zero_energy;
+        }
+    }
+    for(unsigned ph=0; ph<num_phases; ph++) {
+        X_fifo[ph] = shifted[ph];
+        X_fifo[ph + num_phases] = shifted[ph];
+        X_fifo_energy[ph] = shifted_energy[ph];
+        X_fifo_energy[ph + num_phases] = shifted_energy[ph];
+    }
+    *X_fifo_head = 0;
+}
+
+void aec_priv_prev_samples_from_spectrum(
+        int32_t *prev_samples,
+        unsigned head,
+        const bfp_complex_s32_t *X)
+{
+    const unsigned prev_len = AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE;
+    if(X->exp == AEC_ZEROVAL_EXP) {
+        memset(prev_samples, 0, prev_len*sizeof(int32_t));
+        return;
+    }
+    //The processing block isn't windowed before its FFT, so the inverse FFT gives back the input samples
+    complex_s32_t DWORD_ALIGNED block_data[AEC_FD_FRAME_LENGTH];
+    bfp_complex_s32_t block;
+    memcpy(block_data, X->data, X->length*sizeof(complex_s32_t));
+    bfp_complex_s32_init(&block, block_data, X->exp, X->length, 0);
+    block.hr = X->hr;
+    bfp_fft_pack_mono(&block);
+    bfp_s32_t *x = bfp_fft_inverse_mono(&block);
+    bfp_s32_use_exponent(x, AEC_INPUT_EXP);
+    //Oldest sample at head, same as aec_priv_frame_init_channel() leaves it
+    memcpy(&prev_samples[head], x->data, (prev_len - head)*sizeof(int32_t));
+    memcpy(prev_samples, &x->data[prev_len - head], head*sizeof(int32_t));
+}
+
+void aec_priv_calc_total_X_energy(
+        bfp_s32_t *X_energy,
+        float_s32_t *max_X_energy,
+        const bfp_complex_s32_t *X_fifo,
+        unsigned num_phases)
+{
+    int32_t DWORD_ALIGNED energy_scratch[AEC_PROC_FRAME_LENGTH/2 + 1];
+    bfp_s32_t scratch;
+    bfp_s32_init(&scratch, energy_scratch, 0, X_energy->length, 0);
+    memset(X_energy->data, 0, X_energy->length*sizeof(int32_t));
+    X_energy->exp = AEC_ZEROVAL_EXP;
+    X_energy->hr = AEC_ZEROVAL_HR;
+    for(unsigned ph=0; ph<num_phases; ph++) {
+        bfp_complex_s32_squared_mag(&scratch, &X_fifo[ph]);
+        bfp_s32_add(X_energy, X_energy, &scratch);
+    }
+    *max_X_energy = bfp_s32_max(X_energy);
+    //Same divide by 0 protection as aec_priv_update_total_X_energy()
+    if(max_X_energy->mant == 0) {
+        X_energy->exp = AEC_ZEROVAL_EXP;
+    }
+}
+
 void aec_priv_compare_filters(
         aec_state_t *main_state,
         aec_state_t *shadow_state)
@@ -562,16 +819,21 @@ void aec_priv_update_total_X_energy(
         unsigned num_phases,
         unsigned recalc_bin)
 {
+    //X_fifo ordered from newest to oldest phase
+#if AEC_VECT_BACKEND
+    //subtract oldest phase and add newest phase in one pass
+    aec_vect_energy_update(X_energy, &X_fifo[num_phases-1], X);
+#else
     int32_t DWORD_ALIGNED energy_scratch[AEC_PROC_FRAME_LENGTH/2 + 1];
     bfp_s32_t scratch;
-    bfp_s32_init(&scratch, energy_scratch, 0, AEC_PROC_FRAME_LENGTH/2+1, 0);
-    //X_fifo ordered from newest to oldest phase
+    bfp_s32_init(&scratch, energy_scratch, 0, X_energy->length, 0);
     //subtract oldest phase
     bfp_complex_s32_squared_mag(&scratch, &X_fifo[num_phases-1]);
     bfp_s32_sub(X_energy, X_energy, &scratch);
     //add newest phase
     bfp_complex_s32_squared_mag(&scratch, X);
     bfp_s32_add(X_energy, X_energy, &scratch);
+#endif
 
     aec_priv_bfp_complex_s32_recalc_energy_one_bin(X_energy, X_fifo, X, num_phases, recalc_bin);
 
@@ -600,34 +862,32 @@ void aec_priv_update_total_X_energy(
     }    
 }
 
-void aec_priv_update_X_fifo_and_calc_sigmaXX(
+void aec_priv_update_X_fifo(
         bfp_complex_s32_t *X_fifo,
+        unsigned *X_fifo_head,
+        const bfp_complex_s32_t *X,
+        unsigned num_phases)
+{
+    //Move the head back to the oldest phase and overwrite it with X, so the window starting at the head goes from
+    //newest to oldest phase. Entry head+num_phases mirrors entry head.
+    unsigned head = (*X_fifo_head == 0) ? (num_phases - 1) : (*X_fifo_head - 1);
+    memcpy(X_fifo[head].data, X->data, X->length*sizeof(complex_s32_t));
+    X_fifo[head].exp = X->exp;
+    X_fifo[head].hr = X->hr;
+    X_fifo[head].length = X->length;
+    X_fifo[head + num_phases] = X_fifo[head];
+    *X_fifo_head = head;
+}
+
+void aec_priv_calc_sigma_XX(
         bfp_s32_t *sigma_XX,
         float_s32_t *sum_X_energy,
         const bfp_complex_s32_t *X,
-        unsigned num_phases,
         uint32_t sigma_xx_shift)
 {
-    /* Note: Instead of maintaining a separate mapping array, I'll instead, shift around the X_fifo array at the end of update_X_fifo.
-    * This will only involve memcpys of size x_channels*num_phases*sizeof(bfp_complex_s32_t).
-    */
-    //X-fifo update
-    //rearrage X-fifo to point from newest phase to oldest phase
-    bfp_complex_s32_t last_phase = X_fifo[num_phases-1];
-    for(int32_t n=num_phases-1; n>=1; n--) {
-        X_fifo[n] = X_fifo[n-1];
-    }
-    X_fifo[0] = last_phase;
-    //Update X as newest phase
-    memcpy(X_fifo[0].data, X->data, X->length*sizeof(complex_s32_t));
-    X_fifo[0].exp = X->exp;
-    X_fifo[0].hr = X->hr;
-    X_fifo[0].length = X->length;
-    
-    //update sigma_XX
     int32_t DWORD_ALIGNED sigma_scratch_mem[AEC_PROC_FRAME_LENGTH/2 + 1];
     bfp_s32_t scratch;
-    bfp_s32_init(&scratch, sigma_scratch_mem, 0, AEC_FD_FRAME_LENGTH, 0);
+    bfp_s32_init(&scratch, sigma_scratch_mem, 0, X->length, 0);
     bfp_complex_s32_squared_mag(&scratch, X);
     float_s64_t sum = bfp_s32_sum(&scratch);
     *sum_X_energy = float_s64_to_float_s32(sum);
@@ -640,14 +900,29 @@ void aec_priv_update_X_fifo_and_calc_sigmaXX(
     sigma_XX_scaled.exp -= sigma_xx_shift;
     bfp_s32_sub(sigma_XX, sigma_XX, &sigma_XX_scaled); //sigma_XX - (sigma_XX * pow(2, -ema_coef_shr))
     bfp_s32_add(sigma_XX, sigma_XX, &scratch); //sigma_XX - (sigma_XX * pow(2, -ema_coef_shr)) + (pow(2, -ema_coef_shr))*X_energy
+}
 
+void aec_priv_update_X_fifo_and_calc_sigmaXX(
+        bfp_complex_s32_t *X_fifo,
+        unsigned *X_fifo_head,
+        bfp_s32_t *sigma_XX,
+        float_s32_t *sum_X_energy,
+        const bfp_complex_s32_t *X,
+        unsigned num_phases,
+        uint32_t sigma_xx_shift)
+{
+    //X-fifo update
+    aec_priv_update_X_fifo(X_fifo, X_fifo_head, X, num_phases);
+    
+    //update sigma_XX
+    aec_priv_calc_sigma_XX(sigma_XX, sum_X_energy, X, sigma_xx_shift);
 }
 
 void aec_priv_calc_Error_and_Y_hat(
         bfp_complex_s32_t *Error,
         bfp_complex_s32_t *Y_hat,
         const bfp_complex_s32_t *Y,
-        const bfp_complex_s32_t *X_fifo,
+        const bfp_complex_s32_t * const *X_fifo,
         const bfp_complex_s32_t *H_hat,
         unsigned num_x_channels,
         unsigned num_phases,
@@ -768,7 +1043,16 @@ void aec_priv_create_output(
     uint32_t min_hr = (chunks[0].hr < chunks[1].hr) ? chunks[0].hr : chunks[1].hr;
     min_hr = (min_hr < error->hr) ? min_hr : error->hr;
     error->hr = min_hr;
-    
+
+    aec_priv_overlap_add_output(output, overlap, error);
+}
+
+void aec_priv_overlap_add_output(
+        bfp_s32_t *output,
+        bfp_s32_t *overlap,
+        const bfp_s32_t *error)
+{
+    bfp_s32_t chunks[2];
     //copy error to output
     if(output->data != NULL) {
         memcpy(output->data, &error->data[AEC_FRAME_ADVANCE], AEC_FRAME_ADVANCE*sizeof(int32_t));
@@ -857,7 +1141,7 @@ void aec_priv_calc_inv_X_energy_denom(
     if(!is_shadow) { //frequency smoothing
         int32_t norm_denom_buf[AEC_PROC_FRAME_LENGTH/2 + 1];
         bfp_s32_t norm_denom;
-        bfp_s32_init(&norm_denom, &norm_denom_buf[0], 0, AEC_PROC_FRAME_LENGTH/2+1, 0);
+        bfp_s32_init(&norm_denom, &norm_denom_buf[0], 0, X_energy->length, 0);
 
         bfp_s32_t sigma_times_gamma;
         bfp_s32_init(&sigma_times_gamma, sigma_XX->data, sigma_XX->exp+gamma_log2, sigma_XX->length, 0);
@@ -941,15 +1225,135 @@ void aec_priv_calc_inv_X_energy(
 
 void aec_priv_filter_adapt(
         bfp_complex_s32_t *H_hat,
-        const bfp_complex_s32_t *X_fifo,
+        const bfp_complex_s32_t * const *X_fifo,
         const bfp_complex_s32_t *T,
         unsigned num_x_channels,
         unsigned num_phases)
 {
-    unsigned phases = num_x_channels * num_phases;
-    for(unsigned ph=0; ph<phases; ph++) {
-        //find out which channel this phase belongs to
-        aec_l2_adapt_plus_fft_gc(&H_hat[ph], &X_fifo[ph], &T[ph/num_phases]);
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        for(unsigned ph=0; ph<num_phases; ph++) {
+            aec_l2_adapt_plus_fft_gc(&H_hat[ch*num_phases + ph], &X_fifo[ch][ph], &T[ch]);
+        }
+    }
+}
+
+void aec_priv_bfp_complex_s32_merge_band(
+        bfp_complex_s32_t *full,
+        bfp_complex_s32_t *band,
+        unsigned start_offset)
+{
+    //full->exp and full->hr describe the bins outside the band, band->exp and band->hr the bins in it
+    unsigned end = start_offset + band->length;
+    bfp_complex_s32_t chunks[3];
+    bfp_complex_s32_init(&chunks[0], full->data, full->exp, start_offset, 0);
+    chunks[0].hr = full->hr;
+    chunks[1] = *band;
+    bfp_complex_s32_init(&chunks[2], &full->data[end], full->exp, full->length - end, 0);
+    chunks[2].hr = full->hr;
+
+    int32_t exp;
+    uint32_t hr;
+    aec_l2_bfp_complex_s32_unify_exponent(chunks, &exp, &hr, NULL, 3, 0, 0);
+    full->exp = exp;
+    full->hr = hr;
+}
+
+static void filter_adapt_phase_band(
+        bfp_complex_s32_t *H_hat_ph,
+        const bfp_complex_s32_t *X_ph,
+        const bfp_complex_s32_t *T_ch,
+        unsigned start_offset,
+        unsigned length)
+{
+    bfp_complex_s32_t H_hat_chunk;
+    bfp_complex_s32_init(&H_hat_chunk, &H_hat_ph->data[start_offset], H_hat_ph->exp, length, 0);
+    H_hat_chunk.hr = H_hat_ph->hr;
+#if AEC_VECT_BACKEND
+    aec_vect_complex_s32_macc(&H_hat_chunk, T_ch, X_ph, 1, start_offset, 1);
+#else
+    bfp_complex_s32_t T_chunk, X_chunk;
+    bfp_complex_s32_init(&T_chunk, &T_ch->data[start_offset], T_ch->exp, length, 0);
+    T_chunk.hr = T_ch->hr;
+    bfp_complex_s32_init(&X_chunk, &X_ph->data[start_offset], X_ph->exp, length, 0);
+    X_chunk.hr = X_ph->hr;
+    bfp_complex_s32_conj_macc(&H_hat_chunk, &T_chunk, &X_chunk);
+#endif
+    aec_priv_bfp_complex_s32_merge_band(H_hat_ph, &H_hat_chunk, start_offset);
+
+    //The gradient constraint works on the full spectrum
+    bfp_fft_pack_mono(H_hat_ph);
+    bfp_complex_s32_gradient_constraint_mono(H_hat_ph, 240);
+    bfp_fft_unpack_mono(H_hat_ph);
+}
+
+void aec_priv_filter_adapt_band(
+        bfp_complex_s32_t *H_hat,
+        const bfp_complex_s32_t * const *X_fifo,
+        const bfp_complex_s32_t *T,
+        unsigned num_x_channels,
+        unsigned num_phases,
+        unsigned start_offset,
+        unsigned length)
+{
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        for(unsigned ph=0; ph<num_phases; ph++) {
+            filter_adapt_phase_band(&H_hat[ch*num_phases + ph], &X_fifo[ch][ph], &T[ch], start_offset, length);
+        }
+    }
+}
+
+void aec_priv_select_adapt_phases(
+        unsigned *phases,
+        const float_s32_t *X_fifo_energy,
+        unsigned num_phases,
+        unsigned num_adapt,
+        unsigned offset,
+        aec_partial_update_e mode)
+{
+    if(mode == AEC_PARTIAL_UPDATE_ROUND_ROBIN) {
+        for(unsigned i=0; i<num_adapt; i++) {
+            phases[i] = (offset + i) % num_phases;
+        }
+        return;
+    }
+    //Partial selection sort on the X energy of the phases, picking the most recent phase on a tie
+    uint8_t picked[AEC_LIB_MAX_PHASES];
+    memset(picked, 0, num_phases);
+    for(unsigned i=0; i<num_adapt; i++) {
+        int max_ph = -1;
+        for(unsigned ph=0; ph<num_phases; ph++) {
+            if(picked[ph]) continue;
+            if((max_ph < 0) || float_s32_gt(X_fifo_energy[ph], X_fifo_energy[max_ph])) {
+                max_ph = ph;
+            }
+        }
+        picked[max_ph] = 1;
+        phases[i] = max_ph;
+    }
+}
+
+void aec_priv_filter_adapt_phases(
+        bfp_complex_s32_t *H_hat,
+        const bfp_complex_s32_t * const *X_fifo,
+        const bfp_complex_s32_t *T,
+        unsigned num_x_channels,
+        unsigned num_phases,
+        const unsigned (*phases)[AEC_LIB_MAX_PHASES],
+        unsigned num_adapt,
+        unsigned start_offset,
+        unsigned length)
+{
+    unsigned full_band = (start_offset == 0) && (length == AEC_FD_FRAME_LENGTH);
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        for(unsigned i=0; i<num_adapt; i++) {
+            unsigned ph = phases[ch][i];
+            if(full_band) {
+                aec_l2_adapt_plus_fft_gc(&H_hat[ch*num_phases + ph], &X_fifo[ch][ph], &T[ch]);
+            }
+            else {
+                filter_adapt_phase_band(&H_hat[ch*num_phases + ph], &X_fifo[ch][ph], &T[ch], start_offset, length);
+            }
+        }
     }
 }
 
@@ -986,6 +1390,10 @@ void aec_priv_init_config_params(
     core_conf->delta_min = f64_to_float_s32((double)1e-20);
     core_conf->bypass = 0;
     core_conf->coeff_index = 0;
+    core_conf->active_band_start = 0;
+    core_conf->active_band_length = AEC_FD_FRAME_LENGTH;
+    core_conf->partial_update_phases = 0;
+    core_conf->partial_update_mode = AEC_PARTIAL_UPDATE_ROUND_ROBIN;
 
     //shadow_filt_config_params_t
     shadow_filt_config_params_t *shadow_cfg = &config_params->shadow_filt_conf;
@@ -0,0 +1,149 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <string.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_priv.h"
+
+/*
+ * Residual echo suppression.
+ *
+ * With E and Y_hat the smoothed power spectra of the main filter error and echo estimate, the residual echo power in
+ * bin k is estimated as leak * Y_hat[k], where leak is the least squares fit of E to Y_hat over all bins:
+ *
+ *   leak = sum(E[k] * Y_hat[k]) / sum(Y_hat[k] * Y_hat[k])
+ *
+ * and the gain applied to bin k of the error is
+ *
+ *   G[k] = max(min_gain, 1 - overdrive * leak * Y_hat[k] / E[k])
+ *
+ * The gain is applied to the windowed error spectrum that the filters adapt on, which only has the AEC_FRAME_ADVANCE +
+ * AEC_UNUSED_TAPS_PER_PHASE*2 samples of the output in it, so the time aliasing of the gain ends up in the part of the
+ * block that is thrown away.
+ */
+
+// Smooth a power spectrum with a coefficient of 1 - pow(2, -shr), like aec_priv_calc_sigma_XX()
+static void res_smooth_psd(bfp_s32_t *psd, bfp_s32_t *new_psd, uint32_t shr)
+{
+    if(psd->exp == AEC_ZEROVAL_EXP) {
+        //First frame, so start from the new spectrum
+        memcpy(psd->data, new_psd->data, new_psd->length*sizeof(int32_t));
+        psd->exp = new_psd->exp;
+        psd->hr = new_psd->hr;
+        return;
+    }
+    new_psd->exp -= shr;
+    bfp_s32_t psd_scaled = *psd;
+    psd_scaled.exp -= shr;
+    bfp_s32_sub(psd, psd, &psd_scaled);
+    bfp_s32_add(psd, psd, new_psd);
+}
+
+// Mantissa of a value between 0 and 1 at an exponent of -30
+static int32_t to_q30(float_s32_t value)
+{
+    int shr = -30 - value.exp;
+    if(shr > 31) {
+        return 0;
+    }
+    return (shr >= 0) ? (value.mant >> shr) : (value.mant << -shr);
+}
+
+void aec_res_init(aec_res_state_t *res_state)
+{
+    memset(res_state, 0, sizeof(aec_res_state_t));
+    for(int ch=0; ch<AEC_LIB_MAX_Y_CHANNELS; ch++) {
+        bfp_s32_init(&res_state->Error_psd[ch], res_state->Error_psd_data[ch], AEC_ZEROVAL_EXP, AEC_FD_FRAME_LENGTH, 0);
+        res_state->Error_psd[ch].hr = AEC_ZEROVAL_HR;
+        bfp_s32_init(&res_state->Y_hat_psd[ch], res_state->Y_hat_psd_data[ch], AEC_ZEROVAL_EXP, AEC_FD_FRAME_LENGTH, 0);
+        res_state->Y_hat_psd[ch].hr = AEC_ZEROVAL_HR;
+        bfp_s32_init(&res_state->gain[ch], res_state->gain_data[ch], 0, AEC_FD_FRAME_LENGTH, 0);
+        bfp_s32_set(&res_state->gain[ch], 1 << 30, -30);
+        bfp_s32_init(&res_state->overlap[ch], res_state->overlap_data[ch], AEC_ZEROVAL_EXP, AEC_UNUSED_TAPS_PER_PHASE*2, 0);
+        res_state->leak[ch] = f64_to_float_s32(0.0);
+    }
+    aec_res_config_t *conf = &res_state->config;
+    conf->psd_smoothing_shr = 2;
+    conf->leak_update_shr = 3;
+    conf->max_leak = f64_to_float_s32(1.0);
+    conf->overdrive = f64_to_float_s32(2.0);
+    conf->double_talk_overdrive = f64_to_float_s32(1.0);
+    conf->min_gain = f64_to_float_s32(0.1);
+}
+
+void aec_res_calc_gain(
+        aec_res_state_t *res_state,
+        const aec_state_t *main_state,
+        unsigned ch)
+{
+    const aec_res_config_t *conf = &res_state->config;
+    const coherence_mu_params_t *coh_mu_state = &main_state->shared_state->coh_mu_state[ch];
+    bfp_s32_t *Error_psd = &res_state->Error_psd[ch];
+    bfp_s32_t *Y_hat_psd = &res_state->Y_hat_psd[ch];
+    bfp_s32_t *gain = &res_state->gain[ch];
+    //Direct manipulation of mant/exp because f64_to_float_s32(0.0) takes hundreds of cycles
+    const float_s32_t zero = {0, 0};
+
+    int32_t DWORD_ALIGNED scratch_mem[AEC_FD_FRAME_LENGTH];
+    bfp_s32_t scratch;
+    bfp_s32_init(&scratch, scratch_mem, 0, AEC_FD_FRAME_LENGTH, 0);
+    bfp_complex_s32_squared_mag(&scratch, &main_state->Error[ch]);
+    res_smooth_psd(Error_psd, &scratch, conf->psd_smoothing_shr);
+    bfp_complex_s32_squared_mag(&scratch, &main_state->Y_hat[ch]);
+    res_smooth_psd(Y_hat_psd, &scratch, conf->psd_smoothing_shr);
+
+    float_s32_t Y_hat_energy = float_s64_to_float_s32(bfp_s32_dot(Y_hat_psd, Y_hat_psd));
+    if(!float_s32_gt(Y_hat_energy, zero)) {
+        //No echo estimate, so nothing to suppress
+        bfp_s32_set(gain, 1 << 30, -30);
+        return;
+    }
+
+    //Near end speech makes the coherence drop below its slow moving average, as for the adaption freeze in
+    //aec_priv_calc_coherence_mu(). The absolute coherence threshold isn't used since a filter that is shorter than the
+    //echo path, which is what the suppressor is for, keeps the coherence low.
+    const coherence_mu_config_params_t *coh_conf = &main_state->shared_state->config_params.coh_mu_conf;
+    float_s32_t coh_thresh = float_s32_mul(coh_mu_state->coh_slow, coh_conf->coh_thresh_slow);
+    unsigned double_talk = float_s32_gt(coh_thresh, coh_mu_state->coh);
+    if(!double_talk) {
+        float_s32_t leak = float_s32_div(float_s64_to_float_s32(bfp_s32_dot(Error_psd, Y_hat_psd)), Y_hat_energy);
+        leak = float_s32_gt(leak, conf->max_leak) ? conf->max_leak : leak;
+        //leak += (new_leak - leak) * pow(2, -leak_update_shr)
+        float_s32_t step = float_s32_sub(leak, res_state->leak[ch]);
+        step.exp -= conf->leak_update_shr;
+        res_state->leak[ch] = float_s32_add(res_state->leak[ch], step);
+    }
+    float_s32_t overdrive = double_talk ? conf->double_talk_overdrive : conf->overdrive;
+
+    //gain = 1 - (overdrive * leak * Y_hat_psd / Error_psd)
+    float_s32_t delta = {1, Error_psd->exp};
+    bfp_s32_add_scalar(&scratch, Error_psd, delta);
+    aec_priv_calc_inverse(&scratch);
+    bfp_s32_mul(gain, Y_hat_psd, &scratch);
+    float_s32_t minus_one = {-1, 0};
+    bfp_s32_scale(gain, gain, float_s32_mul(minus_one, float_s32_mul(overdrive, res_state->leak[ch])));
+    float_s32_t one = {1, 0};
+    bfp_s32_add_scalar(gain, gain, one);
+
+    bfp_s32_clip(gain, gain, to_q30(conf->min_gain), 1 << 30, -30);
+}
+
+void aec_res_calc_output(
+        aec_res_state_t *res_state,
+        const aec_state_t *main_state,
+        int32_t (*output)[AEC_FRAME_ADVANCE],
+        unsigned ch)
+{
+    //AEC_FD_FRAME_LENGTH complex values hold the AEC_PROC_FRAME_LENGTH sample inverse FFT
+    complex_s32_t DWORD_ALIGNED Error_mem[AEC_FD_FRAME_LENGTH];
+    bfp_complex_s32_t Error;
+    bfp_complex_s32_init(&Error, Error_mem, 0, AEC_FD_FRAME_LENGTH, 0);
+    bfp_complex_s32_real_mul(&Error, &main_state->Error[ch], &res_state->gain[ch]);
+
+    bfp_s32_t error;
+    aec_inverse_fft(&error, &Error);
+
+    bfp_s32_t output_struct;
+    bfp_s32_init(&output_struct, &output[0][0], AEC_INPUT_EXP, AEC_FRAME_ADVANCE, 0);
+    aec_priv_overlap_add_output(&output_struct, &res_state->overlap[ch], &error);
+}
@@ -0,0 +1,216 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <string.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_priv.h"
+
+/*
+ * Snapshot layout. Every field is a 32 bit word in the byte order of the device.
+ *
+ *   header:     AEC_SNAPSHOT_MAGIC, AEC_SNAPSHOT_VERSION, num_y_channels, num_x_channels, main phases, shadow phases
+ *   filters:    main filter then shadow filter, H_hat[y][x*num_phases + ph] in index order. Each phase is its exponent
+ *               followed by its AEC_FRAME_ADVANCE time domain taps
+ *   sigma_XX:   per x channel, exponent followed by AEC_FD_FRAME_LENGTH values
+ *   coherence:  per y channel, coh, coh_slow, mu_coh_count, mu_shad_count and coh_mu of every x channel
+ *
+ * The gradient constraint leaves only the first AEC_FRAME_ADVANCE time domain taps of each phase non zero, so storing
+ * them rather than the spectrum makes a snapshot about half the size for 2 FFTs per phase on save and restore.
+ */
+
+#define AEC_SNAPSHOT_MAGIC (0x53434541) // "AECS"
+#define AEC_SNAPSHOT_VERSION (1)
+#define SNAPSHOT_HEADER_WORDS (6)
+#define SNAPSHOT_PHASE_WORDS (1 + AEC_FRAME_ADVANCE)
+#define SNAPSHOT_FLOAT_WORDS (2)
+
+static inline void put_word(uint8_t **p, int32_t word)
+{
+    memcpy(*p, &word, sizeof(int32_t));
+    *p += sizeof(int32_t);
+}
+
+static inline int32_t get_word(const uint8_t **p)
+{
+    int32_t word;
+    memcpy(&word, *p, sizeof(int32_t));
+    *p += sizeof(int32_t);
+    return word;
+}
+
+static inline void put_float(uint8_t **p, float_s32_t f)
+{
+    put_word(p, f.mant);
+    put_word(p, f.exp);
+}
+
+static inline float_s32_t get_float(const uint8_t **p)
+{
+    float_s32_t f;
+    f.mant = get_word(p);
+    f.exp = get_word(p);
+    return f;
+}
+
+static void put_phase(uint8_t **p, const bfp_complex_s32_t *H)
+{
+    if(H->exp == AEC_ZEROVAL_EXP) {
+        put_word(p, AEC_ZEROVAL_EXP);
+        memset(*p, 0, AEC_FRAME_ADVANCE*sizeof(int32_t));
+        *p += AEC_FRAME_ADVANCE*sizeof(int32_t);
+        return;
+    }
+    complex_s32_t DWORD_ALIGNED data[AEC_FD_FRAME_LENGTH];
+    bfp_complex_s32_t H_copy;
+    memcpy(data, H->data, AEC_FD_FRAME_LENGTH*sizeof(complex_s32_t));
+    bfp_complex_s32_init(&H_copy, data, H->exp, AEC_FD_FRAME_LENGTH, 0);
+    H_copy.hr = H->hr;
+    bfp_fft_pack_mono(&H_copy);
+    bfp_s32_t *h = bfp_fft_inverse_mono(&H_copy);
+    put_word(p, h->exp);
+    memcpy(*p, h->data, AEC_FRAME_ADVANCE*sizeof(int32_t));
+    *p += AEC_FRAME_ADVANCE*sizeof(int32_t);
+}
+
+static void get_phase(bfp_complex_s32_t *H, const uint8_t **p)
+{
+    exponent_t exp = get_word(p);
+    if(exp == AEC_ZEROVAL_EXP) {
+        *p += AEC_FRAME_ADVANCE*sizeof(int32_t);
+        H->exp = AEC_ZEROVAL_EXP;
+        H->hr = AEC_ZEROVAL_HR;
+        return;
+    }
+    int32_t *h_data = (int32_t*)H->data;
+    memcpy(h_data, *p, AEC_FRAME_ADVANCE*sizeof(int32_t));
+    memset(&h_data[AEC_FRAME_ADVANCE], 0, (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE)*sizeof(int32_t));
+    *p += AEC_FRAME_ADVANCE*sizeof(int32_t);
+    bfp_s32_t h;
+    bfp_s32_init(&h, h_data, exp, AEC_PROC_FRAME_LENGTH, 1);
+    bfp_complex_s32_t *H_out = bfp_fft_forward_mono(&h);
+    bfp_fft_unpack_mono(H_out);
+    H->exp = H_out->exp;
+    H->hr = H_out->hr;
+}
+
+uint32_t aec_get_snapshot_size(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_shadow_filter_phases)
+{
+    uint32_t words = SNAPSHOT_HEADER_WORDS;
+    words += num_y_channels * num_x_channels * (num_main_filter_phases + num_shadow_filter_phases) * SNAPSHOT_PHASE_WORDS;
+    words += num_x_channels * (1 + AEC_FD_FRAME_LENGTH);
+    words += num_y_channels * ((2 * SNAPSHOT_FLOAT_WORDS) + 2 + (num_x_channels * SNAPSHOT_FLOAT_WORDS));
+    return words * sizeof(int32_t);
+}
+
+uint32_t aec_save_snapshot(
+        uint8_t *snapshot,
+        uint32_t snapshot_size,
+        const aec_state_t *main_state,
+        const aec_state_t *shadow_state)
+{
+    const aec_shared_state_t *shared_state = main_state->shared_state;
+    unsigned num_y = shared_state->num_y_channels;
+    unsigned num_x = shared_state->num_x_channels;
+    unsigned num_shadow_phases = (shadow_state != NULL) ? shadow_state->num_phases : 0;
+    uint32_t size = aec_get_snapshot_size(num_y, num_x, main_state->num_phases, num_shadow_phases);
+    if(snapshot_size < size) {
+        return 0;
+    }
+
+    uint8_t *p = snapshot;
+    put_word(&p, AEC_SNAPSHOT_MAGIC);
+    put_word(&p, AEC_SNAPSHOT_VERSION);
+    put_word(&p, num_y);
+    put_word(&p, num_x);
+    put_word(&p, main_state->num_phases);
+    put_word(&p, num_shadow_phases);
+
+    const aec_state_t *states[2] = {main_state, shadow_state};
+    for(int s=0; s<2; s++) {
+        if((states[s] == NULL) || (!states[s]->num_phases)) {
+            continue;
+        }
+        for(unsigned ych=0; ych<num_y; ych++) {
+            for(unsigned ph=0; ph<(num_x * states[s]->num_phases); ph++) {
+                put_phase(&p, &states[s]->H_hat[ych][ph]);
+            }
+        }
+    }
+    for(unsigned xch=0; xch<num_x; xch++) {
+        const bfp_s32_t *sigma_XX = &shared_state->sigma_XX[xch];
+        put_word(&p, sigma_XX->exp);
+        memcpy(p, sigma_XX->data, AEC_FD_FRAME_LENGTH*sizeof(int32_t));
+        p += AEC_FD_FRAME_LENGTH*sizeof(int32_t);
+    }
+    for(unsigned ych=0; ych<num_y; ych++) {
+        const coherence_mu_params_t *coh_mu_state = &shared_state->coh_mu_state[ych];
+        put_float(&p, coh_mu_state->coh);
+        put_float(&p, coh_mu_state->coh_slow);
+        put_word(&p, coh_mu_state->mu_coh_count);
+        put_word(&p, coh_mu_state->mu_shad_count);
+        for(unsigned xch=0; xch<num_x; xch++) {
+            put_float(&p, coh_mu_state->coh_mu[xch]);
+        }
+    }
+    return size;
+}
+
+int32_t aec_restore_snapshot(
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        const uint8_t *snapshot,
+        uint32_t snapshot_size)
+{
+    aec_shared_state_t *shared_state = main_state->shared_state;
+    unsigned num_y = shared_state->num_y_channels;
+    unsigned num_x = shared_state->num_x_channels;
+    unsigned num_shadow_phases = (shadow_state != NULL) ? shadow_state->num_phases : 0;
+    uint32_t size = aec_get_snapshot_size(num_y, num_x, main_state->num_phases, num_shadow_phases);
+    if(snapshot_size < size) {
+        return -1;
+    }
+
+    //Check everything before changing any state, so that a snapshot that can't be used leaves the AEC as it was
+    const uint8_t *p = snapshot;
+    const int32_t expected_header[SNAPSHOT_HEADER_WORDS] = {AEC_SNAPSHOT_MAGIC, AEC_SNAPSHOT_VERSION,
+        (int32_t)num_y, (int32_t)num_x, (int32_t)main_state->num_phases, (int32_t)num_shadow_phases};
+    for(int i=0; i<SNAPSHOT_HEADER_WORDS; i++) {
+        if(get_word(&p) != expected_header[i]) {
+            return -1;
+        }
+    }
+
+    aec_state_t *states[2] = {main_state, shadow_state};
+    for(int s=0; s<2; s++) {
+        if((states[s] == NULL) || (!states[s]->num_phases)) {
+            continue;
+        }
+        for(unsigned ych=0; ych<num_y; ych++) {
+            for(unsigned ph=0; ph<(num_x * states[s]->num_phases); ph++) {
+                get_phase(&states[s]->H_hat[ych][ph], &p);
+            }
+        }
+    }
+    for(unsigned xch=0; xch<num_x; xch++) {
+        bfp_s32_t *sigma_XX = &shared_state->sigma_XX[xch];
+        sigma_XX->exp = get_word(&p);
+        memcpy(sigma_XX->data, p, AEC_FD_FRAME_LENGTH*sizeof(int32_t));
+        p += AEC_FD_FRAME_LENGTH*sizeof(int32_t);
+        bfp_s32_headroom(sigma_XX);
+    }
+    for(unsigned ych=0; ych<num_y; ych++) {
+        coherence_mu_params_t *coh_mu_state = &shared_state->coh_mu_state[ych];
+        coh_mu_state->coh = get_float(&p);
+        coh_mu_state->coh_slow = get_float(&p);
+        coh_mu_state->mu_coh_count = get_word(&p);
+        coh_mu_state->mu_shad_count = get_word(&p);
+        for(unsigned xch=0; xch<num_x; xch++) {
+            coh_mu_state->coh_mu[xch] = get_float(&p);
+        }
+    }
+    return 0;
+}
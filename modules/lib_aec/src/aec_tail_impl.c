@@ -0,0 +1,409 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_priv.h"
+
+/*
+ * Non-uniformly partitioned tail filter.
+ *
+ * With B = AEC_TAIL_BLOCK_LENGTH and X_k the spectrum of reference samples [kB, kB+2B) zero padded to
+ * AEC_TAIL_PROC_FRAME_LENGTH, partition p models taps [mB, (m+1)B) of the echo path, where m = start_block + p. Its
+ * contribution to the echo in block b is samples [B, 2B) of IFFT(X_(b-m-1) * H_hat_p).
+ *
+ * X_k is complete at the end of block k+1. The estimate for block b+1 is accumulated during block b, a few partitions
+ * per frame, and partitions whose input is only complete in the last frame of the block are scheduled in that frame.
+ * This is what needs start_block >= 2. Each partition is adapted on the AEC output of block b-1 just before it is
+ * applied.
+ *
+ * Partitions never use X_k for k > b - start_block + 1, so the spectra covering the main filter part of the echo path
+ * aren't kept. The last start_block blocks of reference samples are kept instead, and X_(b+1-start_block) is added to
+ * the FIFO in the last frame of block b. FIFO entry i is then X_(b+1-start_block-i), and one block behind that before
+ * the last frame. Partition p uses entries p+1 and p+3, so the FIFO holds num_partitions + 3 entries.
+ *
+ * The normalisation still covers the whole echo path the main and tail filters model together. The main filter
+ * X_energy is used for the part the FIFO doesn't hold, with each main filter bin standing in for the tail filter bins
+ * around it. Both sum the power of windows that count each reference sample about twice, so it approximately matches
+ * the sum of the missing FIFO entries.
+ */
+
+#define TAIL_B (AEC_TAIL_BLOCK_LENGTH)
+/// The AEC output lags the mic input by the WOLA overlap
+#define TAIL_OUTPUT_DELAY (AEC_UNUSED_TAPS_PER_PHASE*2)
+
+/// Number of FIFO entries before the one a partition's echo estimate starts from
+#define TAIL_FIFO_LEAD (2)
+/// Number of tail filter bins per main filter bin
+#define TAIL_BINS_PER_MAIN_BIN (AEC_TAIL_PROC_FRAME_LENGTH / AEC_PROC_FRAME_LENGTH)
+
+#if (AEC_TAIL_PROC_FRAME_LENGTH < (2*AEC_TAIL_BLOCK_LENGTH))
+#error "AEC_TAIL_PROC_FRAME_LENGTH needs to hold 2 tail filter blocks"
+#endif
+#if (AEC_TAIL_PROC_FRAME_LENGTH > 1024)
+#error "AEC_TAIL_PROC_FRAME_LENGTH is longer than the 1024 point FFTs lib_xcore_math supports by default"
+#endif
+
+static unsigned tail_calc_start_block(unsigned num_main_filter_phases)
+{
+    return (num_main_filter_phases * AEC_FRAME_ADVANCE) / TAIL_B;
+}
+
+// The sizes here need to match the order in which aec_tail_init() carves up the pool.
+uint32_t aec_tail_get_required_memory(
+        unsigned num_y_channels,
+        unsigned num_x_channels,
+        unsigned num_main_filter_phases,
+        unsigned num_tail_partitions)
+{
+    unsigned start_block = tail_calc_start_block(num_main_filter_phases);
+    unsigned fifo_length = num_tail_partitions + TAIL_FIFO_LEAD + 1;
+    uint32_t size = 0;
+    //H_hat, X_fifo
+    size += ((num_y_channels * num_x_channels * num_tail_partitions) + (num_x_channels * fifo_length)) * AEC_TAIL_FD_FRAME_LENGTH * sizeof(complex_s32_t);
+    //Y_hat, Error
+    size += 2 * num_y_channels * AEC_TAIL_FD_FRAME_LENGTH * sizeof(complex_s32_t);
+    //T
+    size += AEC_TAIL_FD_FRAME_LENGTH * sizeof(complex_s32_t);
+    //x_block
+    size += num_x_channels * start_block * TAIL_B * sizeof(int32_t);
+    //error_block, y_hat_block
+    size += 2 * num_y_channels * TAIL_B * sizeof(int32_t);
+    //X_energy, inv_X_energy
+    size += 2 * num_x_channels * AEC_TAIL_FD_FRAME_LENGTH * sizeof(int32_t);
+    return size;
+}
+
+int32_t aec_tail_init(
+        aec_tail_state_t *tail_state,
+        const aec_state_t *main_state,
+        uint8_t *mem_pool,
+        uint32_t mem_pool_size,
+        unsigned num_tail_partitions)
+{
+    aec_shared_state_t *shared_state = main_state->shared_state;
+    unsigned num_y_channels = shared_state->num_y_channels;
+    unsigned num_x_channels = shared_state->num_x_channels;
+    unsigned start_block = tail_calc_start_block(main_state->num_phases);
+
+    if(((uintptr_t)mem_pool & 0x7) != 0) {
+        return -1;
+    }
+    if((num_tail_partitions == 0) || ((num_y_channels * num_x_channels * num_tail_partitions) > AEC_TAIL_MAX_PARTITIONS)) {
+        return -1;
+    }
+    if(start_block < TAIL_FIFO_LEAD) {
+        return -1;
+    }
+    if(mem_pool_size < aec_tail_get_required_memory(num_y_channels, num_x_channels, main_state->num_phases, num_tail_partitions)) {
+        return -1;
+    }
+
+    memset(tail_state, 0, sizeof(aec_tail_state_t));
+    tail_state->shared_state = shared_state;
+    tail_state->num_partitions = num_tail_partitions;
+    tail_state->start_block = start_block;
+    tail_state->fifo_length = num_tail_partitions + TAIL_FIFO_LEAD + 1;
+
+    uint8_t *available_mem_start = mem_pool;
+    //H_hat
+    for(unsigned ch=0; ch<num_y_channels; ch++) {
+        for(unsigned p=0; p<(num_x_channels * num_tail_partitions); p++) {
+            bfp_complex_s32_init(&tail_state->H_hat[ch][p], (complex_s32_t*)available_mem_start, AEC_ZEROVAL_EXP, AEC_TAIL_FD_FRAME_LENGTH, 0);
+            available_mem_start += (AEC_TAIL_FD_FRAME_LENGTH*sizeof(complex_s32_t));
+        }
+    }
+    //X_fifo
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        for(unsigned i=0; i<tail_state->fifo_length; i++) {
+            bfp_complex_s32_init(&tail_state->X_fifo[ch][i], (complex_s32_t*)available_mem_start, AEC_ZEROVAL_EXP, AEC_TAIL_FD_FRAME_LENGTH, 0);
+            //mirror entry so that fifo_length entries from any head index are contiguous
+            tail_state->X_fifo[ch][i + tail_state->fifo_length] = tail_state->X_fifo[ch][i];
+            available_mem_start += (AEC_TAIL_FD_FRAME_LENGTH*sizeof(complex_s32_t));
+        }
+        tail_state->X_fifo_head[ch] = 0;
+    }
+    //Y_hat
+    for(unsigned ch=0; ch<num_y_channels; ch++) {
+        bfp_complex_s32_init(&tail_state->Y_hat[ch], (complex_s32_t*)available_mem_start, AEC_ZEROVAL_EXP, AEC_TAIL_FD_FRAME_LENGTH, 0);
+        available_mem_start += (AEC_TAIL_FD_FRAME_LENGTH*sizeof(complex_s32_t));
+    }
+    //Error
+    for(unsigned ch=0; ch<num_y_channels; ch++) {
+        bfp_complex_s32_init(&tail_state->Error[ch], (complex_s32_t*)available_mem_start, AEC_ZEROVAL_EXP, AEC_TAIL_FD_FRAME_LENGTH, 0);
+        available_mem_start += (AEC_TAIL_FD_FRAME_LENGTH*sizeof(complex_s32_t));
+    }
+    //T
+    bfp_complex_s32_init(&tail_state->T, (complex_s32_t*)available_mem_start, AEC_ZEROVAL_EXP, AEC_TAIL_FD_FRAME_LENGTH, 0);
+    available_mem_start += (AEC_TAIL_FD_FRAME_LENGTH*sizeof(complex_s32_t));
+    //x_block
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        bfp_s32_init(&tail_state->x_block[ch], (int32_t*)available_mem_start, AEC_INPUT_EXP, start_block*TAIL_B, 0);
+        available_mem_start += (start_block*TAIL_B*sizeof(int32_t));
+    }
+    //error_block
+    for(unsigned ch=0; ch<num_y_channels; ch++) {
+        bfp_s32_init(&tail_state->error_block[ch], (int32_t*)available_mem_start, AEC_INPUT_EXP, TAIL_B, 0);
+        available_mem_start += (TAIL_B*sizeof(int32_t));
+    }
+    //y_hat_block
+    for(unsigned ch=0; ch<num_y_channels; ch++) {
+        bfp_s32_init(&tail_state->y_hat_block[ch], (int32_t*)available_mem_start, AEC_INPUT_EXP, TAIL_B, 0);
+        available_mem_start += (TAIL_B*sizeof(int32_t));
+    }
+    //X_energy
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        bfp_s32_init(&tail_state->X_energy[ch], (int32_t*)available_mem_start, AEC_ZEROVAL_EXP, AEC_TAIL_FD_FRAME_LENGTH, 0);
+        available_mem_start += (AEC_TAIL_FD_FRAME_LENGTH*sizeof(int32_t));
+    }
+    //inv_X_energy
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        bfp_s32_init(&tail_state->inv_X_energy[ch], (int32_t*)available_mem_start, AEC_ZEROVAL_EXP, AEC_TAIL_FD_FRAME_LENGTH, 0);
+        available_mem_start += (AEC_TAIL_FD_FRAME_LENGTH*sizeof(int32_t));
+    }
+    uint32_t memory_used = available_mem_start - mem_pool;
+    memset(mem_pool, 0, memory_used);
+
+    tail_state->delta.exp = AEC_ZEROVAL_EXP;
+    return 0;
+}
+
+void aec_tail_reset(aec_tail_state_t *tail_state)
+{
+    aec_shared_state_t *shared_state = tail_state->shared_state;
+    unsigned num_y_channels = shared_state->num_y_channels;
+    unsigned num_x_channels = shared_state->num_x_channels;
+
+    for(unsigned ch=0; ch<num_y_channels; ch++) {
+        for(unsigned p=0; p<(num_x_channels * tail_state->num_partitions); p++) {
+            aec_priv_bfp_complex_s32_reset(&tail_state->H_hat[ch][p]);
+        }
+        aec_priv_bfp_complex_s32_reset(&tail_state->Y_hat[ch]);
+        aec_priv_bfp_complex_s32_reset(&tail_state->Error[ch]);
+        memset(tail_state->error_block[ch].data, 0, TAIL_B*sizeof(int32_t));
+        memset(tail_state->y_hat_block[ch].data, 0, TAIL_B*sizeof(int32_t));
+        for(unsigned x_ch=0; x_ch<num_x_channels; x_ch++) {
+            tail_state->mu[ch][x_ch].mant = 0;
+            tail_state->block_mu[ch][x_ch].mant = 0;
+        }
+    }
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        //X_fifo, including the mirrored entries
+        for(unsigned i=0; i<2*tail_state->fifo_length; i++) {
+            tail_state->X_fifo[ch][i].exp = AEC_ZEROVAL_EXP;
+            tail_state->X_fifo[ch][i].hr = AEC_ZEROVAL_HR;
+        }
+        aec_priv_bfp_s32_reset(&tail_state->X_energy[ch]);
+        memset(tail_state->x_block[ch].data, 0, tail_state->start_block*TAIL_B*sizeof(int32_t));
+    }
+    tail_state->frame_index = 0;
+    tail_state->x_block_index = 0;
+}
+
+void aec_tail_remove_echo(
+        const aec_tail_state_t *tail_state,
+        int32_t (*y_data)[AEC_FRAME_ADVANCE])
+{
+    if(tail_state->shared_state->config_params.aec_core_conf.bypass) {
+        return;
+    }
+    unsigned offset = tail_state->frame_index * AEC_FRAME_ADVANCE;
+    for(unsigned ch=0; ch<tail_state->shared_state->num_y_channels; ch++) {
+        //y and y_hat_block are both 1.31. Saturating subtract
+        vect_s32_sub(&y_data[ch][0], &y_data[ch][0], &tail_state->y_hat_block[ch].data[offset], AEC_FRAME_ADVANCE, 0, 0);
+    }
+}
+
+//Add the spectrum of the oldest 2 blocks of x to the FIFO
+static void tail_push_X_block(
+        aec_tail_state_t *tail_state,
+        unsigned ch)
+{
+    unsigned fifo_length = tail_state->fifo_length;
+    unsigned head = tail_state->X_fifo_head[ch];
+    head = (head == 0) ? (fifo_length - 1) : (head - 1);
+
+    bfp_complex_s32_t *X = &tail_state->X_fifo[ch][head];
+    int32_t *frame = (int32_t*)X->data;
+    const int32_t *x_block = tail_state->x_block[ch].data;
+    unsigned oldest = (tail_state->x_block_index + 1) % tail_state->start_block;
+    unsigned next = (tail_state->x_block_index + 2) % tail_state->start_block;
+    memcpy(&frame[0], &x_block[oldest * TAIL_B], TAIL_B*sizeof(int32_t));
+    memcpy(&frame[TAIL_B], &x_block[next * TAIL_B], TAIL_B*sizeof(int32_t));
+    memset(&frame[2*TAIL_B], 0, (AEC_TAIL_PROC_FRAME_LENGTH - 2*TAIL_B)*sizeof(int32_t));
+
+    bfp_s32_t x;
+    bfp_s32_init(&x, frame, AEC_INPUT_EXP, AEC_TAIL_PROC_FRAME_LENGTH, 1);
+    aec_forward_fft(X, &x);
+    tail_state->X_fifo[ch][head + fifo_length] = *X;
+    tail_state->X_fifo_head[ch] = head;
+}
+
+//Error spectrum, normalisation spectrum and mu for adapting on the block that has just finished
+static void tail_begin_block(
+        aec_tail_state_t *tail_state,
+        const aec_state_t *main_state)
+{
+    aec_shared_state_t *shared_state = tail_state->shared_state;
+    unsigned num_y_channels = shared_state->num_y_channels;
+    unsigned num_x_channels = shared_state->num_x_channels;
+
+    for(unsigned ch=0; ch<num_y_channels; ch++) {
+        //Place the output block where the partitions' echo estimate for that block is, accounting for the output delay
+        int32_t *frame = (int32_t*)tail_state->Error[ch].data;
+        memset(frame, 0, AEC_TAIL_PROC_FRAME_LENGTH*sizeof(int32_t));
+        memcpy(&frame[TAIL_B], &tail_state->error_block[ch].data[TAIL_OUTPUT_DELAY], (TAIL_B - TAIL_OUTPUT_DELAY)*sizeof(int32_t));
+        bfp_s32_t error;
+        bfp_s32_init(&error, frame, AEC_INPUT_EXP, AEC_TAIL_PROC_FRAME_LENGTH, 1);
+        aec_forward_fft(&tail_state->Error[ch], &error);
+    }
+
+    //X energy over the whole echo path the main and tail filters cover together. Each block is counted in 2 FIFO
+    //entries, which gives the same 2*X_energy normalisation the main filter uses. The main filter X_energy stands in
+    //for the blocks before the tail filter
+    float_s32_t max_X_energy[AEC_LIB_MAX_X_CHANNELS];
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        const bfp_complex_s32_t *X_fifo = &tail_state->X_fifo[ch][tail_state->X_fifo_head[ch] + 1];
+        bfp_s32_t *X_energy = &tail_state->X_energy[ch];
+        bfp_s32_t *scratch = &tail_state->inv_X_energy[ch];
+        const bfp_s32_t *main_X_energy = &main_state->X_energy[ch];
+        for(unsigned i=0; i<AEC_TAIL_FD_FRAME_LENGTH; i++) {
+            X_energy->data[i] = main_X_energy->data[i / TAIL_BINS_PER_MAIN_BIN];
+        }
+        X_energy->exp = main_X_energy->exp;
+        X_energy->hr = main_X_energy->hr;
+        for(unsigned i=TAIL_FIFO_LEAD; i<(tail_state->fifo_length - 1); i++) {
+            bfp_complex_s32_squared_mag(scratch, &X_fifo[i]);
+            bfp_s32_add(X_energy, X_energy, scratch);
+        }
+        max_X_energy[ch] = bfp_s32_max(X_energy);
+    }
+    aec_priv_calc_delta(&tail_state->delta, max_X_energy, &shared_state->config_params, main_state->delta_scale, num_x_channels);
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        //No frequency smoothing, so sigma_XX isn't used
+        aec_priv_calc_inv_X_energy(&tail_state->inv_X_energy[ch], &tail_state->X_energy[ch], NULL, &shared_state->config_params, tail_state->delta, 1, 0);
+    }
+
+    //The main filter's coherence mu over the block that has just finished, scaled down since the tail adapts on an
+    //error that is up to 2 blocks old
+    for(unsigned y_ch=0; y_ch<num_y_channels; y_ch++) {
+        for(unsigned x_ch=0; x_ch<num_x_channels; x_ch++) {
+            float_s32_t mu = tail_state->block_mu[y_ch][x_ch];
+            mu.exp -= 2;
+            tail_state->mu[y_ch][x_ch] = mu;
+        }
+    }
+}
+
+//Estimated echo for the next block from the accumulated spectrum
+static void tail_calc_y_hat_block(
+        aec_tail_state_t *tail_state,
+        unsigned ch)
+{
+    bfp_s32_t y_hat, y_hat_chunk;
+    aec_inverse_fft(&y_hat, &tail_state->Y_hat[ch]);
+    bfp_s32_init(&y_hat_chunk, &y_hat.data[TAIL_B], y_hat.exp, TAIL_B, 1);
+    bfp_s32_use_exponent(&y_hat_chunk, AEC_INPUT_EXP);
+    memcpy(tail_state->y_hat_block[ch].data, y_hat_chunk.data, TAIL_B*sizeof(int32_t));
+
+    //start accumulating the next block
+    tail_state->Y_hat[ch].exp = AEC_ZEROVAL_EXP;
+    tail_state->Y_hat[ch].hr = AEC_ZEROVAL_HR;
+    memset(tail_state->Y_hat[ch].data, 0, AEC_TAIL_FD_FRAME_LENGTH*sizeof(complex_s32_t));
+}
+
+void aec_tail_update(
+        aec_tail_state_t *tail_state,
+        const aec_state_t *main_state,
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*output_main)[AEC_FRAME_ADVANCE])
+{
+    aec_shared_state_t *shared_state = tail_state->shared_state;
+    if(shared_state->config_params.aec_core_conf.bypass) {
+        return;
+    }
+    unsigned num_y_channels = shared_state->num_y_channels;
+    unsigned num_x_channels = shared_state->num_x_channels;
+    unsigned num_partitions = tail_state->num_partitions;
+    unsigned frame = tail_state->frame_index;
+    unsigned last_frame = (frame == (AEC_TAIL_BLOCK_FRAMES - 1));
+
+    if(frame == 0) {
+        tail_begin_block(tail_state, main_state);
+    }
+    for(unsigned y_ch=0; y_ch<num_y_channels; y_ch++) {
+        //Lowest main filter mu over the block, so that the tail filter stays frozen for a block the main filter was
+        //frozen in at any point
+        for(unsigned x_ch=0; x_ch<num_x_channels; x_ch++) {
+            float_s32_t main_mu = main_state->mu[y_ch][x_ch];
+            if((frame == 0) || float_s32_gt(tail_state->block_mu[y_ch][x_ch], main_mu)) {
+                tail_state->block_mu[y_ch][x_ch] = main_mu;
+            }
+        }
+        //The main filter has been replaced by the shadow filter, so start the tail again as well
+        if(shared_state->shadow_filter_params.shadow_flag[y_ch] == COPY) {
+            for(unsigned p=0; p<(num_x_channels * num_partitions); p++) {
+                aec_priv_bfp_complex_s32_reset(&tail_state->H_hat[y_ch][p]);
+            }
+            for(unsigned x_ch=0; x_ch<num_x_channels; x_ch++) {
+                tail_state->mu[y_ch][x_ch].mant = 0;
+            }
+        }
+    }
+
+    for(unsigned ch=0; ch<num_x_channels; ch++) {
+        memcpy(&tail_state->x_block[ch].data[(tail_state->x_block_index * TAIL_B) + (frame * AEC_FRAME_ADVANCE)], &x_data[ch][0], AEC_FRAME_ADVANCE*sizeof(int32_t));
+    }
+    for(unsigned ch=0; ch<num_y_channels; ch++) {
+        memcpy(&tail_state->error_block[ch].data[frame * AEC_FRAME_ADVANCE], &output_main[ch][0], AEC_FRAME_ADVANCE*sizeof(int32_t));
+    }
+    if(last_frame) {
+        for(unsigned ch=0; ch<num_x_channels; ch++) {
+            tail_push_X_block(tail_state, ch);
+        }
+        tail_state->x_block_index = (tail_state->x_block_index + 1) % tail_state->start_block;
+    }
+
+    //Partitions p = AEC_TAIL_BLOCK_FRAMES - 1 - frame (mod AEC_TAIL_BLOCK_FRAMES) are done in this frame. Until the push
+    //in the last frame, the FIFO entries are one block behind
+    unsigned first_partition = AEC_TAIL_BLOCK_FRAMES - 1 - frame;
+    unsigned fifo_offset = last_frame ? 0 : 1;
+    if(first_partition < num_partitions) {
+        for(unsigned y_ch=0; y_ch<num_y_channels; y_ch++) {
+            for(unsigned x_ch=0; x_ch<num_x_channels; x_ch++) {
+                const bfp_complex_s32_t *X_fifo = &tail_state->X_fifo[x_ch][tail_state->X_fifo_head[x_ch]];
+                bfp_complex_s32_t *H_hat = &tail_state->H_hat[y_ch][x_ch * num_partitions];
+                //Freeze along with the main filter
+                float_s32_t mu = tail_state->mu[y_ch][x_ch];
+                if(main_state->mu[y_ch][x_ch].mant == 0) {
+                    mu.mant = 0;
+                }
+                if(mu.mant != 0) {
+                    aec_priv_compute_T(&tail_state->T, &tail_state->Error[y_ch], &tail_state->inv_X_energy[x_ch], mu);
+                }
+                for(unsigned p=first_partition; p<num_partitions; p+=AEC_TAIL_BLOCK_FRAMES) {
+                    //Offset of the partition into the FIFO, which starts TAIL_FIFO_LEAD blocks before the tail filter
+                    unsigned m = TAIL_FIFO_LEAD + p;
+                    if(mu.mant != 0) {
+                        //Adapt on the previous block's error and the reference that produced its echo estimate
+                        bfp_complex_s32_conj_macc(&H_hat[p], &tail_state->T, &X_fifo[m + 1 - fifo_offset]);
+                        bfp_fft_pack_mono(&H_hat[p]);
+                        bfp_complex_s32_gradient_constraint_mono(&H_hat[p], TAIL_B);
+                        bfp_fft_unpack_mono(&H_hat[p]);
+                    }
+                    //Echo estimate for the next block
+                    bfp_complex_s32_macc(&tail_state->Y_hat[y_ch], &X_fifo[m - 1 - fifo_offset], &H_hat[p]);
+                }
+            }
+        }
+    }
+
+    if(last_frame) {
+        for(unsigned ch=0; ch<num_y_channels; ch++) {
+            tail_calc_y_hat_block(tail_state, ch);
+        }
+    }
+    tail_state->frame_index = last_frame ? 0 : (frame + 1);
+}
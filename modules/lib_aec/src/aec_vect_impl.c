@@ -0,0 +1,161 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdint.h>
+#include <string.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_priv.h"
+
+/*
+ * Fused host kernels for the hot AEC operations.
+ *
+ * Instead of accumulating one phase at a time through the 32-bit BFP macc (which renormalises the accumulator after
+ * every phase), all terms are first aligned to a common exponent and summed in 64-bit integers, and the result is
+ * normalised back to 32-bit mantissas once. The loops over bins are written with no cross-bin dependencies so that the
+ * host compiler can vectorise them (e.g. AVX2 vpmuldq on x86, smull/smlal on Arm).
+ *
+ * The common exponent is picked so that the 64-bit sum can't overflow while keeping ~30 guard bits below the output
+ * LSB, so the result is within AEC_VECT_LSB_TOLERANCE LSB of the exact result at the output exponent. The BFP path
+ * rounds after every phase, so the two agree to within AEC_VECT_LSB_TOLERANCE LSB per accumulated term. These kernels
+ * are only used in place of the BFP path when AEC_VECT_BACKEND is enabled. Builds without it are bit-exact with xcore.
+ */
+
+//Number of bits needed to hold a sum of count values
+static int vect_sum_growth_bits(unsigned count)
+{
+    int bits = 0;
+    while((1u << bits) < count) {
+        bits++;
+    }
+    return bits;
+}
+
+//Shift a 64-bit value right by shr (left if shr is negative). Right shifts floor towards -inf.
+static inline int64_t vect_ashr64(int64_t x, int shr)
+{
+    if(shr >= 63) {
+        return (x < 0) ? -1 : 0;
+    }
+    if(shr >= 0) {
+        return x >> shr;
+    }
+    return (int64_t)((uint64_t)x << (-shr));
+}
+
+//Largest magnitude in a 64-bit accumulator vector
+static uint64_t vect_s64_max_abs(const int64_t *acc, unsigned length)
+{
+    uint64_t max = 0;
+    for(unsigned i=0; i<length; i++) {
+        uint64_t a = (acc[i] < 0) ? (uint64_t)(-acc[i]) : (uint64_t)acc[i];
+        max = (a > max) ? a : max;
+    }
+    return max;
+}
+
+//Pick the right shift that brings the accumulator down to 32-bit mantissas with 1 bit of headroom
+static int vect_s64_normalise_shift(uint64_t max_abs)
+{
+    int shr = 0;
+    while((max_abs >> shr) >= (1ull << 30)) {
+        shr++;
+    }
+    return shr;
+}
+
+static inline int32_t vect_round_shr64(int64_t x, int shr)
+{
+    if(shr == 0) {
+        return (int32_t)x;
+    }
+    return (int32_t)((x + ((int64_t)1 << (shr - 1))) >> shr);
+}
+
+void aec_vect_complex_s32_macc(
+        bfp_complex_s32_t *acc,
+        const bfp_complex_s32_t *b,
+        const bfp_complex_s32_t *c,
+        unsigned count,
+        unsigned offset,
+        unsigned conj_c)
+{
+    const unsigned length = acc->length;
+    int64_t DWORD_ALIGNED acc_re[AEC_FD_FRAME_LENGTH];
+    int64_t DWORD_ALIGNED acc_im[AEC_FD_FRAME_LENGTH];
+
+    //Log2 bound on the magnitude of every term. A complex product term has 2 partial products per real/imag part.
+    int max_bound = acc->exp + 31 - (int)acc->hr;
+    for(unsigned p=0; p<count; p++) {
+        int bound = b[p].exp + c[p].exp + 63 - (int)b[p].hr - (int)c[p].hr;
+        max_bound = (bound > max_bound) ? bound : max_bound;
+    }
+    const int acc_exp = max_bound + vect_sum_growth_bits(count + 1) - 62;
+
+    //existing accumulator contents
+    const int acc_shr = acc_exp - acc->exp;
+    for(unsigned i=0; i<length; i++) {
+        acc_re[i] = vect_ashr64((int64_t)acc->data[i].re, acc_shr);
+        acc_im[i] = vect_ashr64((int64_t)acc->data[i].im, acc_shr);
+    }
+
+    //product terms
+    for(unsigned p=0; p<count; p++) {
+        const complex_s32_t *restrict b_data = &b[p].data[offset];
+        const complex_s32_t *restrict c_data = &c[p].data[offset];
+        const int shr = acc_exp - (b[p].exp + c[p].exp);
+        const int64_t c_im_sign = conj_c ? -1 : 1;
+        for(unsigned i=0; i<length; i++) {
+            int64_t b_re = b_data[i].re, b_im = b_data[i].im;
+            int64_t c_re = c_data[i].re, c_im = c_im_sign * c_data[i].im;
+            acc_re[i] += vect_ashr64(b_re*c_re, shr) - vect_ashr64(b_im*c_im, shr);
+            acc_im[i] += vect_ashr64(b_re*c_im, shr) + vect_ashr64(b_im*c_re, shr);
+        }
+    }
+
+    uint64_t max_re = vect_s64_max_abs(acc_re, length);
+    uint64_t max_im = vect_s64_max_abs(acc_im, length);
+    const int out_shr = vect_s64_normalise_shift((max_re > max_im) ? max_re : max_im);
+    for(unsigned i=0; i<length; i++) {
+        acc->data[i].re = vect_round_shr64(acc_re[i], out_shr);
+        acc->data[i].im = vect_round_shr64(acc_im[i], out_shr);
+    }
+    acc->exp = acc_exp + out_shr;
+    acc->hr = vect_complex_s32_headroom(acc->data, length);
+}
+
+void aec_vect_energy_update(
+        bfp_s32_t *energy,
+        const bfp_complex_s32_t *X_sub,
+        const bfp_complex_s32_t *X_add)
+{
+    const unsigned length = energy->length;
+    int64_t DWORD_ALIGNED acc[AEC_FD_FRAME_LENGTH];
+
+    //Log2 bound on the magnitude of every term. A squared magnitude has 2 partial products.
+    int max_bound = energy->exp + 31 - (int)energy->hr;
+    int sub_bound = 2*X_sub->exp + 63 - 2*(int)X_sub->hr;
+    int add_bound = 2*X_add->exp + 63 - 2*(int)X_add->hr;
+    max_bound = (sub_bound > max_bound) ? sub_bound : max_bound;
+    max_bound = (add_bound > max_bound) ? add_bound : max_bound;
+    const int acc_exp = max_bound + vect_sum_growth_bits(3) - 62;
+
+    const int energy_shr = acc_exp - energy->exp;
+    const int sub_shr = acc_exp - 2*X_sub->exp;
+    const int add_shr = acc_exp - 2*X_add->exp;
+    const complex_s32_t *restrict sub = X_sub->data;
+    const complex_s32_t *restrict add = X_add->data;
+    for(unsigned i=0; i<length; i++) {
+        int64_t s_re = sub[i].re, s_im = sub[i].im;
+        int64_t a_re = add[i].re, a_im = add[i].im;
+        acc[i] = vect_ashr64((int64_t)energy->data[i], energy_shr)
+               - vect_ashr64(s_re*s_re, sub_shr) - vect_ashr64(s_im*s_im, sub_shr)
+               + vect_ashr64(a_re*a_re, add_shr) + vect_ashr64(a_im*a_im, add_shr);
+    }
+
+    const int out_shr = vect_s64_normalise_shift(vect_s64_max_abs(acc, length));
+    for(unsigned i=0; i<length; i++) {
+        energy->data[i] = vect_round_shr64(acc[i], out_shr);
+    }
+    energy->exp = acc_exp + out_shr;
+    energy->hr = vect_s32_headroom(energy->data, length);
+}
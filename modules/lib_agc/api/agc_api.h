@@ -68,6 +68,9 @@ typedef struct {
     int lc_n_frame_near;
     /** Threshold for far-end correlation above which to indicate far-end activity only. */
     float_s32_t lc_corr_threshold;
+    /** Boolean to detect double-talk from the `aec_double_talk_flag` meta-data instead of
+     *  comparing `aec_corr_factor` with `lc_corr_threshold`. */
+    int lc_use_aec_double_talk;
     /** Gamma coefficient for estimating the power of the far-end background noise. */
     float_s32_t lc_bg_power_gamma;
     /** Factor by which to increase the loss control gain when less than target value. */
@@ -173,6 +176,9 @@ typedef struct {
     /** Correlation factor between the microphone input and the AEC's estimated microphone
      *  signal. */
     float_s32_t aec_corr_factor;
+    /** Boolean to indicate that the AEC has detected near-end activity while the far-end is
+     *  active. Only used if `agc_config_t::lc_use_aec_double_talk` is enabled. */
+    int aec_double_talk_flag;
 } agc_meta_data_t;
 
 /**
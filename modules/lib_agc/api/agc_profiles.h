@@ -39,6 +39,7 @@
     .lc_n_frame_far = 0, \
     .lc_n_frame_near = 0, \
     .lc_corr_threshold = f32_to_float_s32(0), \
+    .lc_use_aec_double_talk = 0, \
     .lc_bg_power_gamma = f32_to_float_s32(0), \
     .lc_gamma_inc = f32_to_float_s32(0), \
     .lc_gamma_dec = f32_to_float_s32(0), \
@@ -71,6 +72,7 @@
     .lc_n_frame_far = 0, \
     .lc_n_frame_near = 0, \
     .lc_corr_threshold = f32_to_float_s32(0), \
+    .lc_use_aec_double_talk = 0, \
     .lc_bg_power_gamma = f32_to_float_s32(0), \
     .lc_gamma_inc = f32_to_float_s32(0), \
     .lc_gamma_dec = f32_to_float_s32(0), \
@@ -164,10 +164,16 @@ void agc_process_frame(agc_state_t *agc,
     }
 
     if (agc->config.lc_enabled) {
-        if (float_s32_gt(meta_data->aec_corr_factor, agc->lc_corr_val)) {
-            agc->lc_corr_val = meta_data->aec_corr_factor;
+        unsigned double_talk;
+        if (agc->config.lc_use_aec_double_talk) {
+            double_talk = (meta_data->aec_double_talk_flag != 0);
         } else {
-            agc->lc_corr_val = float_s32_ema(agc->lc_corr_val, meta_data->aec_corr_factor, AGC_ALPHA_LC_CORR);
+            if (float_s32_gt(meta_data->aec_corr_factor, agc->lc_corr_val)) {
+                agc->lc_corr_val = meta_data->aec_corr_factor;
+            } else {
+                agc->lc_corr_val = float_s32_ema(agc->lc_corr_val, meta_data->aec_corr_factor, AGC_ALPHA_LC_CORR);
+            }
+            double_talk = float_s32_gt(agc->config.lc_corr_threshold, agc->lc_corr_val);
         }
 
         if (float_s32_gt(agc->lc_far_power_est, float_s32_mul(agc->config.lc_far_delta, agc->lc_far_bg_power_est))) {
@@ -181,8 +187,7 @@ void agc_process_frame(agc_state_t *agc,
         float_s32_t delta = (agc->lc_t_far > 0) ? agc->config.lc_near_delta_far_active : agc->config.lc_near_delta;
 
         if (float_s32_gt(agc->lc_near_power_est, float_s32_mul(delta, agc->lc_near_bg_power_est))) {
-            if (agc->lc_t_far == 0 || (agc->lc_t_far > 0 &&
-                                       float_s32_gt(agc->config.lc_corr_threshold, agc->lc_corr_val))) {
+            if (agc->lc_t_far == 0 || (agc->lc_t_far > 0 && double_talk)) {
                 // Near-end speech only or double talk
                 agc->lc_t_near = agc->config.lc_n_frame_near;
             } else {
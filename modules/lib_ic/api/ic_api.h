@@ -22,9 +22,12 @@
  * @brief Initialise IC and VNR data structures and set parameters according to ic_defines.h
  *
  * This is the first function that must called after creating an ic_state_t instance.
+ * It claims a free VNR model instance for the IC's VNR inference context with vnr_inference_ctx_init(), so there need
+ * to be as many model instances, set by VNR_INFERENCE_MAX_CONTEXTS, as IC instances and other VNR inference contexts
+ * used at the same time. Calling ic_init() again on the same state doesn't claim a second model instance.
  *
  * @param[inout] state pointer to IC state structure
- * @returns Error status of the VNR inference engine initialisation that is done as part of ic_init. 0 if no error, one of TfLiteStatus error enum values in case of error. 
+ * @returns Error status of the VNR inference engine initialisation that is done as part of ic_init. 0 if no error, -1 if there is no free VNR model instance, one of TfLiteStatus error enum values in case of error. 
  * @ingroup ic_func
  */
 int32_t ic_init(ic_state_t *state);
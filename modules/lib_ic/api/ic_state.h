@@ -143,6 +143,9 @@ typedef struct {
 // Struct to keep VNR predictions and the EMA alpha
 typedef struct {
     vnr_feature_state_t feature_state[2];
+    // VNR inference context. ic_init() claims a free model instance for it, so every IC instance runs inference on its
+    // own model instance.
+    vnr_inference_ctx_t inference_ctx;
     float_s32_t input_vnr_pred;
     float_s32_t output_vnr_pred;
     q2_30 pred_alpha_q30;
@@ -205,10 +208,12 @@ typedef struct {
     /** Storage for H_hat mantissas. */
     complex_s32_t DWORD_ALIGNED H_hat[IC_Y_CHANNELS][IC_FILTER_PHASES*IC_X_CHANNELS][IC_FD_FRAME_LENGTH];
 
-    /** BFP array pointing to the frequency domain X input history used for calculating normalisation. */
-    bfp_complex_s32_t X_fifo_bfp[IC_X_CHANNELS][IC_FILTER_PHASES];
-    /** 1D alias of the frequency domain X input history used for calculating normalisation. */
-    bfp_complex_s32_t X_fifo_1d_bfp[IC_X_CHANNELS*IC_FILTER_PHASES];
+    /** BFP array pointing to the frequency domain X input history used for calculating normalisation.
+     * Circular buffer where entries IC_FILTER_PHASES onwards mirror the first IC_FILTER_PHASES entries, so
+     * &X_fifo_bfp[ch][X_fifo_head[ch]] points to the phases ordered from newest to oldest. */
+    bfp_complex_s32_t X_fifo_bfp[IC_X_CHANNELS][2*IC_FILTER_PHASES];
+    /** Index of the newest phase in X_fifo_bfp. */
+    unsigned X_fifo_head[IC_X_CHANNELS];
     /** Storage for X_fifo mantissas. */
     complex_s32_t DWORD_ALIGNED X_fifo[IC_X_CHANNELS][IC_FILTER_PHASES][IC_FD_FRAME_LENGTH];
 
@@ -12,7 +12,7 @@ static int32_t ic_init_vnr_pred_state(vnr_pred_state_t *vnr_pred_state){
     vnr_feature_state_init(&vnr_pred_state->feature_state[0]);
     vnr_feature_state_init(&vnr_pred_state->feature_state[1]);
 
-    int32_t ret = vnr_inference_init();
+    int32_t ret = vnr_inference_ctx_init(&vnr_pred_state->inference_ctx, VNR_INFERENCE_ANY_INSTANCE);
     vnr_pred_state->pred_alpha_q30 = Q30(IC_INIT_VNR_PRED_ALPHA);
     vnr_pred_state->input_vnr_pred = f32_to_float_s32(IC_INIT_INPUT_VNR_PRED);
     vnr_pred_state->output_vnr_pred = f32_to_float_s32(IC_INIT_OUTPUT_VNR_PRED);
@@ -77,7 +77,7 @@ int32_t ic_init(ic_state_t *state){
     for(unsigned ch=0; ch<IC_X_CHANNELS; ch++) {
         for(unsigned ph=0; ph<IC_FILTER_PHASES; ph++) {
             bfp_complex_s32_init(&state->X_fifo_bfp[ch][ph], state->X_fifo[ch][ph], zero_exp, IC_FD_FRAME_LENGTH, 0);
-            bfp_complex_s32_init(&state->X_fifo_1d_bfp[ch * IC_FILTER_PHASES + ph], state->X_fifo[ch][ph], zero_exp, IC_FD_FRAME_LENGTH, 0);
+            bfp_complex_s32_init(&state->X_fifo_bfp[ch][ph + IC_FILTER_PHASES], state->X_fifo[ch][ph], zero_exp, IC_FD_FRAME_LENGTH, 0);
         }
     }
     // Initialise Error
@@ -198,9 +198,6 @@ void ic_filter(
         ic_update_X_fifo_and_calc_sigmaXX(state, ch);
     }
 
-    // Update the 1 dimensional bfp structs that are also used to access X_fifo
-    ic_update_X_fifo_1d(state);
-
     for(int ch=0; ch<IC_Y_CHANNELS; ch++) {
         ic_calc_Error_and_Y_hat(state, ch);
     }
@@ -245,17 +242,22 @@ void ic_calc_vnr_pred(
 	float_s32_t * input_vnr_pred,
 	float_s32_t * output_vnr_pred){
 
-    bfp_s32_t feature_patch;
-    int32_t feature_patch_data[VNR_PATCH_WIDTH * VNR_MEL_FILTERS];
-    vnr_extract_features(&ic_state->vnr_pred_state.feature_state[0], &feature_patch, feature_patch_data, &ic_state->Y_bfp[0]);
-    float_s32_t ie_output;
-    vnr_inference(&ie_output, &feature_patch);
-    ic_state->vnr_pred_state.input_vnr_pred = float_s32_ema(ic_state->vnr_pred_state.input_vnr_pred, ie_output, ic_state->vnr_pred_state.pred_alpha_q30);
+#if (IC_FRAME_LENGTH != VNR_PROC_FRAME_LENGTH) || (IC_FRAME_ADVANCE != VNR_FRAME_ADVANCE)
+    #error IC spectra can not be shared with the VNR feature extraction
+#endif
+    // Features of the input and output, run through the inference engine as one batch. The features come straight
+    // from the IC spectra, which always have VNR_FD_FRAME_LENGTH bins so the return values don't need checking.
+    bfp_s32_t feature_patch[2];
+    int32_t feature_patch_data[2][VNR_PATCH_WIDTH * VNR_MEL_FILTERS];
+    vnr_extract_features_from_spectrum(&ic_state->vnr_pred_state.feature_state[0], &feature_patch[0], feature_patch_data[0], &ic_state->Y_bfp[0]);
+    vnr_extract_features_from_spectrum(&ic_state->vnr_pred_state.feature_state[1], &feature_patch[1], feature_patch_data[1], &ic_state->Error_bfp[0]);
+    float_s32_t ie_output[2];
+    vnr_inference_run_batch(&ic_state->vnr_pred_state.inference_ctx, ie_output, feature_patch, 2);
+
+    ic_state->vnr_pred_state.input_vnr_pred = float_s32_ema(ic_state->vnr_pred_state.input_vnr_pred, ie_output[0], ic_state->vnr_pred_state.pred_alpha_q30);
     *input_vnr_pred = ic_state->vnr_pred_state.input_vnr_pred;
 
-    vnr_extract_features(&ic_state->vnr_pred_state.feature_state[1], &feature_patch, feature_patch_data, &ic_state->Error_bfp[0]);
-    vnr_inference(&ie_output, &feature_patch);
-    ic_state->vnr_pred_state.output_vnr_pred = float_s32_ema(ic_state->vnr_pred_state.output_vnr_pred, ie_output, ic_state->vnr_pred_state.pred_alpha_q30);
+    ic_state->vnr_pred_state.output_vnr_pred = float_s32_ema(ic_state->vnr_pred_state.output_vnr_pred, ie_output[1], ic_state->vnr_pred_state.pred_alpha_q30);
     *output_vnr_pred = ic_state->vnr_pred_state.output_vnr_pred;
 }
 
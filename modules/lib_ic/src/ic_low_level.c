@@ -144,7 +144,7 @@ void ic_update_X_energy(
     bfp_s32_t *X_energy_ptr = &state->X_energy_bfp[ch];
     bfp_complex_s32_t *X_ptr = &state->X_bfp[ch];
     float_s32_t *max_X_energy_ptr = &state->max_X_energy[ch];
-    aec_priv_update_total_X_energy(X_energy_ptr, max_X_energy_ptr, &state->X_fifo_bfp[ch][0], X_ptr, IC_FILTER_PHASES, recalc_bin);
+    aec_priv_update_total_X_energy(X_energy_ptr, max_X_energy_ptr, &state->X_fifo_bfp[ch][state->X_fifo_head[ch]], X_ptr, IC_FILTER_PHASES, recalc_bin);
 }
 
 // Update X-fifo with the newest X data. Calculate sigmaXX
@@ -156,19 +156,16 @@ void ic_update_X_fifo_and_calc_sigmaXX(
     bfp_complex_s32_t *X_ptr = &state->X_bfp[ch];
     uint32_t sigma_xx_shift = state->config_params.sigma_xx_shift;
     float_s32_t *sum_X_energy_ptr = &state->sum_X_energy[ch];
-    aec_priv_update_X_fifo_and_calc_sigmaXX(&state->X_fifo_bfp[ch][0], sigma_XX_ptr, sum_X_energy_ptr, X_ptr, IC_FILTER_PHASES, sigma_xx_shift);
+    aec_priv_update_X_fifo_and_calc_sigmaXX(&state->X_fifo_bfp[ch][0], &state->X_fifo_head[ch], sigma_XX_ptr, sum_X_energy_ptr, X_ptr, IC_FILTER_PHASES, sigma_xx_shift);
 
 }
 
-// Update the 1d form of X-fifo pointers
-void ic_update_X_fifo_1d(
-        ic_state_t *state){
-    unsigned count = 0;
+// Get newest to oldest phase pointers into the circular X-fifo
+static void ic_get_X_fifo_windows(
+        ic_state_t *state,
+        const bfp_complex_s32_t **X_fifo){
     for(unsigned ch=0; ch<IC_X_CHANNELS; ch++) {
-        for(unsigned ph=0; ph<IC_FILTER_PHASES; ph++) {
-            state->X_fifo_1d_bfp[count] = state->X_fifo_bfp[ch][ph];
-            count += 1;
-        }
+        X_fifo[ch] = &state->X_fifo_bfp[ch][state->X_fifo_head[ch]];
     }
 }
 
@@ -179,7 +176,8 @@ void ic_calc_Error_and_Y_hat(
     bfp_complex_s32_t *Y_ptr = &state->Y_bfp[ch];
     bfp_complex_s32_t *Y_hat_ptr = &state->Y_hat_bfp[ch];
     bfp_complex_s32_t *Error_ptr = &state->Error_bfp[ch];
-    bfp_complex_s32_t *X_fifo = state->X_fifo_1d_bfp;
+    const bfp_complex_s32_t *X_fifo[IC_X_CHANNELS];
+    ic_get_X_fifo_windows(state, X_fifo);
     bfp_complex_s32_t *H_hat = state->H_hat_bfp[ch];
 
     int32_t bypass_enabled = state->config_params.bypass;
@@ -243,7 +241,9 @@ void ic_filter_adapt(ic_state_t *state){
     }
     bfp_complex_s32_t *T_ptr = &state->T_bfp[0];
     int y_ch = 0;
-    aec_priv_filter_adapt(state->H_hat_bfp[y_ch], state->X_fifo_1d_bfp, T_ptr, IC_X_CHANNELS, IC_FILTER_PHASES);
+    const bfp_complex_s32_t *X_fifo[IC_X_CHANNELS];
+    ic_get_X_fifo_windows(state, X_fifo);
+    aec_priv_filter_adapt(state->H_hat_bfp[y_ch], X_fifo, T_ptr, IC_X_CHANNELS, IC_FILTER_PHASES);
 }
 
 // Arithmetic shift for a signed int32_t
@@ -61,10 +61,6 @@ void ic_update_X_fifo_and_calc_sigmaXX(
         ic_state_t *state,
         unsigned ch);
 
-// Update the 1d form of X-fifo pointers
-void ic_update_X_fifo_1d(
-        ic_state_t *state);
-
 // Calculate filter Error and Y_hat
 void ic_calc_Error_and_Y_hat(
         ic_state_t *state,
@@ -23,5 +23,31 @@
  */
 #define VNR_PATCH_WIDTH (4)
 
+/** Number of VNR model instances, and so of inference contexts that can be initialised at the same time, including
+ * the one used by vnr_inference() and one per IC instance. Each instance has its own tensor arena and copy of the
+ * model, including about 8 KB of const model weights that are not shared between instances. Can be overridden at
+ * compile time, up to a maximum of 4.
+ * @ingroup vnr_defines
+ */
+#ifndef VNR_INFERENCE_MAX_CONTEXTS
+#define VNR_INFERENCE_MAX_CONTEXTS (1)
+#endif
+
+/** Value of the model_index argument of vnr_inference_ctx_init() to claim any free model instance.
+ * @ingroup vnr_defines
+ */
+#define VNR_INFERENCE_ANY_INSTANCE (-1)
+
+/** Number of feature patches vnr_inference_run_batch() quantises and runs through the model in one go. Longer batches
+ * are run this many patches at a time. Each patch in a batch adds VNR_PATCH_WIDTH * VNR_MEL_FILTERS bytes of stack for
+ * the quantised features.
+ * @ingroup vnr_defines
+ */
+#define VNR_INFERENCE_MAX_BATCH (4)
+
+#if (VNR_INFERENCE_MAX_CONTEXTS < 1) || (VNR_INFERENCE_MAX_CONTEXTS > 4)
+#error VNR_INFERENCE_MAX_CONTEXTS must be between 1 and 4
+#endif
+
 #endif
 
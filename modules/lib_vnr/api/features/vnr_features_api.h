@@ -35,7 +35,8 @@ void vnr_input_state_init(vnr_input_state_t *input_state);
  *
  * The frequency spectrum output from this function is processed through the VNR feature extraction stage.
  *
- * If sharing the DFT spectrum calculated in some other module, vnr_form_input_frame() is not needed.
+ * If sharing the DFT spectrum calculated in some other module, vnr_form_input_frame() is not needed. See
+ * vnr_extract_features_from_spectrum().
  *
  * @param[inout] input_state pointer to the VNR input state structure
  * @param[out] X pointer to a variable of type bfp_complex_s32_t that the user allocates. The user doesn't need to initialise this bfp variable. After this function,
@@ -81,6 +82,7 @@ void vnr_feature_state_init(vnr_feature_state_t *feature_state);
  *             It can then be passed to the inference stage.
  * @param[out] feature_patch_data Pointer to the VNR_PATCH_WIDTH * VNR_MEL_FILTERS int32_t values allocated by the user. The extracted features will be written
  *             to the feature_patch_data array and the BFP structure's ``feature_patch->data`` will point to this array.
+ * @param[in] X Pointer to the DFT spectrum of the input frame, as output by vnr_form_input_frame()
  *
  * @ingroup vnr_features_api
  */
@@ -89,4 +91,43 @@ void vnr_extract_features(vnr_feature_state_t *vnr_feature_state,
         int32_t feature_patch_data[VNR_PATCH_WIDTH * VNR_MEL_FILTERS],
         const bfp_complex_s32_t *X);
 
+/**
+ * @brief Extract features from a DFT spectrum shared with another module.
+ *
+ * Modules that already compute the DFT of the signal that the VNR runs on can pass it to this function instead of
+ * calling vnr_form_input_frame() on the time domain samples, which saves a framing and a FFT every frame. The IC does
+ * this with its Y_bfp and Error_bfp spectra, and the AEC's mic spectrum Y could be used in the same way.
+ *
+ * The spectrum must be the DFT of an unwindowed VNR_PROC_FRAME_LENGTH samples frame, moving on by VNR_FRAME_ADVANCE
+ * samples every frame, as that is what the VNR model has been trained on. Spectra of windowed frames, like the NS
+ * spectrum or the AEC error spectrum, can be passed in but the predictions will be off. The spectrum can have any gain
+ * and exponent, since the features are normalised.
+ *
+ * X is either the VNR_FD_FRAME_LENGTH bins from DC to Nyquist, or the VNR_PACKED_FD_FRAME_LENGTH bins output by
+ * bfp_fft_forward_mono() before bfp_fft_unpack_mono(), with the Nyquist bin in the imaginary part of the DC bin.
+ * X is not modified so the spectrum can still be used by the module it belongs to.
+ *
+ * @param[inout] vnr_feature_state Pointer to the VNR feature extraction state structure
+ * @param[out] feature_patch Pointer to the bfp_s32_t structure allocated by the user, as for vnr_extract_features()
+ * @param[out] feature_patch_data Pointer to the VNR_PATCH_WIDTH * VNR_MEL_FILTERS int32_t values allocated by the user,
+ *             as for vnr_extract_features()
+ * @param[in] X Pointer to the shared DFT spectrum
+ *
+ * @returns 0 on success, or -1 if X has neither VNR_FD_FRAME_LENGTH nor VNR_PACKED_FD_FRAME_LENGTH bins, in which
+ *          case the feature state and feature_patch are not updated
+ *
+ * @par Example
+ * @code{.c}
+ *      #include "vnr_features_api.h"
+        bfp_s32_t feature_patch;
+        int32_t feature_patch_data[VNR_PATCH_WIDTH * VNR_MEL_FILTERS];
+        vnr_extract_features_from_spectrum(&vnr_feature_state, &feature_patch, feature_patch_data, &ic_state.Y_bfp[0]);
+ * @endcode
+ * @ingroup vnr_features_api
+ */
+int32_t vnr_extract_features_from_spectrum(vnr_feature_state_t *vnr_feature_state,
+        bfp_s32_t *feature_patch,
+        int32_t feature_patch_data[VNR_PATCH_WIDTH * VNR_MEL_FILTERS],
+        const bfp_complex_s32_t *X);
+
 #endif
@@ -38,6 +38,13 @@
  */   
 #define VNR_FD_FRAME_LENGTH ((VNR_PROC_FRAME_LENGTH/2)+1)
 
+/** Number of bins of spectrum data in the packed output of bfp_fft_forward_mono() for a VNR_PROC_FRAME_LENGTH length time
+ * domain vector. The real Nyquist bin is stored in the imaginary part of the DC bin. NOT USER MODIFIABLE.
+ *
+ * @ingroup vnr_features_state
+ */
+#define VNR_PACKED_FD_FRAME_LENGTH (VNR_PROC_FRAME_LENGTH/2)
+
 /**
  * @brief VNR form_input state structure
  *
@@ -17,6 +17,7 @@
 extern "C" {
 #endif
     #include "xmath/xmath.h"
+    #include "vnr_inference_state.h"
 
     /**
      * @brief Initialise the inference_engine object and load the VNR model into the inference engine.
@@ -25,6 +26,10 @@ extern "C" {
      * It is called once at startup. The memory required for the inference engine object as well as the tensor arena size required for inference 
      * is statically allocated as global buffers in the VNR module. The VNR model is compiled as part of the VNR module.
      *
+     * This initialises a context that is used by vnr_inference(). It claims a model instance the same way as
+     * vnr_inference_ctx_init() with VNR_INFERENCE_ANY_INSTANCE, so it fails if all model instances are already claimed
+     * by other contexts. Calling it again doesn't claim a second model instance.
+     *
      * @ingroup vnr_inference_api
      */
     int32_t vnr_inference_init();
@@ -41,6 +46,65 @@ extern "C" {
      * @ingroup vnr_inference_api
      */
     void vnr_inference(float_s32_t *vnr_output, bfp_s32_t *features);
+
+    /**
+     * @brief Initialise a VNR inference context
+     *
+     * This function claims one of the VNR_INFERENCE_MAX_CONTEXTS model instances for the context and initialises its
+     * quantisation spec. A model instance can only be claimed by one context at a time, so contexts never share a
+     * model instance and different contexts can run vnr_inference_run() at the same time from different threads.
+     * The instance stays claimed until vnr_inference_ctx_release() is called or the context is initialised again.
+     * The model instance is loaded into the inference engine the first time it is claimed.
+     *
+     * This function can be called from several threads at the same time.
+     *
+     * @param[out] ctx Inference context
+     * @param[in] model_index Model instance to claim, between 0 and VNR_INFERENCE_MAX_CONTEXTS-1, or
+     * VNR_INFERENCE_ANY_INSTANCE to claim the lowest numbered free instance
+     * @returns 0 on success, -1 if model_index is out of range, the model instance is claimed by another context or
+     * there is no free model instance, or the model initialisation error
+     * @ingroup vnr_inference_api
+     */
+    int32_t vnr_inference_ctx_init(vnr_inference_ctx_t *ctx, int32_t model_index);
+
+    /**
+     * @brief Release the model instance claimed by a VNR inference context
+     *
+     * After this, the model instance can be claimed by another context and ctx must not be used with
+     * vnr_inference_run() until it is initialised again.
+     *
+     * @param[inout] ctx Inference context initialised with vnr_inference_ctx_init()
+     * @ingroup vnr_inference_api
+     */
+    void vnr_inference_ctx_release(vnr_inference_ctx_t *ctx);
+
+    /**
+     * @brief Run model prediction on a feature patch using an inference context
+     *
+     * Same as vnr_inference(), but on the model instance and with the quantisation spec of the given context.
+     *
+     * @param[inout] ctx Inference context initialised with vnr_inference_ctx_init()
+     * @param[out] vnr_output VNR prediction value.
+     * @param[in] features Input feature vector. Note that this is not passed as a const pointer and the feature memory is overwritten as part of the inference computation. 
+     * @ingroup vnr_inference_api
+     */
+    void vnr_inference_run(vnr_inference_ctx_t *ctx, float_s32_t *vnr_output, bfp_s32_t *features);
+
+    /**
+     * @brief Run model prediction on a batch of feature patches using an inference context
+     *
+     * Gives the same predictions as calling vnr_inference_run() on each patch in turn, for example on the features of
+     * several channels extracted with their own vnr_feature_state_t. The patches are quantised, run through the model
+     * in one invoke and dequantised VNR_INFERENCE_MAX_BATCH at a time, so the per invoke setup of the model is only
+     * paid once for every VNR_INFERENCE_MAX_BATCH patches.
+     *
+     * @param[inout] ctx Inference context initialised with vnr_inference_ctx_init()
+     * @param[out] vnr_output Array of num_patches VNR prediction values. The prediction for features[i] is written to vnr_output[i].
+     * @param[in] features Array of num_patches input feature vectors. Note that these are not passed as const pointers and the feature memory is overwritten as part of the inference computation.
+     * @param[in] num_patches Number of feature patches in the batch
+     * @ingroup vnr_inference_api
+     */
+    void vnr_inference_run_batch(vnr_inference_ctx_t *ctx, float_s32_t *vnr_output, bfp_s32_t *features, unsigned num_patches);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,52 @@
+#ifndef __VNR_INFERENCE_STATE_H__
+#define __VNR_INFERENCE_STATE_H__
+
+#include "vnr_defines.h"
+#include "xmath/xmath.h"
+
+/**
+ * @page page_vnr_inference_state_h vnr_inference_state.h
+ * 
+ * This header contains lib_vnr inference related data structure definitions 
+ *
+ * @ingroup vnr_header_file
+ */
+
+/**
+ * @defgroup vnr_inference_state   VNR inference data structure definitions
+ */ 
+
+/** @brief Quantisation spec used to quantise the VNR input features and dequantise the VNR output according to the
+ * specification for TensorFlow Lite's 8-bit quantization scheme
+ * Quantisation: q = f/input_scale + input_zero_point
+ * Dequantisation: f = output_scale * (q + output_zero_point)
+ *
+ * @ingroup vnr_inference_state
+ */
+typedef struct {
+    /** Inverse of the input scale */
+    float_s32_t input_scale_inv;
+    /** Input zero point */
+    float_s32_t input_zero_point;
+    /** Output scale */
+    float_s32_t output_scale;
+    /** Output zero point */
+    float_s32_t output_zero_point;
+}vnr_model_quant_spec_t;
+
+/**
+ * @brief VNR inference context
+ *
+ * A context runs inference on one of the VNR_INFERENCE_MAX_CONTEXTS model instances, each of which has its own tensor
+ * arena. Each model instance is claimed by at most one context, so contexts don't share any state and can run at the
+ * same time on different threads.
+ *
+ * @ingroup vnr_inference_state
+ */
+typedef struct {
+    /** Quantisation spec of the model */
+    vnr_model_quant_spec_t quant_spec;
+    /** Model instance that the context runs inference on, between 0 and VNR_INFERENCE_MAX_CONTEXTS-1 */
+    int32_t model_index;
+}vnr_inference_ctx_t;
+#endif
@@ -0,0 +1,240 @@
+# Copyright 2022 XMOS LIMITED.
+# This Software is subject to the terms of the XMOS Public Licence: Version 1.
+"""
+Generate the weights and requantisation parameters for the hand written VNR model kernel from the unoptimised TensorFlow
+Lite model.
+
+The kernel in lib_vnr/src/inference/kernel/vnr_kernel.cc implements the VNR graph with the TensorFlow Lite reference int8
+arithmetic. This script reads the model flatbuffer directly so it has no dependencies outside the Python standard
+library, checks that the graph is the one that the kernel implements and writes vnr_kernel_model.h.
+
+python gen_vnr_kernel.py fwk_voice/modules/lib_vnr/python/model/model_output/trained_model.tflite --output-path=fwk_voice/modules/lib_vnr/src/inference/kernel/
+"""
+import argparse
+import math
+import os
+import struct
+
+# Rows of the weight matrices are padded to a multiple of this many bytes, so the dot products run on whole SIMD vectors
+SIMD_BYTES = 16
+
+# TensorFlow Lite schema constants
+BUILTIN_CONV_2D = 3
+BUILTIN_FULLY_CONNECTED = 9
+BUILTIN_LOGISTIC = 14
+BUILTIN_RESHAPE = 22
+ACTIVATION_NONE = 0
+ACTIVATION_RELU = 1
+PADDING_VALID = 1
+TYPE_INT32 = 2
+TYPE_INT8 = 9
+
+def parse_arguments():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("tflite_model", help="Unoptimised TensorFlow Lite VNR model")
+    parser.add_argument("--output-path", type=str, default=".", help="Directory to write vnr_kernel_model.h to")
+    return parser.parse_args()
+
+class FlatbufferTable:
+    """Minimal flatbuffer table reader"""
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        self.vtable = pos - struct.unpack_from('<i', buf, pos)[0]
+        self.vtable_len = struct.unpack_from('<H', buf, self.vtable)[0]
+
+    def _offset(self, field):
+        o = 4 + 2*field
+        if o >= self.vtable_len:
+            return 0
+        return struct.unpack_from('<H', self.buf, self.vtable + o)[0]
+
+    def scalar(self, field, fmt, default=0):
+        o = self._offset(field)
+        return struct.unpack_from('<' + fmt, self.buf, self.pos + o)[0] if o else default
+
+    def _indirect(self, field):
+        o = self._offset(field)
+        if not o:
+            return None
+        p = self.pos + o
+        return p + struct.unpack_from('<I', self.buf, p)[0]
+
+    def table(self, field):
+        p = self._indirect(field)
+        return FlatbufferTable(self.buf, p) if p is not None else None
+
+    def _vector(self, field):
+        p = self._indirect(field)
+        if p is None:
+            return None, 0
+        return p + 4, struct.unpack_from('<I', self.buf, p)[0]
+
+    def tables(self, field):
+        start, n = self._vector(field)
+        tables = []
+        for i in range(n):
+            p = start + 4*i
+            tables.append(FlatbufferTable(self.buf, p + struct.unpack_from('<I', self.buf, p)[0]))
+        return tables
+
+    def scalars(self, field, fmt):
+        start, n = self._vector(field)
+        return list(struct.unpack_from('<%d%s'%(n, fmt), self.buf, start)) if n else []
+
+    def bytes(self, field):
+        start, n = self._vector(field)
+        return self.buf[start:start+n] if n else b''
+
+class Tensor:
+    def __init__(self, table, buffers):
+        self.shape = table.scalars(0, 'i')
+        self.type = table.scalar(1, 'b')
+        self.data = buffers[table.scalar(2, 'I')].bytes(0)
+        q = table.table(4)
+        self.scale = q.scalars(2, 'f') if q else []
+        self.zero_point = q.scalars(3, 'q') if q else []
+
+    def values(self):
+        fmt = {TYPE_INT8: 'b', TYPE_INT32: 'i'}[self.type]
+        return list(struct.unpack('<%d%s'%(len(self.data)//struct.calcsize(fmt), fmt), self.data))
+
+def f32(x):
+    """Round to single precision, as for a float multiply in C"""
+    return struct.unpack('<f', struct.pack('<f', x))[0]
+
+def quantize_multiplier(m):
+    """tflite::QuantizeMultiplier()"""
+    if m == 0.0:
+        return 0, 0
+    q, shift = math.frexp(m)
+    q_fixed = int(math.floor(q * (1 << 31) + 0.5))
+    if q_fixed == (1 << 31):
+        q_fixed //= 2
+        shift += 1
+    if shift < -31:
+        return 0, 0
+    return q_fixed, shift
+
+def padded(n):
+    return (n + SIMD_BYTES - 1) // SIMD_BYTES * SIMD_BYTES
+
+class Layer:
+    """A conv or fully connected layer as out[o] = requant(sum(w[o][i] * in[i]) + bias[o]), with the input zero point
+    folded into the bias"""
+    def __init__(self, name, inp, weights, bias, out, per_channel_scales):
+        self.name = name
+        self.out_channels = weights.shape[0]
+        self.in_channels = len(weights.data) // self.out_channels
+        w = weights.values()
+        self.weights = [w[o*self.in_channels:(o+1)*self.in_channels] for o in range(self.out_channels)]
+        b = bias.values()
+        self.bias = [b[o] - inp.zero_point[0]*sum(self.weights[o]) for o in range(self.out_channels)]
+        self.multiplier = []
+        self.shift = []
+        for o in range(self.out_channels):
+            if per_channel_scales:
+                # tflite::PopulateConvolutionQuantizationParams()
+                m = inp.scale[0] * weights.scale[o] / out.scale[0]
+            else:
+                # tflite::GetQuantizedConvolutionMultipler()
+                m = f32(inp.scale[0] * weights.scale[0]) / out.scale[0]
+            q, s = quantize_multiplier(m)
+            self.multiplier.append(q)
+            self.shift.append(s)
+        self.output_zero_point = out.zero_point[0]
+
+def logistic_table(inp, out):
+    """Logistic output for every int8 input. TensorFlow Lite computes the logistic in Q0.31 or single precision and then
+    rounds to 8 bits, so the table matches it as long as no value is close to a rounding boundary."""
+    assert(out.scale[0] == 1.0/256 and out.zero_point[0] == -128), "ERROR: unexpected logistic output quantisation"
+    table = []
+    for q in range(-128, 128):
+        y = 256.0 / (1.0 + math.exp(-inp.scale[0] * (q - inp.zero_point[0])))
+        frac = y - math.floor(y)
+        assert(abs(frac - 0.5) > 1e-3), f"ERROR: logistic output for input {q} too close to a rounding boundary"
+        table.append(min(int(math.floor(y + 0.5)) - 128, 127))
+    return table
+
+def check(cond, msg):
+    if not cond:
+        raise RuntimeError(f"ERROR: {msg}. The hand written VNR kernel needs updating for this model.")
+
+def parse_model(model_file):
+    buf = open(model_file, 'rb').read()
+    model = FlatbufferTable(buf, struct.unpack_from('<I', buf, 0)[0])
+    opcodes = [max(oc.scalar(0, 'b'), oc.scalar(3, 'i')) for oc in model.tables(1)]
+    buffers = model.tables(4)
+    subgraph = model.tables(2)[0]
+    tensors = [Tensor(t, buffers) for t in subgraph.tables(0)]
+    ops = []
+    for op in subgraph.tables(3):
+        options = op.table(4)
+        ops.append((opcodes[op.scalar(0, 'I')], op.scalars(1, 'i'), op.scalars(2, 'i'), options))
+
+    check([o[0] for o in ops] == [BUILTIN_CONV_2D, BUILTIN_CONV_2D, BUILTIN_RESHAPE, BUILTIN_FULLY_CONNECTED, BUILTIN_FULLY_CONNECTED, BUILTIN_LOGISTIC], "unexpected operators")
+    layers = []
+    for i, activation in zip([0, 1, 3, 4], [ACTIVATION_RELU, ACTIVATION_RELU, ACTIVATION_RELU, ACTIVATION_NONE]):
+        opcode, inputs, outputs, options = ops[i]
+        inp, weights, bias, out = tensors[inputs[0]], tensors[inputs[1]], tensors[inputs[2]], tensors[outputs[0]]
+        check(inp.type == TYPE_INT8 and weights.type == TYPE_INT8 and bias.type == TYPE_INT32 and out.type == TYPE_INT8, f"unexpected types in operator {i}")
+        check(all(z == 0 for z in weights.zero_point), f"unexpected weights zero point in operator {i}")
+        if opcode == BUILTIN_CONV_2D:
+            # Conv2DOptions: padding, stride_w, stride_h, fused_activation_function, dilation_w, dilation_h
+            check(weights.shape[1:3] == [1, 1], f"operator {i} is not a 1x1 convolution")
+            check([options.scalar(f, 'b', 1) for f in range(6)] == [PADDING_VALID, 1, 1, activation, 1, 1], f"unexpected options in operator {i}")
+            per_channel = True
+        else:
+            # FullyConnectedOptions: fused_activation_function
+            check(options.scalar(0, 'b') == activation, f"unexpected activation in operator {i}")
+            check(len(weights.scale) == 1, f"unexpected per channel quantisation in operator {i}")
+            per_channel = False
+        # With a zero point of -128 the ReLU doesn't clamp any further than the int8 range
+        check(activation == ACTIVATION_NONE or out.zero_point[0] == -128, f"unexpected activation range in operator {i}")
+        layers.append(Layer(f"layer{len(layers)}", inp, weights, bias, out, per_channel))
+
+    model_input = tensors[ops[0][1][0]]
+    model_output = tensors[ops[5][2][0]]
+    check(model_input.shape == [1, 1, 4, 24], "unexpected input shape")
+    check(layers[2].in_channels == layers[1].out_channels * model_input.shape[2], "unexpected fully connected input size")
+    check(layers[3].out_channels == 1, "unexpected output size")
+    return model_input, layers, logistic_table(tensors[ops[5][1][0]], model_output)
+
+def c_array(values, per_line=32):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i+per_line]) + ",")
+    return "\n".join(lines)
+
+def write_header(path, model_file, model_input, layers, lut):
+    with open(path, "w") as fp:
+        fp.write(f"// Autogenerated from fwk_voice/modules/lib_vnr/python/utils/kernel/{os.path.basename(__file__)} using {os.path.basename(model_file)}. Do not modify\n")
+        fp.write("#ifndef VNR_KERNEL_MODEL_H\n")
+        fp.write("#define VNR_KERNEL_MODEL_H\n\n")
+        fp.write("#include <stdint.h>\n\n")
+        fp.write(f"#define VNR_KERNEL_SIMD_BYTES ({SIMD_BYTES})\n")
+        fp.write(f"#define VNR_KERNEL_INPUT_WIDTH ({model_input.shape[2]})\n")
+        for i, l in enumerate(layers):
+            name = f"VNR_KERNEL_LAYER{i}"
+            fp.write(f"\n// {['1x1 convolution', '1x1 convolution', 'Fully connected', 'Fully connected'][i]}, {l.in_channels} to {l.out_channels} channels\n")
+            fp.write(f"#define {name}_IN ({l.in_channels})\n")
+            fp.write(f"#define {name}_IN_PADDED ({padded(l.in_channels)})\n")
+            fp.write(f"#define {name}_OUT ({l.out_channels})\n")
+            fp.write(f"#define {name}_OUTPUT_ZERO_POINT ({l.output_zero_point})\n")
+            weights = []
+            for w in l.weights:
+                weights += w + [0] * (padded(l.in_channels) - l.in_channels)
+            fp.write(f"alignas({SIMD_BYTES}) static constexpr int8_t vnr_kernel_layer{i}_weights[{name}_OUT * {name}_IN_PADDED] = {{\n{c_array(weights)}\n}};\n")
+            fp.write(f"static constexpr int32_t vnr_kernel_layer{i}_bias[{name}_OUT] = {{\n{c_array(l.bias, 8)}\n}};\n")
+            fp.write(f"static constexpr int32_t vnr_kernel_layer{i}_multiplier[{name}_OUT] = {{\n{c_array(l.multiplier, 8)}\n}};\n")
+            fp.write(f"static constexpr int32_t vnr_kernel_layer{i}_shift[{name}_OUT] = {{\n{c_array(l.shift, 16)}\n}};\n")
+        fp.write("\n// Logistic output indexed by the int8 input + 128\n")
+        fp.write(f"static constexpr int8_t vnr_kernel_logistic_table[256] = {{\n{c_array(lut)}\n}};\n")
+        fp.write("\n#endif\n")
+
+if __name__ == "__main__":
+    args = parse_arguments()
+    model_input, layers, lut = parse_model(args.tflite_model)
+    output_file = os.path.join(args.output_path, "vnr_kernel_model.h")
+    write_header(output_file, args.tflite_model, model_input, layers, lut)
+    print(f"Written {output_file}")
@@ -6,7 +6,7 @@ import matplotlib
 matplotlib.use("TkAgg")
 import matplotlib.pyplot as plt
 
-#python gen_mel_filters.py -fft_size 512 -mel_size=24 -path=. -type=compact
+#python gen_mel_filters.py -fft_size 512 -mel_size=24 -path=. -type=band_compact
 
 def hz2mel(hz):
     """Convert a value in Hertz to Mels
@@ -287,6 +287,70 @@ class compressed_mel:
 
         return c_text
 
+class band_compact_mel:
+    def __init__(self, fbank, filter_start_bins, weight_bits=26):
+        # The compact form weights are indexed by bin, and the filter peaks split the spectrum into segments where one
+        # filter has the compact weight w and the other 1 - w. Storing w in Q(weight_bits) lets a segment's weighted
+        # and plain sums of 31 bit bin energies be accumulated exactly in 64 bits, for the widest filter.
+        my_compact_mel = compact_mel(fbank, filter_start_bins)
+        self.num_mels = my_compact_mel.num_mels
+        self.num_bins = my_compact_mel.num_bins
+        self.filter_start_bins = [int(b) for b in filter_start_bins]
+        self.weight_bits = weight_bits
+        self.weights = my_compact_mel.flattened_fbank[:self.filter_start_bins[-1]]
+        max_filter_bins = max(self.filter_start_bins[i+2] - self.filter_start_bins[i] for i in range(self.num_mels))
+        assert max_filter_bins * (2**31) * (2**weight_bits) < 2**63, "mel filter too wide for 64 bit accumulation"
+
+    def filter(self, bins):
+        one = 2**self.weight_bits
+        weights = self.get_int_weights()
+        start = self.filter_start_bins
+        weighted = [sum(bins[k] * weights[k] for k in range(start[s], start[s+1])) for s in range(len(start) - 1)]
+        total = [sum(bins[start[s]:start[s+1]]) for s in range(len(start) - 1)]
+        filtered = numpy.zeros(self.num_mels)
+        for idx in range(self.num_mels):
+            if (idx % 2) == 0:
+                filtered[idx] = weighted[idx] + weighted[idx+1]
+            else:
+                filtered[idx] = (total[idx] * one - weighted[idx]) + (total[idx+1] * one - weighted[idx+1])
+        return filtered / one
+
+    def get_int_weights(self):
+        return [int(numpy.round(w * 2**self.weight_bits)) for w in self.weights]
+
+    def gen_c_src(self, var_name):
+        one = 2**self.weight_bits
+        weights = self.get_int_weights()
+        array_name = f"{var_name}_q{self.weight_bits}"
+        index = os.path.realpath(__file__).find('fwk_voice/')
+        assert(index != -1)
+        c_text = f"//Autogenerated by {os.path.realpath(__file__)[index:]}, DO NOT EDIT\n"
+        c_text += f"#ifndef _{var_name}_h_\n"
+        c_text += f"#define _{var_name}_h_\n"
+        c_text += "\n"
+        c_text += f"#include <stdint.h>"
+        c_text += "\n"
+        c_text += f"#define AUDIO_FEATURES_NUM_MELS {self.num_mels}\n";
+        c_text += f"#define AUDIO_FEATURES_NUM_BINS {self.num_bins}\n";
+        c_text += f"#define AUDIO_FEATURES_MEL_SEGMENTS {len(self.filter_start_bins) - 1}\n";
+        c_text += f"#define AUDIO_FEATURES_MEL_WEIGHT_BITS {self.weight_bits}\n";
+        c_text += f"#define AUDIO_FEATURES_MEL_ONE {one}\n";
+        c_text += f"#define AUDIO_FEATURES_MEL_ARRAY_NAME {array_name}\n";
+        c_text += "\n"
+        c_text += f"static const uint32_t {array_name}[{len(self.weights)}] = {{\n"
+        start = self.filter_start_bins
+        for seg in range(len(start) - 1):
+            c_text += "\t" + "".join(f"{w}, " for w in weights[start[seg]:start[seg+1]])[:-1] + "\n"
+        c_text = c_text[:-2] + "};\n" #chop off comma and space first
+        c_text += "\n"
+        c_text += f"static const uint32_t {var_name}_segment_start_bins[{len(start)}] = {{\n\t"
+        for bin in start:
+            c_text += f"{bin}, "
+        c_text = c_text[:-2] + "};\n" #chop off comma and space first
+        c_text += "\n#endif\n"
+
+        return c_text
+
 def single_test_equivalence(fft_size, nmels):
     print(f"testing fft_size: {fft_size}, n mels: {nmels}")
     nbins = fft_size // 2 + 1
@@ -296,21 +360,25 @@ def single_test_equivalence(fft_size, nmels):
     fbank_standard = fbank[ :-1]
     full_filtered = apply_full_mel(test_bins, fbank_standard)
     
-    my_compact_mel = compact_mel(fbank)
+    my_compact_mel = compact_mel(fbank, band_start_bins)
     compact_filtered = numpy.zeros(nmels)
     compact_filtered = my_compact_mel.filter(test_bins, compact_filtered)
 
     my_compressed_mel = compressed_mel(fbank_standard)
     compressed_filtered = my_compressed_mel.filter(test_bins)
 
+    my_band_compact_mel = band_compact_mel(fbank, band_start_bins)
+    band_compact_filtered = my_band_compact_mel.filter(test_bins)
+
     print(fbank_standard.size, my_compressed_mel.count_mel_elements(), my_compact_mel.count_mel_elements())
 
     # print(numpy.isclose(full_filtered, compact_filtered))
     # print(full_filtered, compact_filtered)
     result1 = numpy.allclose(full_filtered, compact_filtered)
     result2 = numpy.allclose(full_filtered, compressed_filtered)
+    result3 = numpy.allclose(full_filtered, band_compact_filtered)
 
-    return result1 and result2
+    return result1 and result2 and result3
 
 def test_equivalence_range():
     for fft_size, test_mels in (
@@ -325,7 +393,7 @@ def test_equivalence_range():
             assert test_equivalence(fft_size, nmels)
     print("PASS")
 
-# python gen_mel_filters.py -fft_size 512 -mel_size=24 -path=. -type=compact
+# python gen_mel_filters.py -fft_size 512 -mel_size=24 -path=. -type=band_compact
 def main():
     parser = argparse.ArgumentParser(description='Generate MEL tables script')
     parser.add_argument('-fft_size', action="store", type=int)
@@ -338,6 +406,7 @@ def main():
     fbank_standard = fbank[ :-1]
     my_compact_mel = compact_mel(fbank, band_start_bins)
     my_compressed_mel = compressed_mel(fbank_standard)
+    my_band_compact_mel = band_compact_mel(fbank, band_start_bins)
 
     print(args)
     if args.type == 'compact':
@@ -350,6 +419,11 @@ def main():
         c_text = my_compressed_mel.gen_c_src(name)
         with open(Path(args.path) / (name + ".h"), "wt") as hfile:
             hfile.write(c_text)
+    elif args.type == 'band_compact':
+        name = f"mel_filter_{args.fft_size}_{args.mel_size}_band_compact"
+        c_text = my_band_compact_mel.gen_c_src(name)
+        with open(Path(args.path) / (name + ".h"), "wt") as hfile:
+            hfile.write(c_text)
     else:
         assert 0 and "not yet supported"
     
@@ -0,0 +1,43 @@
+//Autogenerated by fwk_voice/modules/lib_vnr/python/utils/mel/gen_mel_filters.py, DO NOT EDIT
+#ifndef _mel_filter_512_24_band_compact_h_
+#define _mel_filter_512_24_band_compact_h_
+
+#include <stdint.h>
+#define AUDIO_FEATURES_NUM_MELS 24
+#define AUDIO_FEATURES_NUM_BINS 257
+#define AUDIO_FEATURES_MEL_SEGMENTS 25
+#define AUDIO_FEATURES_MEL_WEIGHT_BITS 26
+#define AUDIO_FEATURES_MEL_ONE 67108864
+#define AUDIO_FEATURES_MEL_ARRAY_NAME mel_filter_512_24_band_compact_q26
+
+static const uint32_t mel_filter_512_24_band_compact_q26[256] = {
+	0, 33554432,
+	67108864, 44739243, 22369621,
+	0, 33554432,
+	67108864, 50331648, 33554432, 16777216,
+	0, 22369621, 44739243,
+	67108864, 50331648, 33554432, 16777216,
+	0, 13421773, 26843546, 40265318, 53687091,
+	67108864, 50331648, 33554432, 16777216,
+	0, 11184811, 22369621, 33554432, 44739243, 55924053,
+	67108864, 55924053, 44739243, 33554432, 22369621, 11184811,
+	0, 11184811, 22369621, 33554432, 44739243, 55924053,
+	67108864, 57521883, 47934903, 38347922, 28760942, 19173961, 9586981,
+	0, 8388608, 16777216, 25165824, 33554432, 41943040, 50331648, 58720256,
+	67108864, 59652324, 52195783, 44739243, 37282702, 29826162, 22369621, 14913081, 7456540,
+	0, 6710886, 13421773, 20132659, 26843546, 33554432, 40265318, 46976205, 53687091, 60397978,
+	67108864, 61008058, 54907252, 48806447, 42705641, 36604835, 30504029, 24403223, 18302417, 12201612, 6100806,
+	0, 5592405, 11184811, 16777216, 22369621, 27962027, 33554432, 39146837, 44739243, 50331648, 55924053, 61516459,
+	67108864, 61946644, 56784423, 51622203, 46459983, 41297762, 36135542, 30973322, 25811102, 20648881, 15486661, 10324441, 5162220,
+	0, 4793490, 9586981, 14380471, 19173961, 23967451, 28760942, 33554432, 38347922, 43141413, 47934903, 52728393, 57521883, 62315374,
+	67108864, 63161284, 59213704, 55266123, 51318543, 47370963, 43423383, 39475802, 35528222, 31580642, 27633062, 23685481, 19737901, 15790321, 11842741, 7895160, 3947580,
+	0, 3947580, 7895160, 11842741, 15790321, 19737901, 23685481, 27633062, 31580642, 35528222, 39475802, 43423383, 47370963, 51318543, 55266123, 59213704, 63161284,
+	67108864, 63753421, 60397978, 57042534, 53687091, 50331648, 46976205, 43620762, 40265318, 36909875, 33554432, 30198989, 26843546, 23488102, 20132659, 16777216, 13421773, 10066330, 6710886, 3355443,
+	0, 3050403, 6100806, 9151209, 12201612, 15252015, 18302417, 21352820, 24403223, 27453626, 30504029, 33554432, 36604835, 39655238, 42705641, 45756044, 48806447, 51856849, 54907252, 57957655, 61008058, 64058461,
+	67108864, 64312661, 61516459, 58720256, 55924053, 53127851, 50331648, 47535445, 44739243, 41943040, 39146837, 36350635, 33554432, 30758229, 27962027, 25165824, 22369621, 19573419, 16777216, 13981013, 11184811, 8388608, 5592405, 2796203,
+	0, 2485513, 4971027, 7456540, 9942054, 12427567, 14913081, 17398594, 19884108, 22369621, 24855135, 27340648, 29826162, 32311675, 34797189, 37282702, 39768216, 42253729, 44739243, 47224756, 49710270, 52195783, 54681297, 57166810, 59652324, 62137837, 64623351};
+
+static const uint32_t mel_filter_512_24_band_compact_segment_start_bins[26] = {
+	0, 2, 5, 7, 11, 14, 18, 23, 27, 33, 39, 45, 52, 60, 69, 79, 90, 102, 115, 129, 146, 163, 183, 205, 229, 256};
+
+#endif
@@ -1,31 +0,0 @@
-//Autogenerated by fwk_voice/modules/lib_vnr/python/utils/mel/gen_mel_filters.py, DO NOT EDIT
-#ifndef _mel_filter_512_24_compact_h_
-#define _mel_filter_512_24_compact_h_
-
-#include <stdint.h>
-#include "xmath/xmath.h"
-#define AUDIO_FEATURES_NUM_MELS 24
-#define AUDIO_FEATURES_NUM_BINS 257
-#define AUDIO_FEATURES_MEL_MAX 2147483647
-#define AUDIO_FEATURES_MEL_HEADROOM_BITS 0
-#define AUDIO_FEATURES_MEL_ARRAY_NAME mel_filter_512_24_compact_q31
-
-uq1_31 mel_filter_512_24_compact_q31[257] = {
-	0, 1073741823, 2147483647, 1431655764, 715827882,
-	0, 1073741823, 2147483647, 1610612735, 1073741823, 536870911,
-	0, 715827882, 1431655764, 2147483647, 1610612735, 1073741823, 536870911,
-	0, 429496729, 858993458, 1288490188, 1717986917, 2147483647, 1610612735, 1073741823, 536870911,
-	0, 357913941, 715827882, 1073741823, 1431655764, 1789569705, 2147483647, 1789569705, 1431655764, 1073741823, 715827882, 357913941,
-	0, 357913941, 715827882, 1073741823, 1431655764, 1789569705, 2147483647, 1840700268, 1533916890, 1227133512, 920350134, 613566756, 306783378,
-	0, 268435455, 536870911, 805306367, 1073741823, 1342177279, 1610612735, 1879048191, 2147483647, 1908874352, 1670265058, 1431655764, 1193046470, 954437176, 715827882, 477218588, 238609294,
-	0, 214748364, 429496729, 644245094, 858993458, 1073741823, 1288490188, 1503238552, 1717986917, 1932735282, 2147483647, 1952257860, 1757032074, 1561806288, 1366580502, 1171354716, 976128930, 780903144, 585677358, 390451572, 195225786,
-	0, 178956970, 357913941, 536870911, 715827882, 894784852, 1073741823, 1252698794, 1431655764, 1610612735, 1789569705, 1968526676, 2147483647, 1982292597, 1817101547, 1651910497, 1486719447, 1321528398, 1156337348, 991146298, 825955248, 660764199, 495573149, 330382099, 165191049,
-	0, 153391689, 306783378, 460175067, 613566756, 766958445, 920350134, 1073741823, 1227133512, 1380525201, 1533916890, 1687308579, 1840700268, 1994091957, 2147483647, 2021161079, 1894838512, 1768515944, 1642193377, 1515870809, 1389548242, 1263225674, 1136903107, 1010580539, 884257972, 757935404, 631612837, 505290269, 378967702, 252645134, 126322567,
-	0, 126322567, 252645134, 378967702, 505290269, 631612837, 757935404, 884257972, 1010580539, 1136903107, 1263225674, 1389548242, 1515870809, 1642193377, 1768515944, 1894838512, 2021161079, 2147483647, 2040109464, 1932735282, 1825361099, 1717986917, 1610612735, 1503238552, 1395864370, 1288490188, 1181116005, 1073741823, 966367641, 858993458, 751619276, 644245094, 536870911, 429496729, 322122547, 214748364, 107374182,
-	0, 97612893, 195225786, 292838679, 390451572, 488064465, 585677358, 683290251, 780903144, 878516037, 976128930, 1073741823, 1171354716, 1268967609, 1366580502, 1464193395, 1561806288, 1659419181, 1757032074, 1854644967, 1952257860, 2049870753, 2147483647, 2058005161, 1968526676, 1879048191, 1789569705, 1700091220, 1610612735, 1521134249, 1431655764, 1342177279, 1252698794, 1163220308, 1073741823, 984263338, 894784852, 805306367, 715827882, 626349397, 536870911, 447392426, 357913941, 268435455, 178956970, 89478485,
-	0, 79536431, 159072862, 238609294, 318145725, 397682156, 477218588, 556755019, 636291450, 715827882, 795364313, 874900745, 954437176, 1033973607, 1113510039, 1193046470, 1272582901, 1352119333, 1431655764, 1511192196, 1590728627, 1670265058, 1749801490, 1829337921, 1908874352, 1988410784, 2067947215, 2147483647};
-
-int32_t mel_filter_512_24_compact_start_bins[26] = {
-	0, 2, 5, 7, 11, 14, 18, 23, 27, 33, 39, 45, 52, 60, 69, 79, 90, 102, 115, 129, 146, 163, 183, 205, 229, 256};
-
-#endif
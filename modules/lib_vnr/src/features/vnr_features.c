@@ -38,3 +38,15 @@ void vnr_extract_features(vnr_feature_state_t *vnr_feature_state,
     vnr_priv_add_new_slice(vnr_feature_state->feature_buffers, new_slice);
     vnr_priv_normalise_patch(feature_patch, feature_patch_data, (const vnr_feature_state_t*)vnr_feature_state);
 }
+
+int32_t vnr_extract_features_from_spectrum(vnr_feature_state_t *vnr_feature_state,
+        bfp_s32_t *feature_patch,
+        int32_t feature_patch_data[VNR_PATCH_WIDTH * VNR_MEL_FILTERS],
+        const bfp_complex_s32_t *X)
+{
+    if((X->length != VNR_FD_FRAME_LENGTH) && (X->length != VNR_PACKED_FD_FRAME_LENGTH)) {
+        return -1;
+    }
+    vnr_extract_features(vnr_feature_state, feature_patch, feature_patch_data, X);
+    return 0;
+}
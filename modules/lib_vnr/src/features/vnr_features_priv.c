@@ -3,7 +3,7 @@
 #include <string.h>
 #include <limits.h>
 #include "vnr_features_priv.h"
-#include "mel_filter_512_24_compact.h"
+#include "mel_filter_512_24_band_compact.h"
 
 void vnr_priv_forward_fft(bfp_complex_s32_t *X, int32_t *x_data) {
     bfp_s32_t x;
@@ -24,6 +24,30 @@ void vnr_priv_forward_fft(bfp_complex_s32_t *X, int32_t *x_data) {
     memcpy(X, temp, sizeof(bfp_complex_s32_t));
 }
 
+void vnr_priv_unpack_squared_mag(bfp_s32_t *squared_mag, const bfp_complex_s32_t *X) {
+    // X->data[0] holds the real DC and Nyquist bins, so squared_mag->data[0] is the sum of their squares. Work them out
+    // separately at the exponent that bfp_complex_s32_squared_mag() picked, which has room for either of them.
+    int shr = squared_mag->exp - (2 * X->exp);
+    int64_t dc = (int64_t)X->data[0].re * X->data[0].re;
+    int64_t nyquist = (int64_t)X->data[0].im * X->data[0].im;
+    if(shr >= 63) {
+        dc = 0;
+        nyquist = 0;
+    }
+    else if(shr > 0) {
+        dc = (dc + ((int64_t)1 << (shr - 1))) >> shr;
+        nyquist = (nyquist + ((int64_t)1 << (shr - 1))) >> shr;
+    }
+    else {
+        dc <<= -shr;
+        nyquist <<= -shr;
+    }
+    squared_mag->data[0] = (int32_t)dc;
+    squared_mag->data[VNR_FD_FRAME_LENGTH - 1] = (int32_t)nyquist;
+    squared_mag->length = VNR_FD_FRAME_LENGTH;
+    squared_mag->hr = bfp_s32_headroom(squared_mag);
+}
+
 void vnr_priv_make_slice(uq8_24 *new_slice, const bfp_complex_s32_t *X, int32_t hp) {    
     // MEL
     float_s32_t mel_output[VNR_MEL_FILTERS];
@@ -66,6 +90,16 @@ void vnr_priv_normalise_patch(bfp_s32_t *normalised_patch, int32_t *normalised_p
     bfp_s32_add_scalar(normalised_patch, &feature_patch_bfp, neg_max); // Subtract the max from every value in the patch
 }
 
+// Non-negative 64 bit mel filter output as a float_s32_t, shifting out the bits above the 31 that a mantissa holds
+static float_s32_t mel_energy_to_float_s32(int64_t energy, exponent_t exp) {
+    int32_t energy_hi = (int32_t)(energy >> 32);
+    right_shift_t shr = (energy_hi != 0) ? (32 - HR_S32(energy_hi)) : (energy > INT32_MAX);
+    float_s32_t out;
+    out.mant = (int32_t)(energy >> shr);
+    out.exp = exp + shr;
+    return out;
+}
+
 void vnr_priv_mel_compute(float_s32_t *filter_output, const bfp_complex_s32_t *X) {
 #if VNR_MEL_FILTERS != AUDIO_FEATURES_NUM_MELS
     #error VNR_MEL_FILTERS not the same as AUDIO_FEATURES_NUM_MELS
@@ -76,6 +110,9 @@ void vnr_priv_mel_compute(float_s32_t *filter_output, const bfp_complex_s32_t *X
     bfp_s32_t squared_mag;
     bfp_s32_init(&squared_mag, squared_mag_data, 0, X->length, 0);
     bfp_complex_s32_squared_mag(&squared_mag, X);
+    if(X->length == VNR_PACKED_FD_FRAME_LENGTH) {
+        vnr_priv_unpack_squared_mag(&squared_mag, X);
+    }
 #if HEADROOM_CHECK
     headroom_t reported_hr = squared_mag.hr;
     headroom_t actual_hr = bfp_s32_headroom(&squared_mag);
@@ -86,62 +123,37 @@ void vnr_priv_mel_compute(float_s32_t *filter_output, const bfp_complex_s32_t *X
 #endif
 
     // Mel filtering
-    unsigned num_bands = AUDIO_FEATURES_NUM_MELS + 1; //Extra band for the 2nd half of the last filter  
-    unsigned num_even_filters = num_bands / 2;
-    unsigned num_odd_filters = AUDIO_FEATURES_NUM_MELS - num_even_filters;
-    int filter_exp = -(31-AUDIO_FEATURES_MEL_HEADROOM_BITS);
-    int filter_hr = AUDIO_FEATURES_MEL_HEADROOM_BITS;
     // out_spect = np.dot(out_spect, self.mel_fbank)
-
-    // Filter through even filters
-    for(unsigned i=0; i<num_even_filters; i++) {
-        // Get start and end bins for the filter
-        unsigned filter_start = mel_filter_512_24_compact_start_bins[2*i];
-        unsigned filter_length = mel_filter_512_24_compact_start_bins[2*(i+1)] - filter_start;
-        // Create input spectrum subset BFP structure
-        bfp_s32_t spect_subset;
-        bfp_s32_init(&spect_subset, (int32_t *) &squared_mag.data[filter_start], squared_mag.exp, filter_length, 1);
-
-        // Create MEL filter BFP structure
-        bfp_s32_t filter_subset;
-        bfp_s32_init(&filter_subset, (int32_t *) &mel_filter_512_24_compact_q31[filter_start], filter_exp, filter_length, 0);
-        filter_subset.hr = filter_hr;
-        
-        // Dot product
-        filter_output[2*i] = float_s64_to_float_s32(bfp_s32_dot(&spect_subset, &filter_subset));
+    // The filter peaks split the spectrum into AUDIO_FEATURES_MEL_SEGMENTS segments, each overlapped by 2 filters. In a
+    // segment, one filter has the band compact weight w of every bin and the other has 1 - w, so the weighted sum and the
+    // plain sum of the segment bins give both filters' outputs, in a single pass over the spectrum. The weights are in
+    // Q26 so the 64 bit sums of the squared magnitudes are exact.
+    const uint32_t *weights = mel_filter_512_24_band_compact_q26;
+    const uint32_t *segment_start = mel_filter_512_24_band_compact_segment_start_bins;
+    const uint32_t *squared_mag_u32 = (const uint32_t *)squared_mag.data; // Squared magnitudes are never negative
+    int64_t weighted_sum[AUDIO_FEATURES_MEL_SEGMENTS];
+    int64_t sum[AUDIO_FEATURES_MEL_SEGMENTS];
+    for(unsigned seg=0; seg<AUDIO_FEATURES_MEL_SEGMENTS; seg++) {
+        uint64_t w_acc = 0, acc = 0;
+        for(unsigned k=segment_start[seg]; k<segment_start[seg+1]; k++) {
+            w_acc += (uint64_t)squared_mag_u32[k] * weights[k];
+            acc += squared_mag_u32[k];
+        }
+        weighted_sum[seg] = (int64_t)w_acc;
+        sum[seg] = (int64_t)acc * AUDIO_FEATURES_MEL_ONE;
     }
 
-    bfp_s32_t filter;
-    bfp_s32_init(&filter, (int32_t *) &mel_filter_512_24_compact_q31[0], filter_exp, AUDIO_FEATURES_NUM_BINS, 0);
-    
-    // Generate odd band filters
-    int32_t odd_band_filters_data[AUDIO_FEATURES_NUM_BINS]; // Memory for storing odd filters
-    bfp_s32_t odd_band_filters;
-    bfp_s32_init(&odd_band_filters, odd_band_filters_data, 0, AUDIO_FEATURES_NUM_BINS, 0);
-    bfp_s32_set(&odd_band_filters, AUDIO_FEATURES_MEL_MAX, filter_exp);
-    odd_band_filters.hr = HR_S32(AUDIO_FEATURES_MEL_MAX);
-    bfp_s32_sub(&odd_band_filters, &odd_band_filters, &filter);
-
-    // Filter through odd filters
-    for(unsigned i=0; i<num_odd_filters; i++) {
-        unsigned filter_start = mel_filter_512_24_compact_start_bins[(2*i) + 1];
-        unsigned filter_length = mel_filter_512_24_compact_start_bins[(2*(i+1)) + 1] - filter_start;
-        // Create input spectrum subset BFP structure
-        bfp_s32_t spect_subset;
-        bfp_s32_init(&spect_subset, &squared_mag.data[filter_start], squared_mag.exp, filter_length, 1);
-
-        // Create MEL filter BFP structure
-        bfp_s32_t filter_subset;
-        bfp_s32_init(&filter_subset, &odd_band_filters.data[filter_start], odd_band_filters.exp, filter_length, 0);
-        filter_subset.hr = odd_band_filters.hr;
-
-        filter_output[(2*i)+1] = float_s64_to_float_s32(bfp_s32_dot(&spect_subset, &filter_subset));
-    }
-}
-
-void vnr_priv_log2(uq8_24 *output_q24, const float_s32_t *input, unsigned length) {
-    for(unsigned i=0; i<length; i++) {
-        output_q24[i] = vnr_priv_float_s32_to_fixed_q24_log2(input[i]);
+    // Even filters rise over segment 2i and fall over segment 2i+1, odd filters over segments 2i+1 and 2i+2
+    exponent_t filter_exp = squared_mag.exp - AUDIO_FEATURES_MEL_WEIGHT_BITS;
+    for(unsigned i=0; i<AUDIO_FEATURES_NUM_MELS; i++) {
+        int64_t energy;
+        if((i & 1) == 0) {
+            energy = weighted_sum[i] + weighted_sum[i+1];
+        }
+        else {
+            energy = (sum[i] - weighted_sum[i]) + (sum[i+1] - weighted_sum[i+1]);
+        }
+        filter_output[i] = mel_energy_to_float_s32(energy, filter_exp);
     }
 }
 
@@ -158,7 +170,7 @@ static const int lookup[33] = {
 
 // Lookup table entries k=0,1,...,32:
 //lookup[k] = 256log2(1 + k/32)
-static int lookup_small_log2_linear_new(uint32_t x) {
+static inline int lookup_small_log2_linear_new(uint32_t x) {
     int mask_bits = 26;
     int mask = (1 << mask_bits) - 1;
     int y = (x >> mask_bits) - 32;
@@ -186,3 +198,22 @@ uq8_24 vnr_priv_float_s32_to_fixed_q24_log2(float_s32_t x) {
     uint32_t log2 = lookup_small_log2_linear_new(x_mant) + number_of_bits;
     return log2;
 }
+
+void vnr_priv_log2(uq8_24 *output_q24, const float_s32_t *input, unsigned length) {
+    // Same as vnr_priv_float_s32_to_fixed_q24_log2() on every input, but normalising all the mantissas first and then
+    // doing the table lookups in a second loop, with no calls in either loop
+    uint32_t x_mant[VNR_MEL_FILTERS];
+    int32_t number_of_bits[VNR_MEL_FILTERS];
+    for(unsigned i=0; i<length; i+=VNR_MEL_FILTERS) {
+        unsigned block = ((length - i) < VNR_MEL_FILTERS) ? (length - i) : VNR_MEL_FILTERS;
+        for(unsigned j=0; j<block; j++) {
+            headroom_t hr = HR_S32(input[i+j].mant) + 1;
+            x_mant[j] = (uint32_t)input[i+j].mant << hr;
+            number_of_bits[j] = (31 + input[i+j].exp - (exponent_t)hr) << MEL_PRECISION;
+        }
+        for(unsigned j=0; j<block; j++) {
+            //Handle case for zero mantissa which is possible with float_s32_t
+            output_q24[i+j] = (x_mant[j] == 0) ? (uq8_24)INT_MIN : (uq8_24)(lookup_small_log2_linear_new(x_mant[j]) + number_of_bits[j]);
+        }
+    }
+}
@@ -22,6 +22,17 @@
  */
 #define VNR_MEL_HP_GAIN (f32_to_float_s32((float)0.01))
 
+/**
+ * @brief Fix up the squared magnitude of a packed DFT spectrum
+ * bfp_complex_s32_squared_mag() of a packed bfp_fft_forward_mono() output puts the sum of the squared DC and Nyquist bins in
+ * the first bin. This function replaces it with the squared DC bin and appends the squared Nyquist bin, to get the same
+ * VNR_FD_FRAME_LENGTH values as the squared magnitude of the unpacked spectrum.
+ *
+ * @param[inout] squared_mag Squared magnitude of X, with memory for VNR_FD_FRAME_LENGTH values
+ * @param[in] X Packed DFT spectrum of VNR_PACKED_FD_FRAME_LENGTH bins
+ */
+void vnr_priv_unpack_squared_mag(bfp_s32_t *squared_mag, const bfp_complex_s32_t *X);
+
 // Matching with python names
 /**
  * @brief Convert a spectrum to Mel frequency spectrum
@@ -82,21 +93,23 @@ void vnr_priv_forward_fft(bfp_complex_s32_t *X, int32_t *x_data);
 
 /**
  * @brief Convert a spectrum to Mel frequency spectrum. 
- * The Mel filters are stored in the mel_filter_512_24_compact.h file that is autogenerated from the gen_mel_filters.py script.
- * The filters are stored in a compact form, meaning,
- * - Only the even filters are stored.
- * - Only the non-zero (and one zero coeff to indicate filter start) coefficients of every filter are stored in 1 array.
- * - The start bin of all even and odd filters are stored and using this, the odd filters are generated by 1 - even_filters at runtime in the vnr_priv_mel_compute() function
+ * The Mel filters are stored in the mel_filter_512_24_band_compact.h file that is autogenerated from the gen_mel_filters.py script.
+ * The filters are stored in a band compact form, meaning,
+ * - The peaks of the filters split the spectrum into segments of contiguous bins, each overlapped by one even and one odd filter.
+ * - One weight per bin is stored, which is the weight of the even filter. The odd filter weight is 1 - the even filter weight.
+ * - The start bin of every segment is stored.
+ *
+ * All the filters are computed in one pass over the segments, with a weighted and a plain sum of the squared magnitude of every segment.
  *
  * @param[out] filter_output MEL filtering output spectrum output as VNR_MEL_FILTERS float_s32_t values.
- * @param[in] X DFT spectrum
+ * @param[in] X DFT spectrum, either unpacked (VNR_FD_FRAME_LENGTH bins) or packed (VNR_PACKED_FD_FRAME_LENGTH bins)
  */
 void vnr_priv_mel_compute(float_s32_t *filter_output, const bfp_complex_s32_t *X);
 
 /**
  * @brief log2 operation on float_s32 values
  * This function takes in an array of float_s32_t values and performs element wise log2 operation on them.
- * The log2 output format is fixed to Q8.24.
+ * The log2 output format is fixed to Q8.24. The output is bit exact with vnr_priv_float_s32_to_fixed_q24_log2() on every value.
  *
  * @param[out] output_q24 pointer to array that'll hold the log2 values.
  * @param[input] input float_s32_t values
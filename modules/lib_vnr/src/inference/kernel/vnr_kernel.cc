@@ -0,0 +1,121 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <string.h>
+#include "vnr_defines.h"
+#include "vnr_kernel.h"
+#include "vnr_kernel_model.h"
+
+static_assert(VNR_KERNEL_INPUT_WIDTH == VNR_PATCH_WIDTH, "VNR kernel input width doesn't match the feature patch");
+static_assert(VNR_KERNEL_LAYER0_IN == VNR_MEL_FILTERS, "VNR kernel input channels don't match the feature patch");
+static_assert(VNR_KERNEL_LAYER1_IN == VNR_KERNEL_LAYER0_OUT, "VNR kernel layer sizes don't match");
+static_assert(VNR_KERNEL_LAYER2_IN == VNR_KERNEL_INPUT_WIDTH * VNR_KERNEL_LAYER1_OUT, "VNR kernel layer sizes don't match");
+static_assert(VNR_KERNEL_LAYER3_IN == VNR_KERNEL_LAYER2_OUT, "VNR kernel layer sizes don't match");
+static_assert(VNR_KERNEL_LAYER3_OUT == 1, "VNR kernel has more than one output");
+
+// tflite::MultiplyByQuantizedMultiplier(), with gemmlowp's SaturatingRoundingDoublingHighMul() and RoundingDivideByPOT()
+static inline int32_t multiply_by_quantized_multiplier(int32_t x, int32_t multiplier, int32_t shift)
+{
+    int32_t left_shift = (shift > 0) ? shift : 0;
+    int32_t right_shift = (shift > 0) ? 0 : -shift;
+
+    int32_t a = (int32_t)((uint32_t)x << left_shift);
+    int32_t high;
+    if((a == INT32_MIN) && (multiplier == INT32_MIN)) {
+        high = INT32_MAX;
+    }
+    else {
+        int64_t ab = (int64_t)a * multiplier;
+        int32_t nudge = (ab >= 0) ? (1 << 30) : (1 - (1 << 30));
+        high = (int32_t)((ab + nudge) / ((int64_t)1 << 31));
+    }
+
+    int32_t mask = (int32_t)(((int64_t)1 << right_shift) - 1);
+    int32_t remainder = high & mask;
+    int32_t threshold = (mask >> 1) + (high < 0);
+    return (high >> right_shift) + (remainder > threshold);
+}
+
+// One conv or fully connected layer, run on num_inputs input vectors that are IN_PADDED bytes apart. Each output vector
+// starts output_stride bytes after the previous one. The weight rows are padded to whole SIMD vectors and the input zero
+// point is folded into the bias, so the inner loop is a plain int8 dot product over a compile time length that the
+// compiler vectorises. Every weight row is applied to all the input vectors before moving on to the next one.
+template <int IN_PADDED, int OUT>
+static inline void vnr_kernel_layer(
+        int8_t *output,
+        int output_stride,
+        const int8_t *input,
+        int num_inputs,
+        const int8_t *weights,
+        const int32_t *bias,
+        const int32_t *multiplier,
+        const int32_t *shift,
+        int32_t output_zero_point)
+{
+    static_assert((IN_PADDED % VNR_KERNEL_SIMD_BYTES) == 0, "VNR kernel weights aren't padded to the SIMD width");
+    for(int o=0; o<OUT; o++) {
+        const int8_t *w = &weights[o * IN_PADDED];
+        for(int n=0; n<num_inputs; n++) {
+            const int8_t *in = &input[n * IN_PADDED];
+            int32_t acc = 0;
+            for(int i=0; i<IN_PADDED; i++) {
+                acc += (int32_t)w[i] * (int32_t)in[i];
+            }
+            acc = multiply_by_quantized_multiplier(acc + bias[o], multiplier[o], shift[o]) + output_zero_point;
+            // ReLU doesn't clamp any further since all the ReLU layers have an output zero point of -128
+            acc = (acc < INT8_MIN) ? INT8_MIN : acc;
+            acc = (acc > INT8_MAX) ? INT8_MAX : acc;
+            output[(n * output_stride) + o] = (int8_t)acc;
+        }
+    }
+}
+
+void vnr_kernel_run_batch(int8_t *output, const int8_t *input, int32_t num_patches)
+{
+    // Padding lanes are zeroed so they don't add anything to the dot products
+    alignas(VNR_KERNEL_SIMD_BYTES) int8_t layer0_in[VNR_INFERENCE_MAX_BATCH][VNR_KERNEL_INPUT_WIDTH][VNR_KERNEL_LAYER0_IN_PADDED] = {{{0}}};
+    alignas(VNR_KERNEL_SIMD_BYTES) int8_t layer1_in[VNR_INFERENCE_MAX_BATCH][VNR_KERNEL_INPUT_WIDTH][VNR_KERNEL_LAYER1_IN_PADDED] = {{{0}}};
+    alignas(VNR_KERNEL_SIMD_BYTES) int8_t layer2_in[VNR_INFERENCE_MAX_BATCH][VNR_KERNEL_LAYER2_IN_PADDED] = {{0}};
+    alignas(VNR_KERNEL_SIMD_BYTES) int8_t layer3_in[VNR_INFERENCE_MAX_BATCH][VNR_KERNEL_LAYER3_IN_PADDED] = {{0}};
+    int8_t layer3_out[VNR_INFERENCE_MAX_BATCH];
+
+    for(int32_t start=0; start<num_patches; start+=VNR_INFERENCE_MAX_BATCH) {
+        int batch = ((num_patches - start) < VNR_INFERENCE_MAX_BATCH) ? (int)(num_patches - start) : VNR_INFERENCE_MAX_BATCH;
+        const int8_t *batch_input = &input[start * VNR_KERNEL_INPUT_WIDTH * VNR_KERNEL_LAYER0_IN];
+        for(int n=0; n<batch; n++) {
+            for(int w=0; w<VNR_KERNEL_INPUT_WIDTH; w++) {
+                memcpy(layer0_in[n][w], &batch_input[((n * VNR_KERNEL_INPUT_WIDTH) + w) * VNR_KERNEL_LAYER0_IN], VNR_KERNEL_LAYER0_IN);
+            }
+        }
+
+        // The 1x1 convolutions run on each of the VNR_KERNEL_INPUT_WIDTH columns of every patch. The output of the second
+        // one is the flattened input of the first fully connected layer.
+        vnr_kernel_layer<VNR_KERNEL_LAYER0_IN_PADDED, VNR_KERNEL_LAYER0_OUT>(&layer1_in[0][0][0], VNR_KERNEL_LAYER1_IN_PADDED,
+                &layer0_in[0][0][0], batch * VNR_KERNEL_INPUT_WIDTH,
+                vnr_kernel_layer0_weights, vnr_kernel_layer0_bias, vnr_kernel_layer0_multiplier, vnr_kernel_layer0_shift,
+                VNR_KERNEL_LAYER0_OUTPUT_ZERO_POINT);
+        for(int n=0; n<batch; n++) {
+            vnr_kernel_layer<VNR_KERNEL_LAYER1_IN_PADDED, VNR_KERNEL_LAYER1_OUT>(layer2_in[n], VNR_KERNEL_LAYER1_OUT,
+                    &layer1_in[n][0][0], VNR_KERNEL_INPUT_WIDTH,
+                    vnr_kernel_layer1_weights, vnr_kernel_layer1_bias, vnr_kernel_layer1_multiplier, vnr_kernel_layer1_shift,
+                    VNR_KERNEL_LAYER1_OUTPUT_ZERO_POINT);
+        }
+
+        vnr_kernel_layer<VNR_KERNEL_LAYER2_IN_PADDED, VNR_KERNEL_LAYER2_OUT>(&layer3_in[0][0], VNR_KERNEL_LAYER3_IN_PADDED,
+                &layer2_in[0][0], batch,
+                vnr_kernel_layer2_weights, vnr_kernel_layer2_bias, vnr_kernel_layer2_multiplier, vnr_kernel_layer2_shift,
+                VNR_KERNEL_LAYER2_OUTPUT_ZERO_POINT);
+        vnr_kernel_layer<VNR_KERNEL_LAYER3_IN_PADDED, VNR_KERNEL_LAYER3_OUT>(layer3_out, 1,
+                &layer3_in[0][0], batch,
+                vnr_kernel_layer3_weights, vnr_kernel_layer3_bias, vnr_kernel_layer3_multiplier, vnr_kernel_layer3_shift,
+                VNR_KERNEL_LAYER3_OUTPUT_ZERO_POINT);
+
+        for(int n=0; n<batch; n++) {
+            output[start + n] = vnr_kernel_logistic_table[(int32_t)layer3_out[n] - INT8_MIN];
+        }
+    }
+}
+
+void vnr_kernel_run(int8_t *output, const int8_t *input)
+{
+    vnr_kernel_run_batch(output, input, 1);
+}
@@ -0,0 +1,39 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef __VNR_KERNEL_H__
+#define __VNR_KERNEL_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    /**
+     * @brief Run the VNR model with the hand written kernel
+     *
+     * This function runs the VNR graph with the TensorFlow Lite reference int8 arithmetic, using the weights and
+     * requantisation parameters in vnr_kernel_model.h. The output is bit exact with the TensorFlow Lite interpreter
+     * running the unoptimised model, trained_model.tflite.
+     *
+     * @param[out] output Quantised VNR model output
+     * @param[in] input Quantised feature patch of VNR_PATCH_WIDTH x VNR_MEL_FILTERS values
+     */
+    void vnr_kernel_run(int8_t *output, const int8_t *input);
+
+    /**
+     * @brief Run the VNR model with the hand written kernel on a batch of feature patches
+     *
+     * Same as calling vnr_kernel_run() on each patch in turn, but every weight row is read once for up to
+     * VNR_INFERENCE_MAX_BATCH patches.
+     *
+     * @param[out] output num_patches quantised VNR model outputs
+     * @param[in] input num_patches quantised feature patches of VNR_PATCH_WIDTH x VNR_MEL_FILTERS values, one after the
+     * other
+     * @param[in] num_patches Number of feature patches
+     */
+    void vnr_kernel_run_batch(int8_t *output, const int8_t *input, int32_t num_patches);
+#ifdef __cplusplus
+}
+#endif
+
+#endif
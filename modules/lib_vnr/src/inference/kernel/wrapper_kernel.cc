@@ -0,0 +1,30 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "vnr_defines.h"
+#include "vnr_kernel.h"
+#include "../wrapper.h"
+
+// Model instances for builds that run the VNR model with the hand written kernel instead of TensorFlow Lite Micro. The
+// kernel keeps no state between calls, so an instance is just its input and output tensors.
+static int8_t model_input[VNR_INFERENCE_MAX_CONTEXTS][VNR_PATCH_WIDTH * VNR_MEL_FILTERS];
+static int8_t model_output[VNR_INFERENCE_MAX_CONTEXTS][1];
+
+int32_t vnr_init(int32_t model_index) {
+    return 0;
+}
+
+int8_t* vnr_get_input(int32_t model_index) {
+    return model_input[model_index];
+}
+
+int8_t* vnr_get_output(int32_t model_index) {
+    return model_output[model_index];
+}
+
+void vnr_inference_invoke(int32_t model_index) {
+    vnr_kernel_run(model_output[model_index], model_input[model_index]);
+}
+
+void vnr_inference_invoke_batch(int32_t model_index, int8_t *output, const int8_t *input, int32_t num_patches) {
+    vnr_kernel_run_batch(output, input, num_patches);
+}
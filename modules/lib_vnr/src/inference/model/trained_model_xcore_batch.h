@@ -0,0 +1,32 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef TRAINED_MODEL_XCORE_BATCH_H
+#define TRAINED_MODEL_XCORE_BATCH_H
+
+// Included by trained_model_xcore_instance<n>.cpp after the generated model, so that it can use the model's file scope
+// state. The generated model has a batch size of 1, so every patch is still run through the prepared operators on its
+// own. model_invoke() sets up and tears down the thread the xcore operators run on for every patch, this does it once
+// for the whole batch.
+TfLiteStatus model_invoke_batch(int8_t *output, const int8_t *input, int num_patches) {
+  TfLiteTensor *in = model_input(0);
+  TfLiteTensor *out = model_output(0);
+  const size_t num_nodes = sizeof(tflNodes) / sizeof(tflNodes[0]);
+  thread_init_1(&xc_config.thread_info);
+  xc_config.thread_info.nstackwords = kStackWordsPerThread;
+  xc_config.thread_info.stacks = &xc_stack[kStackWordsPerThread/2 - 1];
+  for(int n = 0; n < num_patches; ++n) {
+    memcpy(in->data.int8, &input[n * in->bytes], in->bytes);
+    for(size_t i = 0; i < num_nodes; ++i) {
+      TfLiteStatus status = registrations[nodeData[i].used_op_index].invoke(&ctx, &tflNodes[i]);
+      if (status != kTfLiteOk) {
+        thread_destroy(&xc_config.thread_info);
+        return status;
+      }
+    }
+    memcpy(&output[n * out->bytes], out->data.int8, out->bytes);
+  }
+  thread_destroy(&xc_config.thread_info);
+  return kTfLiteOk;
+}
+
+#endif
@@ -0,0 +1,30 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef TRAINED_MODEL_XCORE_INSTANCE_H
+#define TRAINED_MODEL_XCORE_INSTANCE_H
+
+// Included by trained_model_xcore_instance<n>.cpp, after defining VNR_MODEL_INSTANCE_PREFIX, before including the
+// generated model. Gives every function the generated model and its header define outside an anonymous namespace a per
+// instance name. The inline helpers in trained_model_xcore.cpp.h call model_input() and model_output(), so they would
+// otherwise have the same name but a different definition in every instance, which breaks the one definition rule.
+#define VNR_MODEL_CONCAT_(prefix, name) prefix##name
+#define VNR_MODEL_CONCAT(prefix, name) VNR_MODEL_CONCAT_(prefix, name)
+#define VNR_MODEL_RENAME(name) VNR_MODEL_CONCAT(VNR_MODEL_INSTANCE_PREFIX, name)
+
+#define model_init VNR_MODEL_RENAME(init)
+#define model_input VNR_MODEL_RENAME(input)
+#define model_output VNR_MODEL_RENAME(output)
+#define model_invoke VNR_MODEL_RENAME(invoke)
+#define model_invoke_batch VNR_MODEL_RENAME(invoke_batch)
+#define model_inputs VNR_MODEL_RENAME(inputs)
+#define model_outputs VNR_MODEL_RENAME(outputs)
+#define model_input_ptr VNR_MODEL_RENAME(input_ptr)
+#define model_input_size VNR_MODEL_RENAME(input_size)
+#define model_input_dims_len VNR_MODEL_RENAME(input_dims_len)
+#define model_input_dims VNR_MODEL_RENAME(input_dims)
+#define model_output_ptr VNR_MODEL_RENAME(output_ptr)
+#define model_output_size VNR_MODEL_RENAME(output_size)
+#define model_output_dims_len VNR_MODEL_RENAME(output_dims_len)
+#define model_output_dims VNR_MODEL_RENAME(output_dims)
+
+#endif
@@ -0,0 +1,9 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <string.h>
+
+// Model instance 0. It keeps the generated function names, and is built from here rather than from
+// trained_model_xcore.cpp itself so that the batch invoke is in the same translation unit as the generated model.
+#include "trained_model_xcore.cpp.h"
+#include "trained_model_xcore.cpp"
+#include "trained_model_xcore_batch.h"
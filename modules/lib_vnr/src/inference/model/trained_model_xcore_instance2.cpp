@@ -0,0 +1,15 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <string.h>
+#include "vnr_defines.h"
+
+#if (VNR_INFERENCE_MAX_CONTEXTS > 2)
+// Model instance 2. The generated model keeps its tensor arena and runtime state in file scope globals, so each
+// instance is a separate copy of the generated file with its functions renamed. Every copy also has its own copy of the
+// const model weights, which adds about 8 KB of memory per instance.
+#define VNR_MODEL_INSTANCE_PREFIX vnr_model_instance2_
+#include "trained_model_xcore_instance.h"
+#include "trained_model_xcore.cpp.h"
+#include "trained_model_xcore.cpp"
+#include "trained_model_xcore_batch.h"
+#endif
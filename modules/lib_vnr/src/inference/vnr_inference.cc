@@ -6,32 +6,112 @@
 #include "vnr_inference_api.h"
 #include "vnr_inference_priv.h"
 
-// Allocate all memory required by the inference engine
-static vnr_model_quant_spec_t vnr_quant_state;
+#if X86_BUILD
+#include <pthread.h>
+static pthread_mutex_t instance_lock = PTHREAD_MUTEX_INITIALIZER;
+#define INSTANCE_LOCK() pthread_mutex_lock(&instance_lock)
+#define INSTANCE_UNLOCK() pthread_mutex_unlock(&instance_lock)
+#else
+#include <xcore/lock.h>
+// Allocated during static initialisation, before any thread can call vnr_inference_ctx_init()
+static const lock_t instance_lock = lock_alloc();
+#define INSTANCE_LOCK() lock_acquire(instance_lock)
+#define INSTANCE_UNLOCK() lock_release(instance_lock)
+#endif
 
+// Context that has claimed each model instance, NULL if the instance is free. Only accessed with instance_lock held.
+static vnr_inference_ctx_t *instance_owner[VNR_INFERENCE_MAX_CONTEXTS];
+
+// Context used by vnr_inference_init() and vnr_inference()
+static vnr_inference_ctx_t vnr_default_ctx;
+
+// Free any instance claimed by ctx. Called with instance_lock held
+static void release_instances(vnr_inference_ctx_t *ctx) {
+    for(int32_t i=0; i<VNR_INFERENCE_MAX_CONTEXTS; i++) {
+        if(instance_owner[i] == ctx) {
+            instance_owner[i] = NULL;
+        }
+    }
+}
 
 // TODO: unsure why the stack can not be computed automatically here
 #pragma stackfunction 1000
-int32_t vnr_inference_init() {
-
-    int32_t ret = vnr_init();
+int32_t vnr_inference_ctx_init(vnr_inference_ctx_t *ctx, int32_t model_index) {
+    if((model_index < VNR_INFERENCE_ANY_INSTANCE) || (model_index >= VNR_INFERENCE_MAX_CONTEXTS)) {
+        return -1;
+    }
+    INSTANCE_LOCK();
+    // Re-initialising a context gives up the instance it had
+    release_instances(ctx);
+    if(model_index == VNR_INFERENCE_ANY_INSTANCE) {
+        for(int32_t i=0; i<VNR_INFERENCE_MAX_CONTEXTS; i++) {
+            if(instance_owner[i] == NULL) {
+                model_index = i;
+                break;
+            }
+        }
+    }
+    if((model_index == VNR_INFERENCE_ANY_INSTANCE) || (instance_owner[model_index] != NULL)) {
+        INSTANCE_UNLOCK();
+        return -1;
+    }
+    // The one time model initialisation in vnr_init() is done with the lock held, so two contexts claiming instances
+    // at the same time can't both initialise the same model instance
+    int32_t ret = vnr_init(model_index);
+    if(ret == 0) {
+        instance_owner[model_index] = ctx;
+    }
+    INSTANCE_UNLOCK();
+    ctx->model_index = model_index;
 
     // Initialise input quant and output dequant parameters
-    vnr_priv_init_quant_spec(&vnr_quant_state);
+    vnr_priv_init_quant_spec(&ctx->quant_spec);
     return ret;
 }
 
+void vnr_inference_ctx_release(vnr_inference_ctx_t *ctx) {
+    INSTANCE_LOCK();
+    release_instances(ctx);
+    INSTANCE_UNLOCK();
+}
+
 #pragma stackfunction 1000
-void vnr_inference(float_s32_t *vnr_output, bfp_s32_t *features) {
-    int8_t * in_buffer = vnr_get_input();
-    int8_t * out_buffer = vnr_get_output();
+void vnr_inference_run(vnr_inference_ctx_t *ctx, float_s32_t *vnr_output, bfp_s32_t *features) {
+    int8_t * in_buffer = vnr_get_input(ctx->model_index);
+    int8_t * out_buffer = vnr_get_output(ctx->model_index);
     // Quantise features to 8bit
-    vnr_priv_feature_quantise(in_buffer, features, &vnr_quant_state);
+    vnr_priv_feature_quantise(in_buffer, features, &ctx->quant_spec);
 
     // Inference
-    vnr_inference_invoke();
+    vnr_inference_invoke(ctx->model_index);
 
     // Dequantise inference output
-    vnr_priv_output_dequantise(vnr_output, out_buffer, &vnr_quant_state);
+    vnr_priv_output_dequantise(vnr_output, out_buffer, &ctx->quant_spec);
+}
+
+#pragma stackfunction 1000
+void vnr_inference_run_batch(vnr_inference_ctx_t *ctx, float_s32_t *vnr_output, bfp_s32_t *features, unsigned num_patches) {
+    int8_t quantised_patches[VNR_INFERENCE_MAX_BATCH][VNR_PATCH_WIDTH * VNR_MEL_FILTERS];
+    int8_t quantised_output[VNR_INFERENCE_MAX_BATCH];
+    for(unsigned start=0; start<num_patches; start+=VNR_INFERENCE_MAX_BATCH) {
+        unsigned batch = ((num_patches - start) < VNR_INFERENCE_MAX_BATCH) ? (num_patches - start) : VNR_INFERENCE_MAX_BATCH;
+        // Quantise all the patches, run them through the model in one invoke and then dequantise all the outputs
+        for(unsigned i=0; i<batch; i++) {
+            vnr_priv_feature_quantise(quantised_patches[i], &features[start + i], &ctx->quant_spec);
+        }
+        vnr_inference_invoke_batch(ctx->model_index, quantised_output, &quantised_patches[0][0], batch);
+        for(unsigned i=0; i<batch; i++) {
+            vnr_priv_output_dequantise(&vnr_output[start + i], &quantised_output[i], &ctx->quant_spec);
+        }
+    }
 }
 
+#pragma stackfunction 1000
+int32_t vnr_inference_init() {
+    return vnr_inference_ctx_init(&vnr_default_ctx, VNR_INFERENCE_ANY_INSTANCE);
+}
+
+#pragma stackfunction 1000
+void vnr_inference(float_s32_t *vnr_output, bfp_s32_t *features) {
+    vnr_inference_run(&vnr_default_ctx, vnr_output, features);
+}
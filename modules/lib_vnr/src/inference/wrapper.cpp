@@ -1,15 +1,59 @@
 #include "model/trained_model_xcore.cpp.h"
+#include "vnr_defines.h"
 #include "wrapper.h"
 
-// Flag to make sure a given model is initilised only once. This is needed because the model/trained_model_xcore.cpp file have one time initialised non-const global
+// Entry points of the model instances. Every instance is a copy of model/trained_model_xcore.cpp in
+// model/trained_model_xcore_instance<n>.cpp, followed by the batch invoke in model/trained_model_xcore_batch.h. Instance
+// 0 keeps the generated function names.
+TfLiteStatus model_invoke_batch(int8_t *output, const int8_t *input, int num_patches);
+#define VNR_MODEL_INSTANCE(n) \
+    TfLiteStatus vnr_model_instance##n##_init(void *flash_data); \
+    TfLiteTensor *vnr_model_instance##n##_input(int index); \
+    TfLiteTensor *vnr_model_instance##n##_output(int index); \
+    TfLiteStatus vnr_model_instance##n##_invoke(); \
+    TfLiteStatus vnr_model_instance##n##_invoke_batch(int8_t *output, const int8_t *input, int num_patches);
+#if (VNR_INFERENCE_MAX_CONTEXTS > 1)
+VNR_MODEL_INSTANCE(1)
+#endif
+#if (VNR_INFERENCE_MAX_CONTEXTS > 2)
+VNR_MODEL_INSTANCE(2)
+#endif
+#if (VNR_INFERENCE_MAX_CONTEXTS > 3)
+VNR_MODEL_INSTANCE(3)
+#endif
+
+typedef struct {
+    TfLiteStatus (*init)(void *flash_data);
+    TfLiteTensor *(*input)(int index);
+    TfLiteTensor *(*output)(int index);
+    TfLiteStatus (*invoke)();
+    TfLiteStatus (*invoke_batch)(int8_t *output, const int8_t *input, int num_patches);
+}vnr_model_instance_t;
+
+static const vnr_model_instance_t model_instances[VNR_INFERENCE_MAX_CONTEXTS] = {
+    {model_init, model_input, model_output, model_invoke, model_invoke_batch},
+#if (VNR_INFERENCE_MAX_CONTEXTS > 1)
+    {vnr_model_instance1_init, vnr_model_instance1_input, vnr_model_instance1_output, vnr_model_instance1_invoke, vnr_model_instance1_invoke_batch},
+#endif
+#if (VNR_INFERENCE_MAX_CONTEXTS > 2)
+    {vnr_model_instance2_init, vnr_model_instance2_input, vnr_model_instance2_output, vnr_model_instance2_invoke, vnr_model_instance2_invoke_batch},
+#endif
+#if (VNR_INFERENCE_MAX_CONTEXTS > 3)
+    {vnr_model_instance3_init, vnr_model_instance3_input, vnr_model_instance3_output, vnr_model_instance3_invoke, vnr_model_instance3_invoke_batch},
+#endif
+};
+
+// Flags to make sure a given model instance is initilised only once. This is needed because the model/trained_model_xcore.cpp file have one time initialised non-const global
 // values which will not be reset to their original values in subsequent calls to model_init() causing the initialisation to go wrong. 
-static int32_t model_initialised = 0;
+// vnr_init() is only called by vnr_inference_ctx_init() with its model instance lock held, so the check and set of a
+// flag can't race with another thread initialising the same instance.
+static int32_t model_initialised[VNR_INFERENCE_MAX_CONTEXTS] = {0};
 
-int32_t vnr_init() {
-    if(!model_initialised)
+int32_t vnr_init(int32_t model_index) {
+    if(!model_initialised[model_index])
     {
-        model_initialised = 1;
-        int32_t ret = model_init(NULL);
+        model_initialised[model_index] = 1;
+        int32_t ret = model_instances[model_index].init(NULL);
         return ret;
     }
     else
@@ -18,15 +62,18 @@ int32_t vnr_init() {
     }
 }
 
-int8_t* vnr_get_input() {
-    return model_input(0)->data.int8;
+int8_t* vnr_get_input(int32_t model_index) {
+    return model_instances[model_index].input(0)->data.int8;
 }
 
-int8_t* vnr_get_output() {
-    return model_output(0)->data.int8;
+int8_t* vnr_get_output(int32_t model_index) {
+    return model_instances[model_index].output(0)->data.int8;
 }
 
-void vnr_inference_invoke() {
-    model_invoke();
+void vnr_inference_invoke(int32_t model_index) {
+    model_instances[model_index].invoke();
 }
 
+void vnr_inference_invoke_batch(int32_t model_index, int8_t *output, const int8_t *input, int32_t num_patches) {
+    model_instances[model_index].invoke_batch(output, input, num_patches);
+}
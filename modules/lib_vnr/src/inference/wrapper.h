@@ -4,11 +4,14 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-    int32_t vnr_init();
-    int8_t* vnr_get_input();
-    int8_t* vnr_get_output();
-    void vnr_inference_invoke();
+    // Must be called with the model instance lock in vnr_inference.cc held
+    int32_t vnr_init(int32_t model_index);
+    int8_t* vnr_get_input(int32_t model_index);
+    int8_t* vnr_get_output(int32_t model_index);
+    void vnr_inference_invoke(int32_t model_index);
+    // Runs num_patches quantised feature patches, one after the other in input, through the model instance and writes
+    // one quantised output per patch to output. The model instance's input and output tensors are overwritten.
+    void vnr_inference_invoke_batch(int32_t model_index, int8_t *output, const int8_t *input, int32_t num_patches);
 #ifdef __cplusplus
 }
 #endif
-
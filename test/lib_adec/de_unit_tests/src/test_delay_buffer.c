@@ -0,0 +1,136 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "de_unit_tests.h"
+#include <stdio.h>
+#include "delay_buffer.h"
+
+#define FRAME_LENGTH        (240)
+#define MAX_DELAY_SAMPLES   (1000)
+#define BUF_LENGTH          DELAY_BUF_LENGTH(MAX_DELAY_SAMPLES, FRAME_LENGTH)
+#define NUM_FRAMES          (400/F)
+#define NUM_CHANNELS        (MAX_DELAY_BUF_CHANNELS)
+
+static int32_t buffer_memory[NUM_CHANNELS * BUF_LENGTH];
+// Every sample that went into each channel, for the reference to index by sample number
+static int32_t history[NUM_CHANNELS][NUM_FRAMES * FRAME_LENGTH];
+
+// Input sample n of the channel delayed by delay samples, 0 before the start
+static int64_t ref_sample(int32_t ch, int32_t n, int32_t delay) {
+    delay = (delay < 0) ? -delay : delay;
+    return (n - delay < 0) ? 0 : history[ch][n - delay];
+}
+
+// Random number in [0, n). The low bits of pseudo_rand repeat too often to be used on their own
+static int32_t rand_below(unsigned *seed, uint32_t n) {
+    return (int32_t)(((uint64_t)pseudo_rand_uint32(seed) * n) >> 32);
+}
+
+typedef struct {
+    int32_t delay_samples;
+    int32_t prev_delay_samples;
+    int32_t crossfade_length;
+    int32_t crossfade_pos[NUM_CHANNELS];
+} ref_delay_t;
+
+// One sample at a time, crossfading linearly from the previous delay
+static int32_t ref_get_delayed_sample(ref_delay_t *ref, int32_t ch, int32_t n) {
+    int64_t cur = ref_sample(ch, n, ref->delay_samples);
+    if(ref->crossfade_pos[ch] < ref->crossfade_length) {
+        int64_t prev = ref_sample(ch, n, ref->prev_delay_samples);
+        cur = prev + (((cur - prev) * ref->crossfade_pos[ch]) / ref->crossfade_length);
+        ref->crossfade_pos[ch]++;
+    }
+    return (int32_t)cur;
+}
+
+static int32_t ref_update_delay(ref_delay_t *ref, int32_t delay) {
+    int32_t max_delay = BUF_LENGTH - FRAME_LENGTH;
+    delay = (delay > max_delay) ? max_delay : (delay < -max_delay) ? -max_delay : delay;
+    int32_t crossfade = (ref->crossfade_length > 0) && (delay != ref->delay_samples) &&
+        ((delay < 0) == (ref->delay_samples < 0));
+    ref->prev_delay_samples = ref->delay_samples;
+    ref->delay_samples = delay;
+    for(int ch=0; ch<NUM_CHANNELS; ch++) {
+        ref->crossfade_pos[ch] = crossfade ? 0 : ref->crossfade_length;
+    }
+    return crossfade;
+}
+
+// Zero the last delay_samples samples of the channel's history, which the new delay is about to read
+static void ref_reset_partial(ref_delay_t *ref, int32_t ch, int32_t n) {
+    if(ref->crossfade_pos[ch] < ref->crossfade_length) {
+        return;
+    }
+    int32_t delay = (ref->delay_samples < 0) ? -ref->delay_samples : ref->delay_samples;
+    for(int32_t i=n-delay; i<n; i++) {
+        if(i >= 0) {
+            history[ch][i] = 0;
+        }
+    }
+}
+
+static void run_test(int32_t crossfade_frames, unsigned seed) {
+    delay_buf_state_t state;
+    ref_delay_t ref;
+    memset(&ref, 0, sizeof(ref));
+    memset(history, 0, sizeof(history));
+    int32_t delay = rand_below(&seed, MAX_DELAY_SAMPLES);
+    TEST_ASSERT_EQUAL_INT32(0, delay_buffer_init(&state, buffer_memory, NUM_CHANNELS, BUF_LENGTH, FRAME_LENGTH, delay));
+    delay_buffer_set_crossfade(&state, crossfade_frames);
+    ref.delay_samples = ref.prev_delay_samples = delay;
+    ref.crossfade_length = crossfade_frames * FRAME_LENGTH;
+    for(int ch=0; ch<NUM_CHANNELS; ch++) {
+        ref.crossfade_pos[ch] = ref.crossfade_length;
+    }
+
+    int32_t frame[FRAME_LENGTH];
+    int32_t expected[FRAME_LENGTH];
+    for(int f=0; f<NUM_FRAMES; f++) {
+        int32_t n = f * FRAME_LENGTH;
+        // Change the delay every few frames: up, down, across zero and beyond the largest supported delay
+        if(rand_below(&seed, 4) == 0) {
+            int32_t new_delay = rand_below(&seed, 2 * MAX_DELAY_SAMPLES + 400) - (MAX_DELAY_SAMPLES + 200);
+            if(rand_below(&seed, 4) == 0) {
+                // Small changes as well, so that the crossfade runs between nearby delays
+                new_delay = state.delay_samples + rand_below(&seed, 33) - 16;
+            }
+            int32_t crossfade = ref_update_delay(&ref, new_delay);
+            TEST_ASSERT_EQUAL_INT32(crossfade, update_delay_samples(&state, new_delay));
+            TEST_ASSERT_EQUAL_INT32(ref.delay_samples, state.delay_samples);
+            if(rand_below(&seed, 2) == 0) {
+                for(int ch=0; ch<NUM_CHANNELS; ch++) {
+                    reset_partial_delay_buffer(&state, ch);
+                    ref_reset_partial(&ref, ch, n);
+                }
+            }
+        }
+        for(int ch=0; ch<NUM_CHANNELS; ch++) {
+            for(int i=0; i<FRAME_LENGTH; i++) {
+                frame[i] = history[ch][n + i] = pseudo_rand_int32(&seed);
+            }
+            for(int i=0; i<FRAME_LENGTH; i++) {
+                expected[i] = ref_get_delayed_sample(&ref, ch, n + i);
+            }
+            get_delayed_block(&state, frame, ch);
+            TEST_ASSERT_EQUAL_INT32_ARRAY(expected, frame, FRAME_LENGTH);
+        }
+    }
+}
+
+void test_delay_buffer_no_crossfade() {
+    run_test(0, 8713);
+}
+
+void test_delay_buffer_crossfade() {
+    run_test(3, 2291);
+}
+
+void test_delay_buffer_init_sizes() {
+    delay_buf_state_t state;
+    // Buffer lengths must be a whole number of frames, and at least two of them
+    TEST_ASSERT_EQUAL_INT32(-1, delay_buffer_init(&state, buffer_memory, NUM_CHANNELS, BUF_LENGTH + 1, FRAME_LENGTH, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, delay_buffer_init(&state, buffer_memory, NUM_CHANNELS, FRAME_LENGTH, FRAME_LENGTH, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, delay_buffer_init(&state, buffer_memory, NUM_CHANNELS + 1, BUF_LENGTH, FRAME_LENGTH, 0));
+    TEST_ASSERT_EQUAL_INT32(0, delay_buffer_init(&state, buffer_memory, NUM_CHANNELS, BUF_LENGTH, FRAME_LENGTH, 0));
+    TEST_ASSERT_EQUAL_INT32(BUF_LENGTH - FRAME_LENGTH, delay_buffer_max_delay_samples(&state));
+}
@@ -148,3 +148,234 @@ void test_delay_estimate() {
     TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.0, 1.0, (float)dut_peak_to_average_ratio_fp, "dut_peak_to_average_ratio_fp incorrect");
     TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.0, 1.0, (float)peak_to_average_ratio, "peak_to_average_ratio incorrect");
 }
+
+static void randomise_phase(bfp_complex_s32_t *H, unsigned *seed) {
+    H->exp = pseudo_rand_int(seed, -39, 39);
+    for(unsigned i = 0; i < H->length; i++){
+        H->data[i].re = pseudo_rand_int32(seed);
+        H->data[i].im = pseudo_rand_int32(seed);
+    }
+}
+
+static void assert_de_output_equal(de_output_t *expected, de_output_t *actual, unsigned num_phases) {
+    TEST_ASSERT_EQUAL_INT32(expected->measured_delay_samples, actual->measured_delay_samples);
+    TEST_ASSERT_EQUAL_INT32(expected->peak_power_phase_index, actual->peak_power_phase_index);
+    TEST_ASSERT_EQUAL_INT32_ARRAY((int32_t*)&expected->peak_phase_power, (int32_t*)&actual->peak_phase_power, 2);
+    TEST_ASSERT_EQUAL_INT32_ARRAY((int32_t*)&expected->sum_phase_powers, (int32_t*)&actual->sum_phase_powers, 2);
+    TEST_ASSERT_EQUAL_INT32_ARRAY((int32_t*)&expected->peak_to_average_ratio, (int32_t*)&actual->peak_to_average_ratio, 2);
+    TEST_ASSERT_EQUAL_INT32_ARRAY((int32_t*)expected->phase_power, (int32_t*)actual->phase_power, 2*num_phases);
+}
+
+void test_delay_estimate_incremental() {
+    uint8_t DWORD_ALIGNED aec_memory_pool[sizeof(aec_memory_pool_t)];
+    aec_state_t DWORD_ALIGNED state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    unsigned seed = 6743;
+    const unsigned num_phases = NUM_PHASES_DELAY_EST;
+
+    aec_init(&state, NULL, &shared_state, aec_memory_pool, NULL, 1, 1, num_phases, 0);
+    for(unsigned ph = 0; ph < num_phases; ph++){
+        randomise_phase(&state.H_hat[0][ph], &seed);
+    }
+
+    de_output_t expected, actual;
+    de_state_t de_state;
+    //In exact mode every frame should match adec_estimate_delay()
+    unsigned phases_per_frame[] = {0, num_phases, num_phases + 1};
+    for(int i = 0; i < sizeof(phases_per_frame)/sizeof(phases_per_frame[0]); i++) {
+        adec_de_init(&de_state, phases_per_frame[i]);
+        for(int frame = 0; frame < 4; frame++) {
+            randomise_phase(&state.H_hat[0][pseudo_rand_uint32(&seed) % num_phases], &seed);
+            adec_estimate_delay(&expected, state.H_hat[0], num_phases);
+            adec_estimate_delay_incremental(&de_state, &actual, state.H_hat[0], num_phases);
+            assert_de_output_equal(&expected, &actual, num_phases);
+        }
+    }
+
+    for(unsigned per_frame = 1; per_frame < num_phases; per_frame += 4/F + 1) {
+        unsigned peak_phase = num_phases - 1;
+        memset(state.H_hat[0][peak_phase].data, 0, state.H_hat[0][peak_phase].length * sizeof(complex_s32_t));
+
+        adec_de_init(&de_state, per_frame);
+        //First call after init recalculates all phases
+        adec_estimate_delay(&expected, state.H_hat[0], num_phases);
+        adec_estimate_delay_incremental(&de_state, &actual, state.H_hat[0], num_phases);
+        assert_de_output_equal(&expected, &actual, num_phases);
+
+        //Move the peak to a phase that is only recalculated in the last frame of the round robin cycle
+        unsigned frames_to_refresh = (num_phases + per_frame - 1) / per_frame;
+        for(unsigned i = 0; i < state.H_hat[0][peak_phase].length; i++) {
+            state.H_hat[0][peak_phase].data[i].re = INT32_MAX >> 1;
+        }
+        state.H_hat[0][peak_phase].exp = 60;
+
+        for(unsigned frame = 0; frame < frames_to_refresh; frame++) {
+            adec_estimate_delay_incremental(&de_state, &actual, state.H_hat[0], num_phases);
+            if(frame < frames_to_refresh - 1) {
+                TEST_ASSERT_NOT_EQUAL(peak_phase, actual.peak_power_phase_index);
+            }
+        }
+        //Every phase has been recalculated once since H_hat last changed
+        adec_estimate_delay(&expected, state.H_hat[0], num_phases);
+        assert_de_output_equal(&expected, &actual, num_phases);
+        TEST_ASSERT_EQUAL_INT32(peak_phase * AEC_FRAME_ADVANCE, actual.measured_delay_samples);
+
+        //A change of filter length starts over with a full recalculation
+        adec_estimate_delay(&expected, state.H_hat[0], num_phases - 1);
+        adec_estimate_delay_incremental(&de_state, &actual, state.H_hat[0], num_phases - 1);
+        assert_de_output_equal(&expected, &actual, num_phases - 1);
+        for(unsigned ph = 0; ph < num_phases; ph++){
+            randomise_phase(&state.H_hat[0][ph], &seed);
+        }
+    }
+}
+
+void test_delay_estimate_refined() {
+    uint8_t DWORD_ALIGNED aec_memory_pool[sizeof(aec_memory_pool_t)];
+    aec_state_t DWORD_ALIGNED state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    unsigned seed = 9871;
+    const unsigned num_phases = NUM_PHASES_DELAY_EST;
+    de_output_t de_output;
+
+    for(int offset = -200; offset < AEC_FRAME_ADVANCE; offset += 7*F) {
+        aec_init(&state, NULL, &shared_state, aec_memory_pool, NULL, 1, 1, num_phases, 0);
+        unsigned peak_phase = pseudo_rand_uint32(&seed) % num_phases;
+        for(unsigned ph = 0; ph < num_phases; ph++){
+            bfp_complex_s32_t *H = &state.H_hat[0][ph];
+            H->exp = pseudo_rand_int(&seed, -39, 39);
+            for(unsigned k = 0; k < H->length; k++){
+                if(ph == peak_phase) {
+                    //Echo path peak offset samples into the phase, with a gain that varies across frequency
+                    double gain = ldexp(1.0 + 0.5 * sin(k * 0.05), 29);
+                    double angle = -2.0 * M_PI * k * offset / AEC_PROC_FRAME_LENGTH;
+                    H->data[k].re = (int32_t)(gain * cos(angle));
+                    H->data[k].im = (int32_t)(gain * sin(angle));
+                }
+                else {
+                    H->data[k].re = pseudo_rand_int32(&seed) >> 8;
+                    H->data[k].im = pseudo_rand_int32(&seed) >> 8;
+                }
+            }
+            if(ph == peak_phase) {
+                H->exp = 40;
+            }
+        }
+        adec_estimate_delay(&de_output, state.H_hat[0], num_phases);
+        TEST_ASSERT_EQUAL_INT32(peak_phase * AEC_FRAME_ADVANCE, de_output.measured_delay_samples);
+        TEST_ASSERT_INT32_WITHIN(1, peak_phase * AEC_FRAME_ADVANCE + offset, de_output.refined_delay_samples);
+    }
+
+    //No energy in H_hat, so no refinement
+    aec_init(&state, NULL, &shared_state, aec_memory_pool, NULL, 1, 1, num_phases, 0);
+    adec_estimate_delay(&de_output, state.H_hat[0], num_phases);
+    TEST_ASSERT_EQUAL_INT32(de_output.measured_delay_samples, de_output.refined_delay_samples);
+}
+
+#define MULTI_PHASES    10
+
+// Give a phase of every mic channel's filter for a reference a peak with plenty more energy than the random phases
+static void set_reference_peak(aec_state_t *state, unsigned num_y, unsigned xch, unsigned peak_phase, unsigned *seed) {
+    for(unsigned y = 0; y < num_y; y++) {
+        for(unsigned ph = 0; ph < MULTI_PHASES; ph++){
+            bfp_complex_s32_t *H = &state->H_hat[y][xch*MULTI_PHASES + ph];
+            randomise_phase(H, seed);
+            H->exp = (ph == peak_phase) ? 8 : -8;
+        }
+    }
+}
+
+void test_delay_estimate_multi() {
+    uint8_t DWORD_ALIGNED aec_memory_pool[sizeof(aec_memory_pool_t)];
+    aec_state_t DWORD_ALIGNED state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    unsigned seed = 2290;
+    de_output_t expected, actual;
+    de_state_t de_state, expected_state;
+
+    //A single x-y pair should match adec_estimate_delay_incremental()
+    aec_init(&state, NULL, &shared_state, aec_memory_pool, NULL, 1, 1, NUM_PHASES_DELAY_EST, 0);
+    for(unsigned ph = 0; ph < NUM_PHASES_DELAY_EST; ph++){
+        randomise_phase(&state.H_hat[0][ph], &seed);
+    }
+    unsigned phases_per_frame[] = {0, 7, NUM_PHASES_DELAY_EST};
+    for(int i = 0; i < sizeof(phases_per_frame)/sizeof(phases_per_frame[0]); i++) {
+        adec_de_init(&expected_state, phases_per_frame[i]);
+        adec_de_init(&de_state, phases_per_frame[i]);
+        for(int frame = 0; frame < 6; frame++) {
+            randomise_phase(&state.H_hat[0][pseudo_rand_uint32(&seed) % NUM_PHASES_DELAY_EST], &seed);
+            adec_estimate_delay_incremental(&expected_state, &expected, state.H_hat[0], NUM_PHASES_DELAY_EST);
+            adec_estimate_delay_multi(&de_state, &actual, (const bfp_complex_s32_t (*)[AEC_LIB_MAX_PHASES])state.H_hat, 1, 1, NUM_PHASES_DELAY_EST);
+            assert_de_output_equal(&expected, &actual, NUM_PHASES_DELAY_EST);
+            TEST_ASSERT_EQUAL_INT32(expected.refined_delay_samples, actual.refined_delay_samples);
+            TEST_ASSERT_EQUAL_INT32(expected.measured_delay_samples, actual.x_measured_delay_samples[0]);
+            TEST_ASSERT_EQUAL_INT32(0, actual.reference_delay_mismatch_flag);
+        }
+    }
+
+    //Two references with echoes at different delays, on both mics
+    const unsigned num_y = 2, num_x = 2;
+    aec_init(&state, NULL, &shared_state, aec_memory_pool, NULL, num_y, num_x, MULTI_PHASES, 0);
+    const bfp_complex_s32_t (*H_hat)[AEC_LIB_MAX_PHASES] = (const bfp_complex_s32_t (*)[AEC_LIB_MAX_PHASES])state.H_hat;
+    set_reference_peak(&state, num_y, 0, 6, &seed);
+    set_reference_peak(&state, num_y, 1, 2, &seed);
+    //The later echo is the louder one, so the peak of all the references together is at its delay
+    for(unsigned y = 0; y < num_y; y++) {
+        state.H_hat[y][6].exp += 2;
+    }
+    adec_de_init(&de_state, 0);
+    adec_estimate_delay_multi(&de_state, &actual, H_hat, num_y, num_x, MULTI_PHASES);
+    TEST_ASSERT_EQUAL_INT32(6 * AEC_FRAME_ADVANCE, actual.x_measured_delay_samples[0]);
+    TEST_ASSERT_EQUAL_INT32(2 * AEC_FRAME_ADVANCE, actual.x_measured_delay_samples[1]);
+    TEST_ASSERT_EQUAL_INT32(1, actual.reference_delay_mismatch_flag);
+    //Aligned to the earlier echo, which is the second reference's, and so is the peak
+    TEST_ASSERT_EQUAL_INT32(2 * AEC_FRAME_ADVANCE, actual.measured_delay_samples);
+    TEST_ASSERT_EQUAL_INT32(2, actual.peak_power_phase_index);
+    float_s32_t peak_power, mic_power;
+    aec_calc_freq_domain_energy(&peak_power, &H_hat[0][MULTI_PHASES + 2]);
+    aec_calc_freq_domain_energy(&mic_power, &H_hat[1][MULTI_PHASES + 2]);
+    peak_power = float_s32_add(peak_power, mic_power);
+    TEST_ASSERT_EQUAL_INT32(peak_power.mant, actual.peak_phase_power.mant);
+    TEST_ASSERT_EQUAL_INT32(peak_power.exp, actual.peak_phase_power.exp);
+
+    //Peaks in neighbouring phases can be the same delay
+    set_reference_peak(&state, num_y, 1, 5, &seed);
+    adec_estimate_delay_multi(&de_state, &actual, H_hat, num_y, num_x, MULTI_PHASES);
+    TEST_ASSERT_EQUAL_INT32(5 * AEC_FRAME_ADVANCE, actual.x_measured_delay_samples[1]);
+    TEST_ASSERT_EQUAL_INT32(0, actual.reference_delay_mismatch_flag);
+
+    //A reference with no clear peak doesn't count, however far its largest phase is from the other reference's peak
+    for(unsigned y = 0; y < num_y; y++) {
+        for(unsigned ph = 0; ph < MULTI_PHASES; ph++){
+            randomise_phase(&state.H_hat[y][MULTI_PHASES + ph], &seed);
+            state.H_hat[y][MULTI_PHASES + ph].exp = 0;
+        }
+    }
+    adec_estimate_delay_multi(&de_state, &actual, H_hat, num_y, num_x, MULTI_PHASES);
+    TEST_ASSERT_EQUAL_INT32(0, actual.reference_delay_mismatch_flag);
+    TEST_ASSERT_EQUAL_INT32(6 * AEC_FRAME_ADVANCE, actual.measured_delay_samples);
+
+    //The per frame budget is shared by all the x-y pairs, and the outputs catch up once every phase has been
+    //recalculated
+    const unsigned total_phases = num_y * num_x * MULTI_PHASES;
+    for(unsigned per_frame = 3; per_frame < total_phases; per_frame += 8/F + 1) {
+        set_reference_peak(&state, num_y, 0, 6, &seed);
+        set_reference_peak(&state, num_y, 1, 2, &seed);
+        adec_de_init(&de_state, per_frame);
+        adec_estimate_delay_multi(&de_state, &actual, H_hat, num_y, num_x, MULTI_PHASES);
+        TEST_ASSERT_EQUAL_INT32(0, de_state.next_phase);
+
+        set_reference_peak(&state, num_y, 1, 9, &seed);
+        unsigned frames_to_refresh = (total_phases + per_frame - 1) / per_frame;
+        for(unsigned frame = 0; frame < frames_to_refresh; frame++) {
+            adec_estimate_delay_multi(&de_state, &actual, H_hat, num_y, num_x, MULTI_PHASES);
+            TEST_ASSERT_EQUAL_INT32(((frame + 1) * per_frame) % total_phases, de_state.next_phase);
+        }
+        adec_de_init(&expected_state, 0);
+        adec_estimate_delay_multi(&expected_state, &expected, H_hat, num_y, num_x, MULTI_PHASES);
+        assert_de_output_equal(&expected, &actual, MULTI_PHASES);
+        TEST_ASSERT_EQUAL_INT32(9 * AEC_FRAME_ADVANCE, actual.x_measured_delay_samples[1]);
+        TEST_ASSERT_EQUAL_INT32(1, actual.reference_delay_mismatch_flag);
+        TEST_ASSERT_EQUAL_INT32(6 * AEC_FRAME_ADVANCE, actual.measured_delay_samples);
+    }
+}
@@ -0,0 +1,131 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <xs1.h>
+#include "de_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_api.h"
+#include "adec_api.h"
+
+#define GCC_TEST_FRAMES (100)
+#define GCC_TEST_SIG_LEN ((GCC_TEST_FRAMES * AEC_FRAME_ADVANCE) + (2 * ADEC_GCC_PHAT_MAX_DELAY_SAMPLES))
+
+static int32_t reference[GCC_TEST_SIG_LEN];
+static gcc_phat_state_t gcc_state;
+
+// Run the estimator on a reference of white noise and a mic of the reference delayed by delay samples, scaled by
+// 2^-echo_shr and inverted if invert is set, plus uncorrelated near end noise at 2^-noise_shr
+static void run_gcc_phat(gcc_phat_output_t *output, int32_t delay, int echo_shr, int invert, int noise_shr, unsigned *seed)
+{
+    for(int i=0; i<GCC_TEST_SIG_LEN; i++) {
+        reference[i] = pseudo_rand_int32(seed) >> 4;
+    }
+    adec_gcc_phat_init(&gcc_state);
+    memset(output, 0, sizeof(gcc_phat_output_t));
+    int32_t x[AEC_FRAME_ADVANCE], y[AEC_FRAME_ADVANCE];
+    for(int frame=0; frame<GCC_TEST_FRAMES; frame++) {
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            int n = ADEC_GCC_PHAT_MAX_DELAY_SAMPLES + frame*AEC_FRAME_ADVANCE + i;
+            x[i] = reference[n];
+            int32_t echo = (echo_shr < 32) ? (reference[n - delay] >> echo_shr) : 0;
+            y[i] = (invert ? -echo : echo) + (pseudo_rand_int32(seed) >> noise_shr);
+        }
+        adec_gcc_phat_process_frame(&gcc_state, output, y, x, 1);
+        if(frame < (ADEC_GCC_PHAT_FFT_LENGTH * ADEC_GCC_PHAT_DECIMATION_FACTOR) / AEC_FRAME_ADVANCE) {
+            TEST_ASSERT_EQUAL_INT32(0, output->valid);
+        }
+    }
+}
+
+void test_gcc_phat_delay() {
+    unsigned seed = 5511;
+    const float_s32_t good_ratio = f32_to_float_s32(ADEC_GCC_PHAT_GOOD_PEAK_TO_AVERAGE);
+    const int32_t delays[] = {0, 37, 1000, -613, 2200, -2390};
+    for(int d=0; d<sizeof(delays)/sizeof(delays[0]); d++) {
+        gcc_phat_output_t output;
+        //Echo 12dB below the reference and near end noise 12dB below the echo
+        run_gcc_phat(&output, delays[d], 2, (d & 1), 8, &seed);
+        TEST_ASSERT_EQUAL_INT32(1, output.valid);
+        TEST_ASSERT_INT32_WITHIN(ADEC_GCC_PHAT_DECIMATION_FACTOR / 2, delays[d], output.delay_samples);
+        TEST_ASSERT(float_s32_gte(output.peak_to_average_ratio, good_ratio));
+    }
+}
+
+void test_gcc_phat_no_echo() {
+    unsigned seed = 713;
+    const float_s32_t good_ratio = f32_to_float_s32(ADEC_GCC_PHAT_GOOD_PEAK_TO_AVERAGE);
+    for(int i=0; i<4; i++) {
+        gcc_phat_output_t output;
+        //Mic is only near end noise, so there is no delay to find
+        run_gcc_phat(&output, 0, 32, 0, 4, &seed);
+        TEST_ASSERT_EQUAL_INT32(1, output.valid);
+        TEST_ASSERT(!float_s32_gte(output.peak_to_average_ratio, good_ratio));
+    }
+}
+
+void test_gcc_phat_far_end_inactive() {
+    gcc_phat_output_t output;
+    int32_t x[AEC_FRAME_ADVANCE], y[AEC_FRAME_ADVANCE];
+    unsigned seed = 1;
+    for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+        x[i] = pseudo_rand_int32(&seed) >> 4;
+        y[i] = x[i] >> 2;
+    }
+    adec_gcc_phat_init(&gcc_state);
+    output.valid = 0;
+    for(int frame=0; frame<GCC_TEST_FRAMES; frame++) {
+        adec_gcc_phat_process_frame(&gcc_state, &output, y, x, 0);
+    }
+    //No cross spectra averaged without far end activity
+    TEST_ASSERT_EQUAL_INT32(0, gcc_state.num_blocks);
+    TEST_ASSERT_EQUAL_INT32(0, output.valid);
+}
+
+void test_gcc_phat_adec_correction() {
+    adec_state_t adec_state;
+    adec_config_t adec_conf;
+    adec_conf.bypass = 0;
+    adec_conf.force_de_cycle_trigger = 0;
+    adec_conf.use_refined_delay = 0;
+    adec_conf.use_gcc_phat = 1;
+    adec_init(&adec_state, &adec_conf);
+
+    adec_input_t adec_in;
+    adec_output_t adec_output;
+    memset(&adec_in, 0, sizeof(adec_in));
+    adec_in.far_end_active_flag = 1;
+    adec_in.from_gcc_phat.valid = 1;
+    adec_in.from_gcc_phat.peak_to_average_ratio = f32_to_float_s32(2 * ADEC_GCC_PHAT_GOOD_PEAK_TO_AVERAGE);
+
+    //Echo 1000 samples late, so the mic is advanced to leave ADEC_DE_DELAY_HEADROOM_SAMPS of it
+    adec_in.from_gcc_phat.delay_samples = 1000;
+    adec_process_frame(&adec_state, &adec_output, &adec_in);
+    TEST_ASSERT_EQUAL_INT32(1, adec_output.delay_change_request_flag);
+    TEST_ASSERT_EQUAL_INT32(1, adec_output.reset_aec_flag);
+    TEST_ASSERT_EQUAL_INT32(0, adec_output.delay_estimator_enabled_flag);
+    TEST_ASSERT_EQUAL_INT32(-(1000 - 240), adec_output.requested_mic_delay_samples);
+
+    //Estimate is now relative to the new mic delay. Close to the headroom, so nothing to correct
+    adec_in.from_gcc_phat.delay_samples = 250;
+    adec_process_frame(&adec_state, &adec_output, &adec_in);
+    TEST_ASSERT_EQUAL_INT32(0, adec_output.delay_change_request_flag);
+
+    //Echo path got 500 samples shorter
+    adec_in.from_gcc_phat.delay_samples = 240 - 500;
+    adec_process_frame(&adec_state, &adec_output, &adec_in);
+    TEST_ASSERT_EQUAL_INT32(1, adec_output.delay_change_request_flag);
+    TEST_ASSERT_EQUAL_INT32(-(500 - 240), adec_output.requested_mic_delay_samples);
+
+    //Not confident, so no correction
+    adec_in.from_gcc_phat.delay_samples = 2000;
+    adec_in.from_gcc_phat.peak_to_average_ratio = f32_to_float_s32(ADEC_GCC_PHAT_GOOD_PEAK_TO_AVERAGE / 2);
+    adec_process_frame(&adec_state, &adec_output, &adec_in);
+    TEST_ASSERT_EQUAL_INT32(0, adec_output.delay_change_request_flag);
+
+    //GCC-PHAT not enabled, so from_gcc_phat is ignored
+    adec_conf.use_gcc_phat = 0;
+    adec_init(&adec_state, &adec_conf);
+    adec_in.from_gcc_phat.peak_to_average_ratio = f32_to_float_s32(2 * ADEC_GCC_PHAT_GOOD_PEAK_TO_AVERAGE);
+    adec_process_frame(&adec_state, &adec_output, &adec_in);
+    TEST_ASSERT_EQUAL_INT32(0, adec_output.delay_change_request_flag);
+}
@@ -50,7 +50,7 @@ void pipeline_init(pipeline_state_t *state, aec_conf_t *de_conf, aec_conf_t *non
     state->ref_active_threshold =  f64_to_float_s32(pow(10, -60/20.0));
 
     // Initialise default delay values
-    delay_buffer_init(&state->delay_state, 0/*Initialise with 0 delay_samples*/);
+    delay_buffer_init(&state->delay_state, state->delay_buffer_memory, MAX_DELAY_BUF_CHANNELS, AP_DELAY_BUF_LENGTH, AP_FRAME_ADVANCE, 0/*Initialise with 0 delay_samples*/);
     
     memcpy(&state->aec_de_mode_conf, de_conf, sizeof(aec_conf_t));
     memcpy(&state->aec_non_de_mode_conf, non_de_conf, sizeof(aec_conf_t));
@@ -68,16 +68,12 @@ static inline void get_delayed_frame(
     int num_channels = (delay_state->delay_samples) > 0 ? AP_MAX_Y_CHANNELS : AP_MAX_X_CHANNELS;
     if (delay_state->delay_samples >= 0) {/** Requested Mic delay +ve => delay mic*/
         for(int ch=0; ch<num_channels; ch++) {
-            for(int i=0; i<AP_FRAME_ADVANCE; i++) {
-                get_delayed_sample(delay_state, &input_y_data[ch][i], ch);
-            }
+            get_delayed_block(delay_state, &input_y_data[ch][0], ch);
         }
     }
     else if (delay_state->delay_samples < 0) {/* Requested Mic delay negative => advance mic which can't be done, so delay reference*/
         for(int ch=0; ch<num_channels; ch++) {
-            for(int i=0; i<AP_FRAME_ADVANCE; i++) {
-                get_delayed_sample(delay_state, &input_x_data[ch][i], ch);
-            }
+            get_delayed_block(delay_state, &input_x_data[ch][0], ch);
         }
     }
     return;
@@ -14,6 +14,7 @@
 
 #define MAX_DELAY_MS                ( 150 )
 #define MAX_DELAY_SAMPLES           ( 16000*MAX_DELAY_MS/1000 )
+#define AP_DELAY_BUF_LENGTH         DELAY_BUF_LENGTH(MAX_DELAY_SAMPLES, AP_FRAME_ADVANCE)
 
 #ifndef INITIAL_DELAY_ESTIMATION
 #define INITIAL_DELAY_ESTIMATION (0)
@@ -39,6 +40,7 @@ typedef struct {
  
     // Delay Buffer
     delay_buf_state_t delay_state;
+    int32_t delay_buffer_memory[MAX_DELAY_BUF_CHANNELS * AP_DELAY_BUF_LENGTH];
 
     //Top level
     aec_conf_t aec_de_mode_conf;
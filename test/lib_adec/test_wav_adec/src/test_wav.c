@@ -25,13 +25,15 @@ typedef enum {
     ADAPTION_MODE,
     FORCE_ADAPTION_MU,
     STOP_ADAPTING,
+    PARTIAL_UPDATE_PHASES,
+    PARTIAL_UPDATE_MODE,
     NUM_RUNTIME_ARGS
 }runtime_args_indexes_t;
 
 int runtime_args[NUM_RUNTIME_ARGS];
 //valid_tokens_str entries and runtime_args_indexes_t need to maintain the same order so that when a runtime argument token string matches index 'i' string in valid_tokens_str, the corresponding
 //value can be updated in runtime_args[i]
-const char *valid_tokens_str[] = {"y_channels", "x_channels", "main_filter_phases", "shadow_filter_phases", "adaption_mode", "force_adaption_mu", "stop_adapting"}; //TODO autogenerate from runtime_args_indexes_t
+const char *valid_tokens_str[] = {"y_channels", "x_channels", "main_filter_phases", "shadow_filter_phases", "adaption_mode", "force_adaption_mu", "stop_adapting", "partial_update_phases", "partial_update_mode"}; //TODO autogenerate from runtime_args_indexes_t
 
 #define MAX_ARGS_BUF_SIZE (1024)
 void parse_runtime_args(int *runtime_args_arr) {
@@ -85,6 +87,8 @@ void pipeline_wrapper(const char *input_file_name, const char* output_file_name)
     runtime_args[ADAPTION_MODE] = AEC_ADAPTION_AUTO;
     runtime_args[FORCE_ADAPTION_MU] = Q1_30(1.0);
     runtime_args[STOP_ADAPTING] = -1;
+    runtime_args[PARTIAL_UPDATE_PHASES] = 0;
+    runtime_args[PARTIAL_UPDATE_MODE] = AEC_PARTIAL_UPDATE_ROUND_ROBIN;
 
     parse_runtime_args(runtime_args);
     printf("runtime args = ");
@@ -177,6 +181,8 @@ void pipeline_wrapper(const char *input_file_name, const char* output_file_name)
     adec_config_t adec_conf;
     adec_conf.bypass = 0;
     adec_conf.force_de_cycle_trigger = 0; 
+    adec_conf.use_refined_delay = 0;
+    adec_conf.use_gcc_phat = 0;
 #if BYPASS_ADEC
     // All AEC module tests are run in this mode only
     adec_conf.bypass = 1;
@@ -196,6 +202,8 @@ void pipeline_wrapper(const char *input_file_name, const char* output_file_name)
 
     pipeline_state.aec_main_state.shared_state->config_params.coh_mu_conf.adaption_config = runtime_args[ADAPTION_MODE];
     pipeline_state.aec_main_state.shared_state->config_params.coh_mu_conf.force_adaption_mu_q30 = runtime_args[FORCE_ADAPTION_MU];
+    pipeline_state.aec_main_state.shared_state->config_params.aec_core_conf.partial_update_phases = runtime_args[PARTIAL_UPDATE_PHASES];
+    pipeline_state.aec_main_state.shared_state->config_params.aec_core_conf.partial_update_mode = runtime_args[PARTIAL_UPDATE_MODE];
 
     for(unsigned b=0;b<block_count;b++){
         long input_location =  wav_get_frame_start(&input_header_struct, b * AEC_FRAME_ADVANCE, input_header_size);
@@ -0,0 +1,40 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_test_pair.h"
+#include "aec_config.h"
+#include "aec_memory_pool.h"
+#include "pseudo_rand.h"
+
+static uint64_t ref_arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+static uint64_t dut_arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+
+int32_t aec_test_pair_init(aec_test_instance_t *ref, aec_test_instance_t *dut, unsigned num_y_channels,
+        unsigned num_x_channels, unsigned num_main_filter_phases, unsigned num_shadow_filter_phases)
+{
+    uint32_t size = aec_get_required_memory(num_y_channels, num_x_channels, num_main_filter_phases, num_shadow_filter_phases);
+    if(size > sizeof(ref_arena)) {
+        return -1;
+    }
+    ref->X_energy_recalc_bin = 0;
+    dut->X_energy_recalc_bin = 0;
+    if(aec_init_from_arena(&ref->main_state, &ref->shadow_state, &ref->shared_state, (uint8_t*)ref_arena, size,
+                num_y_channels, num_x_channels, num_main_filter_phases, num_shadow_filter_phases) != 0) {
+        return -1;
+    }
+    return aec_init_from_arena(&dut->main_state, &dut->shadow_state, &dut->shared_state, (uint8_t*)dut_arena, size,
+                num_y_channels, num_x_channels, num_main_filter_phases, num_shadow_filter_phases);
+}
+
+void aec_test_echo_frame(int32_t (*y_data)[AEC_FRAME_ADVANCE], int32_t (*x_data)[AEC_FRAME_ADVANCE],
+        unsigned num_y_channels, unsigned num_x_channels, unsigned *seed)
+{
+    for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+        for(int ch=0; ch<num_x_channels; ch++) {
+            x_data[ch][i] = pseudo_rand_int32(seed) >> 3;
+        }
+        for(int ch=0; ch<num_y_channels; ch++) {
+            //Some echo of the reference so that the filters adapt
+            y_data[ch][i] = (x_data[0][i] >> (ch + 2)) + (x_data[num_x_channels - 1][i] >> 3) + (pseudo_rand_int32(seed) >> 10);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef AEC_TEST_PAIR_H
+#define AEC_TEST_PAIR_H
+
+#include <stdint.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+
+/* An AEC instance for the tests that compare a way of processing a frame against aec_process_frame_1thread_r(). */
+typedef struct {
+    aec_state_t DWORD_ALIGNED main_state;
+    aec_state_t DWORD_ALIGNED shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    unsigned X_energy_recalc_bin;
+} aec_test_instance_t;
+
+// Initialise a reference and a DUT instance with the same configuration, each from its own arena. Returns 0 on success
+int32_t aec_test_pair_init(aec_test_instance_t *ref, aec_test_instance_t *dut, unsigned num_y_channels,
+        unsigned num_x_channels, unsigned num_main_filter_phases, unsigned num_shadow_filter_phases);
+
+// Generate a frame of white noise reference on each x channel and mic input with some echo of the references, so that
+// the filters adapt, and a little near end noise
+void aec_test_echo_frame(int32_t (*y_data)[AEC_FRAME_ADVANCE], int32_t (*x_data)[AEC_FRAME_ADVANCE],
+        unsigned num_y_channels, unsigned num_x_channels, unsigned *seed);
+
+#endif
@@ -0,0 +1,56 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <string.h>
+#include <assert.h>
+#include "echo_sim.h"
+#include "pseudo_rand.h"
+
+void echo_sim_init(echo_sim_t *sim, double *history, unsigned history_length, const double *h, unsigned num_taps, unsigned delay)
+{
+    sim->history = history;
+    sim->history_length = history_length;
+    sim->h = h;
+    sim->num_taps = num_taps;
+    sim->delay = delay;
+    echo_sim_clear(sim);
+}
+
+void echo_sim_clear(echo_sim_t *sim)
+{
+    memset(sim->history, 0, sim->history_length * sizeof(double));
+    sim->newest = 0;
+}
+
+double echo_sim_push(echo_sim_t *sim, double x)
+{
+    assert((sim->delay + sim->num_taps) <= sim->history_length);
+    sim->newest = (sim->newest + 1 == sim->history_length) ? 0 : sim->newest + 1;
+    sim->history[sim->newest] = x;
+
+    // Walk back through the history from the first tap, wrapping round at the start of the buffer
+    unsigned i = (sim->newest >= sim->delay) ? (sim->newest - sim->delay) : (sim->newest + sim->history_length - sim->delay);
+    double echo = 0;
+    for(unsigned k=0; k<sim->num_taps; k++) {
+        if(sim->h[k] != 0) {
+            echo += sim->h[k] * sim->history[i];
+        }
+        i = (i == 0) ? (sim->history_length - 1) : (i - 1);
+    }
+    return echo;
+}
+
+double echo_sim_reference(const echo_sim_t *sim, unsigned delay)
+{
+    assert(delay < sim->history_length);
+    unsigned i = (sim->newest >= delay) ? (sim->newest - delay) : (sim->newest + sim->history_length - delay);
+    return sim->history[i];
+}
+
+void echo_sim_frame(echo_sim_t *sim, int32_t *y, int32_t *x, unsigned frame_length, unsigned *seed, int near_end_shr)
+{
+    for(unsigned i=0; i<frame_length; i++) {
+        x[i] = pseudo_rand_int32(seed) >> 3;
+        double echo = echo_sim_push(sim, x[i]);
+        y[i] = (int32_t)echo + (pseudo_rand_int32(seed) >> near_end_shr);
+    }
+}
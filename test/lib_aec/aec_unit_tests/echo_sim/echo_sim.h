@@ -0,0 +1,38 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#ifndef ECHO_SIM_H
+#define ECHO_SIM_H
+
+#include <stdint.h>
+
+/* Floating point echo path simulation for the AEC tests that run the AEC on an echo. The reference history is kept in
+ * a circular buffer supplied by the test, which has to be at least delay + num_taps samples long.
+ */
+typedef struct {
+    double *history;
+    unsigned history_length;
+    unsigned newest;
+    const double *h;
+    unsigned num_taps;
+    /** Samples the echo path starts after. Can be changed between samples.*/
+    unsigned delay;
+} echo_sim_t;
+
+// Set up an echo path of num_taps taps h starting delay samples after the reference, with an empty reference history
+void echo_sim_init(echo_sim_t *sim, double *history, unsigned history_length, const double *h, unsigned num_taps, unsigned delay);
+
+// Clear the reference history
+void echo_sim_clear(echo_sim_t *sim);
+
+// Add a reference sample and return the echo of the reference history at that sample. Taps that are 0 are skipped so
+// sparse echo paths are cheap.
+double echo_sim_push(echo_sim_t *sim, double x);
+
+// Reference sample from delay samples before the newest one
+double echo_sim_reference(const echo_sim_t *sim, unsigned delay);
+
+// Generate a frame of white noise reference x and the mic input y it gives through the echo path, with white noise
+// near end shifted right by near_end_shr added
+void echo_sim_frame(echo_sim_t *sim, int32_t *y, int32_t *x, unsigned frame_length, unsigned *seed, int near_end_shr);
+
+#endif
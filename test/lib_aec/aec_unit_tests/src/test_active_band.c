@@ -0,0 +1,168 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "echo_sim.h"
+#include "aec_process_frame_1thread.h"
+
+#define MAIN_PHASES (10)
+#define SHADOW_PHASES (5)
+#define NUM_BINS (AEC_FD_FRAME_LENGTH)
+#define BAND_START (0)
+#define BAND_LENGTH (193) //0 - 12kHz
+#define LPF_TAPS (127)
+#define ECHO_TAPS (400)
+
+static uint64_t aec_arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+
+static void set_active_band(aec_shared_state_t *shared_state, unsigned start, unsigned length) {
+    shared_state->config_params.aec_core_conf.active_band_start = start;
+    shared_state->config_params.aec_core_conf.active_band_length = length;
+}
+
+static void bfp_to_double(complex_double_t *out, const bfp_complex_s32_t *in) {
+    for(int i=0; i<in->length; i++) {
+        out[i].re = ldexp(in->data[i].re, in->exp);
+        out[i].im = ldexp(in->data[i].im, in->exp);
+    }
+}
+
+//In the active band Error and Y_hat should match the full band calculation. Outside of it Y_hat is 0 and Error is Y.
+void test_active_band_Error_and_Y_hat() {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+
+    unsigned seed = 5113;
+    for(int iter=0; iter<(1<<8)/F; iter++) {
+        int32_t new_frame[AEC_MAX_Y_CHANNELS+AEC_MAX_X_CHANNELS][AEC_FRAME_ADVANCE];
+        unsigned start = pseudo_rand_uint32(&seed) % NUM_BINS;
+        unsigned length = (pseudo_rand_uint32(&seed) % (NUM_BINS - start)) + 1;
+        set_active_band(&shared_state, 0, NUM_BINS);
+        aec_frame_init(&main_state, &shadow_state, &new_frame[0], &new_frame[AEC_MAX_Y_CHANNELS]);
+        bfp_complex_s32_init(&shared_state.Y[0], (complex_s32_t*)&shared_state.y[0].data[0], 0, NUM_BINS, 0);
+
+        for(int ph=0; ph<MAIN_PHASES; ph++) {
+            main_state.H_hat[0][ph].exp = pseudo_rand_int(&seed, -31, 32);
+            shared_state.X_fifo[0][ph].exp = pseudo_rand_int(&seed, -31, 32);
+            for(int i=0; i<NUM_BINS; i++) {
+                main_state.H_hat[0][ph].data[i].re = pseudo_rand_int32(&seed) >> 1;
+                main_state.H_hat[0][ph].data[i].im = pseudo_rand_int32(&seed) >> 1;
+                shared_state.X_fifo[0][ph].data[i].re = pseudo_rand_int32(&seed) >> 1;
+                shared_state.X_fifo[0][ph].data[i].im = pseudo_rand_int32(&seed) >> 1;
+            }
+            main_state.H_hat[0][ph].hr = 1;
+            shared_state.X_fifo[0][ph].hr = 1;
+        }
+        shared_state.Y[0].exp = pseudo_rand_int(&seed, -31, 32);
+        for(int i=0; i<NUM_BINS; i++) {
+            shared_state.Y[0].data[i].re = pseudo_rand_int32(&seed) >> 1;
+            shared_state.Y[0].data[i].im = pseudo_rand_int32(&seed) >> 1;
+        }
+        shared_state.Y[0].hr = 1;
+
+        complex_double_t Y_fp[NUM_BINS], Error_full[NUM_BINS], Y_hat_full[NUM_BINS], Error_band[NUM_BINS], Y_hat_band[NUM_BINS];
+        complex_s32_t Y_copy[NUM_BINS];
+        int Y_exp = shared_state.Y[0].exp;
+        memcpy(Y_copy, shared_state.Y[0].data, sizeof(Y_copy));
+        bfp_to_double(Y_fp, &shared_state.Y[0]);
+        aec_calc_Error_and_Y_hat(&main_state, 0);
+        bfp_to_double(Error_full, &main_state.Error[0]);
+        bfp_to_double(Y_hat_full, &main_state.Y_hat[0]);
+
+        set_active_band(&shared_state, start, length);
+        aec_frame_init(&main_state, &shadow_state, &new_frame[0], &new_frame[AEC_MAX_Y_CHANNELS]);
+        //aec_frame_init() overwrites Y so restore it
+        bfp_complex_s32_init(&shared_state.Y[0], (complex_s32_t*)&shared_state.y[0].data[0], Y_exp, NUM_BINS, 0);
+        memcpy(shared_state.Y[0].data, Y_copy, sizeof(Y_copy));
+        shared_state.Y[0].hr = 1;
+        aec_calc_Error_and_Y_hat(&main_state, 0);
+        bfp_to_double(Error_band, &main_state.Error[0]);
+        bfp_to_double(Y_hat_band, &main_state.Y_hat[0]);
+
+        //Tolerance relative to the largest full band value since the band results may have a different exponent
+        double max_Error = 0, max_Y_hat = 0;
+        for(int i=0; i<NUM_BINS; i++) {
+            max_Error = fmax(max_Error, fmax(fabs(Error_full[i].re), fabs(Error_full[i].im)));
+            max_Y_hat = fmax(max_Y_hat, fmax(fabs(Y_hat_full[i].re), fabs(Y_hat_full[i].im)));
+        }
+        for(int i=0; i<NUM_BINS; i++) {
+            if((i >= start) && (i < start + length)) {
+                TEST_ASSERT_LESS_OR_EQUAL_UINT32(8, (uint32_t)ldexp(fabs(Error_band[i].re - Error_full[i].re) / max_Error, 30));
+                TEST_ASSERT_LESS_OR_EQUAL_UINT32(8, (uint32_t)ldexp(fabs(Error_band[i].im - Error_full[i].im) / max_Error, 30));
+                TEST_ASSERT_LESS_OR_EQUAL_UINT32(8, (uint32_t)ldexp(fabs(Y_hat_band[i].re - Y_hat_full[i].re) / max_Y_hat, 30));
+                TEST_ASSERT_LESS_OR_EQUAL_UINT32(8, (uint32_t)ldexp(fabs(Y_hat_band[i].im - Y_hat_full[i].im) / max_Y_hat, 30));
+            }
+            else {
+                TEST_ASSERT_EQUAL_INT32(0, main_state.Y_hat[0].data[i].re);
+                TEST_ASSERT_EQUAL_INT32(0, main_state.Y_hat[0].data[i].im);
+                //Y is only shifted to align exponents with the in-band Error, so allow for the dropped LSBs
+                TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, (uint32_t)ldexp(fabs(Error_band[i].re - Y_fp[i].re), -main_state.Error[0].exp));
+                TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, (uint32_t)ldexp(fabs(Error_band[i].im - Y_fp[i].im), -main_state.Error[0].exp));
+            }
+        }
+    }
+}
+
+static double run_band_limited_echo(unsigned band_start, unsigned band_length) {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    set_active_band(&shared_state, band_start, band_length);
+
+    //Blackman windowed sinc lowpass with a 10kHz cutoff so the reference has no energy above 12kHz
+    static double lpf[LPF_TAPS];
+    for(int k=0; k<LPF_TAPS; k++) {
+        double n = k - (LPF_TAPS - 1) / 2.0;
+        double fc = 10000.0 / 16000;
+        double sinc = (n == 0) ? fc : sin(M_PI * fc * n) / (M_PI * n);
+        double w = 0.42 - 0.5 * cos(2 * M_PI * k / (LPF_TAPS - 1)) + 0.08 * cos(4 * M_PI * k / (LPF_TAPS - 1));
+        lpf[k] = sinc * w;
+    }
+    unsigned seed = 9087;
+    static double h[ECHO_TAPS];
+    for(int k=0; k<ECHO_TAPS; k++) {
+        h[k] = ldexp(pseudo_rand_int32(&seed), -31) * 0.05 * exp(-k / 80.0);
+    }
+
+    //The lowpass filter is simulated as an echo path too
+    static double noise_history[LPF_TAPS], x_history[ECHO_TAPS];
+    echo_sim_t lpf_sim, sim;
+    echo_sim_init(&lpf_sim, noise_history, LPF_TAPS, lpf, LPF_TAPS, 0);
+    echo_sim_init(&sim, x_history, ECHO_TAPS, h, ECHO_TAPS, 0);
+    unsigned recalc_bin = 0;
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[1][AEC_FRAME_ADVANCE];
+    double y_energy = 0, output_energy = 0;
+    int measure_frames = 100 / F;
+    int num_frames = (200 / F) + measure_frames;
+    for(int frame=0; frame<num_frames; frame++) {
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            x_data[0][i] = (int32_t)echo_sim_push(&lpf_sim, pseudo_rand_int32(&seed) >> 3);
+            double echo = echo_sim_push(&sim, x_data[0][i]);
+            y_data[0][i] = (int32_t)echo + (pseudo_rand_int32(&seed) >> 18);
+        }
+        aec_process_frame_1thread_r(&main_state, &shadow_state, &recalc_bin, output, NULL, y_data, x_data);
+        if(frame >= (num_frames - measure_frames)) {
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                y_energy += (double)y_data[0][i] * y_data[0][i];
+                output_energy += (double)output[0][i] * output[0][i];
+            }
+        }
+    }
+    return 10 * log10(y_energy / output_energy);
+}
+
+//A reference with no energy above the active band should be cancelled about as well as with the full band
+void test_active_band_erle() {
+    double erle_full = run_band_limited_echo(0, NUM_BINS);
+    double erle_band = run_band_limited_echo(BAND_START, BAND_LENGTH);
+    printf("ERLE full band %.1f dB, active band %.1f dB\n", erle_full, erle_band);
+    TEST_ASSERT_GREATER_THAN_INT32((int32_t)(erle_full - 3), (int32_t)erle_band);
+}
@@ -142,9 +142,6 @@ void test_calc_Error_and_Y_hat() {
                 }
             }
         }
-        //aec init only initialises the 2d Xfifo. Since we're using the 1d fifo for error computation, call aec_update_X_fifo_1d()
-        //to update the 1d Fifo
-        aec_update_X_fifo_1d(state_ptr);
         //Generate Y
         for(int ch=0; ch<num_y_channels; ch++) {
             state_ptr->shared_state->Y[ch].exp = pseudo_rand_int(&seed, -31, 32);
@@ -177,6 +174,11 @@ void test_calc_Error_and_Y_hat() {
                 mapping[i] = -1;
             }
             bfp_complex_s32_t Error_par[TEST_NUM_Y*NUM_CHUNKS_PER_Y], Y_hat_par[TEST_NUM_Y*NUM_CHUNKS_PER_Y];
+            //X_fifo head is 0 since no frames have been added to the circular fifo
+            const bfp_complex_s32_t *X_fifo[AEC_MAX_X_CHANNELS];
+            for(int ch=0; ch<num_x_channels; ch++) {
+                X_fifo[ch] = &state_ptr->shared_state->X_fifo[ch][state_ptr->shared_state->X_fifo_head[ch]];
+            }
             for(unsigned t=0; t<TEST_NUM_Y; t++) {
                 int remaining_length = NUM_BINS;
                 int start = 0;
@@ -205,7 +207,7 @@ void test_calc_Error_and_Y_hat() {
                     bfp_complex_s32_init(&Y_hat_par[index], &state_ptr->Y_hat[ch].data[start_offset], state_ptr->Y_hat[ch].exp, length, 0);
                     Y_hat_par[index].hr = state_ptr->Y_hat[ch].hr;
 
-                    aec_l2_calc_Error_and_Y_hat(&Error_par[index], &Y_hat_par[index], &state_ptr->shared_state->Y[ch], state_ptr->X_fifo_1d, state_ptr->H_hat[ch], num_x_channels, state_ptr->num_phases, start_offset, length, state_ptr->shared_state->config_params.aec_core_conf.bypass);
+                    aec_l2_calc_Error_and_Y_hat(&Error_par[index], &Y_hat_par[index], &state_ptr->shared_state->Y[ch], X_fifo, state_ptr->H_hat[ch], num_x_channels, state_ptr->num_phases, start_offset, length, state_ptr->shared_state->config_params.aec_core_conf.bypass);
                     //printf("Error: (%d, %d), Y_hat: (%d,%d)\n", Error_par[index].exp, Error_par[index].hr, Y_hat_par[index].exp, Y_hat_par[index].hr);
                 }
             }    
@@ -128,7 +128,11 @@ void test_calc_coherence() {
 
         //since state.shared_state->y is being initialised with a new frame after calling aec_frame_init(), we need to update state->shared_state->prev_y again since that's where y[240:480] is read from in aec_calc_coherence()
         for(int ch=0; ch<num_y_channels; ch++) {
-            memcpy(state.shared_state->prev_y[ch].data, &state.shared_state->y[ch].data[AEC_FRAME_ADVANCE], (AEC_PROC_FRAME_LENGTH-AEC_FRAME_ADVANCE)*sizeof(int32_t));
+            //prev_y is a ring buffer with the oldest sample at prev_frame_head
+            unsigned head = state.shared_state->prev_frame_head;
+            for(int i=0; i<AEC_PROC_FRAME_LENGTH-AEC_FRAME_ADVANCE; i++) {
+                state.shared_state->prev_y[ch].data[(head + i) % (AEC_PROC_FRAME_LENGTH-AEC_FRAME_ADVANCE)] = state.shared_state->y[ch].data[AEC_FRAME_ADVANCE + i];
+            }
             state.shared_state->prev_y[ch].exp = state.shared_state->y[ch].exp;
             state.shared_state->prev_y[ch].hr = state.shared_state->y[ch].hr;
         }
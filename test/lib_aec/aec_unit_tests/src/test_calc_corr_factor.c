@@ -68,9 +68,16 @@ void test_calc_corr_factor() {
             }
         }
 
-        //since state.shared_state->y is being initialised with a new frame after calling aec_frame_init(), we need to update state->shared_state->prev_y again since that's where y[240:480] is read from in aec_calc_coherence()
+        //aec_calc_corr_factor() reads y[240:480] from the prev_y ring buffer, where aec_frame_init() leaves the last
+        //(AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE) samples of y with the oldest at prev_frame_head. Since y is set up
+        //directly here, fill the ring the same way, starting from a random head so that the wrap around is covered
+        const unsigned prev_len = AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE;
+        unsigned head = pseudo_rand_int(&seed, 0, prev_len);
+        state.shared_state->prev_frame_head = head;
         for(int ch=0; ch<num_y_channels; ch++) {
-            memcpy(state.shared_state->prev_y[ch].data, &state.shared_state->y[ch].data[AEC_FRAME_ADVANCE], (AEC_PROC_FRAME_LENGTH-AEC_FRAME_ADVANCE)*sizeof(int32_t));
+            for(int i=0; i<prev_len; i++) {
+                state.shared_state->prev_y[ch].data[(head + i) % prev_len] = state.shared_state->y[ch].data[AEC_FRAME_ADVANCE + i];
+            }
             state.shared_state->prev_y[ch].exp = state.shared_state->y[ch].exp;
             state.shared_state->prev_y[ch].hr = state.shared_state->y[ch].hr;
         }
@@ -0,0 +1,71 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "echo_sim.h"
+#include "aec_process_frame_1thread.h"
+
+#define MAIN_PHASES (10)
+#define SHADOW_PHASES (5)
+#define ECHO_DELAY (40)
+#define ECHO_TAPS (1200)
+#define HISTORY (ECHO_DELAY + ECHO_TAPS)
+#define FAR_END_FRAMES (300 / F)
+#define FAR_END_MEASURE_FRAMES (50 / F)
+#define DOUBLE_TALK_FRAMES (40)
+#define NEAR_END_FRAMES (20)
+#define SETTLE_FRAMES (5)
+
+static uint64_t aec_arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+
+//Far end only, then near end talking over it, then near end only. After a few frames to settle into each, the state
+//should follow.
+void test_double_talk_state() {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+
+    unsigned seed = 4231;
+    static double h[ECHO_TAPS], x_history[HISTORY];
+    for(int k=0; k<ECHO_TAPS; k++) {
+        h[k] = ldexp(pseudo_rand_int32(&seed), -31) * 0.05 * exp(-k / 200.0);
+    }
+    echo_sim_t sim;
+    echo_sim_init(&sim, x_history, HISTORY, h, ECHO_TAPS, ECHO_DELAY);
+    unsigned recalc_bin = 0;
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[1][AEC_FRAME_ADVANCE];
+    unsigned count[3] = {0, 0, 0};
+    for(int frame=0; frame<FAR_END_FRAMES+DOUBLE_TALK_FRAMES+NEAR_END_FRAMES; frame++) {
+        unsigned far_end = frame < (FAR_END_FRAMES + DOUBLE_TALK_FRAMES);
+        unsigned near_end = frame >= FAR_END_FRAMES;
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            x_data[0][i] = far_end ? (pseudo_rand_int32(&seed) >> 3) : 0;
+            double echo = echo_sim_push(&sim, x_data[0][i]);
+            int32_t near = near_end ? (pseudo_rand_int32(&seed) >> 4) : (pseudo_rand_int32(&seed) >> 16);
+            y_data[0][i] = (int32_t)echo + near;
+        }
+        aec_process_frame_1thread_r(&main_state, &shadow_state, &recalc_bin, output, NULL, y_data, x_data);
+        aec_double_talk_state_e dt_state = aec_get_double_talk_state(&main_state, 0);
+
+        if((frame >= FAR_END_FRAMES - FAR_END_MEASURE_FRAMES) && (frame < FAR_END_FRAMES)) {
+            count[0] += (dt_state == AEC_DT_FAR_END_ONLY);
+        }
+        else if((frame >= FAR_END_FRAMES + SETTLE_FRAMES) && (frame < FAR_END_FRAMES + DOUBLE_TALK_FRAMES)) {
+            count[1] += (dt_state == AEC_DT_DOUBLE_TALK);
+        }
+        else if(frame >= FAR_END_FRAMES + DOUBLE_TALK_FRAMES + SETTLE_FRAMES) {
+            count[2] += (dt_state == AEC_DT_FAR_END_INACTIVE);
+        }
+    }
+    printf("far end only %u/%d, double talk %u/%d, far end inactive %u/%d\n", count[0], FAR_END_MEASURE_FRAMES, count[1],
+            DOUBLE_TALK_FRAMES - SETTLE_FRAMES, count[2], NEAR_END_FRAMES - SETTLE_FRAMES);
+    TEST_ASSERT(count[0] >= (FAR_END_MEASURE_FRAMES * 9) / 10);
+    TEST_ASSERT_EQUAL_UINT32(DOUBLE_TALK_FRAMES - SETTLE_FRAMES, count[1]);
+    TEST_ASSERT_EQUAL_UINT32(NEAR_END_FRAMES - SETTLE_FRAMES, count[2]);
+}
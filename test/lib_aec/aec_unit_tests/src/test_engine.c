@@ -0,0 +1,75 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_engine.h"
+#include "aec_process_frame_1thread.h"
+
+#define NUM_ENGINES (2)
+
+static aec_engine_t engines[NUM_ENGINES];
+
+typedef struct {
+    aec_state_t main_state;
+    aec_state_t shadow_state;
+    aec_shared_state_t shared_state;
+    aec_memory_pool_t main_memory_pool;
+    aec_shadow_filt_memory_pool_t shadow_memory_pool;
+    unsigned X_energy_recalc_bin;
+}ref_instance_t;
+static ref_instance_t ref[NUM_ENGINES];
+
+static int32_t DWORD_ALIGNED y_data[NUM_ENGINES][AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+static int32_t DWORD_ALIGNED x_data[NUM_ENGINES][AEC_MAX_X_CHANNELS][AEC_FRAME_ADVANCE];
+static int32_t DWORD_ALIGNED output_main[NUM_ENGINES][AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+static int32_t DWORD_ALIGNED output_shadow[NUM_ENGINES][AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+static int32_t DWORD_ALIGNED ref_output_main[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+static int32_t DWORD_ALIGNED ref_output_shadow[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+
+//Each instance of a batch should give the same output as its own AEC processed on its own. The instances get different
+//echo paths and the second one has no far end for a while, so that a mix up of their state would show in the output
+void test_engine_batch() {
+    unsigned seed = 3319;
+    for(int e=0; e<NUM_ENGINES; e++) {
+        aec_engine_init(&engines[e], AEC_MAX_Y_CHANNELS, AEC_MAX_X_CHANNELS, AEC_MAIN_FILTER_PHASES, AEC_SHADOW_FILTER_PHASES);
+        aec_init(&ref[e].main_state, &ref[e].shadow_state, &ref[e].shared_state,
+                (uint8_t*)&ref[e].main_memory_pool, (uint8_t*)&ref[e].shadow_memory_pool,
+                AEC_MAX_Y_CHANNELS, AEC_MAX_X_CHANNELS, AEC_MAIN_FILTER_PHASES, AEC_SHADOW_FILTER_PHASES);
+        ref[e].X_energy_recalc_bin = 0;
+    }
+
+    for(int frame=0; frame<64/F; frame++) {
+        for(int e=0; e<NUM_ENGINES; e++) {
+            int far_end_active = (e == 0) || (frame >= 16/F);
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                for(int ch=0; ch<AEC_MAX_X_CHANNELS; ch++) {
+                    x_data[e][ch][i] = far_end_active ? (pseudo_rand_int32(&seed) >> 3) : 0;
+                }
+                for(int ch=0; ch<AEC_MAX_Y_CHANNELS; ch++) {
+                    y_data[e][ch][i] = (x_data[e][0][i] >> (ch + e + 2)) + (x_data[e][1][i] >> (3 + e)) + (pseudo_rand_int32(&seed) >> 10);
+                }
+            }
+        }
+        //Some frames without the shadow filter output
+        int with_shadow = (frame % 4) != 3;
+        aec_engine_process_frame_batch(engines, NUM_ENGINES, output_main, with_shadow ? output_shadow : NULL,
+                (const int32_t (*)[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE])y_data,
+                (const int32_t (*)[AEC_MAX_X_CHANNELS][AEC_FRAME_ADVANCE])x_data);
+
+        for(int e=0; e<NUM_ENGINES; e++) {
+            aec_process_frame_1thread_r(&ref[e].main_state, &ref[e].shadow_state, &ref[e].X_energy_recalc_bin,
+                    ref_output_main, with_shadow ? ref_output_shadow : NULL,
+                    (const int32_t (*)[AEC_FRAME_ADVANCE])y_data[e], (const int32_t (*)[AEC_FRAME_ADVANCE])x_data[e]);
+            for(int ch=0; ch<AEC_MAX_Y_CHANNELS; ch++) {
+                TEST_ASSERT_EQUAL_INT32_ARRAY(ref_output_main[ch], output_main[e][ch], AEC_FRAME_ADVANCE);
+                if(with_shadow) {
+                    TEST_ASSERT_EQUAL_INT32_ARRAY(ref_output_shadow[ch], output_shadow[e][ch], AEC_FRAME_ADVANCE);
+                }
+            }
+            TEST_ASSERT_EQUAL_UINT32(ref[e].X_energy_recalc_bin, engines[e].X_energy_recalc_bin);
+            TEST_ASSERT_EQUAL_UINT32(frame + 1, engines[e].frame_count);
+        }
+    }
+}
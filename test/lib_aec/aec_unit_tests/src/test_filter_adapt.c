@@ -149,10 +149,6 @@ void test_aec_filter_adapt() {
             T_fp[ch][0].im = 0.0;
             T_fp[ch][NUM_BINS-1].im = 0.0;
         }
-        //aec init only initialises the 2d Xfifo. Since we're using the 1d fifo for error computation, call aec_update_X_fifo_1d()
-        //to update the 1d Fifo
-        aec_update_X_fifo_1d(state_ptr);
-
         //ref
         for(int ych=0; ych<num_y_channels; ych++) {
             for(int xch=0; xch<num_x_channels; xch++) {
@@ -186,7 +182,10 @@ void test_aec_filter_adapt() {
                             remaining_phases -= num_phases;
                         }
                         for(int ph=start_phase; ph<start_phase+num_phases; ph++) {
-                            aec_l2_adapt_plus_fft_gc(&state_ptr->H_hat[ch][ph], &state_ptr->X_fifo_1d[ph], &state_ptr->T[ph/state_ptr->num_phases]);
+                            //index into the circular X_fifo of the x channel this phase belongs to
+                            unsigned xch = ph/state_ptr->num_phases;
+                            bfp_complex_s32_t *X_fifo_ptr = &state_ptr->shared_state->X_fifo[xch][state_ptr->shared_state->X_fifo_head[xch]];
+                            aec_l2_adapt_plus_fft_gc(&state_ptr->H_hat[ch][ph], &X_fifo_ptr[ph%state_ptr->num_phases], &state_ptr->T[xch]);
                         }
                         start_phase += num_phases;
                     }
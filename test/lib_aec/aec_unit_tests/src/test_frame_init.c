@@ -0,0 +1,63 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+
+#define PREV_SAMPLES (AEC_PROC_FRAME_LENGTH - AEC_FRAME_ADVANCE)
+
+void test_aec_frame_init() {
+    unsigned num_y_channels = AEC_MAX_Y_CHANNELS;
+    unsigned num_x_channels = AEC_MAX_X_CHANNELS;
+
+    aec_memory_pool_t aec_memory_pool;
+    aec_shadow_filt_memory_pool_t aec_shadow_memory_pool;
+    aec_state_t state, shadow_state;
+    aec_shared_state_t aec_shared_state;
+    aec_init(&state, &shadow_state, &aec_shared_state, (uint8_t*)&aec_memory_pool, (uint8_t*)&aec_shadow_memory_pool,
+            num_y_channels, num_x_channels, AEC_MAIN_FILTER_PHASES, AEC_SHADOW_FILTER_PHASES);
+
+    //Reference sliding window of the last AEC_PROC_FRAME_LENGTH samples
+    int32_t y_ref[AEC_MAX_Y_CHANNELS][AEC_PROC_FRAME_LENGTH];
+    int32_t x_ref[AEC_MAX_X_CHANNELS][AEC_PROC_FRAME_LENGTH];
+    memset(y_ref, 0, sizeof(y_ref));
+    memset(x_ref, 0, sizeof(x_ref));
+
+    int32_t new_y[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+    int32_t new_x[AEC_MAX_X_CHANNELS][AEC_FRAME_ADVANCE];
+    unsigned seed = 8723;
+    //Enough frames for the ring buffer head to wrap around several times
+    for(int frame=0; frame<(64/F); frame++) {
+        for(int ch=0; ch<num_y_channels; ch++) {
+            memmove(&y_ref[ch][0], &y_ref[ch][AEC_FRAME_ADVANCE], PREV_SAMPLES*sizeof(int32_t));
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                new_y[ch][i] = pseudo_rand_int32(&seed) >> (pseudo_rand_uint32(&seed) % 8);
+                y_ref[ch][PREV_SAMPLES + i] = new_y[ch][i];
+            }
+        }
+        for(int ch=0; ch<num_x_channels; ch++) {
+            memmove(&x_ref[ch][0], &x_ref[ch][AEC_FRAME_ADVANCE], PREV_SAMPLES*sizeof(int32_t));
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                new_x[ch][i] = pseudo_rand_int32(&seed) >> (pseudo_rand_uint32(&seed) % 8);
+                x_ref[ch][PREV_SAMPLES + i] = new_x[ch][i];
+            }
+        }
+
+        aec_frame_init(&state, &shadow_state, new_y, new_x);
+
+        for(int ch=0; ch<num_y_channels; ch++) {
+            bfp_s32_t *y = &state.shared_state->y[ch];
+            TEST_ASSERT_EQUAL_INT32(-31, y->exp);
+            TEST_ASSERT_EQUAL_UINT32(vect_s32_headroom(y_ref[ch], AEC_PROC_FRAME_LENGTH), y->hr);
+            TEST_ASSERT_EQUAL_INT32_ARRAY(y_ref[ch], y->data, AEC_PROC_FRAME_LENGTH);
+        }
+        for(int ch=0; ch<num_x_channels; ch++) {
+            bfp_s32_t *x = &state.shared_state->x[ch];
+            TEST_ASSERT_EQUAL_INT32(-31, x->exp);
+            TEST_ASSERT_EQUAL_UINT32(vect_s32_headroom(x_ref[ch], AEC_PROC_FRAME_LENGTH), x->hr);
+            TEST_ASSERT_EQUAL_INT32_ARRAY(x_ref[ch], x->data, AEC_PROC_FRAME_LENGTH);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_process_frame_fused.h"
+#include "aec_process_frame_1thread.h"
+#include "aec_test_pair.h"
+
+#define MAIN_PHASES (10)
+#define SHADOW_PHASES (5)
+
+static void set_config(aec_shared_state_t *shared_state, unsigned config) {
+    aec_core_config_params_t *conf = &shared_state->config_params.aec_core_conf;
+    if(config == 2) {
+        //An odd number of phases per frame, so the threads get different numbers of phases
+        conf->partial_update_phases = 3;
+        conf->partial_update_mode = AEC_PARTIAL_UPDATE_ROUND_ROBIN;
+    }
+    else if(config == 3) {
+        conf->partial_update_phases = 4;
+        conf->partial_update_mode = AEC_PARTIAL_UPDATE_MAX_ENERGY;
+        conf->active_band_start = 0;
+        conf->active_band_length = 129;
+    }
+}
+
+//Output should be the same as processing on one thread, for 1 and 2 y channels, with and without partial update and
+//active band
+void test_fused_bit_exact() {
+    unsigned seed = 5527;
+    for(unsigned config=0; config<4; config++) {
+        unsigned num_y_channels = (config == 1) ? 1 : 2;
+        unsigned num_x_channels = 2;
+        static aec_test_instance_t ref, dut;
+        TEST_ASSERT_EQUAL_INT32(0, aec_test_pair_init(&ref, &dut, num_y_channels, num_x_channels, MAIN_PHASES, SHADOW_PHASES));
+        set_config(&ref.shared_state, config);
+        set_config(&dut.shared_state, config);
+
+        aec_fused_timing_t timing;
+        int32_t DWORD_ALIGNED y_data[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+        int32_t DWORD_ALIGNED x_data[AEC_LIB_MAX_X_CHANNELS][AEC_FRAME_ADVANCE];
+        int32_t DWORD_ALIGNED ref_output[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE], ref_output_shadow[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+        int32_t DWORD_ALIGNED output[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE], output_shadow[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+        for(int frame=0; frame<64/F; frame++) {
+            aec_test_echo_frame(y_data, x_data, num_y_channels, num_x_channels, &seed);
+            aec_process_frame_1thread_r(&ref.main_state, &ref.shadow_state, &ref.X_energy_recalc_bin, ref_output, ref_output_shadow, y_data, x_data);
+            aec_process_frame_fused_r(&dut.main_state, &dut.shadow_state, &dut.X_energy_recalc_bin, output, output_shadow, y_data, x_data, &timing);
+            for(int ch=0; ch<num_y_channels; ch++) {
+                TEST_ASSERT_EQUAL_INT32_ARRAY(ref_output[ch], output[ch], AEC_FRAME_ADVANCE);
+                TEST_ASSERT_EQUAL_INT32_ARRAY(ref_output_shadow[ch], output_shadow[ch], AEC_FRAME_ADVANCE);
+            }
+            TEST_ASSERT_EQUAL_UINT32(ref.X_energy_recalc_bin, dut.X_energy_recalc_bin);
+            //Same number of parallel regions for 1 and 2 y channels
+            TEST_ASSERT_EQUAL_UINT32(3, timing.num_par);
+            //Region time is never less than the time of the busiest thread in it
+            for(int par=0; par<AEC_FUSED_NUM_PAR; par++) {
+                TEST_ASSERT_LESS_OR_EQUAL_UINT32(timing.par_ticks[par], aec_fused_sync_ticks(&timing, par));
+            }
+        }
+    }
+}
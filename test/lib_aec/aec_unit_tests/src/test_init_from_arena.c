@@ -0,0 +1,125 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_process_frame_1thread.h"
+
+#define ROUND_UP_8(x) (((x) + 7) & ~7)
+
+void test_get_required_memory() {
+    //Max config should need exactly the example memory pools
+    uint32_t size = aec_get_required_memory(AEC_MAX_Y_CHANNELS, AEC_MAX_X_CHANNELS, AEC_MAIN_FILTER_PHASES, AEC_SHADOW_FILTER_PHASES);
+    TEST_ASSERT_EQUAL_UINT32(ROUND_UP_8(sizeof(aec_memory_pool_t)) + sizeof(aec_shadow_filt_memory_pool_t), size);
+
+    //Smaller configs need less
+    for(unsigned y=1; y<=AEC_MAX_Y_CHANNELS; y++) {
+        for(unsigned x=1; x<=AEC_MAX_X_CHANNELS; x++) {
+            uint32_t no_shadow_phases = aec_get_required_memory(y, x, AEC_MAIN_FILTER_PHASES, 0);
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(ROUND_UP_8(sizeof(aec_memory_pool_t)) + sizeof(aec_shadow_filt_memory_pool_t), no_shadow_phases);
+            TEST_ASSERT_LESS_THAN_UINT32(aec_get_required_memory(y, x, AEC_MAIN_FILTER_PHASES, 1), no_shadow_phases);
+            TEST_ASSERT_LESS_THAN_UINT32(no_shadow_phases, aec_get_required_memory(y, x, AEC_MAIN_FILTER_PHASES - 1, 0));
+        }
+    }
+}
+
+void test_init_from_arena() {
+    unsigned num_y_channels = AEC_MAX_Y_CHANNELS;
+    unsigned num_x_channels = AEC_MAX_X_CHANNELS;
+    unsigned main_filter_phases = AEC_MAIN_FILTER_PHASES - 1;
+    unsigned shadow_filter_phases = AEC_SHADOW_FILTER_PHASES - 1;
+
+    //Reference, initialised from the example memory pools
+    aec_memory_pool_t aec_memory_pool;
+    aec_shadow_filt_memory_pool_t aec_shadow_memory_pool;
+    aec_state_t DWORD_ALIGNED ref_main_state, ref_shadow_state;
+    aec_shared_state_t DWORD_ALIGNED ref_shared_state;
+    aec_init(&ref_main_state, &ref_shadow_state, &ref_shared_state, (uint8_t*)&aec_memory_pool, (uint8_t*)&aec_shadow_memory_pool,
+            num_y_channels, num_x_channels, main_filter_phases, shadow_filter_phases);
+
+    //DUT, initialised from an arena
+    static uint64_t arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    uint32_t required = aec_get_required_memory(num_y_channels, num_x_channels, main_filter_phases, shadow_filter_phases);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(sizeof(arena), required);
+
+    //Arena too small or unaligned
+    TEST_ASSERT_EQUAL_INT32(-1, aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)arena, required - 1,
+                num_y_channels, num_x_channels, main_filter_phases, shadow_filter_phases));
+    TEST_ASSERT_EQUAL_INT32(-1, aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)arena + 4, required,
+                num_y_channels, num_x_channels, main_filter_phases, shadow_filter_phases));
+
+    TEST_ASSERT_EQUAL_INT32(0, aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)arena, required,
+                num_y_channels, num_x_channels, main_filter_phases, shadow_filter_phases));
+
+    //Output should be identical
+    unsigned seed = 45722;
+    unsigned ref_recalc_bin = 0, recalc_bin = 0;
+    int32_t DWORD_ALIGNED y_data[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED x_data[AEC_MAX_X_CHANNELS][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED ref_output[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+    for(int frame=0; frame<(32/F); frame++) {
+        for(int ch=0; ch<AEC_MAX_Y_CHANNELS; ch++) {
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                y_data[ch][i] = pseudo_rand_int32(&seed) >> 4;
+            }
+        }
+        for(int ch=0; ch<AEC_MAX_X_CHANNELS; ch++) {
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                x_data[ch][i] = pseudo_rand_int32(&seed) >> 4;
+            }
+        }
+        aec_process_frame_1thread_r(&ref_main_state, &ref_shadow_state, &ref_recalc_bin, ref_output, NULL, y_data, x_data);
+        aec_process_frame_1thread_r(&main_state, &shadow_state, &recalc_bin, output, NULL, y_data, x_data);
+        TEST_ASSERT_EQUAL_INT32_ARRAY((int32_t*)ref_output, (int32_t*)output, num_y_channels*AEC_FRAME_ADVANCE);
+    }
+}
+
+#define GUARD_BYTES (256)
+#define GUARD_VALUE (0xA5)
+
+//An arena of exactly aec_get_required_memory() bytes should be enough, both to initialise and to process frames, with a
+//shadow filter, with a shadow state of 0 phases and with no shadow state. aec_process_frame_1thread_r() needs a shadow
+//state, so without one only the initialisation is checked
+void test_init_from_arena_exact_size() {
+    static uint64_t arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t) + GUARD_BYTES) / sizeof(uint64_t) + 1];
+    unsigned seed = 7103;
+    for(unsigned config=0; config<3; config++) {
+        unsigned num_y_channels = AEC_MAX_Y_CHANNELS;
+        unsigned num_x_channels = AEC_MAX_X_CHANNELS;
+        unsigned shadow_filter_phases = (config == 0) ? AEC_SHADOW_FILTER_PHASES : 0;
+        aec_state_t DWORD_ALIGNED main_state, shadow_state;
+        aec_shared_state_t DWORD_ALIGNED shared_state;
+        aec_state_t *shadow_ptr = (config == 2) ? NULL : &shadow_state;
+
+        uint32_t required = aec_get_required_memory(num_y_channels, num_x_channels, AEC_MAIN_FILTER_PHASES, shadow_filter_phases);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(sizeof(arena), required + GUARD_BYTES);
+        uint8_t *mem = (uint8_t*)arena;
+        memset(mem, GUARD_VALUE, required + GUARD_BYTES);
+        TEST_ASSERT_EQUAL_INT32(0, aec_init_from_arena(&main_state, shadow_ptr, &shared_state, mem, required,
+                    num_y_channels, num_x_channels, AEC_MAIN_FILTER_PHASES, shadow_filter_phases));
+
+        unsigned recalc_bin = 0;
+        int32_t DWORD_ALIGNED y_data[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+        int32_t DWORD_ALIGNED x_data[AEC_MAX_X_CHANNELS][AEC_FRAME_ADVANCE];
+        int32_t DWORD_ALIGNED output[AEC_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+        for(int frame=0; (shadow_ptr != NULL) && (frame<(8/F)); frame++) {
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                for(int ch=0; ch<AEC_MAX_X_CHANNELS; ch++) {
+                    x_data[ch][i] = pseudo_rand_int32(&seed) >> 4;
+                }
+                for(int ch=0; ch<AEC_MAX_Y_CHANNELS; ch++) {
+                    y_data[ch][i] = (x_data[0][i] >> 2) + (pseudo_rand_int32(&seed) >> 8);
+                }
+            }
+            aec_process_frame_1thread_r(&main_state, shadow_ptr, &recalc_bin, output, NULL, y_data, x_data);
+        }
+        for(int i=0; i<GUARD_BYTES; i++) {
+            TEST_ASSERT_EQUAL_UINT32(GUARD_VALUE, mem[required + i]);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_scheduler.h"
+#include "aec_process_frame_1thread.h"
+#include "aec_test_pair.h"
+
+#define MAIN_PHASES (10)
+#define SHADOW_PHASES (5)
+
+extern void aec_process_frame_nthreads_r(
+        aec_sched_t *sched,
+        aec_state_t *main_state,
+        aec_state_t *shadow_state,
+        unsigned *X_energy_recalc_bin,
+        int32_t (*output_main)[AEC_FRAME_ADVANCE],
+        int32_t (*output_shadow)[AEC_FRAME_ADVANCE],
+        const int32_t (*y_data)[AEC_FRAME_ADVANCE],
+        const int32_t (*x_data)[AEC_FRAME_ADVANCE]);
+
+void test_sched_init() {
+    aec_sched_t sched;
+    TEST_ASSERT_EQUAL_INT32(-1, aec_sched_init(&sched, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, aec_sched_init(&sched, AEC_SCHED_MAX_THREADS + 1));
+    TEST_ASSERT_EQUAL_INT32(0, aec_sched_init(&sched, AEC_SCHED_MAX_THREADS));
+    aec_sched_deinit(&sched);
+}
+
+//Output should be the same as processing on one thread, for any thread count, channel count and with or without shadow
+//filter. aec_process_frame_1thread_r() needs a shadow filter, so without one the reference is a single thread scheduler
+void test_nthreads_bit_exact() {
+    unsigned seed = 4410;
+    for(unsigned num_threads=1; num_threads<=AEC_SCHED_MAX_THREADS; num_threads++) {
+        for(unsigned config=0; config<3; config++) {
+            unsigned num_y_channels = (config == 1) ? 1 : 2;
+            unsigned num_x_channels = 2;
+            unsigned shadow_phases = (config == 2) ? 0 : SHADOW_PHASES;
+            static aec_test_instance_t ref, dut;
+            TEST_ASSERT_EQUAL_INT32(0, aec_test_pair_init(&ref, &dut, num_y_channels, num_x_channels, MAIN_PHASES, shadow_phases));
+            aec_state_t *ref_shadow_ptr = (shadow_phases != 0) ? &ref.shadow_state : NULL;
+            aec_state_t *shadow_ptr = (shadow_phases != 0) ? &dut.shadow_state : NULL;
+
+            aec_sched_t sched, ref_sched;
+            TEST_ASSERT_EQUAL_INT32(0, aec_sched_init(&sched, num_threads));
+            TEST_ASSERT_EQUAL_INT32(0, aec_sched_init(&ref_sched, 1));
+
+            int32_t DWORD_ALIGNED y_data[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+            int32_t DWORD_ALIGNED x_data[AEC_LIB_MAX_X_CHANNELS][AEC_FRAME_ADVANCE];
+            int32_t DWORD_ALIGNED ref_output[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE], ref_output_shadow[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+            int32_t DWORD_ALIGNED output[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE], output_shadow[AEC_LIB_MAX_Y_CHANNELS][AEC_FRAME_ADVANCE];
+            for(int frame=0; frame<64/F; frame++) {
+                aec_test_echo_frame(y_data, x_data, num_y_channels, num_x_channels, &seed);
+                if(shadow_phases != 0) {
+                    aec_process_frame_1thread_r(&ref.main_state, ref_shadow_ptr, &ref.X_energy_recalc_bin, ref_output, ref_output_shadow, y_data, x_data);
+                }
+                else {
+                    aec_process_frame_nthreads_r(&ref_sched, &ref.main_state, NULL, &ref.X_energy_recalc_bin, ref_output, NULL, y_data, x_data);
+                }
+                aec_process_frame_nthreads_r(&sched, &dut.main_state, shadow_ptr, &dut.X_energy_recalc_bin, output, output_shadow, y_data, x_data);
+                for(int ch=0; ch<num_y_channels; ch++) {
+                    TEST_ASSERT_EQUAL_INT32_ARRAY(ref_output[ch], output[ch], AEC_FRAME_ADVANCE);
+                    if(shadow_phases != 0) {
+                        TEST_ASSERT_EQUAL_INT32_ARRAY(ref_output_shadow[ch], output_shadow[ch], AEC_FRAME_ADVANCE);
+                    }
+                }
+                TEST_ASSERT_EQUAL_UINT32(ref.X_energy_recalc_bin, dut.X_energy_recalc_bin);
+            }
+            unsigned jobs_run = 0;
+            for(unsigned t=0; t<num_threads; t++) {
+                jobs_run += sched.jobs_run[t];
+            }
+            TEST_ASSERT_GREATER_THAN_UINT32(0, jobs_run);
+            aec_sched_deinit(&sched);
+            aec_sched_deinit(&ref_sched);
+        }
+    }
+}
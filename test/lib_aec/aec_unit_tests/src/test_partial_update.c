@@ -0,0 +1,111 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_priv.h"
+#include "echo_sim.h"
+#include "aec_process_frame_1thread.h"
+
+#define MAIN_PHASES (10)
+#define SHADOW_PHASES (5)
+#define ECHO_TAPS (2200)
+#define NUM_BLOCKS (12 / F)
+#define BLOCK_FRAMES (25)
+
+static uint64_t aec_arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+
+void test_select_adapt_phases() {
+    unsigned seed = 7734;
+    for(int iter=0; iter<(1<<10)/F; iter++) {
+        unsigned num_phases = (pseudo_rand_uint32(&seed) % MAIN_PHASES) + 1;
+        unsigned num_adapt = (pseudo_rand_uint32(&seed) % num_phases) + 1;
+        float_s32_t X_fifo_energy[MAIN_PHASES];
+        for(int ph=0; ph<num_phases; ph++) {
+            X_fifo_energy[ph].mant = pseudo_rand_uint32(&seed) >> 1;
+            X_fifo_energy[ph].exp = pseudo_rand_int(&seed, -40, -20);
+        }
+        unsigned phases[MAIN_PHASES];
+
+        //Round robin adapts every phase once in every num_phases frames
+        unsigned count[MAIN_PHASES] = {0};
+        unsigned offset = pseudo_rand_uint32(&seed) % num_phases;
+        for(int frame=0; frame<num_phases; frame++) {
+            aec_priv_select_adapt_phases(phases, X_fifo_energy, num_phases, num_adapt, offset, AEC_PARTIAL_UPDATE_ROUND_ROBIN);
+            for(int i=0; i<num_adapt; i++) {
+                TEST_ASSERT_LESS_THAN_UINT32(num_phases, phases[i]);
+                count[phases[i]]++;
+            }
+            offset = (offset + num_adapt) % num_phases;
+        }
+        for(int ph=0; ph<num_phases; ph++) {
+            TEST_ASSERT_EQUAL_UINT32(num_adapt, count[ph]);
+        }
+
+        //Max energy picks distinct phases, none with less energy than a phase left out
+        aec_priv_select_adapt_phases(phases, X_fifo_energy, num_phases, num_adapt, 0, AEC_PARTIAL_UPDATE_MAX_ENERGY);
+        uint8_t picked[MAIN_PHASES] = {0};
+        for(int i=0; i<num_adapt; i++) {
+            TEST_ASSERT_EQUAL_UINT32(0, picked[phases[i]]);
+            picked[phases[i]] = 1;
+        }
+        for(int i=0; i<num_adapt; i++) {
+            for(int ph=0; ph<num_phases; ph++) {
+                if(!picked[ph]) {
+                    TEST_ASSERT_TRUE(float_s32_gte(X_fifo_energy[phases[i]], X_fifo_energy[ph]));
+                }
+            }
+        }
+    }
+}
+
+static void run_echo(double *erle, unsigned num_adapt, aec_partial_update_e mode) {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    shared_state.config_params.aec_core_conf.partial_update_phases = num_adapt;
+    shared_state.config_params.aec_core_conf.partial_update_mode = mode;
+    shared_state.config_params.coh_mu_conf.adaption_config = AEC_ADAPTION_FORCE_ON;
+
+    unsigned seed = 1290;
+    //Echo path longer than the shadow filter, so the main filter has to converge too
+    static double h[ECHO_TAPS];
+    for(int k=0; k<ECHO_TAPS; k++) {
+        h[k] = ldexp(pseudo_rand_int32(&seed), -31) * 0.05 * exp(-k / 500.0);
+    }
+    static double x_history[ECHO_TAPS];
+    echo_sim_t sim;
+    echo_sim_init(&sim, x_history, ECHO_TAPS, h, ECHO_TAPS, 0);
+    unsigned recalc_bin = 0;
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[1][AEC_FRAME_ADVANCE];
+    double y_energy[NUM_BLOCKS] = {0}, output_energy[NUM_BLOCKS] = {0};
+    for(int frame=0; frame<NUM_BLOCKS*BLOCK_FRAMES; frame++) {
+        echo_sim_frame(&sim, y_data[0], x_data[0], AEC_FRAME_ADVANCE, &seed, 14);
+        aec_process_frame_1thread_r(&main_state, &shadow_state, &recalc_bin, output, NULL, y_data, x_data);
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            y_energy[frame/BLOCK_FRAMES] += (double)y_data[0][i] * y_data[0][i];
+            output_energy[frame/BLOCK_FRAMES] += (double)output[0][i] * output[0][i];
+        }
+    }
+    for(int b=0; b<NUM_BLOCKS; b++) {
+        erle[b] = 10 * log10(y_energy[b] / output_energy[b]);
+    }
+}
+
+//Adapting half the phases every frame should slow down convergence but still converge
+void test_partial_update_convergence() {
+    double erle_full[NUM_BLOCKS], erle_rr[NUM_BLOCKS], erle_max[NUM_BLOCKS];
+    run_echo(erle_full, 0, AEC_PARTIAL_UPDATE_ROUND_ROBIN);
+    run_echo(erle_rr, MAIN_PHASES/2, AEC_PARTIAL_UPDATE_ROUND_ROBIN);
+    run_echo(erle_max, MAIN_PHASES/2, AEC_PARTIAL_UPDATE_MAX_ENERGY);
+    for(int b=0; b<NUM_BLOCKS; b++) {
+        printf("frames %3d-%3d ERLE full %.1f dB, round robin %.1f dB, max energy %.1f dB\n", b*BLOCK_FRAMES, (b+1)*BLOCK_FRAMES - 1, erle_full[b], erle_rr[b], erle_max[b]);
+    }
+    TEST_ASSERT_GREATER_THAN_INT32((int32_t)(erle_full[NUM_BLOCKS-1] - 6), (int32_t)erle_rr[NUM_BLOCKS-1]);
+    TEST_ASSERT_GREATER_THAN_INT32((int32_t)(erle_full[NUM_BLOCKS-1] - 6), (int32_t)erle_max[NUM_BLOCKS-1]);
+}
@@ -0,0 +1,96 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "echo_sim.h"
+#include "aec_process_frame_1thread.h"
+
+#define MAIN_PHASES (5)
+#define SHADOW_PHASES (3)
+#define ECHO_DELAY (100)
+#define ECHO_TAPS (2400)
+#define HISTORY (ECHO_DELAY + ECHO_TAPS)
+#define CONVERGE_FRAMES (200 / F)
+#define MEASURE_FRAMES (50 / F)
+
+static uint64_t aec_arena[2][(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+
+//An echo path longer than the filter leaves a residual echo tail that the suppressor should remove, without changing
+//how the filters adapt
+void test_res_echo_tail() {
+    aec_state_t DWORD_ALIGNED main_state[2], shadow_state[2];
+    aec_shared_state_t DWORD_ALIGNED shared_state[2];
+    static aec_res_state_t DWORD_ALIGNED res_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    for(int i=0; i<2; i++) {
+        aec_init_from_arena(&main_state[i], &shadow_state[i], &shared_state[i], (uint8_t*)aec_arena[i], aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    }
+    aec_res_init(&res_state);
+
+    unsigned seed = 6011;
+    static double h[ECHO_TAPS], x_history[HISTORY];
+    for(int k=0; k<ECHO_TAPS; k++) {
+        h[k] = ldexp(pseudo_rand_int32(&seed), -31) * 0.05 * exp(-k / 500.0);
+    }
+    echo_sim_t sim;
+    echo_sim_init(&sim, x_history, HISTORY, h, ECHO_TAPS, ECHO_DELAY);
+    unsigned recalc_bin[2] = {0, 0};
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[2][1][AEC_FRAME_ADVANCE];
+    double y_energy = 0, output_energy[2] = {0, 0};
+    for(int frame=0; frame<CONVERGE_FRAMES+MEASURE_FRAMES; frame++) {
+        echo_sim_frame(&sim, y_data[0], x_data[0], AEC_FRAME_ADVANCE, &seed, 16);
+        aec_process_frame_1thread_r(&main_state[0], &shadow_state[0], &recalc_bin[0], output[0], NULL, y_data, x_data);
+        aec_process_frame_1thread_res(&main_state[1], &shadow_state[1], &res_state, &recalc_bin[1], output[1], NULL, y_data, x_data);
+
+        //The filters adapt on the unsuppressed error either way
+        TEST_ASSERT_EQUAL_INT32(main_state[0].error_ema_energy[0].mant, main_state[1].error_ema_energy[0].mant);
+        TEST_ASSERT_EQUAL_INT32(main_state[0].error_ema_energy[0].exp, main_state[1].error_ema_energy[0].exp);
+
+        if(frame >= CONVERGE_FRAMES) {
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                y_energy += (double)y_data[0][i] * y_data[0][i];
+                for(int r=0; r<2; r++) {
+                    output_energy[r] += (double)output[r][0][i] * output[r][0][i];
+                }
+            }
+        }
+    }
+    double erle = 10 * log10(y_energy / output_energy[0]);
+    double res_erle = 10 * log10(y_energy / output_energy[1]);
+    printf("ERLE %.1f dB, %.1f dB with residual echo suppression\n", erle, res_erle);
+    TEST_ASSERT(res_erle > erle + 6.0);
+}
+
+//With no echo, the suppressed output should be the AEC output
+void test_res_no_echo() {
+    aec_state_t DWORD_ALIGNED main_state[2], shadow_state[2];
+    aec_shared_state_t DWORD_ALIGNED shared_state[2];
+    static aec_res_state_t DWORD_ALIGNED res_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    for(int i=0; i<2; i++) {
+        aec_init_from_arena(&main_state[i], &shadow_state[i], &shared_state[i], (uint8_t*)aec_arena[i], aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    }
+    aec_res_init(&res_state);
+
+    unsigned seed = 7121;
+    unsigned recalc_bin[2] = {0, 0};
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[2][1][AEC_FRAME_ADVANCE];
+    memset(x_data, 0, sizeof(x_data));
+    for(int frame=0; frame<20; frame++) {
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            y_data[0][i] = pseudo_rand_int32(&seed) >> 4;
+        }
+        aec_process_frame_1thread_r(&main_state[0], &shadow_state[0], &recalc_bin[0], output[0], NULL, y_data, x_data);
+        aec_process_frame_1thread_res(&main_state[1], &shadow_state[1], &res_state, &recalc_bin[1], output[1], NULL, y_data, x_data);
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            TEST_ASSERT_INT32_WITHIN(1 << 8, output[0][0][i], output[1][0][i]);
+        }
+    }
+}
@@ -0,0 +1,188 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_priv.h"
+#include "echo_sim.h"
+#include "aec_process_frame_1thread.h"
+
+#define MAIN_PHASES (10)
+#define SHADOW_PHASES (5)
+#define FILTER_TAPS (MAIN_PHASES * AEC_FRAME_ADVANCE)
+#define ECHO_START (400)
+#define ECHO_TAPS (1500)
+#define REF_DELAY (2 * AEC_FRAME_ADVANCE)
+#define HISTORY (FILTER_TAPS + AEC_FRAME_ADVANCE)
+#define CONVERGE_FRAMES (200 / F)
+#define RECOVER_FRAMES (100 / F)
+
+static uint64_t aec_arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+
+// Time domain taps of every phase of a filter, from AEC_FRAME_ADVANCE taps per phase
+static void filter_to_time_domain(double *taps, const bfp_complex_s32_t *H_hat, unsigned num_phases)
+{
+    for(unsigned ph=0; ph<num_phases; ph++) {
+        complex_s32_t DWORD_ALIGNED data[AEC_FD_FRAME_LENGTH];
+        bfp_complex_s32_t H;
+        memcpy(data, H_hat[ph].data, sizeof(data));
+        bfp_complex_s32_init(&H, data, H_hat[ph].exp, AEC_FD_FRAME_LENGTH, 1);
+        bfp_fft_pack_mono(&H);
+        bfp_s32_t *h = bfp_fft_inverse_mono(&H);
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            taps[ph*AEC_FRAME_ADVANCE + i] = ldexp(h->data[i], h->exp);
+        }
+    }
+}
+
+//Shifted filter taps should match the original taps moved by the shift, for shifts by any number of samples in either
+//direction
+void test_shift_filter_taps() {
+    uint8_t DWORD_ALIGNED aec_memory_pool[sizeof(aec_memory_pool_t)];
+    aec_state_t DWORD_ALIGNED state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    unsigned seed = 5120;
+    static double before[FILTER_TAPS], after[FILTER_TAPS];
+    for(int iter=0; iter<64/F; iter++) {
+        aec_init(&state, NULL, &shared_state, aec_memory_pool, NULL, 1, 1, MAIN_PHASES, 0);
+        for(unsigned ph=0; ph<MAIN_PHASES; ph++) {
+            //Random taps, in phases with different exponents. Every 4th phase is left reset
+            bfp_complex_s32_t *H = &state.H_hat[0][ph];
+            if((ph % 4) == 3) {
+                H->exp = AEC_ZEROVAL_EXP;
+                H->hr = AEC_ZEROVAL_HR;
+                continue;
+            }
+            int32_t *h = (int32_t*)H->data;
+            memset(h, 0, AEC_PROC_FRAME_LENGTH*sizeof(int32_t));
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                h[i] = pseudo_rand_int32(&seed) >> 2;
+            }
+            bfp_s32_t h_bfp;
+            bfp_s32_init(&h_bfp, h, pseudo_rand_int(&seed, -40, -30), AEC_PROC_FRAME_LENGTH, 1);
+            bfp_complex_s32_t *H_out = bfp_fft_forward_mono(&h_bfp);
+            bfp_fft_unpack_mono(H_out);
+            H->exp = H_out->exp;
+            H->hr = H_out->hr;
+        }
+        filter_to_time_domain(before, state.H_hat[0], MAIN_PHASES);
+        double max = 0;
+        for(int i=0; i<FILTER_TAPS; i++) {
+            max = (fabs(before[i]) > max) ? fabs(before[i]) : max;
+        }
+
+        int32_t delta = pseudo_rand_int(&seed, -FILTER_TAPS, FILTER_TAPS);
+        aec_shift_filter_samples(&state, NULL, delta);
+        filter_to_time_domain(after, state.H_hat[0], MAIN_PHASES);
+        for(int i=0; i<FILTER_TAPS; i++) {
+            double expected = ((i - delta >= 0) && (i - delta < FILTER_TAPS)) ? before[i - delta] : 0.0;
+            TEST_ASSERT(fabs(after[i] - expected) <= (max * ldexp(1, -20)));
+        }
+    }
+}
+
+typedef enum {
+    RESET_AEC,
+    SHIFT_AEC_SAMPLES,
+    SHIFT_AEC_PHASES_MIC,
+    SHIFT_AEC_PHASES_REF,
+} delay_change_action_t;
+
+// Converge on an echo with the mic delayed by ECHO_START samples relative to the reference, change that delay by delta
+// samples and return the number of frames until the ERLE is back to within 6dB of what it was before the change. The
+// change is made by delaying the mic, or for SHIFT_AEC_PHASES_REF by delaying the reference, by REF_DELAY samples to start
+// with. The AEC is reset or has its filters shifted to follow the change, depending on action.
+static int frames_to_recover(int32_t delta, delay_change_action_t action)
+{
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    shared_state.config_params.coh_mu_conf.adaption_config = AEC_ADAPTION_FORCE_ON;
+
+    unsigned seed = 3301;
+    static double h[ECHO_TAPS];
+    for(int k=0; k<ECHO_TAPS; k++) {
+        h[k] = ldexp(pseudo_rand_int32(&seed), -31) * 0.05 * exp(-k / 300.0);
+    }
+    static double x_history[HISTORY];
+    echo_sim_t sim;
+    echo_sim_init(&sim, x_history, HISTORY, h, ECHO_TAPS, 0);
+    unsigned recalc_bin = 0;
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[1][AEC_FRAME_ADVANCE];
+    double converged_erle = 0;
+    int32_t ref_delay = (action == SHIFT_AEC_PHASES_REF) ? REF_DELAY : 0;
+    int32_t mic_delay = ECHO_START + ref_delay;
+    for(int frame=0; frame<CONVERGE_FRAMES+RECOVER_FRAMES; frame++) {
+        if(frame == CONVERGE_FRAMES) {
+            if(action == SHIFT_AEC_PHASES_REF) {
+                ref_delay -= delta;
+            }
+            else {
+                mic_delay += delta;
+            }
+            switch(action) {
+                case RESET_AEC:
+                    aec_reset_state(&main_state, &shadow_state);
+                    break;
+                case SHIFT_AEC_SAMPLES:
+                    aec_shift_filter_samples(&main_state, &shadow_state, delta);
+                    break;
+                default:
+                    aec_shift_filter_phases(&main_state, &shadow_state, delta / AEC_FRAME_ADVANCE, (action == SHIFT_AEC_PHASES_REF));
+                    break;
+            }
+        }
+        double y_energy = 0, output_energy = 0;
+        sim.delay = mic_delay;
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            double echo = echo_sim_push(&sim, pseudo_rand_int32(&seed) >> 3);
+            x_data[0][i] = (int32_t)echo_sim_reference(&sim, ref_delay);
+            y_data[0][i] = (int32_t)echo + (pseudo_rand_int32(&seed) >> 14);
+        }
+        aec_process_frame_1thread_r(&main_state, &shadow_state, &recalc_bin, output, NULL, y_data, x_data);
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            y_energy += (double)y_data[0][i] * y_data[0][i];
+            output_energy += (double)output[0][i] * output[0][i];
+        }
+        double erle = 10 * log10(y_energy / output_energy);
+        if(frame == CONVERGE_FRAMES - 1) {
+            converged_erle = erle;
+        }
+        else if((frame >= CONVERGE_FRAMES) && (erle > converged_erle - 6.0)) {
+            return frame - CONVERGE_FRAMES;
+        }
+    }
+    return RECOVER_FRAMES;
+}
+
+//Shifting the filters on a delay change should recover the ERLE within a few frames, much faster than reconverging
+//from a reset
+void test_shift_filter_recovery() {
+    const int32_t deltas[] = {170, -300, 480};
+    for(int d=0; d<sizeof(deltas)/sizeof(deltas[0]); d++) {
+        int reset_frames = frames_to_recover(deltas[d], RESET_AEC);
+        int shift_frames = frames_to_recover(deltas[d], SHIFT_AEC_SAMPLES);
+        printf("delay change %d: %d frames to recover after reset, %d after shift\n", (int)deltas[d], reset_frames, shift_frames);
+        TEST_ASSERT_LESS_OR_EQUAL_INT32(2, shift_frames);
+        TEST_ASSERT_GREATER_THAN_INT32(shift_frames, reset_frames);
+    }
+}
+
+//Whole frame delay changes, made on either input, should recover as quickly with the filter phases shifted
+void test_shift_filter_phases_recovery() {
+    const int32_t deltas[] = {AEC_FRAME_ADVANCE, -AEC_FRAME_ADVANCE, 2*AEC_FRAME_ADVANCE};
+    for(int d=0; d<sizeof(deltas)/sizeof(deltas[0]); d++) {
+        int reset_frames = frames_to_recover(deltas[d], RESET_AEC);
+        int mic_frames = frames_to_recover(deltas[d], SHIFT_AEC_PHASES_MIC);
+        int ref_frames = frames_to_recover(deltas[d], SHIFT_AEC_PHASES_REF);
+        printf("delay change %d: %d frames to recover after reset, %d after shifting for mic, %d for reference\n", (int)deltas[d], reset_frames, mic_frames, ref_frames);
+        TEST_ASSERT_LESS_OR_EQUAL_INT32(2, mic_frames);
+        TEST_ASSERT_LESS_OR_EQUAL_INT32(2, ref_frames);
+        TEST_ASSERT_GREATER_THAN_INT32(mic_frames, reset_frames);
+    }
+}
@@ -0,0 +1,165 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_priv.h"
+#include "echo_sim.h"
+#include "aec_process_frame_1thread.h"
+
+#define MAIN_PHASES (10)
+#define SHADOW_PHASES (5)
+#define ECHO_DELAY (200)
+#define ECHO_TAPS (1500)
+#define HISTORY (ECHO_DELAY + ECHO_TAPS)
+#define CONVERGE_FRAMES (200 / F)
+#define RESTART_FRAMES (MAIN_PHASES + 1)
+
+static uint64_t aec_arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+static uint8_t snapshot[sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)];
+
+typedef struct {
+    double h[ECHO_TAPS];
+    double x_history[HISTORY];
+    echo_sim_t echo;
+    unsigned seed;
+    unsigned recalc_bin;
+}session_t;
+
+static void session_init(session_t *sim)
+{
+    sim->seed = 9001;
+    for(int k=0; k<ECHO_TAPS; k++) {
+        sim->h[k] = ldexp(pseudo_rand_int32(&sim->seed), -31) * 0.05 * exp(-k / 300.0);
+    }
+    echo_sim_init(&sim->echo, sim->x_history, HISTORY, sim->h, ECHO_TAPS, ECHO_DELAY);
+    sim->recalc_bin = 0;
+}
+
+// Run a frame of white noise reference through the echo path and the AEC and return the frame's ERLE in dB
+static double session_frame(session_t *sim, aec_state_t *main_state, aec_state_t *shadow_state)
+{
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[1][AEC_FRAME_ADVANCE];
+    double y_energy = 0, output_energy = 0;
+    echo_sim_frame(&sim->echo, y_data[0], x_data[0], AEC_FRAME_ADVANCE, &sim->seed, 14);
+    aec_process_frame_1thread_r(main_state, shadow_state, &sim->recalc_bin, output, NULL, y_data, x_data);
+    for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+        y_energy += (double)y_data[0][i] * y_data[0][i];
+        output_energy += (double)output[0][i] * output[0][i];
+    }
+    return 10 * log10(y_energy / output_energy);
+}
+
+// Energy of the time domain taps of a filter phase
+static double phase_energy(const bfp_complex_s32_t *H)
+{
+    if(H->exp == AEC_ZEROVAL_EXP) {
+        return 0;
+    }
+    complex_s32_t DWORD_ALIGNED data[AEC_FD_FRAME_LENGTH];
+    bfp_complex_s32_t H_copy;
+    memcpy(data, H->data, sizeof(data));
+    bfp_complex_s32_init(&H_copy, data, H->exp, AEC_FD_FRAME_LENGTH, 1);
+    bfp_fft_pack_mono(&H_copy);
+    bfp_s32_t *h = bfp_fft_inverse_mono(&H_copy);
+    double energy = 0;
+    for(int i=0; i<AEC_PROC_FRAME_LENGTH; i++) {
+        energy += ldexp(h->data[i], h->exp) * ldexp(h->data[i], h->exp);
+    }
+    return energy;
+}
+
+//A restored AEC should cancel the echo as soon as its X FIFO has filled, where a newly initialised one has to converge
+//first
+void test_snapshot_restore() {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    static session_t sim;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    uint32_t snapshot_size = aec_get_snapshot_size(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    TEST_ASSERT(snapshot_size <= sizeof(snapshot));
+
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    session_init(&sim);
+    double converged_erle = 0;
+    for(int frame=0; frame<CONVERGE_FRAMES; frame++) {
+        converged_erle = session_frame(&sim, &main_state, &shadow_state);
+    }
+    TEST_ASSERT_EQUAL_UINT32(snapshot_size, aec_save_snapshot(snapshot, snapshot_size, &main_state, &shadow_state));
+    double main_energy[MAIN_PHASES], shadow_energy[SHADOW_PHASES];
+    for(int ph=0; ph<MAIN_PHASES; ph++) {
+        main_energy[ph] = phase_energy(&main_state.H_hat[0][ph]);
+    }
+    for(int ph=0; ph<SHADOW_PHASES; ph++) {
+        shadow_energy[ph] = phase_energy(&shadow_state.H_hat[0][ph]);
+    }
+    int32_t sigma_XX_exp = shared_state.sigma_XX[0].exp;
+    int32_t sigma_XX_0 = shared_state.sigma_XX[0].data[0];
+    float_s32_t coh = shared_state.coh_mu_state[0].coh;
+
+    //New session, with nothing in the reference history
+    for(int restore=0; restore<2; restore++) {
+        aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+        if(restore) {
+            TEST_ASSERT_EQUAL_INT32(0, aec_restore_snapshot(&main_state, &shadow_state, snapshot, snapshot_size));
+            for(int ph=0; ph<MAIN_PHASES; ph++) {
+                TEST_ASSERT(fabs(phase_energy(&main_state.H_hat[0][ph]) - main_energy[ph]) <= (main_energy[ph] * ldexp(1, -20)));
+            }
+            for(int ph=0; ph<SHADOW_PHASES; ph++) {
+                TEST_ASSERT(fabs(phase_energy(&shadow_state.H_hat[0][ph]) - shadow_energy[ph]) <= (shadow_energy[ph] * ldexp(1, -20)));
+            }
+            TEST_ASSERT_EQUAL_INT32(sigma_XX_exp, shared_state.sigma_XX[0].exp);
+            TEST_ASSERT_EQUAL_INT32(sigma_XX_0, shared_state.sigma_XX[0].data[0]);
+            TEST_ASSERT_EQUAL_INT32(coh.mant, shared_state.coh_mu_state[0].coh.mant);
+            TEST_ASSERT_EQUAL_INT32(coh.exp, shared_state.coh_mu_state[0].coh.exp);
+        }
+        echo_sim_clear(&sim.echo);
+        double erle = 0;
+        for(int frame=0; frame<RESTART_FRAMES; frame++) {
+            erle = session_frame(&sim, &main_state, &shadow_state);
+        }
+        printf("ERLE %.1f dB converged, %.1f dB %d frames after %s\n", converged_erle, erle, RESTART_FRAMES, restore ? "restoring" : "initialising");
+        if(restore) {
+            TEST_ASSERT(erle > converged_erle - 6.0);
+        }
+        else {
+            TEST_ASSERT(erle < converged_erle - 6.0);
+        }
+    }
+}
+
+//Snapshots that don't match the AEC configuration, or aren't AEC snapshots, should be rejected without changing the AEC
+void test_snapshot_invalid() {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    uint32_t snapshot_size = aec_get_snapshot_size(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+
+    TEST_ASSERT_EQUAL_UINT32(0, aec_save_snapshot(snapshot, snapshot_size - 1, &main_state, &shadow_state));
+    TEST_ASSERT_EQUAL_UINT32(snapshot_size, aec_save_snapshot(snapshot, snapshot_size, &main_state, &shadow_state));
+    TEST_ASSERT_EQUAL_INT32(-1, aec_restore_snapshot(&main_state, &shadow_state, snapshot, snapshot_size - 1));
+
+    //Different phase counts
+    aec_size = aec_get_required_memory(1, 1, MAIN_PHASES + 1, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES + 1, SHADOW_PHASES);
+    TEST_ASSERT_EQUAL_INT32(-1, aec_restore_snapshot(&main_state, &shadow_state, snapshot, sizeof(snapshot)));
+    aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, 0);
+    aec_init_from_arena(&main_state, NULL, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, 0);
+    TEST_ASSERT_EQUAL_INT32(-1, aec_restore_snapshot(&main_state, NULL, snapshot, sizeof(snapshot)));
+
+    //Not an AEC snapshot
+    aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    shared_state.sigma_XX[0].exp = -40;
+    snapshot[0] ^= 0xff;
+    TEST_ASSERT_EQUAL_INT32(-1, aec_restore_snapshot(&main_state, &shadow_state, snapshot, snapshot_size));
+    TEST_ASSERT_EQUAL_INT32(-40, shared_state.sigma_XX[0].exp);
+    snapshot[0] ^= 0xff;
+    TEST_ASSERT_EQUAL_INT32(0, aec_restore_snapshot(&main_state, &shadow_state, snapshot, snapshot_size));
+    TEST_ASSERT_EQUAL_INT32(AEC_ZEROVAL_EXP, shared_state.sigma_XX[0].exp);
+}
@@ -0,0 +1,242 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "echo_sim.h"
+#include "aec_process_frame_1thread.h"
+
+#ifdef __xcore__
+#include <xcore/hwtimer.h>
+#define TAIL_TEST_TIME() ((uint32_t)get_reference_time())
+#else
+#include <time.h>
+#define TAIL_TEST_TIME() ((uint32_t)clock())
+#endif
+
+#define MAIN_PHASES (4 * AEC_TAIL_BLOCK_FRAMES)
+#define SHADOW_PHASES (5)
+#define TAIL_PARTITIONS (4 * AEC_TAIL_BLOCK_FRAMES)
+#define TAIL_START (MAIN_PHASES * AEC_FRAME_ADVANCE)
+#define TAIL_TAPS (TAIL_PARTITIONS * AEC_TAIL_BLOCK_LENGTH)
+#define HISTORY (TAIL_START + TAIL_TAPS)
+//Main filter phases covering the same echo path as MAIN_PHASES plus the tail filter
+#define UNIFORM_PHASES (MAIN_PHASES + (TAIL_PARTITIONS * AEC_TAIL_BLOCK_FRAMES))
+
+static uint64_t aec_arena[(sizeof(aec_memory_pool_t) + sizeof(aec_shadow_filt_memory_pool_t)) / sizeof(uint64_t) + 1];
+static uint64_t tail_arena[(1 << 18) / sizeof(uint64_t)];
+
+void test_tail_init() {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    aec_tail_state_t DWORD_ALIGNED tail_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    TEST_ASSERT_EQUAL_INT32(0, aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size,
+                1, 1, MAIN_PHASES, SHADOW_PHASES));
+
+    uint32_t required = aec_tail_get_required_memory(1, 1, MAIN_PHASES, TAIL_PARTITIONS);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(sizeof(tail_arena), required);
+    TEST_ASSERT_LESS_THAN_UINT32(required, aec_tail_get_required_memory(1, 1, MAIN_PHASES, TAIL_PARTITIONS - 1));
+    TEST_ASSERT_LESS_THAN_UINT32(aec_tail_get_required_memory(2, 1, MAIN_PHASES, TAIL_PARTITIONS), required);
+
+    //Pool too small or unaligned
+    TEST_ASSERT_EQUAL_INT32(-1, aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena, required - 1, TAIL_PARTITIONS));
+    TEST_ASSERT_EQUAL_INT32(-1, aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena + 4, required, TAIL_PARTITIONS));
+    //Unsupported number of partitions
+    TEST_ASSERT_EQUAL_INT32(-1, aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena, sizeof(tail_arena), 0));
+    TEST_ASSERT_EQUAL_INT32(-1, aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena, sizeof(tail_arena), AEC_TAIL_MAX_PARTITIONS + 1));
+
+    TEST_ASSERT_EQUAL_INT32(0, aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena, required, TAIL_PARTITIONS));
+    TEST_ASSERT_EQUAL_UINT32(MAIN_PHASES / AEC_TAIL_BLOCK_FRAMES, tail_state.start_block);
+
+    //Main filter too short for the tail filter
+    TEST_ASSERT_EQUAL_INT32(0, aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size,
+                1, 1, (2 * AEC_TAIL_BLOCK_FRAMES) - 1, SHADOW_PHASES));
+    TEST_ASSERT_EQUAL_INT32(-1, aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena, sizeof(tail_arena), TAIL_PARTITIONS));
+}
+
+//With a known filter and no adaption, the removed echo should be the reference convolved with the tail taps
+void test_tail_echo_estimate() {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    aec_tail_state_t DWORD_ALIGNED tail_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena, sizeof(tail_arena), TAIL_PARTITIONS);
+
+    //Sparse taps, including the first and last tap of every partition
+    unsigned seed = 30422;
+    static double h[TAIL_TAPS];
+    memset(h, 0, sizeof(h));
+    for(int p=0; p<TAIL_PARTITIONS; p++) {
+        int32_t DWORD_ALIGNED taps[AEC_TAIL_PROC_FRAME_LENGTH + AEC_FFT_PADDING];
+        memset(taps, 0, sizeof(taps));
+        for(int i=0; i<AEC_TAIL_BLOCK_LENGTH; i++) {
+            if(((i % 37) == 0) || (i == (AEC_TAIL_BLOCK_LENGTH - 1))) {
+                taps[i] = pseudo_rand_int32(&seed) >> 4;
+                h[p*AEC_TAIL_BLOCK_LENGTH + i] = ldexp(taps[i], -35);
+            }
+        }
+        bfp_s32_t taps_bfp;
+        bfp_complex_s32_t H;
+        bfp_s32_init(&taps_bfp, taps, -35, AEC_TAIL_PROC_FRAME_LENGTH, 1);
+        aec_forward_fft(&H, &taps_bfp);
+        memcpy(tail_state.H_hat[0][p].data, H.data, AEC_TAIL_FD_FRAME_LENGTH*sizeof(complex_s32_t));
+        tail_state.H_hat[0][p].exp = H.exp;
+        tail_state.H_hat[0][p].hr = H.hr;
+    }
+
+    static double x_history[HISTORY];
+    echo_sim_t sim;
+    echo_sim_init(&sim, x_history, HISTORY, h, TAIL_TAPS, TAIL_START);
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[1][AEC_FRAME_ADVANCE];
+    memset(output, 0, sizeof(output));
+    double max_diff = 0;
+    for(int frame=0; frame<(128/F); frame++) {
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            x_data[0][i] = pseudo_rand_int32(&seed) >> 4;
+            y_data[0][i] = 0;
+        }
+        aec_tail_remove_echo(&tail_state, y_data);
+        for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+            double expected = echo_sim_push(&sim, x_data[0][i]);
+            double diff = fabs(-expected - (double)y_data[0][i]);
+            if(diff > max_diff) max_diff = diff;
+        }
+        //A zero error leaves the filter unchanged
+        aec_tail_update(&tail_state, &main_state, x_data, output);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(64, (uint32_t)max_diff);
+}
+
+//Run an echo longer than the main filter until the filters have converged, and then double_talk_frames of near end
+//speech. Returns the ERLE over the last frames before the near end speech and over the frames after it.
+static void run_long_echo(double *erle_before, double *erle_after, unsigned use_tail, int double_talk_frames) {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    aec_tail_state_t DWORD_ALIGNED tail_state;
+    uint32_t aec_size = aec_get_required_memory(1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, MAIN_PHASES, SHADOW_PHASES);
+    aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena, sizeof(tail_arena), TAIL_PARTITIONS);
+
+    //Short room response that the main filter covers, followed by weaker late reflections that it doesn't
+    unsigned seed = 6311;
+    static double h[HISTORY];
+    memset(h, 0, sizeof(h));
+    for(int k=40; k<440; k++) {
+        h[k] = ldexp(pseudo_rand_int32(&seed), -31) * 0.04 * exp(-(k - 40) / 80.0);
+    }
+    for(int k=TAIL_START + 180; k<HISTORY; k+=(pseudo_rand_uint32(&seed) % 128) + 1) {
+        h[k] = ldexp(pseudo_rand_int32(&seed), -31) * 0.004;
+    }
+
+    static double x_history[HISTORY];
+    echo_sim_t sim;
+    echo_sim_init(&sim, x_history, HISTORY, h, HISTORY, 0);
+    unsigned recalc_bin = 0;
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[1][AEC_FRAME_ADVANCE];
+    double y_energy[2] = {0, 0}, output_energy[2] = {0, 0};
+    //The tail filter adapts once per block and needs a few hundred frames whatever the speedup factor
+    int converge_frames = 240 + (240 / F);
+    int measure_frames = 100 / F;
+    //The output lags the mic input by the overlap, so the frame after the near end speech still has some of it
+    int num_frames = converge_frames + double_talk_frames + (double_talk_frames ? (measure_frames + 1) : 0);
+    for(int frame=0; frame<num_frames; frame++) {
+        unsigned near_end = (frame >= converge_frames) && (frame < (converge_frames + double_talk_frames));
+        echo_sim_frame(&sim, y_data[0], x_data[0], AEC_FRAME_ADVANCE, &seed, near_end ? 4 : 16);
+        if(use_tail) {
+            aec_process_frame_1thread_tail(&main_state, &shadow_state, &tail_state, &recalc_bin, output, NULL, y_data, x_data);
+        }
+        else {
+            aec_process_frame_1thread_r(&main_state, &shadow_state, &recalc_bin, output, NULL, y_data, x_data);
+        }
+        int after = (frame >= (num_frames - measure_frames)) && double_talk_frames;
+        if(after || ((frame >= (converge_frames - measure_frames)) && (frame < converge_frames))) {
+            for(int i=0; i<AEC_FRAME_ADVANCE; i++) {
+                y_energy[after] += (double)y_data[0][i] * y_data[0][i];
+                output_energy[after] += (double)output[0][i] * output[0][i];
+            }
+        }
+    }
+    *erle_before = 10 * log10(y_energy[0] / output_energy[0]);
+    *erle_after = double_talk_frames ? 10 * log10(y_energy[1] / output_energy[1]) : *erle_before;
+}
+
+//An echo path longer than the main filter should be cancelled further with the tail filter
+void test_tail_long_echo() {
+    double erle_main, erle_tail;
+    run_long_echo(&erle_main, &erle_main, 0, 0);
+    run_long_echo(&erle_tail, &erle_tail, 1, 0);
+    printf("ERLE main filter only %.1f dB, with tail filter %.1f dB\n", erle_main, erle_tail);
+    TEST_ASSERT_GREATER_THAN_INT32((int32_t)(erle_main + 4), (int32_t)erle_tail);
+}
+
+//The tail filter should freeze along with the main filter on near end speech, and still cancel the echo after it
+void test_tail_double_talk() {
+    double erle_before, erle_after;
+    run_long_echo(&erle_before, &erle_after, 1, 40);
+    printf("ERLE with tail filter before double talk %.1f dB, after %.1f dB\n", erle_before, erle_after);
+    TEST_ASSERT_GREATER_THAN_INT32((int32_t)(erle_before - 3), (int32_t)erle_after);
+}
+
+//Time per frame to process the same echo with main filter phases only, with the main filter extended uniformly by the
+//tail length, and with the tail filter. Returns the extra time the uniform extension and the tail filter each take.
+static void run_tail_cost(uint64_t *uniform_ticks, uint64_t *tail_ticks) {
+    aec_state_t DWORD_ALIGNED main_state, shadow_state;
+    aec_shared_state_t DWORD_ALIGNED shared_state;
+    aec_tail_state_t DWORD_ALIGNED tail_state;
+
+    unsigned seed = 1723;
+    static double h[HISTORY];
+    memset(h, 0, sizeof(h));
+    for(int k=40; k<HISTORY; k+=(pseudo_rand_uint32(&seed) % 16) + 1) {
+        h[k] = ldexp(pseudo_rand_int32(&seed), -31) * 0.02;
+    }
+    static double x_history[HISTORY];
+    int32_t DWORD_ALIGNED x_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED y_data[1][AEC_FRAME_ADVANCE];
+    int32_t DWORD_ALIGNED output[1][AEC_FRAME_ADVANCE];
+    uint64_t ticks[3] = {0, 0, 0};
+    for(int config=0; config<3; config++) {
+        unsigned phases = (config == 1) ? UNIFORM_PHASES : MAIN_PHASES;
+        uint32_t aec_size = aec_get_required_memory(1, 1, phases, SHADOW_PHASES);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(sizeof(aec_arena), aec_size);
+        aec_init_from_arena(&main_state, &shadow_state, &shared_state, (uint8_t*)aec_arena, aec_size, 1, 1, phases, SHADOW_PHASES);
+        aec_tail_init(&tail_state, &main_state, (uint8_t*)tail_arena, sizeof(tail_arena), TAIL_PARTITIONS);
+        echo_sim_t sim;
+        echo_sim_init(&sim, x_history, HISTORY, h, HISTORY, 0);
+        unsigned recalc_bin = 0;
+        unsigned frame_seed = 8817;
+        for(int frame=0; frame<(64/F); frame++) {
+            echo_sim_frame(&sim, y_data[0], x_data[0], AEC_FRAME_ADVANCE, &frame_seed, 16);
+            uint32_t t0 = TAIL_TEST_TIME();
+            if(config == 2) {
+                aec_process_frame_1thread_tail(&main_state, &shadow_state, &tail_state, &recalc_bin, output, NULL, y_data, x_data);
+            }
+            else {
+                aec_process_frame_1thread_r(&main_state, &shadow_state, &recalc_bin, output, NULL, y_data, x_data);
+            }
+            ticks[config] += (uint32_t)(TAIL_TEST_TIME() - t0);
+        }
+    }
+    *uniform_ticks = (ticks[1] > ticks[0]) ? (ticks[1] - ticks[0]) : 0;
+    *tail_ticks = (ticks[2] > ticks[0]) ? (ticks[2] - ticks[0]) : 1;
+}
+
+//The tail filter partitions are AEC_TAIL_BLOCK_FRAMES times longer than main filter phases and are processed once per
+//block, so per modelled tap it does about half the complex multiply accumulates and FFT work of extending the main
+//filter. Its per block FFTs and normalisation take back a little of that.
+void test_tail_cost() {
+    uint64_t uniform_ticks, tail_ticks;
+    run_tail_cost(&uniform_ticks, &tail_ticks);
+    double saving = (double)uniform_ticks / tail_ticks;
+    printf("Extra time for %d taps: main filter %llu, tail filter %llu, %.2fx saving\n", TAIL_TAPS,
+            (unsigned long long)uniform_ticks, (unsigned long long)tail_ticks, saving);
+    TEST_ASSERT_GREATER_THAN_INT32(150, (int32_t)(saving * 100));
+}
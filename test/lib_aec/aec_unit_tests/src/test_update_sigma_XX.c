@@ -108,16 +108,22 @@ void test_update_sigma_XX() {
         update_mapping(mapping, num_phases);
         for(unsigned ch=0; ch < num_x_channels; ch++){
             bfp_complex_s32_t *X_ptr = &state.shared_state->X[ch];
-            TEST_ASSERT_EQUAL_INT32(state.shared_state->X_fifo[ch][0].exp, X_ptr->exp);
-            TEST_ASSERT_EQUAL_INT32(state.shared_state->X_fifo[ch][0].hr, X_ptr->hr);
-            TEST_ASSERT_EQUAL_INT32(state.shared_state->X_fifo[ch][0].length, X_ptr->length);
-            if(memcmp(state.shared_state->X_fifo[ch][0].data, X_ptr->data, X_ptr->length*sizeof(X_ptr->data[0])))
+            //X_fifo is circular, newest phase at the head
+            bfp_complex_s32_t *X_fifo_ptr = &state.shared_state->X_fifo[ch][state.shared_state->X_fifo_head[ch]];
+            TEST_ASSERT_EQUAL_INT32(X_fifo_ptr[0].exp, X_ptr->exp);
+            TEST_ASSERT_EQUAL_INT32(X_fifo_ptr[0].hr, X_ptr->hr);
+            TEST_ASSERT_EQUAL_INT32(X_fifo_ptr[0].length, X_ptr->length);
+            if(memcmp(X_fifo_ptr[0].data, X_ptr->data, X_ptr->length*sizeof(X_ptr->data[0])))
             {
                 printf("X data mismatch\n");
                 assert(0);
             }
             for(unsigned ph=0; ph<num_phases; ph++) {
-                TEST_ASSERT_EQUAL_INT32_MESSAGE(state.shared_state->X_fifo[ch][ph].data, X_fifo_check[ch][mapping[ph]].data, "X_fifo data ptr mismatch");
+                TEST_ASSERT_EQUAL_INT32_MESSAGE(X_fifo_ptr[ph].data, X_fifo_check[ch][mapping[ph]].data, "X_fifo data ptr mismatch");
+                //mirrored entries
+                TEST_ASSERT_EQUAL_INT32_MESSAGE(state.shared_state->X_fifo[ch][ph].data, state.shared_state->X_fifo[ch][ph + num_phases].data, "X_fifo mirror data ptr mismatch");
+                TEST_ASSERT_EQUAL_INT32_MESSAGE(state.shared_state->X_fifo[ch][ph].exp, state.shared_state->X_fifo[ch][ph + num_phases].exp, "X_fifo mirror exp mismatch");
+                TEST_ASSERT_EQUAL_INT32_MESSAGE(state.shared_state->X_fifo[ch][ph].hr, state.shared_state->X_fifo[ch][ph + num_phases].hr, "X_fifo mirror hr mismatch");
             }
         }
     }
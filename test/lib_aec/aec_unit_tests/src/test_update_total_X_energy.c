@@ -147,18 +147,16 @@ void test_update_total_X_energy() {
         }
         update_X_fifo_fp(X_fifo_fp, mapping, X_fp, num_x_channels, state.num_phases);
 
-        aec_update_X_fifo_1d(&state);
-        aec_update_X_fifo_1d(&shadow_state);
-
-        //Check 1d fifo update
-        int count = 0;
+        //Check circular fifo update. Newest phase is at the head and the mirrored entries match
         for(int i=0; i<num_x_channels; i++) {
+            unsigned head = state.shared_state->X_fifo_head[i];
+            TEST_ASSERT_EQUAL_INT32(state.shared_state->X[i].exp, state.shared_state->X_fifo[i][head].exp);
+            TEST_ASSERT_EQUAL_INT32(state.shared_state->X[i].hr, state.shared_state->X_fifo[i][head].hr);
             for(int j=0; j<state.num_phases; j++) {
-                TEST_ASSERT_EQUAL_INT32(state.X_fifo_1d[count].data, state.shared_state->X_fifo[i][j].data);
-                TEST_ASSERT_EQUAL_INT32(state.X_fifo_1d[count].exp, state.shared_state->X_fifo[i][j].exp);
-                TEST_ASSERT_EQUAL_INT32(state.X_fifo_1d[count].hr, state.shared_state->X_fifo[i][j].hr);
-                TEST_ASSERT_EQUAL_INT32(state.X_fifo_1d[count].length, state.shared_state->X_fifo[i][j].length);
-                count++;
+                TEST_ASSERT_EQUAL_INT32(state.shared_state->X_fifo[i][j].data, state.shared_state->X_fifo[i][j + state.num_phases].data);
+                TEST_ASSERT_EQUAL_INT32(state.shared_state->X_fifo[i][j].exp, state.shared_state->X_fifo[i][j + state.num_phases].exp);
+                TEST_ASSERT_EQUAL_INT32(state.shared_state->X_fifo[i][j].hr, state.shared_state->X_fifo[i][j + state.num_phases].hr);
+                TEST_ASSERT_EQUAL_INT32(state.shared_state->X_fifo[i][j].length, state.shared_state->X_fifo[i][j + state.num_phases].length);
             }
         }
         //printf("iter %d. done memcmp\n", iter);
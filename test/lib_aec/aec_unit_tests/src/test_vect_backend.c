@@ -0,0 +1,175 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "aec_unit_tests.h"
+#include <stdio.h>
+#include <assert.h>
+#include "aec_defines.h"
+#include "aec_api.h"
+#include "aec_priv.h"
+
+#define NUM_BINS ((AEC_PROC_FRAME_LENGTH/2) + 1)
+#define TEST_MAX_PHASES (AEC_MAX_X_CHANNELS * AEC_MAIN_FILTER_PHASES)
+
+static void gen_bfp_complex(bfp_complex_s32_t *a, complex_double_t *a_fp, unsigned *seed)
+{
+    a->exp = pseudo_rand_int(seed, -31, 32);
+    a->hr = pseudo_rand_uint32(seed) % 5;
+    for(int i=0; i<NUM_BINS; i++) {
+        a->data[i].re = pseudo_rand_int32(seed) >> a->hr;
+        a->data[i].im = pseudo_rand_int32(seed) >> a->hr;
+        a_fp[i].re = ldexp(a->data[i].re, a->exp);
+        a_fp[i].im = ldexp(a->data[i].im, a->exp);
+    }
+}
+
+// Compares the AEC_VECT_BACKEND kernels against the lib_xcore_math BFP path they replace and against a double
+// precision reference. The kernels are always built, so this runs irrespective of which path the library uses.
+void test_vect_complex_s32_macc() {
+    complex_s32_t DWORD_ALIGNED b_data[TEST_MAX_PHASES][NUM_BINS];
+    complex_s32_t DWORD_ALIGNED c_data[TEST_MAX_PHASES][NUM_BINS];
+    complex_s32_t DWORD_ALIGNED acc_ref_data[NUM_BINS];
+    complex_s32_t DWORD_ALIGNED acc_dut_data[NUM_BINS];
+    bfp_complex_s32_t b[TEST_MAX_PHASES], c[TEST_MAX_PHASES];
+    bfp_complex_s32_t acc_ref, acc_dut;
+    complex_double_t b_fp[NUM_BINS], c_fp[NUM_BINS];
+    complex_double_t acc_fp[NUM_BINS], acc_ref_fp[NUM_BINS];
+
+    unsigned seed = 34785;
+    unsigned max_diff_exact = 0, max_diff_bfp = 0;
+    for(int itt=0; itt<(1<<10)/F; itt++) {
+        unsigned count = (pseudo_rand_uint32(&seed) % TEST_MAX_PHASES) + 1;
+        unsigned conj = pseudo_rand_uint32(&seed) % 2;
+        unsigned offset = pseudo_rand_uint32(&seed) % NUM_BINS;
+        unsigned length = NUM_BINS - offset;
+
+        bfp_complex_s32_init(&acc_ref, acc_ref_data, 0, length, 0);
+        bfp_complex_s32_init(&acc_dut, acc_dut_data, 0, length, 0);
+        if(pseudo_rand_uint32(&seed) % 2) {
+            //Start from an empty accumulator, as Y_hat is at the start of aec_l2_calc_Error_and_Y_hat()
+            memset(acc_ref_data, 0, sizeof(acc_ref_data));
+            acc_ref.exp = AEC_ZEROVAL_EXP;
+            acc_ref.hr = AEC_ZEROVAL_HR;
+            for(int i=0; i<length; i++) {
+                acc_fp[i].re = 0.0;
+                acc_fp[i].im = 0.0;
+            }
+        }
+        else {
+            //Start from an existing filter, as H_hat is in aec_l2_adapt_plus_fft_gc()
+            complex_double_t tmp_fp[NUM_BINS];
+            bfp_complex_s32_t tmp;
+            bfp_complex_s32_init(&tmp, acc_ref_data, 0, NUM_BINS, 0);
+            gen_bfp_complex(&tmp, tmp_fp, &seed);
+            acc_ref.exp = tmp.exp;
+            acc_ref.hr = tmp.hr;
+            memcpy(acc_fp, tmp_fp, length*sizeof(complex_double_t));
+        }
+        memcpy(acc_dut_data, acc_ref_data, sizeof(acc_dut_data));
+        acc_dut.exp = acc_ref.exp;
+        acc_dut.hr = acc_ref.hr;
+
+        for(int p=0; p<count; p++) {
+            bfp_complex_s32_init(&b[p], b_data[p], 0, NUM_BINS, 0);
+            bfp_complex_s32_init(&c[p], c_data[p], 0, NUM_BINS, 0);
+            gen_bfp_complex(&b[p], b_fp, &seed);
+            gen_bfp_complex(&c[p], c_fp, &seed);
+            for(int i=0; i<length; i++) {
+                double c_im = conj ? -c_fp[offset+i].im : c_fp[offset+i].im;
+                acc_fp[i].re += (b_fp[offset+i].re * c_fp[offset+i].re) - (b_fp[offset+i].im * c_im);
+                acc_fp[i].im += (b_fp[offset+i].re * c_im) + (b_fp[offset+i].im * c_fp[offset+i].re);
+            }
+        }
+
+        //scalar BFP path, as in aec_l2_calc_Error_and_Y_hat() and aec_l2_adapt_plus_fft_gc()
+        for(int p=0; p<count; p++) {
+            bfp_complex_s32_t b_chunk, c_chunk;
+            bfp_complex_s32_init(&b_chunk, &b[p].data[offset], b[p].exp, length, 0);
+            b_chunk.hr = b[p].hr;
+            bfp_complex_s32_init(&c_chunk, &c[p].data[offset], c[p].exp, length, 0);
+            c_chunk.hr = c[p].hr;
+            if(conj) {
+                bfp_complex_s32_conj_macc(&acc_ref, &b_chunk, &c_chunk);
+            }
+            else {
+                bfp_complex_s32_macc(&acc_ref, &b_chunk, &c_chunk);
+            }
+        }
+        //dut
+        aec_vect_complex_s32_macc(&acc_dut, b, c, count, offset, conj);
+
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(vect_complex_s32_headroom(acc_dut.data, length), acc_dut.hr, "acc headroom incorrect.");
+
+        unsigned diff = vector_int32_maxdiff((int32_t*)acc_dut.data, acc_dut.exp, (double*)acc_fp, 0, length*2);
+        max_diff_exact = (diff > max_diff_exact) ? diff : max_diff_exact;
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(AEC_VECT_LSB_TOLERANCE, diff, "diff from exact result too large.");
+
+        for(int i=0; i<length; i++) {
+            acc_ref_fp[i].re = ldexp(acc_ref.data[i].re, acc_ref.exp);
+            acc_ref_fp[i].im = ldexp(acc_ref.data[i].im, acc_ref.exp);
+        }
+        diff = vector_int32_maxdiff((int32_t*)acc_dut.data, acc_dut.exp, (double*)acc_ref_fp, 0, length*2);
+        max_diff_bfp = (diff > max_diff_bfp) ? diff : max_diff_bfp;
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(2*AEC_VECT_LSB_TOLERANCE*(count+1), diff, "diff from BFP path too large.");
+    }
+    printf("max_diff_exact %d, max_diff_bfp %d\n", max_diff_exact, max_diff_bfp);
+}
+
+void test_vect_energy_update() {
+    complex_s32_t DWORD_ALIGNED X_sub_data[NUM_BINS], X_add_data[NUM_BINS];
+    int32_t DWORD_ALIGNED energy_ref_data[NUM_BINS], energy_dut_data[NUM_BINS], scratch_data[NUM_BINS];
+    bfp_complex_s32_t X_sub, X_add;
+    bfp_s32_t energy_ref, energy_dut, scratch;
+    complex_double_t X_sub_fp[NUM_BINS], X_add_fp[NUM_BINS];
+    double energy_fp[NUM_BINS], energy_ref_fp[NUM_BINS];
+
+    bfp_complex_s32_init(&X_sub, X_sub_data, 0, NUM_BINS, 0);
+    bfp_complex_s32_init(&X_add, X_add_data, 0, NUM_BINS, 0);
+    bfp_s32_init(&energy_ref, energy_ref_data, 0, NUM_BINS, 0);
+    bfp_s32_init(&energy_dut, energy_dut_data, 0, NUM_BINS, 0);
+    bfp_s32_init(&scratch, scratch_data, 0, NUM_BINS, 0);
+
+    unsigned seed = 6823;
+    unsigned max_diff_exact = 0, max_diff_bfp = 0;
+    for(int itt=0; itt<(1<<10)/F; itt++) {
+        gen_bfp_complex(&X_sub, X_sub_fp, &seed);
+        gen_bfp_complex(&X_add, X_add_fp, &seed);
+        //X_energy always contains the energy of the phase being subtracted
+        bfp_complex_s32_squared_mag(&energy_ref, &X_sub);
+        for(int i=0; i<NUM_BINS; i++) {
+            energy_ref.data[i] = energy_ref.data[i] >> 1;
+            energy_ref.data[i] += (pseudo_rand_uint32(&seed) >> 2);
+        }
+        energy_ref.hr = vect_s32_headroom(energy_ref.data, NUM_BINS);
+        memcpy(energy_dut_data, energy_ref_data, sizeof(energy_dut_data));
+        energy_dut.exp = energy_ref.exp;
+        energy_dut.hr = energy_ref.hr;
+
+        for(int i=0; i<NUM_BINS; i++) {
+            energy_fp[i] = ldexp(energy_ref.data[i], energy_ref.exp)
+                - ((X_sub_fp[i].re * X_sub_fp[i].re) + (X_sub_fp[i].im * X_sub_fp[i].im))
+                + ((X_add_fp[i].re * X_add_fp[i].re) + (X_add_fp[i].im * X_add_fp[i].im));
+        }
+
+        //scalar BFP path, as in aec_priv_update_total_X_energy()
+        bfp_complex_s32_squared_mag(&scratch, &X_sub);
+        bfp_s32_sub(&energy_ref, &energy_ref, &scratch);
+        bfp_complex_s32_squared_mag(&scratch, &X_add);
+        bfp_s32_add(&energy_ref, &energy_ref, &scratch);
+        //dut
+        aec_vect_energy_update(&energy_dut, &X_sub, &X_add);
+
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(vect_s32_headroom(energy_dut.data, NUM_BINS), energy_dut.hr, "energy headroom incorrect.");
+
+        unsigned diff = vector_int32_maxdiff(energy_dut.data, energy_dut.exp, energy_fp, 0, NUM_BINS);
+        max_diff_exact = (diff > max_diff_exact) ? diff : max_diff_exact;
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(AEC_VECT_LSB_TOLERANCE, diff, "diff from exact result too large.");
+
+        for(int i=0; i<NUM_BINS; i++) {
+            energy_ref_fp[i] = ldexp(energy_ref.data[i], energy_ref.exp);
+        }
+        diff = vector_int32_maxdiff(energy_dut.data, energy_dut.exp, energy_ref_fp, 0, NUM_BINS);
+        max_diff_bfp = (diff > max_diff_bfp) ? diff : max_diff_bfp;
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(2*AEC_VECT_LSB_TOLERANCE*3, diff, "diff from BFP path too large.");
+    }
+    printf("max_diff_exact %d, max_diff_bfp %d\n", max_diff_exact, max_diff_bfp);
+}
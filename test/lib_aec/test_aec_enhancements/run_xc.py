@@ -23,13 +23,14 @@ in_dir = parser.get("Folders", "in_dir")
 out_dir = parser.get("Folders", "out_dir")
 
 adapt_mode_dict = {'AEC_ADAPTION_AUTO':0, 'AEC_ADAPTION_FORCE_ON':1, 'AEC_ADAPTION_FORCE_OFF': 2}
+partial_update_mode_dict = {'AEC_PARTIAL_UPDATE_ROUND_ROBIN':0, 'AEC_PARTIAL_UPDATE_MAX_ENERGY':1}
 
 dut_H_hat_file = "H_hat.bin"
 runtime_args_file = "args.bin"
 AEC_MAX_Y_CHANNELS = int(parser.get("Config", "y_channel_count"))
 AEC_MAX_X_CHANNELS = int(parser.get("Config", "x_channel_count"))
 
-def run_aec_xc(y_data, x_data, testname, adapt=-1, h_hat_dump=None, adapt_mode=adapt_mode_dict['AEC_ADAPTION_AUTO'], num_y_channels=AEC_MAX_Y_CHANNELS, num_x_channels=AEC_MAX_X_CHANNELS):
+def run_aec_xc(y_data, x_data, testname, adapt=-1, h_hat_dump=None, adapt_mode=adapt_mode_dict['AEC_ADAPTION_AUTO'], num_y_channels=AEC_MAX_Y_CHANNELS, num_x_channels=AEC_MAX_X_CHANNELS, partial_update_phases=0, partial_update_mode=partial_update_mode_dict['AEC_PARTIAL_UPDATE_ROUND_ROBIN']):
     input_file = f"{in_dir}/input_{testname}.wav"
     output_file = f"{out_dir}/output_{testname}.wav"
     #input wav file always has (AEC_MAX_Y_CHANNELS + AEC_MAX_X_CHANNELS) channels, as per the build time aec configuration. Changing AEC config at runtime shouldn't affect input packing
@@ -61,6 +62,8 @@ def run_aec_xc(y_data, x_data, testname, adapt=-1, h_hat_dump=None, adapt_mode=a
         fargs.write(f"x_channels {num_x_channels}\n".encode('utf-8'))
         fargs.write(f"stop_adapting {adapt}\n".encode('utf-8'))
         fargs.write(f"adaption_mode {adapt_mode}\n".encode('utf-8'))
+        fargs.write(f"partial_update_phases {partial_update_phases}\n".encode('utf-8'))
+        fargs.write(f"partial_update_mode {partial_update_mode}\n".encode('utf-8'))
     
     shutil.copy2(input_file, os.path.join(tmp_folder, "input.wav"))
     shutil.copy2(runtime_args_file, os.path.join(tmp_folder, runtime_args_file))
@@ -0,0 +1,74 @@
+# Copyright 2022 XMOS LIMITED.
+# This Software is subject to the terms of the XMOS Public Licence: Version 1.
+'''
+The purpose of this test is to measure the cost of adapting only some of the filter phases every frame.
+White noise is used as it gives a constant convergence rate.
+The convergence rate and maximum attenuation with partial update are compared against adapting all phases.
+'''
+
+import os
+
+import numpy as np
+import scipy.signal as spsig
+import scipy.io.wavfile
+from pathlib import Path
+
+import wav_test_functions as wtf
+import run_xc
+
+import pytest
+
+hydra_audio_path = os.environ.get('hydra_audio_PATH', '~/hydra_audio')
+
+def run_white_noise(testname, partial_update_phases, partial_update_mode):
+    fs = 16000
+    N = fs * 10
+    np.random.seed(500)
+
+    # load impulse response
+    filename1 = "000_LAB_XTS_DUTL_fs16kHz"
+    filepath = Path(hydra_audio_path, "acoustic_team_test_audio", "impulse", filename1 + ".npy")
+    h1 = np.load(filepath)
+    hN = h1.shape[0]
+    h = h1[:,0]
+
+    u = np.random.randn(N)
+    d = spsig.convolve(u, h, 'full')[hN-1:N]
+    d = d * 0.01 #20dB attenuation
+    u = u * 0.2
+
+    in_data = np.stack((d, u[hN-1:N]), axis=0)
+    in_data_32bit = (np.asarray(in_data * np.iinfo(np.int32).max, dtype=np.int32)).T
+
+    print("Run AEC XC")
+    dut_input_file, dut_output_file = run_xc.run_aec_xc(in_data_32bit[:,:1], in_data_32bit[:,1:], testname,
+            adapt_mode=run_xc.adapt_mode_dict['AEC_ADAPTION_FORCE_ON'], num_y_channels=1, num_x_channels=1,
+            partial_update_phases=partial_update_phases, partial_update_mode=run_xc.partial_update_mode_dict[partial_update_mode])
+    rate, output_wav_file = scipy.io.wavfile.read(dut_output_file, 'r')
+    _, leq_error = wtf.leq_smooth(output_wav_file[:,0], fs, 0.05)
+    time = np.arange(len(leq_error))*0.05
+    return wtf.calc_convergence_rate(time, leq_error), wtf.calc_max_attenuation(leq_error)
+
+
+@pytest.mark.parametrize("partial_update_mode", ['AEC_PARTIAL_UPDATE_ROUND_ROBIN', 'AEC_PARTIAL_UPDATE_MAX_ENERGY'])
+@pytest.mark.parametrize("partial_update_phases", [5, 2])
+def test_partial_update(partial_update_mode, partial_update_phases):
+    ''' test_partial_update - run mono white noise convolved with a modelled impulse response, adapting all 10 phases
+    every frame and adapting partial_update_phases of them.
+
+    pass/fail: check the partial update convergence rate is at least 10 dB/s and scales with the phases adapted
+    pass/fail: check the partial update maximum attenuation is within 6 dB of adapting all phases'''
+    testname = f"{(Path(__file__).stem)[5:]}_{partial_update_mode}_{partial_update_phases}"
+    phases = 10
+
+    rate_full, max_atten_full = run_white_noise(f"{testname}_full", 0, partial_update_mode)
+    rate_partial, max_atten_partial = run_white_noise(testname, partial_update_phases, partial_update_mode)
+    print(f"{partial_update_phases} of {phases} phases: convergence rate {rate_partial:.1f} dB/s (full {rate_full:.1f} dB/s), max attenuation {max_atten_partial:.1f} dB (full {max_atten_full:.1f} dB)")
+
+    assert rate_partial > 10
+    assert rate_partial > rate_full * partial_update_phases / phases
+    assert max_atten_partial < max_atten_full + 6
+
+
+if __name__ == "__main__":
+    test_partial_update('AEC_PARTIAL_UPDATE_ROUND_ROBIN', 5)
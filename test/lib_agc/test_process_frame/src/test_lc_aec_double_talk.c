@@ -0,0 +1,71 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "test_process_frame.h"
+#include "xmath/xmath.h"
+#include <pseudo_rand.h>
+
+// With lc_use_aec_double_talk enabled, the loss control should take double-talk from the
+// aec_double_talk_flag meta-data and ignore aec_corr_factor. Two AGC instances get the same
+// far-end correlation and far power, and only differ in the double-talk flag. The one with the
+// flag set must reach the double-talk gain and the other the far-end only gain.
+
+void test_lc_aec_double_talk() {
+    int32_t input[AGC_FRAME_ADVANCE];
+    int32_t output[AGC_FRAME_ADVANCE];
+    bfp_s32_t input_bfp;
+
+    bfp_s32_init(&input_bfp, input, FRAME_EXP, AGC_FRAME_ADVANCE, 0);
+
+    // Random seed
+    unsigned seed = 10973;
+
+    agc_config_t conf = AGC_PROFILE_COMMS;
+    conf.adapt_on_vnr = 0;
+    conf.lc_use_aec_double_talk = 1;
+
+    agc_state_t agc_far;
+    agc_meta_data_t md_far;
+    md_far.vnr_flag = AGC_META_DATA_NO_VNR;
+    md_far.aec_corr_factor = f32_to_float_s32(TEST_LC_DT_CORR);
+    md_far.aec_double_talk_flag = 0;
+
+    agc_state_t agc_double_talk;
+    agc_meta_data_t md_double_talk;
+    md_double_talk.vnr_flag = AGC_META_DATA_NO_VNR;
+    md_double_talk.aec_corr_factor = f32_to_float_s32(TEST_LC_FAR_CORR);
+    md_double_talk.aec_double_talk_flag = 1;
+
+    // Scale the input by 0.5 to avoid the AGC adaption upper threshold
+    float_s32_t scale = f32_to_float_s32(0.5);
+
+    unsigned num_frames = conf.lc_n_frame_far;
+    if (num_frames < conf.lc_n_frame_near) {
+        num_frames = conf.lc_n_frame_near;
+    }
+
+    for (unsigned iter = 0; iter < (1<<10)/F; ++iter) {
+        agc_init(&agc_far, &conf);
+        agc_init(&agc_double_talk, &conf);
+
+        for (unsigned frame = 0; frame < num_frames; ++frame) {
+            for (unsigned idx = 0; idx < AGC_FRAME_ADVANCE; ++idx) {
+                input[idx] = pseudo_rand_int32(&seed);
+            }
+            bfp_s32_headroom(&input_bfp);
+            bfp_s32_scale(&input_bfp, &input_bfp, scale);
+            bfp_s32_use_exponent(&input_bfp, FRAME_EXP);
+
+            float_s32_t input_energy = float_s64_to_float_s32(bfp_s32_energy(&input_bfp));
+            float_s32_t far_power = float_s32_mul(input_energy, f32_to_float_s32(TEST_LC_DT_POWER_SCALE));
+
+            md_far.aec_ref_power = far_power;
+            agc_process_frame(&agc_far, output, input, &md_far);
+
+            md_double_talk.aec_ref_power = far_power;
+            agc_process_frame(&agc_double_talk, output, input, &md_double_talk);
+        }
+
+        TEST_ASSERT_EQUAL_FLOAT(float_s32_to_float(conf.lc_gain_min), float_s32_to_float(agc_far.lc_gain));
+        TEST_ASSERT_EQUAL_FLOAT(float_s32_to_float(conf.lc_gain_double_talk), float_s32_to_float(agc_double_talk.lc_gain));
+    }
+}
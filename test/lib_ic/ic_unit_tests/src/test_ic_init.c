@@ -0,0 +1,26 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include "ic_unit_tests.h"
+#include "ic_api.h"
+
+// One more IC instance than there are VNR model instances
+static ic_state_t state[VNR_INFERENCE_MAX_CONTEXTS + 1];
+
+// Every IC instance claims its own VNR model instance, and ic_init() fails once there are none left
+void test_ic_init_vnr_instance() {
+    for(int i=0; i<VNR_INFERENCE_MAX_CONTEXTS; i++) {
+        TEST_ASSERT_EQUAL_INT32(0, ic_init(&state[i]));
+        for(int j=0; j<i; j++) {
+            TEST_ASSERT_NOT_EQUAL(state[j].vnr_pred_state.inference_ctx.model_index, state[i].vnr_pred_state.inference_ctx.model_index);
+        }
+    }
+    // Initialising an IC instance again doesn't use up another model instance
+    TEST_ASSERT_EQUAL_INT32(0, ic_init(&state[0]));
+    TEST_ASSERT_EQUAL_INT32(-1, ic_init(&state[VNR_INFERENCE_MAX_CONTEXTS]));
+
+    // A released model instance can be claimed by the next IC instance
+    int32_t model_index = state[0].vnr_pred_state.inference_ctx.model_index;
+    vnr_inference_ctx_release(&state[0].vnr_pred_state.inference_ctx);
+    TEST_ASSERT_EQUAL_INT32(0, ic_init(&state[VNR_INFERENCE_MAX_CONTEXTS]));
+    TEST_ASSERT_EQUAL_INT32(model_index, state[VNR_INFERENCE_MAX_CONTEXTS].vnr_pred_state.inference_ctx.model_index);
+}
@@ -0,0 +1,46 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <xcore/hwtimer.h>
+#include "vnr_features_api.h"
+#include "vnr_features_priv.h"
+#include "pseudo_rand.h"
+
+#define PROFILE_FRAMES (100)
+
+// Cycles taken by the mel filterbank and the log2 that make up a new feature slice, on random spectra
+int main(int argc, char** argv) {
+    complex_s32_t DWORD_ALIGNED X_data[VNR_FD_FRAME_LENGTH];
+    bfp_complex_s32_t X;
+    float_s32_t mel_output[VNR_MEL_FILTERS];
+    uq8_24 new_slice[VNR_MEL_FILTERS];
+    unsigned seed = 5317;
+    uint32_t max_mel_cycles = 0, max_log2_cycles = 0;
+    uint64_t total_mel_cycles = 0, total_log2_cycles = 0;
+
+    for(unsigned fr=0; fr<PROFILE_FRAMES; fr++) {
+        int hr = pseudo_rand_uint(&seed, 0, 8);
+        for(unsigned i=0; i<VNR_FD_FRAME_LENGTH; i++) {
+            X_data[i].re = pseudo_rand_int32(&seed) >> hr;
+            X_data[i].im = pseudo_rand_int32(&seed) >> hr;
+        }
+        bfp_complex_s32_init(&X, X_data, -31, VNR_FD_FRAME_LENGTH, 1);
+
+        uint32_t start_mel = get_reference_time();
+        vnr_priv_mel_compute(mel_output, &X);
+        uint32_t end_mel = get_reference_time();
+        vnr_priv_log2(new_slice, mel_output, VNR_MEL_FILTERS);
+        uint32_t end_log2 = get_reference_time();
+
+        uint32_t mel_cycles = end_mel - start_mel;
+        uint32_t log2_cycles = end_log2 - end_mel;
+        if(max_mel_cycles < mel_cycles) {max_mel_cycles = mel_cycles;}
+        if(max_log2_cycles < log2_cycles) {max_log2_cycles = log2_cycles;}
+        total_mel_cycles += mel_cycles;
+        total_log2_cycles += log2_cycles;
+    }
+    printf("Profile: max_mel_compute_cycles = %u, max_log2_cycles = %u\n", (unsigned)max_mel_cycles, (unsigned)max_log2_cycles);
+    printf("Profile: average_mel_compute_cycles = %u, average_log2_cycles = %u\n",
+            (unsigned)(total_mel_cycles / PROFILE_FRAMES), (unsigned)(total_log2_cycles / PROFILE_FRAMES));
+    return new_slice[0];
+}
@@ -0,0 +1,68 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+
+#include "vnr_features_api.h"
+#include "vnr_features_priv.h"
+
+// Features are extracted from the same input through 3 paths. The vnr_form_input_frame() output passed to
+// vnr_extract_features(), the same spectrum passed to vnr_extract_features_from_spectrum(), and a packed spectrum
+// computed by the test, as a module sharing its FFT output would, passed to vnr_extract_features_from_spectrum().
+static vnr_input_state_t vnr_input_state;
+static vnr_feature_state_t vnr_feature_state[3];
+static int32_t prev_input_samples[VNR_PROC_FRAME_LENGTH - VNR_FRAME_ADVANCE];
+void test_init()
+{
+    vnr_input_state_init(&vnr_input_state);
+    for(int i=0; i<3; i++) {
+        vnr_feature_state_init(&vnr_feature_state[i]);
+    }
+    memset(prev_input_samples, 0, sizeof(prev_input_samples));
+}
+
+void test(int32_t *output, int32_t *input)
+{
+    for(int i=0; i<3; i++) {
+        vnr_feature_state[i].config.enable_highpass = input[VNR_FRAME_ADVANCE]; // Highpass enabled flag sent as the last value
+    }
+    complex_s32_t DWORD_ALIGNED input_frame[VNR_FD_FRAME_LENGTH];
+    bfp_complex_s32_t X;
+    vnr_form_input_frame(&vnr_input_state, &X, input_frame, input);
+
+    // Packed spectrum of the same frame
+    int32_t DWORD_ALIGNED x_data[VNR_PROC_FRAME_LENGTH];
+    memcpy(x_data, prev_input_samples, (VNR_PROC_FRAME_LENGTH - VNR_FRAME_ADVANCE)*sizeof(int32_t));
+    memcpy(&x_data[VNR_PROC_FRAME_LENGTH - VNR_FRAME_ADVANCE], input, VNR_FRAME_ADVANCE*sizeof(int32_t));
+    memcpy(prev_input_samples, &x_data[VNR_FRAME_ADVANCE], (VNR_PROC_FRAME_LENGTH - VNR_FRAME_ADVANCE)*sizeof(int32_t));
+    bfp_s32_t x;
+    bfp_s32_init(&x, x_data, VNR_INPUT_EXP, VNR_PROC_FRAME_LENGTH, 1);
+    bfp_complex_s32_t *X_packed = bfp_fft_forward_mono(&x);
+    X_packed->hr = bfp_complex_s32_headroom(X_packed);
+    assert(X_packed->length == VNR_PACKED_FD_FRAME_LENGTH);
+
+    bfp_s32_t feature_patch;
+    int32_t feature_patch_data[VNR_PATCH_WIDTH*VNR_MEL_FILTERS];
+
+    // A spectrum of the wrong length is rejected
+    bfp_complex_s32_t X_bad = X;
+    X_bad.length = VNR_PACKED_FD_FRAME_LENGTH - 1;
+    output[0] = vnr_extract_features_from_spectrum(&vnr_feature_state[1], &feature_patch, feature_patch_data, &X_bad);
+    output[1] = vnr_extract_features_from_spectrum(&vnr_feature_state[1], &feature_patch, feature_patch_data, &X);
+    output[2] = vnr_extract_features_from_spectrum(&vnr_feature_state[2], &feature_patch, feature_patch_data, X_packed);
+    memcpy(&output[3], &feature_patch.exp, sizeof(int32_t));
+    memcpy(&output[4], feature_patch.data, feature_patch.length * sizeof(int32_t));
+
+    vnr_extract_features(&vnr_feature_state[0], &feature_patch, feature_patch_data, &X);
+    memcpy(&output[4+feature_patch.length], &feature_patch.exp, sizeof(int32_t));
+    memcpy(&output[5+feature_patch.length], feature_patch.data, feature_patch.length * sizeof(int32_t));
+
+    // Sharing the spectrum doesn't change it, and vnr_extract_features_from_spectrum() on it gives the same state as
+    // vnr_extract_features()
+    assert(X.length == VNR_FD_FRAME_LENGTH);
+    assert(X_packed->length == VNR_PACKED_FD_FRAME_LENGTH);
+    output[5+(2*feature_patch.length)] = memcmp(vnr_feature_state[0].feature_buffers, vnr_feature_state[1].feature_buffers, sizeof(vnr_feature_state[0].feature_buffers));
+}
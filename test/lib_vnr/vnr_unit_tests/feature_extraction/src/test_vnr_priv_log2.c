@@ -16,4 +16,8 @@ void test_init()
 void test(int32_t *output, int32_t *input) {
     //log2 output is always 8.24
     vnr_priv_log2(&output[0], (float_s32_t*)input, VNR_MEL_FILTERS);
+    // The batched log2 is bit exact with the single value one
+    for(int i=0; i<VNR_MEL_FILTERS; i++) {
+        assert(output[i] == (int32_t)vnr_priv_float_s32_to_fixed_q24_log2(((float_s32_t*)input)[i]));
+    }
 }
@@ -0,0 +1,53 @@
+import numpy as np
+import data_processing.frame_preprocessor as fp
+import os
+import test_utils
+
+this_file_dir = os.path.dirname(os.path.realpath(__file__))
+exe_dir = os.path.join(this_file_dir, '../../../../build/test/lib_vnr/vnr_unit_tests/feature_extraction/bin/')
+xe = os.path.join(exe_dir, 'fwk_voice_test_vnr_extract_features_from_spectrum.xe')
+
+def test_vnr_extract_features_from_spectrum(target):
+    np.random.seed(3571)
+    input_data = np.empty(0, dtype=np.int32)
+    input_words_per_frame = fp.FRAME_ADVANCE + 1 #No. of int32 values sent to dut as input per frame
+
+    patch_len = fp.PATCH_WIDTH * fp.MEL_FILTERS
+    # 3 return values, packed spectrum features exponent and mantissas, unpacked spectrum features exponent and mantissas, feature state compare
+    output_words_per_frame = 3 + 2*(patch_len + 1) + 1
+
+    input_data = np.append(input_data, np.array([input_words_per_frame, output_words_per_frame], dtype=np.int32))
+    min_int = -2**31
+    max_int = 2**31
+    test_frames = 1024
+
+    for itt in range(0,test_frames):
+        enable_highpass = np.random.randint(2)
+        hr = np.random.randint(8)
+        data = np.random.randint(min_int, high=max_int, size=fp.FRAME_ADVANCE)
+        data = np.array(data, dtype=np.int32)
+        data = data >> hr
+        input_data = np.append(input_data, data)
+        input_data = np.append(input_data, enable_highpass)
+
+    exe_name = xe
+    if(target == "x86"): #Remove the .xe extension from the xe name to get the x86 executable
+        exe_name = os.path.splitext(xe)[0]
+    op = test_utils.run_dut(input_data, "test_vnr_extract_features_from_spectrum", exe_name)
+    op = op.reshape(-1, output_words_per_frame)
+    assert op.shape[0] == test_frames
+
+    max_diff = 0
+    for fr in range(0,test_frames):
+        assert op[fr][0] == -1, f"ERROR: frame {fr}. spectrum of the wrong length not rejected"
+        assert op[fr][1] == 0, f"ERROR: frame {fr}. unpacked spectrum rejected"
+        assert op[fr][2] == 0, f"ERROR: frame {fr}. packed spectrum rejected"
+        assert op[fr][-1] == 0, f"ERROR: frame {fr}. shared unpacked spectrum feature state differs from vnr_extract_features()"
+
+        packed = test_utils.int32_to_double(op[fr][4:4+patch_len], op[fr][3])
+        unpacked = test_utils.int32_to_double(op[fr][5+patch_len:5+2*patch_len], op[fr][4+patch_len])
+        diff = np.max(np.abs(packed - unpacked))
+        max_diff = max(max_diff, diff)
+        assert diff < 1e-5, f"ERROR: frame {fr}. packed spectrum features max diff exceeds threshold"
+
+    print(f"max diff packed vs unpacked spectrum features = {max_diff}")
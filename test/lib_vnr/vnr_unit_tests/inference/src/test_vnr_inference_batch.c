@@ -0,0 +1,48 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "vnr_defines.h"
+#include "vnr_inference_api.h"
+
+// One more patch than vnr_inference_run_batch() runs in one invoke, so that the batch is split
+#define BATCH_SIZE (VNR_INFERENCE_MAX_BATCH + 1)
+
+static vnr_inference_ctx_t ctx;
+
+void test_init()
+{
+    int32_t ret = vnr_inference_ctx_init(&ctx, VNR_INFERENCE_ANY_INSTANCE);
+    if(ret) {
+        printf("vnr_inference_ctx_init() returned error %ld\n",ret);
+        assert(0);
+    }
+}
+
+void test(int32_t *output, int32_t *input)
+{
+    // Patch b of the batch is the input patch scaled by 2^-b. Each one is run on its own with vnr_inference_run()
+    // and then together with vnr_inference_run_batch().
+    int32_t patch_data[BATCH_SIZE][VNR_PATCH_WIDTH*VNR_MEL_FILTERS];
+    bfp_s32_t patch[BATCH_SIZE];
+    float_s32_t *single_output = (float_s32_t*)&output[0];
+    float_s32_t *batch_output = (float_s32_t*)&output[2*BATCH_SIZE];
+    for(int run=0; run<2; run++) {
+        for(int b=0; b<BATCH_SIZE; b++) {
+            // input has exponent followed by 96 data values
+            memcpy(patch_data[b], &input[1], sizeof(patch_data[b]));
+            bfp_s32_init(&patch[b], patch_data[b], input[0] - b, VNR_PATCH_WIDTH*VNR_MEL_FILTERS, 1);
+        }
+        if(run == 0) {
+            for(int b=0; b<BATCH_SIZE; b++) {
+                vnr_inference_run(&ctx, &single_output[b], &patch[b]);
+            }
+        }
+        else {
+            vnr_inference_run_batch(&ctx, batch_output, patch, BATCH_SIZE);
+        }
+    }
+}
@@ -0,0 +1,150 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "vnr_defines.h"
+#include "vnr_inference_api.h"
+#if X86_BUILD
+#include <pthread.h>
+#else
+#include <xcore/parallel.h>
+#endif
+
+#if (VNR_INFERENCE_MAX_CONTEXTS < 2)
+#error test_vnr_inference_ctx needs VNR_INFERENCE_MAX_CONTEXTS of at least 2
+#endif
+
+// ctx runs at the same time as vnr_inference(). The others claim the remaining model instances
+static vnr_inference_ctx_t ctx;
+static vnr_inference_ctx_t other_ctx[VNR_INFERENCE_MAX_CONTEXTS - 1];
+
+typedef struct {
+    vnr_inference_ctx_t *ctx;
+    float_s32_t *output;
+    bfp_s32_t *patch;
+    int32_t init_ret;
+}ctx_job_t;
+
+// Runs inference on job->ctx, or with vnr_inference() if it is NULL. Claims a free model instance for job->ctx
+// instead if patch is NULL
+static void run_ctx_job(ctx_job_t *job)
+{
+    if(job->patch == NULL) {
+        job->init_ret = vnr_inference_ctx_init(job->ctx, VNR_INFERENCE_ANY_INSTANCE);
+    }
+    else if(job->ctx == NULL) {
+        vnr_inference(job->output, job->patch);
+    }
+    else {
+        vnr_inference_run(job->ctx, job->output, job->patch);
+    }
+}
+
+#if X86_BUILD
+static void *ctx_job(void *arg)
+{
+    run_ctx_job((ctx_job_t*)arg);
+    return NULL;
+}
+#else
+DECLARE_JOB(ctx_job, (ctx_job_t*));
+void ctx_job(ctx_job_t *job)
+{
+    run_ctx_job(job);
+}
+#endif
+
+static void run_ctx_jobs(ctx_job_t *job)
+{
+#if X86_BUILD
+    pthread_t thread[2];
+    for(int i=0; i<2; i++) {
+        pthread_create(&thread[i], NULL, ctx_job, &job[i]);
+    }
+    for(int i=0; i<2; i++) {
+        pthread_join(thread[i], NULL);
+    }
+#else
+    PAR_JOBS(
+        PJOB(ctx_job, (&job[0])),
+        PJOB(ctx_job, (&job[1]))
+        );
+#endif
+}
+
+void test_init()
+{
+    int32_t ret = vnr_inference_init();
+    if(ret) {
+        printf("vnr_inference_init() returned error %ld\n",ret);
+        assert(0);
+    }
+    // Initialising again doesn't claim another instance
+    ret = vnr_inference_init();
+    assert(ret == 0);
+    ret = vnr_inference_ctx_init(&ctx, VNR_INFERENCE_ANY_INSTANCE);
+    if(ret) {
+        printf("vnr_inference_ctx_init() returned error %ld\n",ret);
+        assert(0);
+    }
+    ret = vnr_inference_ctx_init(&ctx, VNR_INFERENCE_ANY_INSTANCE);
+    assert(ret == 0);
+    ret = vnr_inference_ctx_init(&other_ctx[0], VNR_INFERENCE_MAX_CONTEXTS);
+    assert(ret == -1);
+    // An instance can only be claimed by one context
+    ret = vnr_inference_ctx_init(&other_ctx[0], ctx.model_index);
+    assert(ret == -1);
+
+    // Claim the remaining instances, after which none is free
+    for(int i=0; i<VNR_INFERENCE_MAX_CONTEXTS - 2; i++) {
+        ret = vnr_inference_ctx_init(&other_ctx[i], VNR_INFERENCE_ANY_INSTANCE);
+        assert(ret == 0);
+        assert(other_ctx[i].model_index != ctx.model_index);
+    }
+    vnr_inference_ctx_t *last_ctx = &other_ctx[VNR_INFERENCE_MAX_CONTEXTS - 2];
+    ret = vnr_inference_ctx_init(last_ctx, VNR_INFERENCE_ANY_INSTANCE);
+    assert(ret == -1);
+
+    // A released instance is free again. When two threads claim the only free instance at the same time, only one
+    // of them gets it
+    vnr_inference_ctx_release(&ctx);
+    ctx_job_t job[2];
+    vnr_inference_ctx_t *claiming_ctx[2] = {&ctx, last_ctx};
+    for(int i=0; i<2; i++) {
+        job[i].ctx = claiming_ctx[i];
+        job[i].patch = NULL;
+    }
+    run_ctx_jobs(job);
+    assert((job[0].init_ret == 0) != (job[1].init_ret == 0));
+    if(job[1].init_ret == 0) {
+        vnr_inference_ctx_release(last_ctx);
+        ret = vnr_inference_ctx_init(&ctx, VNR_INFERENCE_ANY_INSTANCE);
+        assert(ret == 0);
+    }
+}
+
+void test(int32_t *output, int32_t *input)
+{
+    // Run the same patch through vnr_inference() and then through vnr_inference() and ctx at the same time, on separate
+    // threads. The patch memory is overwritten by the inference so each run gets its own copy.
+    int32_t patch_data[3][VNR_PATCH_WIDTH*VNR_MEL_FILTERS];
+    bfp_s32_t this_patch[3];
+    for(int i=0; i<3; i++) {
+        // input has exponent followed by 96 data values
+        memcpy(patch_data[i], &input[1], sizeof(patch_data[i]));
+        bfp_s32_init(&this_patch[i], patch_data[i], input[0], VNR_PATCH_WIDTH*VNR_MEL_FILTERS, 1);
+    }
+    vnr_inference((float_s32_t*)&output[0], &this_patch[0]);
+
+    ctx_job_t job[2];
+    vnr_inference_ctx_t *job_ctx[2] = {NULL, &ctx};
+    for(int i=0; i<2; i++) {
+        job[i].ctx = job_ctx[i];
+        job[i].output = (float_s32_t*)&output[2*(i+1)];
+        job[i].patch = &this_patch[i+1];
+    }
+    run_ctx_jobs(job);
+}
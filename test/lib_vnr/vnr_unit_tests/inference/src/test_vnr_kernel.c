@@ -0,0 +1,33 @@
+// Copyright 2022 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "vnr_defines.h"
+#include "wrapper.h"
+#include "kernel/vnr_kernel.h"
+
+void test_init()
+{
+    int32_t ret = vnr_init(0);
+    if(ret) {
+        printf("vnr_init() returned error %ld\n",ret);
+        assert(0);
+    }
+}
+
+void test(int32_t *output, int32_t *input)
+{
+    // input has the 96 quantised features packed 4 to a word. output is the hand written kernel output followed by the
+    // output of the model that vnr_inference() runs.
+    const int8_t *quantised_patch = (const int8_t*)input;
+    int8_t kernel_output;
+    vnr_kernel_run(&kernel_output, quantised_patch);
+    output[0] = kernel_output;
+
+    memcpy(vnr_get_input(0), quantised_patch, VNR_PATCH_WIDTH*VNR_MEL_FILTERS);
+    vnr_inference_invoke(0);
+    output[1] = *vnr_get_output(0);
+}
@@ -0,0 +1,54 @@
+import numpy as np
+import data_processing.frame_preprocessor as fp
+import py_vnr.vnr as vnr
+import os
+import sys
+this_file_dir = os.path.dirname(os.path.realpath(__file__))
+sys.path.append(os.path.join(this_file_dir, "../feature_extraction"))
+import test_utils
+
+exe_dir = os.path.join(this_file_dir, '../../../../build/test/lib_vnr/vnr_unit_tests/inference/bin/')
+xe = os.path.join(exe_dir, 'fwk_voice_test_vnr_inference_batch.xe')
+
+batch_size = 5 # VNR_INFERENCE_MAX_BATCH + 1
+
+def test_vnr_inference_batch(target, tflite_model):
+    np.random.seed(2467)
+    vnr_obj = vnr.Vnr(model_file=tflite_model) 
+
+    input_data = np.empty(0, dtype=np.int32)
+    input_words_per_frame = (fp.PATCH_WIDTH * fp.MEL_FILTERS)+1 # 96 mantissas and 1 exponent
+    output_words_per_frame = 4 * batch_size # vnr_inference_run() outputs followed by the vnr_inference_run_batch() outputs
+    input_data = np.append(input_data, np.array([input_words_per_frame, output_words_per_frame], dtype=np.int32))
+
+    min_int = -2**31
+    max_int = 0 # Normalised features are all negative with a max of 0
+    test_frames = 1024
+    ref_output_double = np.empty((test_frames, batch_size), dtype=np.float64)
+    for itt in range(0,test_frames):
+        data = np.random.randint(min_int, high=max_int+1, size=fp.PATCH_WIDTH * fp.MEL_FILTERS)
+        exp = np.random.randint(-30, high=0) # exp
+        input_data = np.append(input_data, exp)
+        input_data = np.append(input_data, data)
+        # Ref implementation. Patch b in the batch is the input patch scaled by 2**-b
+        for b in range(batch_size):
+            this_patch = test_utils.int32_to_double(data, exp - b)
+            this_patch = this_patch.reshape(1, 1, fp.PATCH_WIDTH, fp.MEL_FILTERS)
+            ref_output_double[itt, b] = vnr_obj.run(this_patch)
+
+    exe_name = xe
+    if(target == "x86"): #Remove the .xe extension from the xe name to get the x86 executable
+        exe_name = os.path.splitext(xe)[0]
+    op = test_utils.run_dut(input_data, "test_vnr_inference_batch", exe_name)
+    op = op.reshape(test_frames, output_words_per_frame)
+
+    single = op[:, 0:2*batch_size]
+    batch = op[:, 2*batch_size:]
+    assert(np.array_equal(single, batch)), "ERROR: test_vnr_inference_batch batch output differs from running each patch on its own"
+
+    dut_output_double = single[:, 0::2].astype(np.float64) * (2.0 ** single[:, 1::2])
+    diff = np.abs(ref_output_double - dut_output_double)
+    assert(np.max(diff) < 0.05), f"ERROR: test_vnr_inference_batch max diff {np.max(diff)} exceeds threshold"
+
+if __name__ == "__main__":
+    test_vnr_inference_batch("xcore", test_utils.get_model())
@@ -0,0 +1,53 @@
+import numpy as np
+import data_processing.frame_preprocessor as fp
+import py_vnr.vnr as vnr
+import os
+import sys
+this_file_dir = os.path.dirname(os.path.realpath(__file__))
+sys.path.append(os.path.join(this_file_dir, "../feature_extraction"))
+import test_utils
+
+exe_dir = os.path.join(this_file_dir, '../../../../build/test/lib_vnr/vnr_unit_tests/inference/bin/')
+xe = os.path.join(exe_dir, 'fwk_voice_test_vnr_inference_ctx.xe')
+
+def test_vnr_inference_ctx(target, tflite_model):
+    np.random.seed(3571)
+    vnr_obj = vnr.Vnr(model_file=tflite_model) 
+
+    input_data = np.empty(0, dtype=np.int32)
+    input_words_per_frame = (fp.PATCH_WIDTH * fp.MEL_FILTERS)+1 # 96 mantissas and 1 exponent
+    output_words_per_frame = 6 # vnr_inference() output followed by the output of vnr_inference() and a context run at the same time
+    input_data = np.append(input_data, np.array([input_words_per_frame, output_words_per_frame], dtype=np.int32))
+
+    min_int = -2**31
+    max_int = 0 # Normalised features are all negative with a max of 0
+    test_frames = 1024
+    ref_output_double = np.empty(0, dtype=np.float64)
+    for itt in range(0,test_frames):
+        data = np.random.randint(min_int, high=max_int+1, size=fp.PATCH_WIDTH * fp.MEL_FILTERS)
+        exp = np.random.randint(-31, high=0) # exp
+        input_data = np.append(input_data, exp)
+        input_data = np.append(input_data, data)
+        # Ref implementation
+        this_patch = test_utils.int32_to_double(data, exp)
+        this_patch = this_patch.reshape(1, 1, fp.PATCH_WIDTH, fp.MEL_FILTERS)
+        ref_output_double = np.append(ref_output_double, vnr_obj.run(this_patch))
+
+    exe_name = xe
+    if(target == "x86"): #Remove the .xe extension from the xe name to get the x86 executable
+        exe_name = os.path.splitext(xe)[0]
+    op = test_utils.run_dut(input_data, "test_vnr_inference_ctx", exe_name)
+    op = op.reshape(test_frames, output_words_per_frame)
+
+    # Every context has its own model instance and quantisation spec, so has to give exactly the same output as vnr_inference()
+    # run on its own, also when vnr_inference() and another context run at the same time on separate threads
+    for c in range(1, 3):
+        assert(np.array_equal(op[:,0:2], op[:,2*c:2*c+2])), f"ERROR: test_vnr_inference_ctx concurrent run {c-1} output differs from vnr_inference()"
+
+    dut_output_double = op[:,0].astype(np.float64) * (2.0 ** op[:,1])
+    for fr in range(0,test_frames):
+        diff = np.abs(ref_output_double[fr] - dut_output_double[fr])
+        assert(diff < 0.05), f"ERROR: test_vnr_inference_ctx frame {fr}. diff {diff} exceeds threshold"
+
+if __name__ == "__main__":
+    test_vnr_inference_ctx("xcore", test_utils.get_model())
@@ -0,0 +1,55 @@
+import numpy as np
+import data_processing.frame_preprocessor as fp
+import os
+import sys
+this_file_dir = os.path.dirname(os.path.realpath(__file__))
+sys.path.append(os.path.join(this_file_dir, "../feature_extraction"))
+import test_utils
+import tensorflow as tf
+
+exe_dir = os.path.join(this_file_dir, '../../../../build/test/lib_vnr/vnr_unit_tests/inference/bin/')
+xe = os.path.join(exe_dir, 'fwk_voice_test_vnr_kernel.xe')
+
+def test_vnr_kernel(target, tflite_model):
+    np.random.seed(4813)
+    interpreter_tflite = tf.lite.Interpreter(model_path=tflite_model)
+    interpreter_tflite.allocate_tensors()
+    input_details = interpreter_tflite.get_input_details()[0]
+    output_details = interpreter_tflite.get_output_details()[0]
+    output_scale, output_zero_point = output_details["quantization"]
+
+    input_data = np.empty(0, dtype=np.int32)
+    input_words_per_frame = (fp.PATCH_WIDTH * fp.MEL_FILTERS) // 4 # 96 int8 quantised features
+    output_words_per_frame = 2 # Hand written kernel output and vnr_inference() model output
+    input_data = np.append(input_data, np.array([input_words_per_frame, output_words_per_frame], dtype=np.int32))
+
+    test_frames = 4096
+    ref_output = np.empty(test_frames, dtype=np.int32)
+    for itt in range(0,test_frames):
+        # Random normalised features over the range of the model input quantisation
+        exp = np.random.randint(-30, high=-24)
+        data = np.random.randint(-2**31, high=1, size=fp.PATCH_WIDTH * fp.MEL_FILTERS)
+        this_patch = test_utils.quantise_patch(tflite_model, test_utils.int32_to_double(data, exp))
+        input_data = np.append(input_data, this_patch.view(np.int32))
+        # Ref implementation
+        interpreter_tflite.set_tensor(input_details["index"], this_patch.reshape(input_details["shape"]))
+        interpreter_tflite.invoke()
+        ref_output[itt] = interpreter_tflite.get_tensor(output_details["index"]).flatten()[0]
+
+    exe_name = xe
+    if(target == "x86"): #Remove the .xe extension from the xe name to get the x86 executable
+        exe_name = os.path.splitext(xe)[0]
+    op = test_utils.run_dut(input_data, "test_vnr_kernel", exe_name)
+    kernel_output = op[0::2]
+    model_output = op[1::2]
+
+    mismatch = np.flatnonzero(kernel_output != ref_output)
+    assert(len(mismatch) == 0), f"ERROR: test_vnr_kernel frame {mismatch[0]}. kernel output {kernel_output[mismatch[0]]} != TensorFlow Lite output {ref_output[mismatch[0]]}"
+
+    # The model that vnr_inference() runs is optimised for xcore, so only has to be close to the kernel
+    diff = np.abs(kernel_output - model_output).astype(np.float64) * output_scale
+    print("max_diff = ", np.max(diff))
+    assert(np.max(diff) < 0.05), f"ERROR: test_vnr_kernel max diff {np.max(diff)} from the vnr_inference() model exceeds threshold"
+
+if __name__ == "__main__":
+    test_vnr_kernel("xcore", test_utils.get_model())